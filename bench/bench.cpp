@@ -0,0 +1,260 @@
+#include "bench.h"
+
+#include "fmath.h"
+
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+
+#if PLATFORM_WINDOWS
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+// ------------------------------------------------------------------------------
+// Heap counters
+// ------------------------------------------------------------------------------
+
+static std::atomic<u64> heap_bytes{ 0 };
+static std::atomic<u64> heap_allocs{ 0 };
+
+static void* counted_alloc(size_t size)
+{
+    heap_bytes.fetch_add(size, std::memory_order_relaxed);
+    heap_allocs.fetch_add(1, std::memory_order_relaxed);
+
+    void* p = malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+
+    return p;
+}
+
+static void* counted_aligned_alloc(size_t size, size_t alignment)
+{
+    heap_bytes.fetch_add(size, std::memory_order_relaxed);
+    heap_allocs.fetch_add(1, std::memory_order_relaxed);
+
+#if defined(_MSC_VER)
+    void* p = _aligned_malloc(size ? size : 1, alignment);
+#else
+    void* p = nullptr;
+    if (posix_memalign(&p, alignment < sizeof(void*) ? sizeof(void*) : alignment, size ? size : 1) != 0)
+        p = nullptr;
+#endif
+    if (!p)
+        throw std::bad_alloc();
+
+    return p;
+}
+
+static void counted_aligned_free(void* p)
+{
+#if defined(_MSC_VER)
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+void* operator new(size_t size) { return counted_alloc(size); }
+void* operator new[](size_t size) { return counted_alloc(size); }
+void* operator new(size_t size, std::align_val_t al) { return counted_aligned_alloc(size, size_t(al)); }
+void* operator new[](size_t size, std::align_val_t al) { return counted_aligned_alloc(size, size_t(al)); }
+
+// The nothrow forms would otherwise come from the library and pair its allocator with the free below
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    try { return counted_alloc(size); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    try { return counted_alloc(size); } catch (...) { return nullptr; }
+}
+void* operator new(size_t size, std::align_val_t al, const std::nothrow_t&) noexcept
+{
+    try { return counted_aligned_alloc(size, size_t(al)); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t size, std::align_val_t al, const std::nothrow_t&) noexcept
+{
+    try { return counted_aligned_alloc(size, size_t(al)); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { counted_aligned_free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { counted_aligned_free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { counted_aligned_free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { counted_aligned_free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { counted_aligned_free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { counted_aligned_free(p); }
+
+namespace JojBench
+{
+#if defined(_MSC_VER)
+    const void* volatile sink = nullptr;
+#endif
+
+    u64 allocated_bytes()
+    {
+        return heap_bytes.load(std::memory_order_relaxed);
+    }
+
+    u64 allocation_count()
+    {
+        return heap_allocs.load(std::memory_order_relaxed);
+    }
+
+    const char* math_backend()
+    {
+#if FMATH_AVX
+        return "avx";
+#elif FMATH_SSE
+        return "sse2";
+#elif FMATH_NEON
+        return "neon";
+#else
+        return "scalar";
+#endif
+    }
+
+    // ------------------------------------------------------------------------------
+    // Runner
+    // ------------------------------------------------------------------------------
+
+    BenchResult run_benchmark(const Benchmark& b, f64 min_time)
+    {
+        typedef std::chrono::steady_clock Clock;
+
+        // Warm-up, also runs any lazy setup of the benchmark
+        b.func(1);
+
+        u64 iterations = 1;
+        f64 elapsed = 0.0;
+        u64 bytes = 0;
+        u64 allocs = 0;
+
+        for (;;)
+        {
+            u64 bytes_before = allocated_bytes();
+            u64 allocs_before = allocation_count();
+
+            Clock::time_point start = Clock::now();
+            b.func(iterations);
+            Clock::time_point end = Clock::now();
+
+            elapsed = std::chrono::duration<f64>(end - start).count();
+            bytes = allocated_bytes() - bytes_before;
+            allocs = allocation_count() - allocs_before;
+
+            if (elapsed >= min_time || iterations >= 1000000000ULL)
+                break;
+
+            // Aim past min_time, growing at least 2x and at most 100x per step
+            f64 scale = elapsed > 0.0 ? (min_time * 1.4) / elapsed : 100.0;
+            scale = scale < 2.0 ? 2.0 : (scale > 100.0 ? 100.0 : scale);
+            iterations = u64(f64(iterations) * scale);
+        }
+
+        BenchResult r;
+        r.name = b.name;
+        r.iterations = iterations;
+        r.ns_per_op = elapsed * 1e9 / f64(iterations);
+        r.bytes_per_op = f64(bytes) / f64(iterations);
+        r.allocs_per_op = f64(allocs) / f64(iterations);
+        r.items_per_sec = elapsed > 0.0 ? b.items_per_op * f64(iterations) / elapsed : 0.0;
+        r.item_name = b.item_name;
+        return r;
+    }
+
+    // ------------------------------------------------------------------------------
+    // Reports
+    // ------------------------------------------------------------------------------
+
+    void print_results(const std::vector<BenchResult>& results)
+    {
+        fprintf(stderr, "%-28s %14s %14s %12s %12s %16s\n",
+            "benchmark", "iterations", "ns/op", "B/op", "allocs/op", "throughput");
+
+        for (const BenchResult& r : results)
+        {
+            fprintf(stderr, "%-28s %14llu %14.2f %12.1f %12.2f %12.3g %s/s\n",
+                r.name.c_str(), r.iterations, r.ns_per_op, r.bytes_per_op,
+                r.allocs_per_op, r.items_per_sec, r.item_name.c_str());
+        }
+    }
+
+    b8 write_json(const std::vector<BenchResult>& results, const char* path)
+    {
+        FILE* f = fopen(path, "w");
+        if (!f)
+            return false;
+
+        fprintf(f, "{\n");
+        fprintf(f, "  \"context\": {\n");
+        fprintf(f, "    \"math_backend\": \"%s\",\n", math_backend());
+#if defined(NDEBUG)
+        fprintf(f, "    \"build\": \"release\"\n");
+#else
+        fprintf(f, "    \"build\": \"debug\"\n");
+#endif
+        fprintf(f, "  },\n");
+        fprintf(f, "  \"benchmarks\": [\n");
+
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const BenchResult& r = results[i];
+            fprintf(f, "    { \"name\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.3f, "
+                "\"bytes_per_op\": %.3f, \"allocs_per_op\": %.3f, \"items_per_second\": %.3f, \"item\": \"%s\" }%s\n",
+                r.name.c_str(), r.iterations, r.ns_per_op, r.bytes_per_op, r.allocs_per_op,
+                r.items_per_sec, r.item_name.c_str(), i + 1 < results.size() ? "," : "");
+        }
+
+        fprintf(f, "  ]\n");
+        fprintf(f, "}\n");
+        fclose(f);
+        return true;
+    }
+
+    // ------------------------------------------------------------------------------
+    // StdoutSilencer
+    // ------------------------------------------------------------------------------
+
+    StdoutSilencer::StdoutSilencer(const char* path)
+    {
+        fflush(stdout);
+#if PLATFORM_WINDOWS
+        saved_fd = _dup(_fileno(stdout));
+        i32 target_fd = path ? _open(path, _O_WRONLY | _O_CREAT | _O_TRUNC, _S_IREAD | _S_IWRITE) : _open("NUL", _O_WRONLY);
+        _dup2(target_fd, _fileno(stdout));
+        _close(target_fd);
+#else
+        saved_fd = dup(fileno(stdout));
+        i32 target_fd = path ? open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644) : open("/dev/null", O_WRONLY);
+        dup2(target_fd, fileno(stdout));
+        close(target_fd);
+#endif
+    }
+
+    StdoutSilencer::~StdoutSilencer()
+    {
+        fflush(stdout);
+#if PLATFORM_WINDOWS
+        _dup2(saved_fd, _fileno(stdout));
+        _close(saved_fd);
+#else
+        dup2(saved_fd, fileno(stdout));
+        close(saved_fd);
+#endif
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "defines.h"
+
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace JojBench
+{
+    // Benchmark body, must run the measured operation "iterations" times
+    typedef void(*BenchFunc)(u64 iterations);
+
+    struct Benchmark
+    {
+        const char* name;           // Benchmark name, used by --filter and in reports
+        BenchFunc func;             // Benchmark body
+        f64 items_per_op;           // Items processed by one operation (vertices, messages, ...)
+        const char* item_name;      // Item label used for throughput
+    };
+
+    struct BenchResult
+    {
+        std::string name;           // Benchmark name
+        u64 iterations;             // Operations in the measured run
+        f64 ns_per_op;              // Wall time per operation
+        f64 bytes_per_op;           // Heap bytes allocated per operation
+        f64 allocs_per_op;          // Heap allocations per operation
+        f64 items_per_sec;          // Throughput in items per second
+        std::string item_name;      // Item label
+    };
+
+    // Heap counters, fed by the global operator new replaced in bench.cpp
+    u64 allocated_bytes();
+    u64 allocation_count();
+
+    // Return name of the fmath.h backend this binary was built with
+    const char* math_backend();
+
+    /* @brief Run benchmark b with growing iteration counts until one run
+     * takes at least min_time seconds, then report that run.
+     * A warm-up call runs first so lazy setup is not measured.
+     */
+    BenchResult run_benchmark(const Benchmark& b, f64 min_time);
+
+    // Print results as a table on stderr
+    void print_results(const std::vector<BenchResult>& results);
+
+    // Write results as JSON to path, return false if the file can't be opened
+    b8 write_json(const std::vector<BenchResult>& results, const char* path);
+
+    // Redirect stdout to the null device while alive (logger benchmarks)
+    class StdoutSilencer
+    {
+    public:
+        // Redirect stdout to path, or discard it if path is nullptr
+        explicit StdoutSilencer(const char* path = nullptr);
+        ~StdoutSilencer();
+
+    private:
+        i32 saved_fd;
+    };
+
+#if defined(_MSC_VER)
+    extern const void* volatile sink;
+#endif
+
+    // Keep the compiler from discarding value or the work that produced it
+    template <typename T>
+    inline void do_not_optimize(const T& value)
+    {
+#if defined(_MSC_VER)
+        sink = &value;
+        _ReadWriteBarrier();
+#else
+        asm volatile("" : : "g"(&value) : "memory");
+#endif
+    }
+}
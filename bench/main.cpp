@@ -0,0 +1,1018 @@
+#include "bench.h"
+
+#include "fmath.h"
+#include "frame_pipeline.h"
+#include "ecs.h"
+#include "events.h"
+#include "geometry.h"
+#include "job_system.h"
+#include "clock.h"
+#include "timer_wheel.h"
+#include "transform_hierarchy.h"
+#include "frame_arena.h"
+#include "handle_pool.h"
+#include "memory_tracker.h"
+#include "mesh_optimizer.h"
+#include "null/renderer_null.h"
+#include "profiler.h"
+#include "vertex_format.h"
+#include "logger.h"
+
+#if PLATFORM_WINDOWS
+#include "win32/timer.h"
+#elif PLATFORM_LINUX
+#include "engine.h"
+#include "linux/timer.h"
+#endif // PLATFORM_WINDOWS
+
+#include <chrono>
+#include <deque>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace JojBench;
+
+// Working set size of the math benchmarks, small enough to stay in L1/L2
+static const u32 MATH_SET = 256;
+
+// ------------------------------------------------------------------------------
+// fmath
+// ------------------------------------------------------------------------------
+
+static std::vector<Mat4>& bench_matrices()
+{
+    static std::vector<Mat4> matrices;
+    if (matrices.empty())
+    {
+        matrices.resize(MATH_SET);
+        for (u32 i = 0; i < MATH_SET; ++i)
+            for (u32 j = 0; j < 16; ++j)
+                matrices[i].data[j] = f32((i * 16 + j) % 7) * 0.25f - 0.5f;
+    }
+    return matrices;
+}
+
+static std::vector<Vec3>& bench_vectors()
+{
+    static std::vector<Vec3> vectors;
+    if (vectors.empty())
+    {
+        vectors.resize(MATH_SET);
+        for (u32 i = 0; i < MATH_SET; ++i)
+            vectors[i] = vec3_create(f32(i % 13) + 1.0f, f32(i % 7) - 3.0f, f32(i % 5) + 0.5f);
+    }
+    return vectors;
+}
+
+static void bench_mat4_mul(u64 iterations)
+{
+    std::vector<Mat4>& m = bench_matrices();
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        Mat4 r = mat4_mul(m[i % MATH_SET], m[(i + 1) % MATH_SET]);
+        do_not_optimize(r);
+    }
+}
+
+static void bench_mat4_mul_scalar(u64 iterations)
+{
+    std::vector<Mat4>& m = bench_matrices();
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        Mat4 r = mat4_mul_scalar(m[i % MATH_SET], m[(i + 1) % MATH_SET]);
+        do_not_optimize(r);
+    }
+}
+
+static void bench_vec3_normalize(u64 iterations)
+{
+    std::vector<Vec3>& v = bench_vectors();
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        Vec3 r = vec3_normalize(v[i % MATH_SET]);
+        do_not_optimize(r);
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Geometry
+// ------------------------------------------------------------------------------
+
+// Exposes Geometry::subdivide to the benchmark
+class SubdivideGeometry : public JojRenderer::Geometry
+{
+public:
+    void run_subdivide() { subdivide(); }
+};
+
+// Source mesh of the subdivide benchmark: GeoSphere with 3 subdivisions (1280 triangles)
+static const JojRenderer::GeoSphere& subdivide_source()
+{
+    static JojRenderer::GeoSphere source(1.0f, 3);
+    return source;
+}
+
+static void bench_geometry_subdivide(u64 iterations)
+{
+    const JojRenderer::GeoSphere& source = subdivide_source();
+    SubdivideGeometry geo;
+
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        geo.vertices = source.vertices;
+        geo.indices = source.indices;
+        geo.run_subdivide();
+        do_not_optimize(geo.vertices.data());
+    }
+}
+
+static void bench_sphere_ctor(u64 iterations)
+{
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        JojRenderer::Sphere sphere(1.0f, 40, 40);
+        do_not_optimize(sphere.vertices.data());
+    }
+}
+
+static void bench_geosphere_ctor(u64 iterations)
+{
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        JojRenderer::GeoSphere geosphere(1.0f, 4);
+        do_not_optimize(geosphere.vertices.data());
+    }
+}
+
+static void bench_grid_ctor(u64 iterations)
+{
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        JojRenderer::Grid grid(100.0f, 100.0f, 100, 100);
+        do_not_optimize(grid.vertices.data());
+    }
+}
+
+static void bench_mesh_optimize(u64 iterations)
+{
+    static JojRenderer::Sphere source(1.0f, 40, 40);
+    JojRenderer::Geometry geo;
+
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        geo.vertices = source.vertices;
+        geo.indices = source.indices;
+        JojRenderer::MeshOptimizationReport report = JojRenderer::optimize_mesh(geo);
+        do_not_optimize(report);
+    }
+}
+
+static void bench_pack_vertices(u64 iterations)
+{
+    static JojRenderer::Sphere source(1.0f, 40, 40);
+    JojRenderer::VertexFormat format = JojRenderer::VertexFormat::lit();
+
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        JojRenderer::PackedVertices packed = JojRenderer::pack_vertices(source, format);
+        do_not_optimize(packed.data.data());
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Job system
+// ------------------------------------------------------------------------------
+
+// Jobs per run/wait operation
+static const u32 JOB_BATCH = 64;
+
+// Elements of the parallel_for benchmark
+static const u32 PARALLEL_FOR_COUNT = 1 << 20;
+
+static JojEngine::JobSystem& bench_jobs()
+{
+    static JojEngine::JobSystem jobs;
+    if (!jobs.is_running())
+        jobs.init();
+    return jobs;
+}
+
+static void empty_job(void*)
+{
+}
+
+static void bench_job_run_wait(u64 iterations)
+{
+    JojEngine::JobSystem& jobs = bench_jobs();
+    JojEngine::Job batch[JOB_BATCH];
+
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        JojEngine::JobCounter counter;
+        for (u32 j = 0; j < JOB_BATCH; ++j)
+            batch[j] = { empty_job, nullptr, &counter };
+
+        jobs.run(batch, JOB_BATCH);
+        jobs.wait(&counter);
+    }
+}
+
+static void bench_parallel_for(u64 iterations)
+{
+    static std::vector<f32> values(PARALLEL_FOR_COUNT, 1.5f);
+    JojEngine::JobSystem& jobs = bench_jobs();
+
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        jobs.parallel_for(PARALLEL_FOR_COUNT, 16384, [&](u32 begin, u32 end)
+        {
+            for (u32 k = begin; k < end; ++k)
+                values[k] = values[k] * 0.5f + 0.75f;
+        });
+        do_not_optimize(values.data());
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Frame loop
+// ------------------------------------------------------------------------------
+
+// Simulated frame costs: CPU update, CPU draw submission and GPU time waited on at present
+static const f64 FRAME_UPDATE_TIME = 0.0005;
+static const f64 FRAME_DRAW_TIME = 0.0001;
+static const f64 FRAME_GPU_TIME = 0.0005;
+
+// Busy CPU work for seconds
+static void spin_for(f64 seconds)
+{
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() +
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<f64>(seconds));
+    while (std::chrono::steady_clock::now() < end)
+    {
+    }
+}
+
+static void bench_frame_loop_serial(u64 iterations)
+{
+    JojRenderer::NullRenderer renderer;
+    renderer.init();
+    renderer.set_gpu_frametime(FRAME_GPU_TIME);
+
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        spin_for(FRAME_UPDATE_TIME);
+        renderer.clear();
+        spin_for(FRAME_DRAW_TIME);
+        renderer.swap_buffers();
+    }
+}
+
+static void render_frame(JojEngine::FrameSnapshot*, void* user)
+{
+    JojRenderer::NullRenderer* renderer = (JojRenderer::NullRenderer*)user;
+    renderer->clear();
+    spin_for(FRAME_DRAW_TIME);
+    renderer->swap_buffers();
+}
+
+static void run_pipelined_frames(u64 iterations, u32 depth)
+{
+    JojRenderer::NullRenderer renderer;
+    renderer.init();
+    renderer.set_gpu_frametime(FRAME_GPU_TIME);
+
+    JojEngine::FrameSnapshot storage[JojEngine::MAX_PIPELINE_DEPTH + 1];
+    JojEngine::FrameSnapshot* snapshots[JojEngine::MAX_PIPELINE_DEPTH + 1];
+    for (u32 i = 0; i <= JojEngine::MAX_PIPELINE_DEPTH; ++i)
+        snapshots[i] = &storage[i];
+
+    JojEngine::FramePipeline pipeline;
+    pipeline.init(depth, snapshots, render_frame, &renderer);
+
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        JojEngine::FrameSnapshot* snapshot = pipeline.begin_frame();
+        spin_for(FRAME_UPDATE_TIME);
+        snapshot->frametime = f32(FRAME_UPDATE_TIME);
+        pipeline.end_frame();
+    }
+
+    // Measured time includes rendering the last frames
+    pipeline.shutdown();
+}
+
+static void bench_frame_loop_pipelined_1(u64 iterations) { run_pipelined_frames(iterations, 1); }
+static void bench_frame_loop_pipelined_2(u64 iterations) { run_pipelined_frames(iterations, 2); }
+static void bench_frame_loop_pipelined_3(u64 iterations) { run_pipelined_frames(iterations, 3); }
+
+// ------------------------------------------------------------------------------
+// Events
+// ------------------------------------------------------------------------------
+
+// Mouse messages the synthetic OS queue receives per frame
+static const u32 EVENT_FLOOD = 1000;
+
+// What PlatformManager::pump_events does with the OS queue: drain it all into the frame buffer
+static void pump_synthetic(std::deque<JojPlatform::Event>& os_queue, JojPlatform::EventQueue& events)
+{
+    events.clear();
+    while (!os_queue.empty())
+    {
+        events.push(os_queue.front());
+        os_queue.pop_front();
+    }
+}
+
+static void flood_mouse(std::deque<JojPlatform::Event>& os_queue, u32 count)
+{
+    for (u32 i = 0; i < count; ++i)
+        os_queue.push_back({ JojPlatform::EventType::MOUSE_MOVE, 0, i32(i % 1366), i32(i % 768), 0 });
+}
+
+static void bench_event_flood(u64 iterations)
+{
+    std::deque<JojPlatform::Event> os_queue;
+    JojPlatform::EventQueue events;
+
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        flood_mouse(os_queue, EVENT_FLOOD / 2);
+        os_queue.push_back({ JojPlatform::EventType::KEY_DOWN, 'W', 0, 0, 0 });
+        flood_mouse(os_queue, EVENT_FLOOD / 2);
+        pump_synthetic(os_queue, events);
+        do_not_optimize(events.size());
+    }
+}
+
+#if PLATFORM_LINUX
+// ------------------------------------------------------------------------------
+// Headless engine
+// ------------------------------------------------------------------------------
+
+// Runs frame_limit frames of the real Engine loop on the null renderer and headless platform
+class HeadlessGame : public JojEngine::Game
+{
+public:
+    explicit HeadlessGame(u64 frame_limit) : frame_limit(frame_limit) {}
+
+    void init() override {}
+    void shutdown() override {}
+
+    void update() override
+    {
+        if (++frames >= frame_limit)
+            JojEngine::Engine::close_engine();
+    }
+
+    void draw() override
+    {
+        JojEngine::Engine::null_renderer->clear();
+        JojEngine::Engine::null_renderer->render();
+        JojEngine::Engine::null_renderer->swap_buffers();
+    }
+
+    u64 frames = 0;
+    u64 frame_limit;
+};
+
+static void bench_engine_frame(u64 iterations)
+{
+    JojEngine::Engine engine;
+    engine.start(new HeadlessGame(iterations), JojEngine::RendererBackend::NULL_RENDERER);
+}
+#endif // PLATFORM_LINUX
+
+// ------------------------------------------------------------------------------
+// Profiler
+// ------------------------------------------------------------------------------
+
+static void bench_profile_zone(u64 iterations)
+{
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        FPROFILE_ZONE("bench_zone");
+    }
+}
+
+static void bench_profile_zone_disabled(u64 iterations)
+{
+    JojEngine::Profiler::set_enabled(false);
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        FPROFILE_ZONE("bench_zone");
+    }
+    JojEngine::Profiler::set_enabled(true);
+}
+
+// ------------------------------------------------------------------------------
+// Frame arena
+// ------------------------------------------------------------------------------
+
+// Same transient pattern on both: a few small blocks and a vector per "frame" of 64 operations
+static void bench_frame_arena(u64 iterations)
+{
+    static JojEngine::LinearArena arena;
+    if (arena.get_capacity() == 0)
+        arena.init(1 << 20);
+
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        if ((i & 63) == 0)
+            arena.reset();
+        void* p = arena.allocate(16 + (i & 127), 16);
+        do_not_optimize(p);
+    }
+}
+
+static void bench_heap_alloc(u64 iterations)
+{
+    void* live[64] = {};
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        if ((i & 63) == 0)
+            for (void*& p : live)
+            {
+                free(p);
+                p = nullptr;
+            }
+        live[i & 63] = malloc(16 + (i & 127));
+        do_not_optimize(live[i & 63]);
+    }
+    for (void* p : live)
+        free(p);
+}
+
+static void bench_frame_vector(u64 iterations)
+{
+    static JojEngine::LinearArena arena;
+    if (arena.get_capacity() == 0)
+        arena.init(1 << 20);
+
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        arena.reset();
+        JojEngine::FrameVector<u32> values{ JojEngine::ArenaAllocator<u32>(&arena) };
+        for (u32 j = 0; j < 64; ++j)
+            values.push_back(j);
+        do_not_optimize(values.data());
+    }
+}
+
+static void bench_heap_vector(u64 iterations)
+{
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        std::vector<u32> values;
+        for (u32 j = 0; j < 64; ++j)
+            values.push_back(j);
+        do_not_optimize(values.data());
+    }
+}
+
+// Same as heap_vector_push64 with allocations counted under a tag
+static void bench_tracked_vector(u64 iterations)
+{
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        JojEngine::TrackedVector<u32, JojEngine::MemoryTag::GAME> values;
+        for (u32 j = 0; j < 64; ++j)
+            values.push_back(j);
+        do_not_optimize(values.data());
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Entity-component system
+// ------------------------------------------------------------------------------
+
+// Entities of the scene update benchmarks
+static const u32 SCENE_ENTITIES = 100000;
+
+struct BenchPosition { f32 x, y, z; };
+struct BenchVelocity { f32 x, y, z; };
+struct BenchSpin { f32 angle, speed; };
+
+// A quarter of the entities also spin, so queries cross two archetypes
+static JojEngine::World& bench_world()
+{
+    static JojEngine::World world;
+    static b8 ready = false;
+    if (!ready)
+    {
+        world.init(SCENE_ENTITIES);
+        for (u32 i = 0; i < SCENE_ENTITIES; ++i)
+        {
+            BenchPosition position = { f32(i), 0.0f, 0.0f };
+            BenchVelocity velocity = { 1.0f, 0.5f, 0.25f };
+            if (i % 4 == 0)
+                world.create(position, velocity, BenchSpin{ 0.0f, 1.0f });
+            else
+                world.create(position, velocity);
+        }
+        ready = true;
+    }
+    return world;
+}
+
+// The same scene as one heap object per entity updated through a virtual call
+class BenchSceneObject
+{
+public:
+    virtual ~BenchSceneObject() {}
+    virtual void update(f32 dt) = 0;
+};
+
+class BenchMovingObject : public BenchSceneObject
+{
+public:
+    BenchPosition position = {};
+    BenchVelocity velocity = { 1.0f, 0.5f, 0.25f };
+    Mat4 world = mat4_identity();
+    char name[32] = {};
+
+    void update(f32 dt) override
+    {
+        position.x += velocity.x * dt;
+        position.y += velocity.y * dt;
+        position.z += velocity.z * dt;
+    }
+};
+
+static void bench_ecs_update(u64 iterations)
+{
+    JojEngine::World& world = bench_world();
+    const f32 dt = 1.0f / 60.0f;
+
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        world.each<BenchPosition, const BenchVelocity>([dt](BenchPosition& p, const BenchVelocity& v)
+        {
+            p.x += v.x * dt;
+            p.y += v.y * dt;
+            p.z += v.z * dt;
+        });
+    }
+}
+
+static void bench_ecs_parallel_update(u64 iterations)
+{
+    JojEngine::World& world = bench_world();
+    JojEngine::JobSystem& jobs = bench_jobs();
+    const f32 dt = 1.0f / 60.0f;
+
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        world.parallel_each<BenchPosition, const BenchVelocity>(&jobs, [dt](BenchPosition& p, const BenchVelocity& v)
+        {
+            p.x += v.x * dt;
+            p.y += v.y * dt;
+            p.z += v.z * dt;
+        });
+    }
+}
+
+static void bench_object_update(u64 iterations)
+{
+    static std::vector<std::unique_ptr<BenchSceneObject>> objects;
+    if (objects.empty())
+    {
+        for (u32 i = 0; i < SCENE_ENTITIES; ++i)
+            objects.push_back(std::make_unique<BenchMovingObject>());
+    }
+
+    const f32 dt = 1.0f / 60.0f;
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        for (std::unique_ptr<BenchSceneObject>& object : objects)
+            object->update(dt);
+        do_not_optimize(objects.data());
+    }
+}
+
+// One spawn and one despawn of an entity with two components
+static void bench_ecs_create_destroy(u64 iterations)
+{
+    static JojEngine::World world;
+    if (world.get_archetype_count() == 0)
+        world.init(1024);
+
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        JojEngine::Entity entity = world.create(BenchPosition{ 1.0f, 2.0f, 3.0f }, BenchVelocity{});
+        world.destroy(entity);
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Transform hierarchy
+// ------------------------------------------------------------------------------
+
+// Roots of the hierarchy benchmarks, each with 10 children of 10 children (111 nodes)
+static const u32 SCENE_ROOTS = 1000;
+static const u32 SCENE_NODES = SCENE_ROOTS * 111;
+
+static Transform bench_node_transform(u32 i)
+{
+    return transform_create(vec3_create(f32(i % 17), 1.0f, -f32(i % 5)),
+        quat_from_axis_angle(vec3_up(), 0.01f * f32(i % 31)), vec3_create(1.0f, 1.0f, 1.0f));
+}
+
+// Build the benchmark scene into hierarchy, return its roots
+static std::vector<JojEngine::TransformNode> bench_build_scene(JojEngine::TransformHierarchy& hierarchy)
+{
+    std::vector<JojEngine::TransformNode> roots;
+    hierarchy.init(SCENE_NODES);
+
+    u32 n = 0;
+    for (u32 r = 0; r < SCENE_ROOTS; ++r)
+    {
+        JojEngine::TransformNode root = hierarchy.create(bench_node_transform(n++));
+        roots.push_back(root);
+        for (u32 c = 0; c < 10; ++c)
+        {
+            JojEngine::TransformNode child = hierarchy.create(bench_node_transform(n++), root);
+            for (u32 g = 0; g < 10; ++g)
+                hierarchy.create(bench_node_transform(n++), child);
+        }
+    }
+
+    hierarchy.update();
+    return roots;
+}
+
+struct BenchScene
+{
+    JojEngine::TransformHierarchy hierarchy;
+    std::vector<JojEngine::TransformNode> roots;
+};
+
+static BenchScene& bench_scene()
+{
+    static BenchScene scene;
+    if (scene.roots.empty())
+        scene.roots = bench_build_scene(scene.hierarchy);
+    return scene;
+}
+
+// Nothing moved
+static void bench_transform_static(u64 iterations)
+{
+    BenchScene& scene = bench_scene();
+    for (u64 i = 0; i < iterations; ++i)
+        do_not_optimize(scene.hierarchy.update());
+}
+
+// Every root moved, every world matrix is recomputed
+static void bench_transform_all(u64 iterations)
+{
+    BenchScene& scene = bench_scene();
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        for (u32 r = 0; r < SCENE_ROOTS; ++r)
+            scene.hierarchy.set_local(scene.roots[r], bench_node_transform(u32(i) + r));
+        do_not_optimize(scene.hierarchy.update());
+    }
+}
+
+static void bench_transform_all_parallel(u64 iterations)
+{
+    BenchScene& scene = bench_scene();
+    JojEngine::JobSystem& jobs = bench_jobs();
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        for (u32 r = 0; r < SCENE_ROOTS; ++r)
+            scene.hierarchy.set_local(scene.roots[r], bench_node_transform(u32(i) + r));
+        do_not_optimize(scene.hierarchy.update(&jobs));
+    }
+}
+
+// One root moved, its 111 nodes are recomputed
+static void bench_transform_one_subtree(u64 iterations)
+{
+    BenchScene& scene = bench_scene();
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        scene.hierarchy.set_local(scene.roots[i % SCENE_ROOTS], bench_node_transform(u32(i)));
+        do_not_optimize(scene.hierarchy.update());
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Handle pools
+// ------------------------------------------------------------------------------
+
+struct PoolItem
+{
+    Vec3 position;
+    f32 radius;
+};
+
+// Destroy one object and create one per iteration, pool kept half full
+static void bench_pool_create_destroy(u64 iterations)
+{
+    static JojEngine::Pool<PoolItem> pool;
+    static std::vector<JojEngine::Handle<PoolItem>> handles;
+    const u32 count = 1024;
+
+    pool.init(count * 2);
+    handles.clear();
+    for (u32 i = 0; i < count; ++i)
+        handles.push_back(pool.create(PoolItem{ { f32(i), 0.0f, 0.0f }, 1.0f }));
+
+    u32 seed = 99;
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        u32 victim = (seed >> 8) % count;
+        pool.destroy(handles[victim]);
+        handles[victim] = pool.create(PoolItem{ { f32(i), 0.0f, 0.0f }, 1.0f });
+    }
+    do_not_optimize(handles.data());
+}
+
+// Random handle lookups with the generation check
+static void bench_pool_get(u64 iterations)
+{
+    static JojEngine::Pool<PoolItem> pool;
+    static std::vector<JojEngine::Handle<PoolItem>> handles;
+    const u32 count = 4096;
+
+    if (pool.get_count() == 0)
+    {
+        pool.init(count);
+        for (u32 i = 0; i < count; ++i)
+            handles.push_back(pool.create(PoolItem{ { f32(i), 0.0f, 0.0f }, 1.0f }));
+    }
+
+    f32 sum = 0.0f;
+    u32 seed = 7;
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        sum += pool.get(handles[(seed >> 8) % count])->radius;
+    }
+    do_not_optimize(sum);
+}
+
+// ------------------------------------------------------------------------------
+// Logger and timer
+// ------------------------------------------------------------------------------
+
+static void bench_logger_info(u64 iterations)
+{
+    // Formatting and the write syscall are measured, the terminal is not
+    StdoutSilencer silencer;
+    for (u64 i = 0; i < iterations; ++i)
+        FINFO("JojBench message %llu value %f", i, 1.5);
+}
+
+// Cost on the logging thread: format into the ring, the writer thread does the rest
+static void run_logger_async(u64 iterations, LogOverflow overflow)
+{
+    StdoutSilencer silencer;
+    log_start_async(1024, overflow);
+    for (u64 i = 0; i < iterations; ++i)
+        FINFO("JojBench message %llu value %f", i, 1.5);
+    log_stop_async();
+}
+
+static void bench_logger_info_async(u64 iterations) { run_logger_async(iterations, LOG_OVERFLOW_DROP); }
+static void bench_logger_info_async_block(u64 iterations) { run_logger_async(iterations, LOG_OVERFLOW_BLOCK); }
+
+// Same call with a binary log open: the arguments are copied, formatting happens in the decoder
+static void bench_logger_info_binary(u64 iterations)
+{
+    const char* path = "joj_bench_binary.log";
+    log_open_binary(path, 256ull << 20);
+    for (u64 i = 0; i < iterations; ++i)
+        FINFO("JojBench message %llu value %f", i, 1.5);
+    log_close_binary();
+    remove(path);
+}
+
+// Message of a channel set below its level: one relaxed load, nothing formatted
+static void bench_logger_info_filtered(u64 iterations)
+{
+    log_set_level(LOG_CHANNEL_GAME, LOG_LEVEL_WARN);
+    for (u64 i = 0; i < iterations; ++i)
+        FINFO("JojBench message %llu value %f", i, 1.5);
+    log_set_level(LOG_CHANNEL_GAME, LOG_LEVEL_INFO);
+}
+
+static void bench_steady_clock(u64 iterations)
+{
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        std::chrono::steady_clock::time_point t = std::chrono::steady_clock::now();
+        do_not_optimize(t);
+    }
+}
+
+#if PLATFORM_WINDOWS || PLATFORM_LINUX
+static void bench_platform_timer(u64 iterations)
+{
+    static JojPlatform::Timer timer;
+    timer.start();
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        f32 t = timer.elapsed();
+        do_not_optimize(t);
+    }
+}
+#endif // PLATFORM_WINDOWS || PLATFORM_LINUX
+
+static void bench_clock_now(u64 iterations)
+{
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        i64 t = JojPlatform::Clock::now();
+        do_not_optimize(t);
+    }
+}
+
+static void bench_clock_ticks(u64 iterations)
+{
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        i64 t = JojPlatform::Clock::ticks();
+        do_not_optimize(t);
+    }
+}
+
+// One timer scheduled 1 to 1024 ms ahead and one 1 ms tick per iteration, about 512 pending
+static void bench_timer_wheel(u64 iterations)
+{
+    static JojEngine::TimerWheel wheel;
+    static u64 fired = 0;
+    const i64 ms = 1000000;
+
+    wheel.init(0, ms);
+    u32 seed = 12345;
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        wheel.schedule(i64((seed >> 22) + 1) * ms, [](void*) { fired++; }, nullptr);
+        wheel.advance(i64(i + 1) * ms);
+    }
+    do_not_optimize(fired);
+}
+
+// ------------------------------------------------------------------------------
+// Reports
+// ------------------------------------------------------------------------------
+
+// Print post-transform cache statistics of the generated meshes before and after optimize_mesh
+static void print_mesh_report()
+{
+    struct Entry { const char* name; JojRenderer::Geometry geo; };
+    Entry entries[] =
+    {
+        { "Sphere(1, 40, 40)",          JojRenderer::Sphere(1.0f, 40, 40) },
+        { "GeoSphere(1, 4)",            JojRenderer::GeoSphere(1.0f, 4) },
+        { "Grid(100, 100, 100, 100)",   JojRenderer::Grid(100.0f, 100.0f, 100, 100) },
+        { "Cylinder(1, 0.5, 3, 40, 10)", JojRenderer::Cylinder(1.0f, 0.5f, 3.0f, 40, 10) },
+    };
+
+    fprintf(stderr, "%-28s %10s %10s %10s %10s\n", "mesh", "acmr", "acmr opt", "atvr", "atvr opt");
+    for (Entry& e : entries)
+    {
+        JojRenderer::MeshOptimizationReport r = JojRenderer::optimize_mesh(e.geo);
+        fprintf(stderr, "%-28s %10.3f %10.3f %10.3f %10.3f\n", e.name,
+            r.before.acmr, r.after.acmr, r.before.atvr, r.after.atvr);
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Registry
+// ------------------------------------------------------------------------------
+
+// Items per operation of the geometry benchmarks, taken from the meshes themselves
+static f64 subdivide_items() { return f64(subdivide_source().get_index_count() / 3 * 4); }
+static f64 sphere_items() { return f64(JojRenderer::Sphere(1.0f, 40, 40).get_vertex_count()); }
+static f64 geosphere_items() { return f64(JojRenderer::GeoSphere(1.0f, 4).get_vertex_count()); }
+static f64 grid_items() { return 100.0 * 100.0; }
+static f64 pack_vertices_items() { return f64(JojRenderer::Sphere(1.0f, 40, 40).get_vertex_count()); }
+static f64 mesh_optimize_items() { return f64(JojRenderer::Sphere(1.0f, 40, 40).get_index_count() / 3); }
+
+static void print_usage(const char* exe)
+{
+    fprintf(stderr,
+        "Usage: %s [--filter <substring>] [--min-time <seconds>] [--json <path>] [--list] [--mesh-report]\n", exe);
+}
+
+int main(int argc, char** argv)
+{
+    const char* filter = nullptr;
+    const char* json_path = nullptr;
+    f64 min_time = 0.25;
+    b8 list_only = false;
+    b8 mesh_report = false;
+
+    for (i32 i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+            filter = argv[++i];
+        else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            json_path = argv[++i];
+        else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc)
+            min_time = atof(argv[++i]);
+        else if (strcmp(argv[i], "--list") == 0)
+            list_only = true;
+        else if (strcmp(argv[i], "--mesh-report") == 0)
+            mesh_report = true;
+        else
+        {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    const Benchmark benchmarks[] =
+    {
+        { "mat4_mul",               bench_mat4_mul,             1.0,                "matrices" },
+        { "mat4_mul_scalar",        bench_mat4_mul_scalar,      1.0,                "matrices" },
+        { "vec3_normalize",         bench_vec3_normalize,       1.0,                "vectors" },
+        { "geometry_subdivide",     bench_geometry_subdivide,   subdivide_items(),  "triangles" },
+        { "sphere_ctor",            bench_sphere_ctor,          sphere_items(),     "vertices" },
+        { "geosphere_ctor",         bench_geosphere_ctor,       geosphere_items(),  "vertices" },
+        { "grid_ctor",              bench_grid_ctor,            grid_items(),       "vertices" },
+        { "mesh_optimize",          bench_mesh_optimize,        mesh_optimize_items(), "triangles" },
+        { "pack_vertices",          bench_pack_vertices,        pack_vertices_items(), "vertices" },
+        { "frame_arena_alloc",      bench_frame_arena,          1.0,                "allocations" },
+        { "heap_alloc",             bench_heap_alloc,           1.0,                "allocations" },
+        { "frame_vector_push64",    bench_frame_vector,         64.0,               "elements" },
+        { "heap_vector_push64",     bench_heap_vector,          64.0,               "elements" },
+        { "tracked_vector_push64",  bench_tracked_vector,       64.0,               "elements" },
+        { "ecs_update_100k",        bench_ecs_update,           f64(SCENE_ENTITIES), "entities" },
+        { "ecs_parallel_update_100k", bench_ecs_parallel_update, f64(SCENE_ENTITIES), "entities" },
+        { "object_update_100k",     bench_object_update,        f64(SCENE_ENTITIES), "entities" },
+        { "ecs_create_destroy",     bench_ecs_create_destroy,   1.0,                "entities" },
+        { "transform_update_static", bench_transform_static,    f64(SCENE_NODES),   "nodes" },
+        { "transform_update_all",   bench_transform_all,        f64(SCENE_NODES),   "nodes" },
+        { "transform_update_all_parallel", bench_transform_all_parallel, f64(SCENE_NODES), "nodes" },
+        { "transform_update_subtree", bench_transform_one_subtree, 111.0,           "nodes" },
+        { "pool_create_destroy",    bench_pool_create_destroy,  1.0,                "objects" },
+        { "pool_get",               bench_pool_get,             1.0,                "lookups" },
+        { "job_run_wait",           bench_job_run_wait,         f64(JOB_BATCH),     "jobs" },
+        { "parallel_for",           bench_parallel_for,         f64(PARALLEL_FOR_COUNT), "elements" },
+        { "frame_loop_serial",      bench_frame_loop_serial,    1.0,                "frames" },
+        { "frame_loop_pipelined_1", bench_frame_loop_pipelined_1, 1.0,              "frames" },
+        { "frame_loop_pipelined_2", bench_frame_loop_pipelined_2, 1.0,              "frames" },
+        { "frame_loop_pipelined_3", bench_frame_loop_pipelined_3, 1.0,              "frames" },
+        { "event_flood",            bench_event_flood,          f64(EVENT_FLOOD + 1), "events" },
+        { "profile_zone",           bench_profile_zone,         1.0,                "zones" },
+        { "profile_zone_disabled",  bench_profile_zone_disabled, 1.0,               "zones" },
+        { "logger_info",            bench_logger_info,          1.0,                "messages" },
+        { "logger_info_async",      bench_logger_info_async,    1.0,                "messages" },
+        { "logger_info_async_block", bench_logger_info_async_block, 1.0,            "messages" },
+        { "logger_info_binary",     bench_logger_info_binary,   1.0,                "messages" },
+        { "logger_info_filtered",   bench_logger_info_filtered, 1.0,                "messages" },
+        { "steady_clock_now",       bench_steady_clock,         1.0,                "reads" },
+#if PLATFORM_WINDOWS || PLATFORM_LINUX
+        { "platform_timer_elapsed", bench_platform_timer,       1.0,                "reads" },
+#endif // PLATFORM_WINDOWS || PLATFORM_LINUX
+        { "clock_now",              bench_clock_now,            1.0,                "reads" },
+        { "clock_ticks",            bench_clock_ticks,          1.0,                "reads" },
+        { "timer_wheel",            bench_timer_wheel,          1.0,                "timers" },
+#if PLATFORM_LINUX
+        { "engine_frame_headless",  bench_engine_frame,         1.0,                "frames" },
+#endif // PLATFORM_LINUX
+    };
+
+    if (mesh_report)
+    {
+        print_mesh_report();
+        return 0;
+    }
+
+    std::vector<BenchResult> results;
+
+    for (const Benchmark& b : benchmarks)
+    {
+        if (filter && !strstr(b.name, filter))
+            continue;
+
+        if (list_only)
+        {
+            printf("%s\n", b.name);
+            continue;
+        }
+
+        results.push_back(run_benchmark(b, min_time));
+    }
+
+    if (list_only)
+        return 0;
+
+    fprintf(stderr, "JojBench (math backend: %s)\n", math_backend());
+    print_results(results);
+
+    if (json_path && !write_json(results, json_path))
+    {
+        fprintf(stderr, "Failed to write %s\n", json_path);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,501 @@
+#include "binary_log.h"
+
+#include "profiler.h"
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if PLATFORM_WINDOWS
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif // PLATFORM_WINDOWS
+
+std::atomic<b8> binary_log_active{ false };
+
+namespace
+{
+    struct FormatSite
+    {
+        LogChannel channel;
+        LogLevel level;
+        const char* format;
+        const char* file;
+        u32 line;
+    };
+}
+
+// Call sites registered so far, rewritten at the start of every new log file
+static std::mutex format_lock;
+static std::vector<FormatSite> formats;
+
+// Mapped file
+static u8* mapping = nullptr;
+static u64 mapping_size = 0;
+static std::atomic<u64> write_offset{ 0 };     // Next free byte after the header
+static std::atomic<u64> dropped{ 0 };
+static std::atomic<u32> writers{ 0 };          // Threads between reserve and commit
+
+#if PLATFORM_WINDOWS
+static HANDLE file_handle = INVALID_HANDLE_VALUE;
+static HANDLE map_handle = nullptr;
+#else
+static i32 file_fd = -1;
+#endif // PLATFORM_WINDOWS
+
+// ------------------------------------------------------------------------------
+
+u8* binary_log_reserve(u32 size)
+{
+    writers.fetch_add(1, std::memory_order_seq_cst);
+    if (!binary_log_active.load(std::memory_order_seq_cst))
+    {
+        writers.fetch_sub(1, std::memory_order_release);
+        return nullptr;
+    }
+
+    u64 offset = write_offset.fetch_add(size, std::memory_order_relaxed);
+    if (offset + size > mapping_size - sizeof(BinaryLogHeader))
+    {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        writers.fetch_sub(1, std::memory_order_release);
+        return nullptr;
+    }
+
+    return mapping + sizeof(BinaryLogHeader) + offset;
+}
+
+// Fill the header of a reserved record and publish it
+static void publish(u8* record, u32 size, u32 id, BinaryLogKind kind, LogChannel channel, LogLevel level)
+{
+    BinaryLogRecord* header = (BinaryLogRecord*)record;
+    header->id = id;
+    header->kind = kind;
+    header->level = u16(level);
+    header->channel = u32(channel);
+    header->ticks = JojEngine::Profiler::get_ticks();
+
+    // Size last: the decoder stops at a record whose size is still zero
+    std::atomic_thread_fence(std::memory_order_release);
+    header->size = size;
+
+    writers.fetch_sub(1, std::memory_order_release);
+}
+
+void binary_log_commit(u8* record, u32 size, u32 id, LogChannel channel, LogLevel level)
+{
+    publish(record, size, id, BINARY_LOG_MESSAGE, channel, level);
+}
+
+// Write the dictionary entry of a call site, format_lock held
+static void write_format(u32 id, const FormatSite& site)
+{
+    u32 file_length = u32(strlen(site.file)) + 1;
+    u32 format_length = u32(strlen(site.format)) + 1;
+    u32 size = u32(sizeof(BinaryLogRecord)) + 4 + file_length + format_length;
+    size = (size + 7) & ~7u;
+
+    u8* record = binary_log_reserve(size);
+    if (!record)
+        return;
+
+    u8* out = record + sizeof(BinaryLogRecord);
+    memcpy(out, &site.line, 4);
+    memcpy(out + 4, site.file, file_length);
+    memcpy(out + 4 + file_length, site.format, format_length);
+
+    publish(record, size, id, BINARY_LOG_FORMAT, site.channel, site.level);
+}
+
+u32 log_register_format(LogChannel channel, LogLevel level, const char* format, const char* file, u32 line)
+{
+    std::lock_guard<std::mutex> lock(format_lock);
+
+    u32 id = u32(formats.size());
+    formats.push_back({ channel, level, format, file, line });
+
+    if (binary_log_active.load(std::memory_order_relaxed))
+        write_format(id, formats.back());
+
+    return id;
+}
+
+// ------------------------------------------------------------------------------
+
+b8 log_open_binary(const char* path, u64 capacity)
+{
+    std::lock_guard<std::mutex> lock(format_lock);
+    if (binary_log_active.load())
+        return false;
+
+    u64 size = sizeof(BinaryLogHeader) + ((capacity + 7) & ~7ull);
+
+#if PLATFORM_WINDOWS
+    file_handle = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_handle == INVALID_HANDLE_VALUE)
+        return false;
+
+    map_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READWRITE, DWORD(size >> 32), DWORD(size & 0xFFFFFFFF), nullptr);
+    mapping = map_handle ? (u8*)MapViewOfFile(map_handle, FILE_MAP_WRITE, 0, 0, size) : nullptr;
+    if (!mapping)
+    {
+        if (map_handle)
+            CloseHandle(map_handle);
+        CloseHandle(file_handle);
+        map_handle = nullptr;
+        file_handle = INVALID_HANDLE_VALUE;
+        return false;
+    }
+#else
+    file_fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (file_fd < 0)
+        return false;
+
+    // The new file reads as zeros, so unwritten records have size 0. Pages are
+    // mapped up front so logging calls never take a page fault
+    void* view = ftruncate(file_fd, off_t(size)) == 0 ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, file_fd, 0) : MAP_FAILED;
+    if (view == MAP_FAILED)
+    {
+        close(file_fd);
+        file_fd = -1;
+        return false;
+    }
+    mapping = (u8*)view;
+#endif // PLATFORM_WINDOWS
+
+    mapping_size = size;
+    write_offset.store(0, std::memory_order_relaxed);
+    dropped.store(0, std::memory_order_relaxed);
+
+    BinaryLogHeader* header = (BinaryLogHeader*)mapping;
+    memcpy(header->magic, "JOJBLOG1", 8);
+    header->start_ticks = JojEngine::Profiler::get_ticks();
+
+    binary_log_active.store(true, std::memory_order_seq_cst);
+
+    // Call sites registered by an earlier log keep their IDs
+    for (u32 id = 0; id < u32(formats.size()); ++id)
+        write_format(id, formats[id]);
+
+    return true;
+}
+
+void log_close_binary()
+{
+    std::lock_guard<std::mutex> lock(format_lock);
+    if (!binary_log_active.load())
+        return;
+
+    // New calls fall back to text, wait for the ones copying their records
+    binary_log_active.store(false, std::memory_order_seq_cst);
+    while (writers.load(std::memory_order_acquire) != 0)
+        std::this_thread::yield();
+
+    u64 used = write_offset.load(std::memory_order_relaxed);
+    used = used < mapping_size - sizeof(BinaryLogHeader) ? used : mapping_size - sizeof(BinaryLogHeader);
+
+    BinaryLogHeader* header = (BinaryLogHeader*)mapping;
+    header->ticks_per_second = JojEngine::Profiler::get_ticks_per_second();
+    header->used = used;
+
+    u64 file_size = sizeof(BinaryLogHeader) + used;
+
+#if PLATFORM_WINDOWS
+    FlushViewOfFile(mapping, 0);
+    UnmapViewOfFile(mapping);
+    CloseHandle(map_handle);
+
+    LARGE_INTEGER end;
+    end.QuadPart = LONGLONG(file_size);
+    SetFilePointerEx(file_handle, end, nullptr, FILE_BEGIN);
+    SetEndOfFile(file_handle);
+    CloseHandle(file_handle);
+
+    map_handle = nullptr;
+    file_handle = INVALID_HANDLE_VALUE;
+#else
+    munmap(mapping, mapping_size);
+    if (ftruncate(file_fd, off_t(file_size)) != 0)
+        fprintf(stderr, "Failed to trim binary log\n");
+    close(file_fd);
+    file_fd = -1;
+#endif // PLATFORM_WINDOWS
+
+    mapping = nullptr;
+    mapping_size = 0;
+}
+
+u64 log_binary_dropped()
+{
+    return dropped.load(std::memory_order_relaxed);
+}
+
+// ------------------------------------------------------------------------------
+// Decoder
+// ------------------------------------------------------------------------------
+
+namespace
+{
+    struct DecodedFormat
+    {
+        u16 level = 0;
+        std::string format;
+        std::string file;
+        u32 line = 0;
+    };
+}
+
+/* Fill dictionary from the format records at offsets. The file is not
+ * trusted: IDs must be below the number of records (every site has one
+ * format record), line, file and format must lie inside the payload.
+ */
+static void read_dictionary(const u8* data, const std::vector<u64>& offsets, u32 records, std::vector<DecodedFormat>& dictionary)
+{
+    for (u64 offset : offsets)
+    {
+        BinaryLogRecord record;
+        memcpy(&record, data + offset, sizeof(record));
+
+        const char* payload = (const char*)data + offset + sizeof(BinaryLogRecord);
+        const char* payload_end = (const char*)data + offset + record.size;
+        if (record.id >= records || payload_end - payload < 4)
+            continue;
+
+        const char* file = payload + 4;
+        const char* file_end = (const char*)memchr(file, 0, payload_end - file);
+        if (!file_end)
+            continue;
+
+        const char* format = file_end + 1;
+        const char* format_end = (const char*)memchr(format, 0, payload_end - format);
+        if (!format_end)
+            continue;
+
+        if (dictionary.size() <= record.id)
+            dictionary.resize(record.id + 1);
+
+        DecodedFormat& entry = dictionary[record.id];
+        entry.level = record.level;
+        memcpy(&entry.line, payload, 4);
+        entry.file.assign(file, file_end);
+        entry.format.assign(format, format_end);
+    }
+}
+
+// Return true if an argument stored with tag can be printed with conversion
+static b8 conversion_matches(u8 tag, char conversion)
+{
+    switch (conversion)
+    {
+    case 's':
+        return tag == BINARY_ARG_STR;
+    case 'p':
+        return tag == BINARY_ARG_PTR;
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+        return tag == BINARY_ARG_F64 || tag == BINARY_ARG_I64 || tag == BINARY_ARG_U64;
+    case 'c': case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+        return tag == BINARY_ARG_I64 || tag == BINARY_ARG_U64;
+    default:
+        return false;
+    }
+}
+
+// Append one conversion of spec (without its length modifier) applied to the argument at args
+static const u8* format_argument(std::string& text, std::string spec, char conversion, const u8* args, const u8* end)
+{
+    char buffer[512];
+    if (args >= end)
+    {
+        text += "<missing>";
+        return args;
+    }
+
+    u8 tag = *args++;
+    if (tag != BINARY_ARG_STR && tag != BINARY_ARG_I64 && tag != BINARY_ARG_U64 && tag != BINARY_ARG_F64 && tag != BINARY_ARG_PTR)
+    {
+        // Size of an unknown argument is unknown too, the rest of the record can't be read
+        text += "<corrupt>";
+        return end;
+    }
+
+    u32 length = 0;
+    if (tag == BINARY_ARG_STR && end - args >= 4)
+        memcpy(&length, args, 4);
+    u64 size = tag == BINARY_ARG_STR ? 4ull + length : 8ull;
+    if (u64(end - args) < size)
+    {
+        text += "<corrupt>";
+        return end;
+    }
+    const u8* next = args + size;
+
+    // A format that doesn't match what was logged would hand printf the wrong type
+    if (!conversion_matches(tag, conversion))
+    {
+        text += "<bad %";
+        text += conversion;
+        text += ">";
+        return next;
+    }
+
+    if (tag == BINARY_ARG_STR)
+    {
+        // Only '-' of the flags is defined for strings, width and precision follow the flags
+        std::string string_spec = "%";
+        size_t k = 1;
+        for (; k < spec.size() && strchr("-+ #0", spec[k]); ++k)
+            if (spec[k] == '-')
+                string_spec += '-';
+        string_spec += spec.substr(k);
+
+        std::string value((const char*)args + 4, length);
+        snprintf(buffer, sizeof(buffer), (string_spec + "s").c_str(), value.c_str());
+        text += buffer;
+        return next;
+    }
+
+    u64 bits = 0;
+    memcpy(&bits, args, 8);
+
+    switch (conversion)
+    {
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+    {
+        f64 value = 0.0;
+        if (tag == BINARY_ARG_F64)
+            memcpy(&value, &bits, 8);
+        else
+            value = tag == BINARY_ARG_I64 ? f64(i64(bits)) : f64(bits);
+        snprintf(buffer, sizeof(buffer), (spec + conversion).c_str(), value);
+        break;
+    }
+    case 'p':
+        snprintf(buffer, sizeof(buffer), (spec + 'p').c_str(), (void*)uintptr_t(bits));
+        break;
+    case 'c':
+        snprintf(buffer, sizeof(buffer), (spec + 'c').c_str(), i32(bits));
+        break;
+    case 'd': case 'i':
+        snprintf(buffer, sizeof(buffer), (spec + "lld").c_str(), (long long)i64(bits));
+        break;
+    default:
+        snprintf(buffer, sizeof(buffer), (spec + "ll" + conversion).c_str(), (unsigned long long)bits);
+        break;
+    }
+
+    text += buffer;
+    return next;
+}
+
+// Rebuild the text of one message
+static std::string format_message(const std::string& format, const u8* args, const u8* end)
+{
+    std::string text;
+    for (size_t i = 0; i < format.size(); ++i)
+    {
+        if (format[i] != '%')
+        {
+            text += format[i];
+            continue;
+        }
+
+        if (i + 1 < format.size() && format[i + 1] == '%')
+        {
+            text += '%';
+            ++i;
+            continue;
+        }
+
+        // Flags, width and precision are kept, length modifiers are replaced by the stored type
+        std::string spec = "%";
+        size_t j = i + 1;
+        while (j < format.size() && strchr("-+ #0123456789.", format[j]))
+            spec += format[j++];
+        while (j < format.size() && strchr("hlLqjzt", format[j]))
+            ++j;
+
+        if (j >= format.size())
+            break;
+
+        args = format_argument(text, spec, format[j], args, end);
+        i = j;
+    }
+    return text;
+}
+
+b8 log_decode_binary(const char* path, FILE* out)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return false;
+
+    std::vector<u8> data;
+    u8 buffer[1 << 16];
+    size_t read = 0;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        data.insert(data.end(), buffer, buffer + read);
+    fclose(file);
+
+    if (data.size() < sizeof(BinaryLogHeader) || memcmp(data.data(), "JOJBLOG1", 8) != 0)
+        return false;
+
+    BinaryLogHeader header;
+    memcpy(&header, data.data(), sizeof(header));
+
+    // A log that was never closed has no rate or size, read until the first incomplete record
+    u64 end = header.used ? sizeof(BinaryLogHeader) + header.used : data.size();
+    end = end < data.size() ? end : data.size();
+    f64 rate = header.ticks_per_second > 0.0 ? header.ticks_per_second : JojEngine::Profiler::get_ticks_per_second();
+
+    const char* level_strings[5] = {
+        "[FATAL]", "[ERROR]", "[WARN]", "[DEBUG]", "[INFO]"
+    };
+
+    // Records from different threads interleave, so a message can precede the
+    // format record of its site: read the dictionary first, then the messages
+    std::vector<DecodedFormat> dictionary;
+    std::vector<u64> format_offsets;
+    u32 records = 0;
+    for (u32 pass = 0; pass < 2; ++pass)
+    {
+        u64 offset = sizeof(BinaryLogHeader);
+        while (offset + sizeof(BinaryLogRecord) <= end)
+        {
+            BinaryLogRecord record;
+            memcpy(&record, data.data() + offset, sizeof(record));
+            if (record.size < sizeof(BinaryLogRecord) || offset + record.size > end)
+                break;
+
+            const u8* payload = data.data() + offset + sizeof(BinaryLogRecord);
+            const u8* payload_end = data.data() + offset + record.size;
+            offset += record.size;
+
+            if (pass == 0)
+            {
+                records++;
+                if (record.kind == BINARY_LOG_FORMAT)
+                    format_offsets.push_back(offset - record.size);
+            }
+            else if (pass == 1 && record.kind == BINARY_LOG_MESSAGE)
+            {
+                f64 seconds = f64(record.ticks - header.start_ticks) / rate;
+                const char* level = record.level < 5 ? level_strings[record.level] : "";
+                const char* channel = log_channel_name(LogChannel(record.channel));
+
+                if (record.id < dictionary.size() && !dictionary[record.id].format.empty())
+                    fprintf(out, "[%12.6f] %s[%s]: %s\n", seconds, level, channel, format_message(dictionary[record.id].format, payload, payload_end).c_str());
+                else
+                    fprintf(out, "[%12.6f] %s[%s]: <unknown format %u>\n", seconds, level, channel, record.id);
+            }
+        }
+
+        if (pass == 0)
+            read_dictionary(data.data(), format_offsets, records, dictionary);
+    }
+
+    return true;
+}
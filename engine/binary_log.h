@@ -0,0 +1,167 @@
+#pragma once
+
+#include "defines.h"
+#include "logger.h"
+
+#include <atomic>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <type_traits>
+
+/* Binary logging
+ * While a binary log is open, FLOG (FDEBUG, FINFO) skips vsnprintf: every call
+ * site registers its format string once and gets an ID, then each call
+ * copies only the ID, a timestamp and its raw arguments into a record of
+ * a memory-mapped file. Format strings are written to the file the first
+ * time they are used, so the offline decoder (JojLogDecode or
+ * log_decode_binary) needs nothing but the file to rebuild the text.
+ * Supported arguments: integers, enums, floating point, C strings and
+ * pointers. A full file drops records (log_binary_dropped), closing it
+ * trims the unused space.
+ */
+
+// Record kinds in a binary log
+enum BinaryLogKind : u16
+{
+    BINARY_LOG_FORMAT = 1,      // Payload: u32 line, file, format (both null terminated)
+    BINARY_LOG_MESSAGE = 2,     // Payload: tagged arguments
+};
+
+// Argument tags in a message payload
+enum BinaryLogArg : u8
+{
+    BINARY_ARG_I64 = 1,
+    BINARY_ARG_U64 = 2,
+    BINARY_ARG_F64 = 3,
+    BINARY_ARG_STR = 4,         // u32 length, then the characters
+    BINARY_ARG_PTR = 5,
+};
+
+// Start of a binary log file
+struct BinaryLogHeader
+{
+    char magic[8];              // "JOJBLOG1"
+    f64 ticks_per_second;       // Timestamp rate (written on close)
+    i64 start_ticks;            // Timestamp of log_open_binary
+    u64 used;                   // Bytes of records after the header (written on close)
+};
+
+// Every record starts 8-byte aligned with this header
+struct BinaryLogRecord
+{
+    u32 size;                   // Bytes including this header, written last (0 = incomplete)
+    u32 id;                     // Format ID
+    u16 kind;                   // BinaryLogKind
+    u16 level;                  // LogLevel of the format
+    u32 channel;                // LogChannel of the format
+    i64 ticks;                  // Profiler ticks
+};
+
+// Create path with room for capacity bytes of records and route FLOG messages to it
+b8 log_open_binary(const char* path, u64 capacity = 64ull << 20);
+
+// Write the header, unmap the file and trim it to the records written
+void log_close_binary();
+
+// Return number of records dropped because the file was full
+u64 log_binary_dropped();
+
+// Register a call site, return its format ID (called once per site by the macros)
+u32 log_register_format(LogChannel channel, LogLevel level, const char* format, const char* file, u32 line);
+
+// Turn a binary log back into text lines written to out
+b8 log_decode_binary(const char* path, FILE* out);
+
+// ------------------------------------------------------------------------------
+
+// True while a binary log is open
+extern std::atomic<b8> binary_log_active;
+
+// Reserve size bytes for a record, nullptr if the file is full or closed
+u8* binary_log_reserve(u32 size);
+
+// Fill the record header and publish it
+void binary_log_commit(u8* record, u32 size, u32 id, LogChannel channel, LogLevel level);
+
+// String argument as written, null pointers log as empty (arrays decay here, not in a comparison)
+inline const char* binary_arg_text(const char* text)
+{
+    return text ? text : "";
+}
+
+template <typename T>
+inline u32 binary_arg_size(const T& value)
+{
+    typedef std::decay_t<T> Arg;
+    if constexpr (std::is_same_v<Arg, const char*> || std::is_same_v<Arg, char*>)
+        return 1 + 4 + u32(strlen(binary_arg_text(value)));
+    else
+        return 1 + 8;
+}
+
+template <typename T>
+inline u8* binary_arg_write(u8* out, const T& value)
+{
+    typedef std::decay_t<T> Arg;
+    if constexpr (std::is_same_v<Arg, const char*> || std::is_same_v<Arg, char*>)
+    {
+        const char* text = binary_arg_text(value);
+        u32 length = u32(strlen(text));
+        *out++ = BINARY_ARG_STR;
+        memcpy(out, &length, 4);
+        memcpy(out + 4, text, length);
+        return out + 4 + length;
+    }
+    else
+    {
+        u64 bits = 0;
+        if constexpr (std::is_floating_point_v<Arg>)
+        {
+            f64 v = f64(value);
+            *out = BINARY_ARG_F64;
+            memcpy(&bits, &v, 8);
+        }
+        else if constexpr (std::is_pointer_v<Arg>)
+        {
+            *out = BINARY_ARG_PTR;
+            bits = u64(uintptr_t(value));
+        }
+        else if constexpr (std::is_enum_v<Arg> || std::is_signed_v<Arg>)
+        {
+            *out = BINARY_ARG_I64;
+            bits = u64(i64(value));
+        }
+        else
+        {
+            *out = BINARY_ARG_U64;
+            bits = u64(value);
+        }
+        memcpy(out + 1, &bits, 8);
+        return out + 9;
+    }
+}
+
+// Copy a message with its raw arguments into the binary log
+template <typename... Args>
+inline void log_binary(u32 id, LogChannel channel, LogLevel level, const Args&... args)
+{
+    u32 size = u32(sizeof(BinaryLogRecord)) + (0u + ... + binary_arg_size(args));
+    size = (size + 7) & ~7u;
+
+    u8* record = binary_log_reserve(size);
+    if (!record)
+        return;
+
+    u8* out = record + sizeof(BinaryLogRecord);
+    ((out = binary_arg_write(out, args)), ...);
+    (void)out;
+    binary_log_commit(record, size, id, channel, level);
+}
+
+// Register the call site once, then log its arguments
+#define FLOG_BINARY(channel, level, message, ...) \
+    do { \
+        static const u32 binary_log_id = log_register_format(channel, level, message, __FILE__, __LINE__); \
+        log_binary(binary_log_id, channel, level, ##__VA_ARGS__); \
+    } while (0)
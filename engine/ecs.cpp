@@ -0,0 +1,550 @@
+#include "ecs.h"
+
+#include "logger.h"
+#include "memory_tracker.h"
+#include "profiler.h"
+#include <atomic>
+#include <stdlib.h>
+
+namespace
+{
+	struct ComponentType
+	{
+		u32 size;
+		u32 alignment;
+	};
+}
+
+static std::mutex registry_lock;
+static ComponentType component_types[JojEngine::ECS_MAX_COMPONENTS];
+static std::atomic<u32> component_count{ 0 };		// Published after the type is filled in
+
+// Columns start at cache line boundaries at most, chunks are aligned to that
+static const u32 CHUNK_ALIGNMENT = 64;
+
+static u8* allocate_chunk(u32 size)
+{
+	FMEMORY_ALLOC(JojEngine::MemoryTag::ENGINE, size);
+#if defined(_MSC_VER)
+	return (u8*)_aligned_malloc(size_t(size), size_t(CHUNK_ALIGNMENT));
+#else
+	return (u8*)aligned_alloc(size_t(CHUNK_ALIGNMENT), size_t((size + CHUNK_ALIGNMENT - 1) & ~(CHUNK_ALIGNMENT - 1)));
+#endif
+}
+
+static void free_chunk(u8* chunk, u32 size)
+{
+	FMEMORY_FREE(JojEngine::MemoryTag::ENGINE, size);
+#if defined(_MSC_VER)
+	_aligned_free(chunk);
+#else
+	free(chunk);
+#endif
+}
+
+u32 JojEngine::ComponentRegistry::register_type(u32 size, u32 alignment)
+{
+	std::lock_guard<std::mutex> lock(registry_lock);
+	if (component_count.load(std::memory_order_relaxed) == ECS_MAX_COMPONENTS)
+	{
+		FERROR(FAILED, "Too many component types, the new one can't be stored.");
+		return ECS_INVALID_COMPONENT;
+	}
+
+	u32 id = component_count.load(std::memory_order_relaxed);
+	component_types[id] = { size, alignment < CHUNK_ALIGNMENT ? alignment : CHUNK_ALIGNMENT };
+	component_count.store(id + 1, std::memory_order_release);
+	return id;
+}
+
+u32 JojEngine::ComponentRegistry::get_size(u32 id)
+{
+	return id < component_count.load(std::memory_order_acquire) ? component_types[id].size : 0;
+}
+
+u32 JojEngine::ComponentRegistry::get_alignment(u32 id)
+{
+	return id < component_count.load(std::memory_order_acquire) ? component_types[id].alignment : 1;
+}
+
+u32 JojEngine::ComponentRegistry::get_count()
+{
+	return component_count.load(std::memory_order_acquire);
+}
+
+// ------------------------------------------------------------------------------
+
+void JojEngine::CommandBuffer::destroy(Entity entity)
+{
+	std::lock_guard<std::mutex> guard(lock);
+
+	Command command = { Op::DESTROY, 0, entity };
+	write(&command, sizeof(command));
+	count++;
+}
+
+void JojEngine::CommandBuffer::clear()
+{
+	std::lock_guard<std::mutex> guard(lock);
+	data.clear();
+	count = 0;
+}
+
+// ------------------------------------------------------------------------------
+
+JojEngine::World::World()
+{
+}
+
+JojEngine::World::~World()
+{
+	shutdown();
+}
+
+b8 JojEngine::World::init(u32 max_entities)
+{
+	shutdown();
+
+	if (!entities.init(max_entities))
+		return false;
+
+	empty = get_archetype(0);
+	return true;
+}
+
+void JojEngine::World::shutdown()
+{
+	for (std::unique_ptr<Archetype>& archetype : archetypes)
+	{
+		for (Archetype::Chunk& chunk : archetype->chunks)
+			free_chunk(chunk.data, archetype->chunk_bytes);
+	}
+
+	archetypes.clear();
+	lookup.clear();
+	entities.clear();
+	empty = nullptr;
+}
+
+JojEngine::Entity JojEngine::World::create()
+{
+	return create_with(nullptr, nullptr, 0);
+}
+
+b8 JojEngine::World::destroy(Entity entity)
+{
+	const EntityLocation* location = entities.get(entity);
+	if (!location)
+		return false;
+
+	remove_row(*location);
+	return entities.destroy(entity);
+}
+
+b8 JojEngine::World::is_alive(Entity entity) const
+{
+	return entities.is_alive(entity);
+}
+
+void JojEngine::World::flush(CommandBuffer& commands)
+{
+	FPROFILE_ZONE("ecs_flush");
+
+	std::lock_guard<std::mutex> guard(commands.lock);
+
+	const u8* at = commands.data.data();
+	const u8* end = at + commands.data.size();
+	while (at < end)
+	{
+		CommandBuffer::Command command;
+		memcpy(&command, at, sizeof(command));
+		at += sizeof(command);
+
+		switch (command.op)
+		{
+		case CommandBuffer::Op::CREATE:
+		{
+			u32 ids[ECS_MAX_COMPONENTS];
+			const void* values[ECS_MAX_COMPONENTS];
+			u32 count = 0;
+
+			for (u32 i = 0; i < command.component; ++i)
+			{
+				u32 id;
+				memcpy(&id, at, sizeof(id));
+				at += sizeof(id);
+
+				// Recording refused unregistered types, every payload has the size of its type
+				if (count < ECS_MAX_COMPONENTS)
+				{
+					ids[count] = id;
+					values[count] = at;
+					count++;
+				}
+				at += ComponentRegistry::get_size(id);
+			}
+
+			create_with(ids, values, count);
+			break;
+		}
+		case CommandBuffer::Op::DESTROY:
+			destroy(command.entity);
+			break;
+		case CommandBuffer::Op::ADD:
+		{
+			u32 size = ComponentRegistry::get_size(command.component);
+			if (u8* storage = add_component(command.entity, command.component))
+				memcpy(storage, at, size);
+			at += size;
+			break;
+		}
+		case CommandBuffer::Op::REMOVE:
+			remove_component(command.entity, command.component);
+			break;
+		}
+	}
+
+	commands.data.clear();
+	commands.count = 0;
+}
+
+u32 JojEngine::World::get_entity_count() const
+{
+	return entities.get_count();
+}
+
+u32 JojEngine::World::get_archetype_count() const
+{
+	return u32(archetypes.size());
+}
+
+u32 JojEngine::World::get_chunk_count() const
+{
+	u32 count = 0;
+	for (const std::unique_ptr<Archetype>& archetype : archetypes)
+		count += u32(archetype->chunks.size());
+	return count;
+}
+
+JojEngine::Archetype* JojEngine::World::get_archetype(ComponentMask mask)
+{
+	auto found = lookup.find(mask);
+	if (found != lookup.end())
+		return found->second;
+
+	std::unique_ptr<Archetype> archetype = std::make_unique<Archetype>();
+	archetype->mask = mask;
+	memset(archetype->column, Archetype::NONE, sizeof(archetype->column));
+	memset(archetype->add_edge, 0, sizeof(archetype->add_edge));
+	memset(archetype->remove_edge, 0, sizeof(archetype->remove_edge));
+
+	u32 row_size = u32(sizeof(Entity));
+	for (u32 id = 0; id < ECS_MAX_COMPONENTS; ++id)
+	{
+		if (mask & (ComponentMask(1) << id))
+		{
+			archetype->column[id] = u8(archetype->components.size());
+			archetype->components.push_back(id);
+			row_size += ComponentRegistry::get_size(id);
+		}
+	}
+	archetype->offsets.resize(archetype->components.size());
+
+	// Largest capacity whose columns (each aligned) fit in a chunk, at least one entity
+	u32 capacity = ECS_CHUNK_SIZE / row_size;
+	capacity = capacity ? capacity : 1;
+	for (;; --capacity)
+	{
+		u32 offset = capacity * u32(sizeof(Entity));
+		for (u32 i = 0; i < archetype->components.size(); ++i)
+		{
+			u32 alignment = ComponentRegistry::get_alignment(archetype->components[i]);
+			offset = (offset + alignment - 1) & ~(alignment - 1);
+			archetype->offsets[i] = offset;
+			offset += capacity * ComponentRegistry::get_size(archetype->components[i]);
+		}
+
+		if (offset <= ECS_CHUNK_SIZE || capacity == 1)
+		{
+			archetype->chunk_capacity = capacity;
+			archetype->chunk_bytes = offset > ECS_CHUNK_SIZE ? offset : ECS_CHUNK_SIZE;
+			break;
+		}
+	}
+
+	Archetype* result = archetype.get();
+	archetypes.push_back(std::move(archetype));
+	lookup[mask] = result;
+	return result;
+}
+
+void JojEngine::World::push_row(Archetype* archetype, Entity entity, EntityLocation& location)
+{
+	u32 chunk = archetype->count / archetype->chunk_capacity;
+	if (chunk == archetype->chunks.size())
+		archetype->chunks.push_back({ allocate_chunk(archetype->chunk_bytes), 0 });
+
+	Archetype::Chunk& target = archetype->chunks[chunk];
+	location = { archetype, chunk, target.count };
+	archetype->get_entities(target)[target.count] = entity;
+
+	target.count++;
+	archetype->count++;
+}
+
+void JojEngine::World::remove_row(const EntityLocation& location)
+{
+	Archetype* archetype = location.archetype;
+	u32 last = archetype->count - 1;
+	Archetype::Chunk& last_chunk = archetype->chunks[last / archetype->chunk_capacity];
+	u32 last_row = last % archetype->chunk_capacity;
+
+	// Move the last entity into the hole
+	if (location.chunk != last / archetype->chunk_capacity || location.row != last_row)
+	{
+		Archetype::Chunk& chunk = archetype->chunks[location.chunk];
+		for (u32 i = 0; i < archetype->components.size(); ++i)
+		{
+			u32 size = ComponentRegistry::get_size(archetype->components[i]);
+			memcpy(chunk.data + archetype->offsets[i] + location.row * size,
+				last_chunk.data + archetype->offsets[i] + last_row * size, size);
+		}
+
+		Entity moved = archetype->get_entities(last_chunk)[last_row];
+		archetype->get_entities(chunk)[location.row] = moved;
+		EntityLocation* moved_location = entities.get(moved);
+		moved_location->chunk = location.chunk;
+		moved_location->row = location.row;
+	}
+
+	last_chunk.count--;
+	archetype->count--;
+}
+
+u8* JojEngine::World::get_component(const EntityLocation& location, u32 id) const
+{
+	u8 column = location.archetype->column[id];
+	if (column == Archetype::NONE)
+		return nullptr;
+
+	const Archetype::Chunk& chunk = location.archetype->chunks[location.chunk];
+	return chunk.data + location.archetype->offsets[column] + location.row * ComponentRegistry::get_size(id);
+}
+
+JojEngine::Entity JojEngine::World::create_with(const u32* ids, const void* const* values, u32 count)
+{
+	ComponentMask mask = 0;
+	for (u32 i = 0; i < count; ++i)
+		mask |= ComponentMask(1) << ids[i];
+
+	// A query for a type that couldn't be registered must never match
+	if (mask & (ComponentMask(1) << ECS_INVALID_COMPONENT))
+		return Entity();
+
+	Entity entity = entities.create();
+	if (entity.is_null())
+		return entity;
+
+	EntityLocation* location = entities.get(entity);
+	push_row(mask ? get_archetype(mask) : empty, entity, *location);
+
+	for (u32 i = 0; i < count; ++i)
+		memcpy(get_component(*location, ids[i]), values[i], ComponentRegistry::get_size(ids[i]));
+
+	return entity;
+}
+
+u8* JojEngine::World::add_component(Entity entity, u32 id)
+{
+	EntityLocation* location = entities.get(entity);
+	if (!location || id >= ECS_MAX_COMPONENTS)
+		return nullptr;
+
+	Archetype* source = location->archetype;
+	if (source->column[id] != Archetype::NONE)
+		return get_component(*location, id);
+
+	Archetype* target = source->add_edge[id];
+	if (!target)
+	{
+		target = get_archetype(source->mask | (ComponentMask(1) << id));
+		source->add_edge[id] = target;
+		target->remove_edge[id] = source;
+	}
+
+	// Every component of the source is in the target
+	EntityLocation from = *location;
+	push_row(target, entity, *location);
+	for (u32 component : source->components)
+		memcpy(get_component(*location, component), get_component(from, component), ComponentRegistry::get_size(component));
+	remove_row(from);
+
+	return get_component(*location, id);
+}
+
+b8 JojEngine::World::remove_component(Entity entity, u32 id)
+{
+	EntityLocation* location = entities.get(entity);
+	if (!location || id >= ECS_MAX_COMPONENTS || location->archetype->column[id] == Archetype::NONE)
+		return false;
+
+	Archetype* source = location->archetype;
+	Archetype* target = source->remove_edge[id];
+	if (!target)
+	{
+		target = get_archetype(source->mask & ~(ComponentMask(1) << id));
+		source->remove_edge[id] = target;
+		target->add_edge[id] = source;
+	}
+
+	// Every component of the target is in the source
+	EntityLocation from = *location;
+	push_row(target, entity, *location);
+	for (u32 component : target->components)
+		memcpy(get_component(*location, component), get_component(from, component), ComponentRegistry::get_size(component));
+	remove_row(from);
+
+	return true;
+}
+
+void JojEngine::World::collect_chunks(ComponentMask mask, std::vector<std::pair<Archetype*, u32>>& chunks)
+{
+	for (const std::unique_ptr<Archetype>& archetype : archetypes)
+	{
+		if ((archetype->mask & mask) != mask)
+			continue;
+
+		for (u32 i = 0; i < archetype->chunks.size() && archetype->chunks[i].count > 0; ++i)
+			chunks.push_back({ archetype.get(), i });
+	}
+}
+
+// ------------------------------------------------------------------------------
+
+JojEngine::SystemSchedule::SystemSchedule()
+{
+	stage_count = 0;
+	built = false;
+}
+
+JojEngine::SystemSchedule::~SystemSchedule()
+{
+}
+
+void JojEngine::SystemSchedule::add(const char* name, SystemFunc func, void* data, ComponentMask reads, ComponentMask writes)
+{
+	std::unique_ptr<System> system = std::make_unique<System>();
+	system->name = name;
+	system->func = func;
+	system->data = data;
+	system->reads = reads;
+	system->writes = writes;
+	system->stage = 0;
+	system->world = nullptr;
+	systems.push_back(std::move(system));
+	built = false;
+}
+
+void JojEngine::SystemSchedule::build()
+{
+	stage_count = 0;
+	u32 stage_begin = 0;
+
+	for (u32 i = 0; i < systems.size(); ++i)
+	{
+		System* system = systems[i].get();
+
+		b8 conflict = stage_count == 0;
+		for (u32 j = stage_begin; j < i && !conflict; ++j)
+		{
+			const System* other = systems[j].get();
+			conflict = (system->writes & (other->reads | other->writes)) || (other->writes & system->reads);
+		}
+
+		if (conflict)
+		{
+			stage_count++;
+			stage_begin = i;
+		}
+		system->stage = stage_count - 1;
+	}
+
+	built = true;
+}
+
+void JojEngine::SystemSchedule::run(World& world, JobSystem* jobs, LinearArena* arena)
+{
+	if (!built)
+		build();
+
+	// One stage holds at most every system, the arena version is gone after the frame
+	std::vector<Job> heap_jobs;
+	Job* stage_jobs = nullptr;
+	if (arena)
+	{
+		stage_jobs = arena->allocate_array<Job>(systems.size());
+	}
+	else
+	{
+		heap_jobs.resize(systems.size());
+		stage_jobs = heap_jobs.data();
+	}
+
+	u32 begin = 0;
+	while (begin < systems.size())
+	{
+		u32 end = begin;
+		while (end < systems.size() && systems[end]->stage == systems[begin]->stage)
+			end++;
+
+		u32 count = end - begin;
+		for (u32 i = begin; i < end; ++i)
+		{
+			systems[i]->world = &world;
+			stage_jobs[i - begin] = { [](void* data)
+			{
+				System* system = (System*)data;
+				FPROFILE_ZONE(system->name);
+				system->func(*system->world, system->commands, system->data);
+			}, systems[i].get(), nullptr };
+		}
+
+		// Systems of a stage touch disjoint components
+		if (jobs && count > 1)
+		{
+			JobCounter counter;
+			for (u32 i = 0; i < count; ++i)
+				stage_jobs[i].counter = &counter;
+			jobs->run(stage_jobs, count);
+			jobs->wait(&counter);
+		}
+		else
+		{
+			for (u32 i = 0; i < count; ++i)
+				stage_jobs[i].func(stage_jobs[i].data);
+		}
+
+		// Sync point
+		for (u32 i = begin; i < end; ++i)
+			world.flush(systems[i]->commands);
+
+		begin = end;
+	}
+}
+
+void JojEngine::SystemSchedule::clear()
+{
+	systems.clear();
+	stage_count = 0;
+	built = false;
+}
+
+u32 JojEngine::SystemSchedule::get_stage_count() const
+{
+	return stage_count;
+}
+
+u32 JojEngine::SystemSchedule::get_stage(u32 i) const
+{
+	return systems[i]->stage;
+}
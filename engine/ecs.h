@@ -0,0 +1,488 @@
+#pragma once
+
+#include "defines.h"
+
+#include "frame_arena.h"
+#include "handle_pool.h"
+#include "job_system.h"
+#include <memory>
+#include <mutex>
+#include <string.h>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace JojEngine
+{
+	/* Archetype-based entity-component system
+	 * Entities with the same set of components share an archetype, which
+	 * stores them in fixed-size chunks: one array per component (SoA) plus
+	 * the entity handles, so a query walks tightly packed columns of only
+	 * the components it asks for. Adding or removing a component moves the
+	 * entity to another archetype (a structural change), destroying fills
+	 * the hole with the archetype's last entity.
+	 * Components must be trivially copyable and destructible (plain data,
+	 * handles to anything else), they are moved with memcpy.
+	 * Structural changes invalidate component pointers and must not happen
+	 * during a query: systems record them in a CommandBuffer and the World
+	 * applies them at a sync point (flush, or between SystemSchedule stages).
+	 * Queries may run concurrently with each other. Not thread safe otherwise.
+	 */
+
+	struct EntityTag;
+	typedef Handle<EntityTag> Entity;
+
+	// Bit i of a mask is the component with ID i
+	typedef u64 ComponentMask;
+
+	// Most component types, bit 63 marks a type that could not be registered
+	const u32 ECS_MAX_COMPONENTS = 63;
+	const u32 ECS_INVALID_COMPONENT = 63;
+
+	// Bytes of one chunk (bigger if a single entity doesn't fit)
+	const u32 ECS_CHUNK_SIZE = 16 * 1024;
+
+	class ComponentRegistry
+	{
+	public:
+		// Assign the next ID to a component type (ECS_INVALID_COMPONENT when full)
+		static u32 register_type(u32 size, u32 alignment);
+
+		static u32 get_size(u32 id);			// Bytes of one component
+		static u32 get_alignment(u32 id);		// Alignment of one component
+		static u32 get_count();				// Registered types
+	};
+
+	// Return ID of component type T, registered on first use
+	template <typename T>
+	inline u32 component_id()
+	{
+		// const T is T (read-only queries)
+		if constexpr (!std::is_same_v<T, std::remove_cv_t<T>>)
+		{
+			return component_id<std::remove_cv_t<T>>();
+		}
+		else
+		{
+			static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+				"Components are moved with memcpy and never destroyed");
+
+			static const u32 id = ComponentRegistry::register_type(u32(sizeof(T)), u32(alignof(T)));
+			return id;
+		}
+	}
+
+	// Return mask of component types C
+	template <typename... C>
+	inline ComponentMask component_mask()
+	{
+		return (ComponentMask(0) | ... | (ComponentMask(1) << component_id<C>()));
+	}
+
+	// Entities of one component set, stored in chunks
+	struct Archetype
+	{
+		static const u8 NONE = 0xFF;
+
+		struct Chunk
+		{
+			u8* data;				// Entity column, then one column per component
+			u32 count;				// Entities in it
+		};
+
+		ComponentMask mask = 0;
+		std::vector<u32> components;			// Component IDs in ascending order
+		std::vector<u32> offsets;				// Byte offset of each component column in a chunk
+		u8 column[ECS_MAX_COMPONENTS + 1];		// Position in components of each ID (NONE if absent)
+		u32 chunk_capacity = 0;					// Entities per chunk
+		u32 chunk_bytes = 0;					// Bytes per chunk
+		u32 count = 0;							// Entities in every chunk
+		std::vector<Chunk> chunks;				// All full but the last used one, spare ones stay allocated
+
+		Archetype* add_edge[ECS_MAX_COMPONENTS + 1];		// Archetype with one more component (cached)
+		Archetype* remove_edge[ECS_MAX_COMPONENTS + 1];		// Archetype with one less component (cached)
+
+		Entity* get_entities(const Chunk& chunk) const { return (Entity*)chunk.data; }
+
+		// Return column of component T in chunk (the archetype must have it)
+		template <typename T>
+		T* get_column(const Chunk& chunk) const { return (T*)(chunk.data + offsets[column[component_id<T>()]]); }
+	};
+
+	/* Structural changes recorded for later
+	 * Recording is thread safe (one lock per command), World::flush applies
+	 * commands in the order they were recorded and empties the buffer.
+	 * Commands on entities destroyed in the meantime are skipped. A command
+	 * with a component type that could not be registered is refused when
+	 * recorded (returns false), the way World::create and World::add refuse it.
+	 */
+	class CommandBuffer
+	{
+	public:
+		CommandBuffer() {}
+		~CommandBuffer() {}
+
+		// Create an entity with components, return false if a type has no ID
+		template <typename... C>
+		b8 create(const C&... components);
+
+		// Destroy entity
+		void destroy(Entity entity);
+
+		// Add component to entity (or overwrite it), return false if the type has no ID
+		template <typename T>
+		b8 add(Entity entity, const T& value);
+
+		// Remove component from entity, return false if the type has no ID
+		template <typename T>
+		b8 remove(Entity entity);
+
+		// Drop every recorded command
+		void clear();
+
+		// Return number of recorded commands
+		u32 get_count() const { return count; }
+
+	private:
+		friend class World;
+
+		enum class Op : u32 { CREATE, DESTROY, ADD, REMOVE };
+
+		// Followed by the component (ADD) or by count pairs of ID and component (CREATE)
+		struct Command
+		{
+			Op op;
+			u32 component;			// Component ID, component count for CREATE
+			Entity entity;
+		};
+
+		std::mutex lock;
+		std::vector<u8> data;		// Commands, back to back
+		u32 count = 0;
+
+		void write(const void* bytes, u32 size)
+		{ data.insert(data.end(), (const u8*)bytes, (const u8*)bytes + size); }
+	};
+
+	class World
+	{
+	public:
+		World();
+		~World();
+
+		World(const World&) = delete;
+		World& operator=(const World&) = delete;
+
+		// Reserve room for max_entities entities, destroys current ones
+		b8 init(u32 max_entities);
+
+		// Destroy every entity and free the chunks
+		void shutdown();
+
+		// Create an entity without components (null if the world is full)
+		Entity create();
+
+		// Create an entity with components (null if the world is full)
+		template <typename... C>
+		Entity create(const C&... components);
+
+		// Destroy entity, return false if it is stale
+		b8 destroy(Entity entity);
+
+		// Return true if entity refers to a live entity
+		b8 is_alive(Entity entity) const;
+
+		// Add component to entity (or overwrite it), return false if entity is stale
+		template <typename T>
+		b8 add(Entity entity, const T& value);
+
+		// Remove component from entity, return false if it didn't have it
+		template <typename T>
+		b8 remove(Entity entity);
+
+		// Return component of entity, nullptr if it has none or is stale
+		template <typename T>
+		T* get(Entity entity);
+
+		// Return true if entity has component T
+		template <typename T>
+		b8 has(Entity entity) const;
+
+		// Call func(C&...) for every entity with components C
+		template <typename... C, typename Func>
+		void each(const Func& func);
+
+		// Call func(count, entities, C*...) for every chunk with components C
+		template <typename... C, typename Func>
+		void each_chunk(const Func& func);
+
+		/* @brief Same as each_chunk with chunks spread across jobs. The calling
+		 * thread takes part and the call returns when every chunk was visited.
+		 * func runs concurrently and must only touch its own chunk.
+		 */
+		template <typename... C, typename Func>
+		void parallel_each_chunk(JobSystem* jobs, const Func& func);
+
+		// Same as each with chunks spread across jobs
+		template <typename... C, typename Func>
+		void parallel_each(JobSystem* jobs, const Func& func);
+
+		// Apply and clear commands (a sync point, no query may be running)
+		void flush(CommandBuffer& commands);
+
+		u32 get_entity_count() const;			// Live entities
+		u32 get_archetype_count() const;		// Component sets seen so far
+		u32 get_chunk_count() const;			// Allocated chunks
+
+	private:
+		struct EntityLocation
+		{
+			Archetype* archetype;
+			u32 chunk;
+			u32 row;
+		};
+
+		Pool<EntityLocation, EntityTag> entities;			// Where each entity is stored
+		std::vector<std::unique_ptr<Archetype>> archetypes;
+		std::unordered_map<ComponentMask, Archetype*> lookup;	// Archetype of each mask
+		Archetype* empty = nullptr;							// Archetype without components
+
+		Archetype* get_archetype(ComponentMask mask);		// Find or create the archetype of mask
+		void push_row(Archetype* archetype, Entity entity, EntityLocation& location);	// Append entity to archetype
+		void remove_row(const EntityLocation& location);	// Fill the hole with the last entity
+		u8* get_component(const EntityLocation& location, u32 id) const;	// Storage of component id
+
+		// Create an entity and copy count components into it
+		Entity create_with(const u32* ids, const void* const* values, u32 count);
+
+		// Move entity to the archetype with component id, return its storage
+		u8* add_component(Entity entity, u32 id);
+
+		// Move entity to the archetype without component id
+		b8 remove_component(Entity entity, u32 id);
+
+		// Chunks with entities having every component of mask
+		void collect_chunks(ComponentMask mask, std::vector<std::pair<Archetype*, u32>>& chunks);
+	};
+
+	// System body, structural changes go to commands
+	typedef void(*SystemFunc)(World& world, CommandBuffer& commands, void* data);
+
+	/* Systems run in stages
+	 * Every system declares the component types it reads and writes.
+	 * build() walks them in the order they were added and puts each into
+	 * the current stage unless it conflicts with a system already there
+	 * (one writes what the other reads or writes), which starts a new stage.
+	 * run() executes the systems of a stage in parallel on the job system,
+	 * then applies their commands in system order before the next stage.
+	 * Systems that touch something not described by their masks (a shared
+	 * counter, the renderer) must declare it or take care of it themselves.
+	 */
+	class SystemSchedule
+	{
+	public:
+		SystemSchedule();
+		~SystemSchedule();
+
+		// Add system, reads and writes are masks of component types (component_mask<A, B>())
+		void add(const char* name, SystemFunc func, void* data, ComponentMask reads, ComponentMask writes);
+
+		// Group systems into stages (called by run after add)
+		void build();
+
+		/* @brief Run every stage on jobs (serially if nullptr), flushing commands
+		 * into world after each. The job list of a stage comes from arena when
+		 * given (Game::frame_arena->current()), from the heap otherwise.
+		 */
+		void run(World& world, JobSystem* jobs, LinearArena* arena = nullptr);
+
+		// Remove every system
+		void clear();
+
+		// Return number of stages (after build)
+		u32 get_stage_count() const;
+
+		// Return stage of system i (after build)
+		u32 get_stage(u32 i) const;
+
+	private:
+		struct System
+		{
+			const char* name;
+			SystemFunc func;
+			void* data;
+			ComponentMask reads;
+			ComponentMask writes;
+			u32 stage;
+			World* world;				// World of the current run
+			CommandBuffer commands;		// Structural changes of the current stage
+		};
+
+		std::vector<std::unique_ptr<System>> systems;
+		u32 stage_count;
+		b8 built;
+	};
+
+	// ------------------------------------------------------------------------------
+
+	template <typename... C>
+	inline b8 CommandBuffer::create(const C&... components)
+	{
+		if ((false || ... || (component_id<C>() == ECS_INVALID_COMPONENT)))
+			return false;
+
+		std::lock_guard<std::mutex> guard(lock);
+
+		Command command = { Op::CREATE, u32(sizeof...(C)), Entity() };
+		write(&command, sizeof(command));
+		([&](u32 id, const void* value, u32 size) { write(&id, sizeof(id)); write(value, size); }
+			(component_id<C>(), &components, u32(sizeof(C))), ...);
+		count++;
+		return true;
+	}
+
+	template <typename T>
+	inline b8 CommandBuffer::add(Entity entity, const T& value)
+	{
+		u32 id = component_id<T>();
+		if (id == ECS_INVALID_COMPONENT)
+			return false;
+
+		std::lock_guard<std::mutex> guard(lock);
+
+		Command command = { Op::ADD, id, entity };
+		write(&command, sizeof(command));
+		write(&value, u32(sizeof(T)));
+		count++;
+		return true;
+	}
+
+	template <typename T>
+	inline b8 CommandBuffer::remove(Entity entity)
+	{
+		u32 id = component_id<T>();
+		if (id == ECS_INVALID_COMPONENT)
+			return false;
+
+		std::lock_guard<std::mutex> guard(lock);
+
+		Command command = { Op::REMOVE, id, entity };
+		write(&command, sizeof(command));
+		count++;
+		return true;
+	}
+
+	template <typename... C>
+	inline Entity World::create(const C&... components)
+	{
+		if constexpr (sizeof...(C) == 0)
+		{
+			return create();
+		}
+		else
+		{
+			const u32 ids[] = { component_id<C>()... };
+			const void* const values[] = { &components... };
+			return create_with(ids, values, u32(sizeof...(C)));
+		}
+	}
+
+	template <typename T>
+	inline b8 World::add(Entity entity, const T& value)
+	{
+		u8* storage = add_component(entity, component_id<T>());
+		if (!storage)
+			return false;
+
+		memcpy(storage, &value, sizeof(T));
+		return true;
+	}
+
+	template <typename T>
+	inline b8 World::remove(Entity entity)
+	{
+		return remove_component(entity, component_id<T>());
+	}
+
+	template <typename T>
+	inline T* World::get(Entity entity)
+	{
+		const EntityLocation* location = entities.get(entity);
+		return location ? (T*)get_component(*location, component_id<T>()) : nullptr;
+	}
+
+	template <typename T>
+	inline b8 World::has(Entity entity) const
+	{
+		const EntityLocation* location = entities.get(entity);
+		return location && location->archetype->column[component_id<T>()] != Archetype::NONE;
+	}
+
+	template <typename... C, typename Func>
+	inline void World::each_chunk(const Func& func)
+	{
+		ComponentMask mask = component_mask<C...>();
+		for (const std::unique_ptr<Archetype>& archetype : archetypes)
+		{
+			if ((archetype->mask & mask) != mask)
+				continue;
+
+			for (const Archetype::Chunk& chunk : archetype->chunks)
+			{
+				// Used chunks come first
+				if (chunk.count == 0)
+					break;
+				func(chunk.count, (const Entity*)archetype->get_entities(chunk), archetype->template get_column<C>(chunk)...);
+			}
+		}
+	}
+
+	template <typename... C, typename Func>
+	inline void World::each(const Func& func)
+	{
+		each_chunk<C...>([&](u32 count, const Entity*, C*... columns)
+		{
+			for (u32 i = 0; i < count; ++i)
+				func(columns[i]...);
+		});
+	}
+
+	template <typename... C, typename Func>
+	inline void World::parallel_each_chunk(JobSystem* jobs, const Func& func)
+	{
+		std::vector<std::pair<Archetype*, u32>> chunks;
+		collect_chunks(component_mask<C...>(), chunks);
+
+		auto visit = [&](u32 begin, u32 end)
+		{
+			for (u32 i = begin; i < end; ++i)
+			{
+				const Archetype* archetype = chunks[i].first;
+				const Archetype::Chunk& chunk = archetype->chunks[chunks[i].second];
+				func(chunk.count, (const Entity*)archetype->get_entities(chunk), archetype->template get_column<C>(chunk)...);
+			}
+		};
+
+		// No workers before init and after shutdown
+		u32 workers = jobs && jobs->is_running() ? jobs->get_worker_count() : 0;
+		if (workers == 0)
+		{
+			visit(0, u32(chunks.size()));
+			return;
+		}
+
+		// About four batches per worker so uneven chunks still balance
+		u32 batch = u32(chunks.size()) / (workers * 4);
+		jobs->parallel_for(u32(chunks.size()), batch ? batch : 1, visit);
+	}
+
+	template <typename... C, typename Func>
+	inline void World::parallel_each(JobSystem* jobs, const Func& func)
+	{
+		parallel_each_chunk<C...>(jobs, [&](u32 count, const Entity*, C*... columns)
+		{
+			for (u32 i = 0; i < count; ++i)
+				func(columns[i]...);
+		});
+	}
+}
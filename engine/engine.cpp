@@ -1,22 +1,46 @@
 #include "engine.h"
 
-#include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "logger.h"
+#include "clock.h"
+#include "memory_tracker.h"
+#include "geometry.h"
+
+#if PLATFORM_WINDOWS || PLATFORM_LINUX
 
 // Static members
 std::unique_ptr<JojPlatform::PlatformManager> JojEngine::Engine::pm = nullptr;			// Platform Manager
+#if PLATFORM_WINDOWS
 std::unique_ptr<JojRenderer::DX11Renderer> JojEngine::Engine::renderer = nullptr;		// D3D11 Renderer
 std::unique_ptr<JojRenderer::DX12Renderer> JojEngine::Engine::dx12_renderer = nullptr;	// D3D12 Renderer
 
 std::unique_ptr<JojRenderer::GLRenderer> JojEngine::Engine::gl_renderer = nullptr;		// Opengl context
+#endif // PLATFORM_WINDOWS
+std::unique_ptr<JojRenderer::NullRenderer> JojEngine::Engine::null_renderer = nullptr;	// Headless renderer
+
+std::unique_ptr<JojEngine::JobSystem> JojEngine::Engine::jobs = nullptr;		// Job scheduler
 
 JojEngine::Game* JojEngine::Engine::game = nullptr;							// Pointer to game
 f32 JojEngine::Engine::frametime = 0.0f;									// Current frametime
+f32 JojEngine::Engine::alpha = 1.0f;										// Interpolation alpha
+i64 JojEngine::Engine::game_time = 0;										// Game clock
+JojEngine::TimerWheel JojEngine::Engine::timers;							// Gameplay timers
+JojEngine::FrameArena JojEngine::Engine::frame_arena;						// Per-frame memory
+b8 JojEngine::Engine::fixed_step = false;									// Variable timestep
+JojEngine::FixedTimestep JojEngine::Engine::timestep;						// Fixed timestep accumulator
 b8 JojEngine::Engine::paused = false;										// Engine state
 b8 JojEngine::Engine::running = false;										// Engine is not running
 
 std::string JojEngine::Engine::renderer_name = "";
 
+b8 JojEngine::Engine::async_logging = false;												// Synchronous log lines
+
+u32 JojEngine::Engine::pipeline_depth = 0;												// Serial loop
+std::unique_ptr<JojEngine::FramePipeline> JojEngine::Engine::pipeline = nullptr;		// Render thread
+std::vector<std::unique_ptr<JojEngine::FrameSnapshot>> JojEngine::Engine::snapshots;	// Pipeline snapshots
+
 JojEngine::Engine::Engine()
 {
 	pm = std::make_unique<JojPlatform::PlatformManager>();
@@ -31,22 +55,52 @@ i32 JojEngine::Engine::start(JojEngine::Game* game, RendererBackend renderer_bac
 {
 	this->game = game;
 
-	if (!pm->init(800, 600))
+	// Log lines are written by a background thread while the engine runs, if asked for
+	const char* async_env = getenv("JOJ_LOG_ASYNC");
+	b8 async = async_logging || (async_env && strcmp(async_env, "0") != 0);
+	if (async)
+		log_start_async();
+
+	// Early exits stop the writer too, pending lines are written
+	auto fail = [async]()
 	{
-		// TODO: Use own logger
-		OutputDebugString("Failed to initialize platform manager.\n");
+		if (async)
+			log_stop_async();
 		return -1;
+	};
+
+	// Channel levels can be changed without rebuilding, e.g. JOJ_LOG=warn,renderer=debug
+	if (const char* levels = getenv("JOJ_LOG"))
+	{
+		if (!log_parse_levels(levels))
+			FWARN("JOJ_LOG has unknown entries, they were ignored.");
+	}
+
+	if (!pm->init(800, 600))
+	{
+		FFATAL(ERR_PLATFORM, "Failed to initialize platform manager.");
+		return fail();
 	}
 
 	// Initialize graphics device
-	if (renderer_backend == RendererBackend::DX11)
+	if (renderer_backend == RendererBackend::NULL_RENDERER)
+	{
+		null_renderer = std::make_unique<JojRenderer::NullRenderer>();
+		if (!null_renderer->init(pm->get_window()))
+		{
+			FFATAL(ERR_RENDERER, "Failed to initialize null renderer.");
+			return fail();
+		}
+	}
+#if PLATFORM_WINDOWS
+	else if (renderer_backend == RendererBackend::DX11)
 	{
 		renderer = std::make_unique<JojRenderer::DX11Renderer>();
 		if (!renderer->init(pm->get_window()))
 		{
 			FFATAL(ERR_RENDERER, "Failed to initialize D3D11 renderer.");
 			OutputDebugString("-----> Failed to initialize Renderer::DX11.\n");
-			return -1;
+			return fail();
 		}
 	}
 	else if (renderer_backend == RendererBackend::DX12)
@@ -56,7 +110,7 @@ i32 JojEngine::Engine::start(JojEngine::Game* game, RendererBackend renderer_bac
 		{
 			FFATAL(ERR_RENDERER, "Failed to initialize D3D12 renderer.");
 			OutputDebugString("-----> Failed to initialize Renderer::DX12.\n");
-			return -1;
+			return fail();
 		}
 	}
 	else
@@ -66,14 +120,32 @@ i32 JojEngine::Engine::start(JojEngine::Game* game, RendererBackend renderer_bac
 		{
 			FFATAL(ERR_RENDERER, "Failed to initialize OpenGL renderer.");
 			OutputDebugString("-----> Failed to initialize OpenGL\n");
-			return -1;
+			return fail();
 		}
 	}
+#else
+	else
+	{
+		FFATAL(ERR_RENDERER, "Only the null renderer is available on this platform.");
+		return fail();
+	}
+#endif // PLATFORM_WINDOWS
 
 	renderer_name = renderer_to_string(renderer_backend);
 
+	// Start one worker per hardware thread, this thread is worker 0
+	jobs = std::make_unique<JojEngine::JobSystem>();
+	jobs->init();
+	JojEngine::Game::jobs = jobs.get();
+	JojRenderer::Geometry::jobs = jobs.get();
+	JojEngine::Game::timers = &timers;
+	JojEngine::Game::frame_arena = &frame_arena;
+	FINFO("Job system started with %u workers.", jobs->get_worker_count());
+
+#if PLATFORM_WINDOWS
 	// Change window procedure to EngineProc
 	pm->change_window_procedure(pm->get_window()->get_id(), GWLP_WNDPROC, (LONG_PTR)EngineProc);
+#endif // PLATFORM_WINDOWS
 
 	// Adjust sleep resolution to 1 millisecond
 	pm->begin_period();
@@ -88,66 +160,126 @@ i32 JojEngine::Engine::start(JojEngine::Game* game, RendererBackend renderer_bac
 	// Return sleep resolution to original value
 	pm->end_period();
 
+	// Write pending log lines
+	if (async)
+		log_stop_async();
+
 	// Close engine
 	return exit_code;
 }
 
 i32 JojEngine::Engine::loop()
 {
-	// Start time counter
-	pm->start_timer();
+	Profiler::set_thread_name("Main");
+
+	// Game time starts at zero, timers scheduled by init count from there
+	game_time = 0;
+	timers.init(game_time);
+	i64 clock_last = JojPlatform::Clock::now();
 
-	// Windows messages
-	MSG msg = { 0 };
+	// Ready before game->init so the game can allocate from it, pipelined frames keep
+	// their memory until the render thread drew them (depth + 2 arenas if requested)
+	frame_arena.init(pipeline_depth > 0 ? pipeline_depth + 2 : 2, FRAME_ARENA_CAPACITY);
 
 	// Initialize game
 	game->init();
 
+	// Pipelined loop if requested and supported by the game
+	b8 pipelined = pipeline_depth > 0 && start_pipeline();
+
+	// Fixed timestep if the game asked for it
+	fixed_step = game->get_tick_rate() > 0.0f;
+	if (fixed_step)
+	{
+		timestep.init(game->get_tick_rate(), game->get_max_steps());
+		FINFO("Fixed timestep at %.1f ticks per second.", game->get_tick_rate());
+	}
+
 	// Engine is running
 	running = true;
 
 	// Main loop
 	do
 	{
-		// Handle all events before updating game
-		if (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE))
+		FPROFILE_FRAME();
+		MemoryTracker::frame_mark();
+
+		// Memory of the oldest frame in rotation is reused
+		frame_arena.begin_frame();
+
+		// Handle all pending events before updating game
 		{
-			TranslateMessage(&msg);
-			DispatchMessage(&msg);
+			FPROFILE_ZONE("pump_events");
+			if (!pm->pump_events())
+				break;
 		}
-		else
+
+		// -----------------------------------------------
+		// Pause/Resume Game
+		// -----------------------------------------------
+		// P key pauses engine
+		if (pm->is_key_pressed('P'))
 		{
-			// -----------------------------------------------
-			// Pause/Resume Game
-			// -----------------------------------------------
-			// P key pauses engine
-			if (pm->is_key_pressed('P'))
+			if (paused)
+				resume();
+			else
+				pause();
+		}
+
+		// One clock read per frame drives game time, timers and the frametime alike
+		i64 clock_now = JojPlatform::Clock::now();
+		i64 delta = clock_now - clock_last;
+		clock_last = clock_now;
+
+		// Game time only advances while unpaused
+		if (!paused)
+		{
+			game_time += delta;
+			f32 elapsed = f32(delta * 1e-9);
+
+			// Timers due by now fire before the update
 			{
-				if (paused)
-					resume();
-				else
-					pause();
+				FPROFILE_ZONE("timers");
+				timers.advance(game_time);
 			}
 
-			if (!paused)
+			if (pipelined)
+			{
+				// Simulate into a free snapshot while the render thread draws older ones
+				FrameSnapshot* snapshot = pipeline->begin_frame();
+				simulate(elapsed);
+				snapshot->frametime = frametime;
+				snapshot->alpha = alpha;
+				{
+					FPROFILE_ZONE("write_snapshot");
+					game->write_snapshot(snapshot);
+				}
+				pipeline->end_frame();
+			}
+			else
 			{
-				// Calculate frametime
-				frametime = get_frametime();
-
 				// Update game
-				game->update();
+				simulate(elapsed);
 
 				// Game draw
+				FPROFILE_ZONE("draw");
 				game->draw();
 			}
-			else
-			{
-				// Game paused
-				game->on_pause();
-			}
+
+			update_title(elapsed);
 		}
+		else
+		{
+			// Game paused
+			game->on_pause();
+		}
+	} while (running);
 
-	} while (running && msg.message != WM_QUIT);
+	// Render submitted frames and finish game jobs before its resources go away
+	if (pipeline)
+		pipeline->shutdown();
+	jobs->shutdown();
+	frame_arena.shutdown();
 
 	pm->shutdown();
 
@@ -155,23 +287,76 @@ i32 JojEngine::Engine::loop()
 	game->shutdown();
 
 	// Close game
-	return i32(msg.wParam);
+	return pm->get_exit_code();
+}
+
+b8 JojEngine::Engine::start_pipeline()
+{
+	snapshots.clear();
+	for (u32 i = 0; i < pipeline_depth + 1; ++i)
+	{
+		FrameSnapshot* snapshot = game->create_snapshot();
+		if (!snapshot)
+		{
+			FWARN("Game has no frame snapshot, using the serial loop.");
+			snapshots.clear();
+			return false;
+		}
+		snapshots.emplace_back(snapshot);
+	}
+
+	std::vector<FrameSnapshot*> slots;
+	for (std::unique_ptr<FrameSnapshot>& snapshot : snapshots)
+		slots.push_back(snapshot.get());
+
+	pipeline = std::make_unique<JojEngine::FramePipeline>();
+	if (!pipeline->init(pipeline_depth, slots.data(), render_snapshot, game))
+	{
+		FERROR(ERR_RENDERER, "Failed to start render thread.");
+		pipeline.reset();
+		snapshots.clear();
+		return false;
+	}
+
+	FINFO("Pipelined loop with depth %u.", pipeline_depth);
+	return true;
 }
 
-f32 JojEngine::Engine::get_frametime()
+void JojEngine::Engine::render_snapshot(FrameSnapshot* snapshot, void* user)
 {
+	((JojEngine::Game*)user)->draw_snapshot(snapshot);
+}
+
+void JojEngine::Engine::simulate(f32 elapsed)
+{
+	FPROFILE_ZONE("update");
+
+	if (!fixed_step)
+	{
+		frametime = elapsed;
+		alpha = 1.0f;
+		game->update();
+		return;
+	}
+
+	// Whole ticks only, the leftover is interpolated by draw
+	u32 steps = timestep.advance(elapsed);
+	frametime = timestep.get_step();
 
+	for (u32 i = 0; i < steps; ++i)
+		game->update();
+
+	alpha = timestep.get_alpha();
+}
+
+void JojEngine::Engine::update_title(f32 elapsed)
+{
 #ifdef _DEBUG
 	static f32 total_time = 0.0f;	// Total time elapsed
 	static u32  frame_count = 0;	// Elapsed frame counter
-#endif
 
-	// Current frame time
-	frametime = pm->reset_timer();
-
-#ifdef _DEBUG
 	// Accumulated frametime
-	total_time += frametime;
+	total_time += elapsed;
 
 	// Increment frame counter
 	frame_count++;
@@ -179,26 +364,29 @@ f32 JojEngine::Engine::get_frametime()
 	// Updates FPS indicator in the window every 1000ms (1 second)
 	if (total_time >= 1.0f)
 	{
-		std::stringstream text;		// Text flow for messages
-		text << std::fixed;			// Always show the fractional part
-		text.precision(3);			// three numbers after comma
+		// Formatted on the stack, the title is rebuilt every second
+		char text[512];
+		i32 length = snprintf(text, sizeof(text), "%s    Renderer Backend: %s    FPS: %u    Frametime: %.3f (ms)",
+			pm->get_window()->get_title().c_str(), renderer_name.c_str(), frame_count, elapsed * 1000.0f);
 
-		text << pm->get_window()->get_title().c_str() << "    "
-			<< "Renderer Backend: " << renderer_name.c_str() << "    "
-			<< "FPS: " << frame_count << "    "
-			<< "Frametime: " << frametime * 1000 << " (ms)";
+		if (fixed_step && length > 0 && length < i32(sizeof(text)))
+			snprintf(text + length, sizeof(text) - length, "    Ticks: %llu", (unsigned long long)timestep.get_tick_count());
 
-		SetWindowText(pm->get_window()->get_id(), text.str().c_str());
+#if PLATFORM_WINDOWS
+		SetWindowText(pm->get_window()->get_id(), text);
+#else
+		FDEBUG("%s", text);
+#endif // PLATFORM_WINDOWS
 
 		frame_count = 0;
 		total_time -= 1.0f;
 	}
+#else
+	(void)elapsed;
 #endif
-
-	return frametime;
 }
 
-
+#if PLATFORM_WINDOWS
 LRESULT CALLBACK JojEngine::Engine::EngineProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 {
 	// Window must be repainted
@@ -206,4 +394,7 @@ LRESULT CALLBACK JojEngine::Engine::EngineProc(HWND hWnd, UINT msg, WPARAM wPara
 		game->display();
 
 	return CallWindowProc(JojPlatform::Input::InputProc, hWnd, msg, wParam, lParam);
-}
\ No newline at end of file
+}
+#endif // PLATFORM_WINDOWS
+
+#endif // PLATFORM_WINDOWS || PLATFORM_LINUX
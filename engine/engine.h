@@ -2,8 +2,10 @@
 
 #include "defines.h"
 
-#if PLATFORM_WINDOWS
 #include "platform_manager.h"
+#include "null/renderer_null.h"
+
+#if PLATFORM_WINDOWS
 #include "dx12/renderer_dx12.h"
 #include "dx11/renderer_dx11.h"
 #include "opengl/renderer_gl.h"
@@ -11,10 +13,20 @@
 
 #include <memory>
 #include "game.h"
+#include "fixed_timestep.h"
+#include "frame_pipeline.h"
+#include "job_system.h"
+#include "profiler.h"
+#include "timer_wheel.h"
+#include "frame_arena.h"
+#include <vector>
+
+#if PLATFORM_WINDOWS || PLATFORM_LINUX
 
 namespace JojEngine
 {
-	enum class RendererBackend { DX11, DX12, OPENGL };
+	// NULL_RENDERER draws nothing and is the only backend without Windows
+	enum class RendererBackend { DX11, DX12, OPENGL, NULL_RENDERER };
 
 	std::string renderer_to_string(RendererBackend renderer_backend);
 
@@ -25,14 +37,24 @@ namespace JojEngine
 		~Engine();
 
 		static std::unique_ptr<JojPlatform::PlatformManager> pm;			// Platform Manager
+#if PLATFORM_WINDOWS
 		static std::unique_ptr<JojRenderer::DX11Renderer> renderer;			// DX11 Renderer
 		static std::unique_ptr<JojRenderer::DX12Renderer> dx12_renderer;	// DX12 Renderer
 
 		static std::unique_ptr<JojRenderer::GLRenderer> gl_renderer;		// OpenGL Renderer
+#endif // PLATFORM_WINDOWS
+		static std::unique_ptr<JojRenderer::NullRenderer> null_renderer;	// Headless Renderer
 
 
+		static std::unique_ptr<JojEngine::JobSystem> jobs;		// Job scheduler, shared by engine and game
+
 		static JojEngine::Game* game;							// Game to be executed
-		static f32 frametime;									// Current frametime
+		static f32 frametime;									// Current frametime (the tick in fixed timestep mode)
+		static f32 alpha;										// Fraction of a tick to interpolate by when drawing
+
+		static i64 game_time;									// Nanoseconds run while unpaused
+		static JojEngine::TimerWheel timers;					// Gameplay timers, advanced to game_time before each update
+		static JojEngine::FrameArena frame_arena;				// Transient memory, one arena reset per frame
 
 		static std::string renderer_name;	// Hold current Renderer backend name
 
@@ -40,29 +62,56 @@ namespace JojEngine
 
 		static void close_engine();									// Close Engine
 
+		// Run update and draw/present on separate threads depth frames apart (0 = serial loop), call before start
+		static void set_pipeline_depth(u32 depth);
+
+		// Write log lines on a background thread while the engine runs (or set JOJ_LOG_ASYNC=1), call before start
+		static void set_async_logging(b8 enabled);
+
 		static void pause();	// Pause engine
 		static void resume();	// Resume engine
 
+#if PLATFORM_WINDOWS
 		// Handle Windows events
 		static LRESULT CALLBACK EngineProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
+#endif // PLATFORM_WINDOWS
 
 	private:
 		static b8 running;						// Control wether engine is running
 		static b8 paused;						// Engine state
 
-		f32 get_frametime();					// Calculate frametime
+		static b8 async_logging;				// Async logging requested by set_async_logging
+
+		static u32 pipeline_depth;										// Requested pipeline depth (0 = serial)
+		static std::unique_ptr<JojEngine::FramePipeline> pipeline;		// Render thread of the pipelined loop
+		static std::vector<std::unique_ptr<FrameSnapshot>> snapshots;	// Snapshots rotating through the pipeline
+
+		b8 start_pipeline();					// Create snapshots and start render thread
+		static void render_snapshot(FrameSnapshot* snapshot, void* user);	// Render thread body
+
+		static b8 fixed_step;					// Game simulates in fixed ticks
+		static JojEngine::FixedTimestep timestep;	// Tick accumulator of fixed timestep mode
+
+		void update_title(f32 elapsed);			// Show FPS and frametime in the window title (debug)
+		void simulate(f32 elapsed);				// Run the updates of one frame
 		i32 loop();								// Main loop
 	};
 
-	// Close Engine
+	// Close Engine, the loop ends after this frame and shuts the job system down
 	inline void Engine::close_engine()
 	{ running = false; }
 
+	inline void Engine::set_pipeline_depth(u32 depth)
+	{ pipeline_depth = depth > MAX_PIPELINE_DEPTH ? MAX_PIPELINE_DEPTH : depth; }
+
+	inline void Engine::set_async_logging(b8 enabled)
+	{ async_logging = enabled; }
+
 	inline void Engine::pause()
-	{ paused = true; pm->stop_timer(); }
+	{ paused = true; }
 
 	inline void Engine::resume()
-	{ paused = false; pm->start_timer(); }
+	{ paused = false; }
 
 	inline std::string renderer_to_string(RendererBackend renderer_backend)
 	{
@@ -77,9 +126,14 @@ namespace JojEngine
 		case JojEngine::RendererBackend::OPENGL:
 			return "OpenGL";
 			break;
+		case JojEngine::RendererBackend::NULL_RENDERER:
+			return "Null";
+			break;
 		default:
 			return "Default";
 			break;
 		}
 	};
-}
\ No newline at end of file
+}
+
+#endif // PLATFORM_WINDOWS || PLATFORM_LINUX
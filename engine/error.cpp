@@ -1,5 +1,7 @@
 #include "error.h"
 
+#if PLATFORM_WINDOWS
+
 #include <comdef.h>
 #include <sstream>
 
@@ -39,4 +41,6 @@ std::string JojEngine::Error::to_string() const
         << ":\n" << err.ErrorMessage();
 
     return text.str();
-}
\ No newline at end of file
+}
+
+#endif // PLATFORM_WINDOWS
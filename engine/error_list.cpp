@@ -16,6 +16,6 @@ const char* error_strings[] = {
     "[Window error]: ",
     "[Input error]: ",
     "[Context error]: ",
-    "[Renderer error]: "
+    "[Renderer error]: ",
     "[Platform error]: "
 };
\ No newline at end of file
@@ -0,0 +1,36 @@
+#include "fixed_timestep.h"
+
+JojEngine::FixedTimestep::FixedTimestep()
+{
+	init(60.0, 5);
+}
+
+void JojEngine::FixedTimestep::init(f64 tick_rate, u32 max_steps)
+{
+	step = tick_rate > 0.0 ? 1.0 / tick_rate : 1.0 / 60.0;
+	accumulator = 0.0;
+	this->max_steps = max_steps ? max_steps : 1;
+	tick_count = 0;
+	dropped_time = 0.0;
+}
+
+u32 JojEngine::FixedTimestep::advance(f64 frametime)
+{
+	accumulator += frametime > 0.0 ? frametime : 0.0;
+
+	u32 steps = u32(accumulator / step);
+	if (steps > max_steps)
+	{
+		// Catching up would only make the next frame longer, drop the excess
+		f64 excess = f64(steps - max_steps) * step;
+		dropped_time += excess;
+		accumulator -= excess;
+		steps = max_steps;
+	}
+
+	accumulator -= f64(steps) * step;
+	accumulator = accumulator > 0.0 ? accumulator : 0.0;
+	tick_count += steps;
+
+	return steps;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "defines.h"
+
+namespace JojEngine
+{
+	/* Fixed timestep accumulator
+	 * Frametime is added to an accumulator and consumed in whole ticks of
+	 * 1 / tick_rate seconds, so the simulation always advances by the same
+	 * step no matter how fast frames are rendered. A long frame runs at most
+	 * max_steps ticks, the rest of its time is dropped instead of making the
+	 * next frames even longer. The leftover fraction of a tick is the
+	 * interpolation alpha between the last two simulated states.
+	 */
+	class FixedTimestep
+	{
+	public:
+		FixedTimestep();
+
+		// Set ticks per second and catch-up limit, reset accumulated time
+		void init(f64 tick_rate, u32 max_steps);
+
+		// Add frametime, return number of ticks to simulate this frame
+		u32 advance(f64 frametime);
+
+		// Return seconds per tick
+		f32 get_step() const
+		{ return f32(step); }
+
+		// Return fraction of a tick left in the accumulator [0, 1]
+		f32 get_alpha() const
+		{ return f32(accumulator / step); }
+
+		// Return number of ticks simulated since init
+		u64 get_tick_count() const
+		{ return tick_count; }
+
+		// Return seconds dropped by the catch-up limit since init
+		f64 get_dropped_time() const
+		{ return dropped_time; }
+
+	private:
+		f64 step;				// Seconds per tick
+		f64 accumulator;		// Time not simulated yet
+		u32 max_steps;			// Most ticks per frame
+		u64 tick_count;			// Ticks simulated
+		f64 dropped_time;		// Time thrown away by max_steps
+	};
+}
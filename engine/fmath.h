@@ -2,10 +2,6 @@
 
 #include "defines.h"
 
-#include <intrin.h>
-#include <immintrin.h>
-//#include <x86intrin.h>
-
 #include <math.h>
 #include <stdio.h>
 
@@ -13,6 +9,68 @@
 
 #define FDEG2RAD F_PI / 180.0f
 
+/* Math backend
+ * Picked at compile time from the target instruction set:
+ * AVX (two columns per register) > SSE2 (one column per register) on x86/x64,
+ * NEON on ARM, scalar anywhere else.
+ * Configure with JOJ_NATIVE_ARCH (or pass /arch:AVX2, -mavx2) to get the AVX paths,
+ * JOJ_MATH_FORCE_SCALAR (FMATH_FORCE_SCALAR) to benchmark against the scalar backend.
+ * The *_scalar functions are the reference implementations and are always available.
+ */
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_AMD64) || defined(_M_IX86)
+#define FMATH_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define FMATH_ARM 1
+#include <arm_neon.h>
+#endif
+
+#if !defined(FMATH_FORCE_SCALAR)
+#if FMATH_X86 && (defined(__AVX__) || defined(__AVX2__))
+#define FMATH_AVX 1
+#endif
+
+#if FMATH_X86 && (defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define FMATH_SSE 1
+#endif
+
+#if FMATH_ARM
+#define FMATH_NEON 1
+#endif
+#endif // FMATH_FORCE_SCALAR
+
+#if !defined(FMATH_SSE) && !defined(FMATH_NEON)
+#define FMATH_SCALAR 1
+#endif
+
+// Four float lanes, the storage of a Mat4 column for the target
+#if FMATH_X86
+typedef __m128 fvec4;
+#elif FMATH_ARM
+typedef float32x4_t fvec4;
+#else
+typedef struct fvec4_s {
+    alignas(16) f32 lanes[4];
+} fvec4;
+#endif
+
+// Return fvec4 (x, y, z, w)
+FINLINE fvec4 fvec4_set(f32 x, f32 y, f32 z, f32 w)
+{
+#if FMATH_X86
+    return _mm_setr_ps(x, y, z, w);
+#elif FMATH_ARM
+    const f32 lanes[4] = { x, y, z, w };
+    return vld1q_f32(lanes);
+#else
+    fvec4 v = { { x, y, z, w } };
+    return v;
+#endif
+}
+
 /* Math Types */
 
 
@@ -82,13 +140,37 @@ typedef union Vec4_u
 // Mat4 structure
 typedef struct Mat4 {
     union {
+#if FMATH_X86
         __m256 chunk[2];
-        __m128 column[4];
+#endif
+        fvec4 column[4];
         Vec4 column_vector[4];
         f32 data[16];
     };
 } Mat4;
 
+// Quat structure (x, y, z: vector part, w: scalar part)
+// No __m128 member so it packs tightly inside Transform
+typedef union Quat_u
+{
+    f32 elements[4];
+    struct
+    {
+        f32 x, y, z, w;
+    };
+} Quat;
+
+// Transform structure: translation, rotation and scale packed in 40 bytes
+typedef struct Transform
+{
+    Vec3 translation;
+    Quat rotation;
+    Vec3 scale;
+} Transform;
+
+/** @brief Assert Transform to be 40 bytes.*/
+STATIC_ASSERT(sizeof(Transform) == 40, "Expected Transform to be 40 bytes.");
+
 
 /* Vector 2 */
 
@@ -332,6 +414,12 @@ FINLINE void vec3v_cross_product(Vec3 a, Vec3 b)
     v->z = z;
 }
 
+// Return linear interpolation between Vec3 a and b
+FINLINE Vec3 vec3_lerp(Vec3 a, Vec3 b, f32 t)
+{
+    return { a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t };
+}
+
 // Return distance between Vec a and b
 FINLINE f64 vec3_distance(Vec3 a, Vec3 b)
 {
@@ -350,12 +438,11 @@ FINLINE void vec3_print(Vec3 a)
     printf("(%f, %f, %f)", a.x, a.y, a.z);
 }
 
-FINLINE Vec4 mat4_mult_vec3(Mat4 a, Vec4 b)
+// Return Vec4 b multiplied by the rows of Mat4 a (data[0..3] . b, data[4..7] . b, ...) - Scalar reference
+FINLINE Vec4 mat4_mult_vec3_scalar(Mat4 a, Vec4 b)
 {
     Vec4 v;
 
-    // printf("%.2f*%.2f + %.2f*%.2f + %.2f*%.2f + %.2f*%.2f\n",
-        // a.data[0] , b.x , a.data[1] , b.y , a.data[2] , b.z , a.data[3] , b.w);
     v.x = a.data[0] * b.x + a.data[1] * b.y + a.data[2] * b.z + a.data[3] * b.w;
     v.y = a.data[4] * b.x + a.data[5] * b.y + a.data[6] * b.z + a.data[7] * b.w;
     v.z = a.data[8] * b.x + a.data[9] * b.y + a.data[10] * b.z + a.data[11] * b.w;
@@ -364,6 +451,27 @@ FINLINE Vec4 mat4_mult_vec3(Mat4 a, Vec4 b)
     return v;
 }
 
+// Return Vec4 b multiplied by the rows of Mat4 a (data[0..3] . b, data[4..7] . b, ...)
+FINLINE Vec4 mat4_mult_vec3(Mat4 a, Vec4 b)
+{
+#if FMATH_SSE
+    __m128 v = _mm_loadu_ps(b.elements);
+    __m128 p0 = _mm_mul_ps(a.column[0], v);
+    __m128 p1 = _mm_mul_ps(a.column[1], v);
+    __m128 p2 = _mm_mul_ps(a.column[2], v);
+    __m128 p3 = _mm_mul_ps(a.column[3], v);
+
+    // Transpose products so each lane holds one dot product, summed in the same order as the scalar path
+    _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+
+    Vec4 r;
+    _mm_storeu_ps(r.elements, _mm_add_ps(_mm_add_ps(_mm_add_ps(p0, p1), p2), p3));
+    return r;
+#else
+    return mat4_mult_vec3_scalar(a, b);
+#endif
+}
+
 
 /* Vector 4 */
 
@@ -387,23 +495,29 @@ FINLINE Vec4 vec4_blue()
     return { 0.0f, 0.0f, 1.0f, 1.0f };
 }
 
+FINLINE Vec4 vec4_yellow()
+{
+    return { 1.0f, 1.0f, 0.0f, 1.0f };
+}
+
 
 /* Matrix 4 */
 
 FINLINE Mat4 mat4_identity()
 {
     Mat4 m;
-    m.column[0] = _mm_setr_ps(1, 0, 0, 0);
-    m.column[1] = _mm_setr_ps(0, 1, 0, 0);
-    m.column[2] = _mm_setr_ps(0, 0, 1, 0);
-    m.column[3] = _mm_setr_ps(0, 0, 0, 1);
+    m.column[0] = fvec4_set(1, 0, 0, 0);
+    m.column[1] = fvec4_set(0, 1, 0, 0);
+    m.column[2] = fvec4_set(0, 0, 1, 0);
+    m.column[3] = fvec4_set(0, 0, 0, 1);
     return m;
 }
 
 /* @brief: Code from the Kohi Game Engine
  * https://github.com/travisvroman/kohi/blob/873e3a9ccf91dcda626592901c19408256ad51f5/engine/src/math/kmath.h
+ * Scalar reference for mat4_mul (a is applied first, then b).
  */
-FINLINE Mat4 mat4_mul(Mat4 a, Mat4 b)
+FINLINE Mat4 mat4_mul_scalar(Mat4 a, Mat4 b)
 {
     Mat4 m = mat4_identity();
 
@@ -422,16 +536,397 @@ FINLINE Mat4 mat4_mul(Mat4 a, Mat4 b)
     return m;
 }
 
+/* @brief Multiply a and b (a is applied first, then b).
+ * Each column of the result is a linear combination of the columns of b
+ * weighted by the matching column of a, accumulated in the same order as
+ * mat4_mul_scalar. AVX handles two result columns per register.
+ */
+FINLINE Mat4 mat4_mul(Mat4 a, Mat4 b)
+{
+#if FMATH_AVX
+    Mat4 m;
+
+    // Both 128-bit lanes hold the same column of b
+    __m256 b0 = _mm256_broadcast_ps(&b.column[0]);
+    __m256 b1 = _mm256_broadcast_ps(&b.column[1]);
+    __m256 b2 = _mm256_broadcast_ps(&b.column[2]);
+    __m256 b3 = _mm256_broadcast_ps(&b.column[3]);
+
+    for (i32 i = 0; i < 2; ++i)
+    {
+        // Two columns of a, splat per lane
+        __m256 c = a.chunk[i];
+        __m256 r = _mm256_mul_ps(_mm256_shuffle_ps(c, c, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+        r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(c, c, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+        r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(c, c, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+        r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 3, 3)), b3));
+        m.chunk[i] = r;
+    }
+
+    return m;
+#elif FMATH_SSE
+    Mat4 m;
+
+    for (i32 i = 0; i < 4; ++i)
+    {
+        __m128 c = a.column[i];
+        __m128 r = _mm_mul_ps(_mm_shuffle_ps(c, c, _MM_SHUFFLE(0, 0, 0, 0)), b.column[0]);
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(c, c, _MM_SHUFFLE(1, 1, 1, 1)), b.column[1]));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(c, c, _MM_SHUFFLE(2, 2, 2, 2)), b.column[2]));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 3, 3)), b.column[3]));
+        m.column[i] = r;
+    }
+
+    return m;
+#elif FMATH_NEON
+    Mat4 m;
+
+    for (i32 i = 0; i < 4; ++i)
+    {
+        float32x4_t c = a.column[i];
+        float32x4_t r = vmulq_n_f32(b.column[0], vgetq_lane_f32(c, 0));
+        r = vmlaq_n_f32(r, b.column[1], vgetq_lane_f32(c, 1));
+        r = vmlaq_n_f32(r, b.column[2], vgetq_lane_f32(c, 2));
+        r = vmlaq_n_f32(r, b.column[3], vgetq_lane_f32(c, 3));
+        m.column[i] = r;
+    }
+
+    return m;
+#else
+    return mat4_mul_scalar(a, b);
+#endif
+}
+
+// Return transpose of Mat4 a - Scalar reference
+FINLINE Mat4 mat4_transpose_scalar(Mat4 a)
+{
+    Mat4 m;
+
+    for (i32 i = 0; i < 4; ++i)
+        for (i32 j = 0; j < 4; ++j)
+            m.data[i * 4 + j] = a.data[j * 4 + i];
+
+    return m;
+}
+
+// Return transpose of Mat4 a
+FINLINE Mat4 mat4_transpose(Mat4 a)
+{
+#if FMATH_SSE
+    _MM_TRANSPOSE4_PS(a.column[0], a.column[1], a.column[2], a.column[3]);
+    return a;
+#elif FMATH_NEON
+    float32x4x2_t t01 = vtrnq_f32(a.column[0], a.column[1]);
+    float32x4x2_t t23 = vtrnq_f32(a.column[2], a.column[3]);
+
+    Mat4 m;
+    m.column[0] = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+    m.column[1] = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+    m.column[2] = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+    m.column[3] = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+    return m;
+#else
+    return mat4_transpose_scalar(a);
+#endif
+}
+
+/* @brief Return inverse of Mat4 a by cofactor expansion - Scalar reference.
+ * The inverse of a transpose is the transpose of the inverse, so the same
+ * formula works for column-major and row-major storage.
+ * Singular matrices are not detected.
+ */
+FINLINE Mat4 mat4_inverse_scalar(Mat4 a)
+{
+    const f32* m = a.data;
+    Mat4 out;
+    f32* inv = out.data;
+
+    inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] +
+        m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+    inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] -
+        m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+    inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] +
+        m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+    inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] -
+        m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+    inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] -
+        m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+    inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] +
+        m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+    inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] -
+        m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+    inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] +
+        m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+    inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] +
+        m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+    inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] -
+        m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+    inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] +
+        m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+    inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] -
+        m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+    inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] -
+        m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+    inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] +
+        m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+    inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] -
+        m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+    inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] +
+        m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+    f32 det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+    f32 inv_det = 1.0f / det;
+
+    for (i32 i = 0; i < 16; ++i)
+        inv[i] *= inv_det;
+
+    return out;
+}
+
+#if FMATH_SSE
+// 2x2 matrix product A*B, each matrix packed as (m00, m01, m10, m11)
+FINLINE __m128 mat2_mul_sse(__m128 a, __m128 b)
+{
+    return _mm_add_ps(
+        _mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 3, 0))),
+        _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+
+// 2x2 adjugate product adj(A)*B
+FINLINE __m128 mat2_adj_mul_sse(__m128 a, __m128 b)
+{
+    return _mm_sub_ps(
+        _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 3, 3)), b),
+        _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))));
+}
+
+// 2x2 adjugate product A*adj(B)
+FINLINE __m128 mat2_mul_adj_sse(__m128 a, __m128 b)
+{
+    return _mm_sub_ps(
+        _mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 0, 3))),
+        _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+
+// Cross product of the xyz lanes, w = a.w * b.w - a.w * b.w
+FINLINE __m128 vec3_cross_sse(__m128 a, __m128 b)
+{
+    __m128 a_yzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 b_yzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 c = _mm_sub_ps(_mm_mul_ps(a, b_yzx), _mm_mul_ps(a_yzx, b));
+    return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+}
+#endif // FMATH_SSE
+
+/* @brief Return inverse of Mat4 a.
+ * SSE path splits the matrix in four 2x2 blocks and inverts it blockwise,
+ * which needs a single division. Singular matrices are not detected.
+ */
+FINLINE Mat4 mat4_inverse(Mat4 a)
+{
+#if FMATH_SSE
+    // 2x2 blocks
+    __m128 A = _mm_movelh_ps(a.column[0], a.column[1]);
+    __m128 B = _mm_movehl_ps(a.column[1], a.column[0]);
+    __m128 C = _mm_movelh_ps(a.column[2], a.column[3]);
+    __m128 D = _mm_movehl_ps(a.column[3], a.column[2]);
+
+    // Block determinants (|A|, |B|, |C|, |D|)
+    __m128 det_sub = _mm_sub_ps(
+        _mm_mul_ps(_mm_shuffle_ps(a.column[0], a.column[2], _MM_SHUFFLE(2, 0, 2, 0)),
+            _mm_shuffle_ps(a.column[1], a.column[3], _MM_SHUFFLE(3, 1, 3, 1))),
+        _mm_mul_ps(_mm_shuffle_ps(a.column[0], a.column[2], _MM_SHUFFLE(3, 1, 3, 1)),
+            _mm_shuffle_ps(a.column[1], a.column[3], _MM_SHUFFLE(2, 0, 2, 0))));
+
+    __m128 det_a = _mm_shuffle_ps(det_sub, det_sub, _MM_SHUFFLE(0, 0, 0, 0));
+    __m128 det_b = _mm_shuffle_ps(det_sub, det_sub, _MM_SHUFFLE(1, 1, 1, 1));
+    __m128 det_c = _mm_shuffle_ps(det_sub, det_sub, _MM_SHUFFLE(2, 2, 2, 2));
+    __m128 det_d = _mm_shuffle_ps(det_sub, det_sub, _MM_SHUFFLE(3, 3, 3, 3));
+
+    __m128 d_c = mat2_adj_mul_sse(D, C);
+    __m128 a_b = mat2_adj_mul_sse(A, B);
+
+    // Adjugates of the inverse blocks
+    __m128 x = _mm_sub_ps(_mm_mul_ps(det_d, A), mat2_mul_sse(B, d_c));
+    __m128 w = _mm_sub_ps(_mm_mul_ps(det_a, D), mat2_mul_sse(C, a_b));
+    __m128 y = _mm_sub_ps(_mm_mul_ps(det_b, C), mat2_mul_adj_sse(D, a_b));
+    __m128 z = _mm_sub_ps(_mm_mul_ps(det_c, B), mat2_mul_adj_sse(A, d_c));
+
+    // |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+    __m128 det_m = _mm_add_ps(_mm_mul_ps(det_a, det_d), _mm_mul_ps(det_b, det_c));
+    __m128 tr = _mm_mul_ps(a_b, _mm_shuffle_ps(d_c, d_c, _MM_SHUFFLE(3, 1, 2, 0)));
+    tr = _mm_add_ps(tr, _mm_shuffle_ps(tr, tr, _MM_SHUFFLE(2, 3, 0, 1)));
+    tr = _mm_add_ps(tr, _mm_shuffle_ps(tr, tr, _MM_SHUFFLE(1, 0, 3, 2)));
+    det_m = _mm_sub_ps(det_m, tr);
+
+    __m128 r_det = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det_m);
+
+    x = _mm_mul_ps(x, r_det);
+    y = _mm_mul_ps(y, r_det);
+    z = _mm_mul_ps(z, r_det);
+    w = _mm_mul_ps(w, r_det);
+
+    // Apply the adjugate shuffle while storing
+    Mat4 m;
+    m.column[0] = _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3));
+    m.column[1] = _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2));
+    m.column[2] = _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3));
+    m.column[3] = _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2));
+    return m;
+#else
+    return mat4_inverse_scalar(a);
+#endif
+}
+
+/* @brief Return inverse of an affine Mat4 a - Scalar reference.
+ * Columns 0-2 hold the linear part (rotation, scale, shear) with w = 0
+ * and column 3 holds the translation with w = 1.
+ */
+FINLINE Mat4 mat4_inverse_affine_scalar(Mat4 a)
+{
+    const f32* m = a.data;
+
+    // Rows of the inverse linear part are the cross products of its columns
+    f32 r0[3] = { m[5] * m[10] - m[6] * m[9], m[6] * m[8] - m[4] * m[10], m[4] * m[9] - m[5] * m[8] };
+    f32 r1[3] = { m[9] * m[2] - m[10] * m[1], m[10] * m[0] - m[8] * m[2], m[8] * m[1] - m[9] * m[0] };
+    f32 r2[3] = { m[1] * m[6] - m[2] * m[5], m[2] * m[4] - m[0] * m[6], m[0] * m[5] - m[1] * m[4] };
+
+    f32 inv_det = 1.0f / (m[0] * r0[0] + m[1] * r0[1] + m[2] * r0[2]);
+
+    Mat4 out;
+    f32* o = out.data;
+    for (i32 j = 0; j < 3; ++j)
+    {
+        o[j * 4 + 0] = r0[j] * inv_det;
+        o[j * 4 + 1] = r1[j] * inv_det;
+        o[j * 4 + 2] = r2[j] * inv_det;
+        o[j * 4 + 3] = 0.0f;
+    }
+
+    // Translation = -(inverse linear part * t)
+    o[12] = -(o[0] * m[12] + o[4] * m[13] + o[8] * m[14]);
+    o[13] = -(o[1] * m[12] + o[5] * m[13] + o[9] * m[14]);
+    o[14] = -(o[2] * m[12] + o[6] * m[13] + o[10] * m[14]);
+    o[15] = 1.0f;
+
+    return out;
+}
+
+/* @brief Return inverse of an affine Mat4 a.
+ * Much cheaper than mat4_inverse; the last row must be (0, 0, 0, 1).
+ */
+FINLINE Mat4 mat4_inverse_affine(Mat4 a)
+{
+#if FMATH_SSE
+    __m128 r0 = vec3_cross_sse(a.column[1], a.column[2]);
+    __m128 r1 = vec3_cross_sse(a.column[2], a.column[0]);
+    __m128 r2 = vec3_cross_sse(a.column[0], a.column[1]);
+    __m128 r3 = _mm_setzero_ps();
+
+    // det = c0 . (c1 x c2)
+    __m128 det = _mm_mul_ps(a.column[0], r0);
+    det = _mm_add_ps(_mm_add_ps(_mm_shuffle_ps(det, det, _MM_SHUFFLE(0, 0, 0, 0)),
+        _mm_shuffle_ps(det, det, _MM_SHUFFLE(1, 1, 1, 1))), _mm_shuffle_ps(det, det, _MM_SHUFFLE(2, 2, 2, 2)));
+    __m128 inv_det = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+    // Cross products are the rows of the inverse, transpose them into columns
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+    Mat4 m;
+    m.column[0] = _mm_mul_ps(r0, inv_det);
+    m.column[1] = _mm_mul_ps(r1, inv_det);
+    m.column[2] = _mm_mul_ps(r2, inv_det);
+
+    __m128 t = a.column[3];
+    __m128 p = _mm_mul_ps(m.column[0], _mm_shuffle_ps(t, t, _MM_SHUFFLE(0, 0, 0, 0)));
+    p = _mm_add_ps(p, _mm_mul_ps(m.column[1], _mm_shuffle_ps(t, t, _MM_SHUFFLE(1, 1, 1, 1))));
+    p = _mm_add_ps(p, _mm_mul_ps(m.column[2], _mm_shuffle_ps(t, t, _MM_SHUFFLE(2, 2, 2, 2))));
+    m.column[3] = _mm_sub_ps(_mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f), p);
+
+    return m;
+#else
+    return mat4_inverse_affine_scalar(a);
+#endif
+}
+
+// Transform point p by Mat4 a (w = 1, translation applied) - Scalar reference
+FINLINE Vec3 mat4_transform_point_scalar(Mat4 a, Vec3 p)
+{
+    const f32* m = a.data;
+    return {
+        m[0] * p.x + m[4] * p.y + m[8] * p.z + m[12],
+        m[1] * p.x + m[5] * p.y + m[9] * p.z + m[13],
+        m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14]
+    };
+}
+
+// Transform direction v by Mat4 a (w = 0, translation ignored) - Scalar reference
+FINLINE Vec3 mat4_transform_vector_scalar(Mat4 a, Vec3 v)
+{
+    const f32* m = a.data;
+    return {
+        m[0] * v.x + m[4] * v.y + m[8] * v.z,
+        m[1] * v.x + m[5] * v.y + m[9] * v.z,
+        m[2] * v.x + m[6] * v.y + m[10] * v.z
+    };
+}
+
+// Transform point p by Mat4 a (w = 1, translation applied)
+FINLINE Vec3 mat4_transform_point(Mat4 a, Vec3 p)
+{
+#if FMATH_SSE
+    __m128 r = _mm_mul_ps(a.column[0], _mm_set1_ps(p.x));
+    r = _mm_add_ps(r, _mm_mul_ps(a.column[1], _mm_set1_ps(p.y)));
+    r = _mm_add_ps(r, _mm_mul_ps(a.column[2], _mm_set1_ps(p.z)));
+    r = _mm_add_ps(r, a.column[3]);
+
+    f32 out[4];
+    _mm_storeu_ps(out, r);
+    return { out[0], out[1], out[2] };
+#elif FMATH_NEON
+    float32x4_t r = vmulq_n_f32(a.column[0], p.x);
+    r = vmlaq_n_f32(r, a.column[1], p.y);
+    r = vmlaq_n_f32(r, a.column[2], p.z);
+    r = vaddq_f32(r, a.column[3]);
+
+    f32 out[4];
+    vst1q_f32(out, r);
+    return { out[0], out[1], out[2] };
+#else
+    return mat4_transform_point_scalar(a, p);
+#endif
+}
+
+// Transform direction v by Mat4 a (w = 0, translation ignored)
+FINLINE Vec3 mat4_transform_vector(Mat4 a, Vec3 v)
+{
+#if FMATH_SSE
+    __m128 r = _mm_mul_ps(a.column[0], _mm_set1_ps(v.x));
+    r = _mm_add_ps(r, _mm_mul_ps(a.column[1], _mm_set1_ps(v.y)));
+    r = _mm_add_ps(r, _mm_mul_ps(a.column[2], _mm_set1_ps(v.z)));
+
+    f32 out[4];
+    _mm_storeu_ps(out, r);
+    return { out[0], out[1], out[2] };
+#elif FMATH_NEON
+    float32x4_t r = vmulq_n_f32(a.column[0], v.x);
+    r = vmlaq_n_f32(r, a.column[1], v.y);
+    r = vmlaq_n_f32(r, a.column[2], v.z);
+
+    f32 out[4];
+    vst1q_f32(out, r);
+    return { out[0], out[1], out[2] };
+#else
+    return mat4_transform_vector_scalar(a, v);
+#endif
+}
+
 FINLINE Mat4 mat4_translate(Mat4 a, Vec3 b)
 {
     Mat4 m = a;
-    float temp[4];
-
-    _mm_store_ps(temp, a.column[3]);
-    temp[0] += b.x;
-    temp[1] += b.y;
-    temp[2] += b.z;
-    m.column[3] = _mm_load_ps(temp);
+    m.data[12] += b.x;
+    m.data[13] += b.y;
+    m.data[14] += b.z;
 
     return m;
 }
@@ -497,10 +992,10 @@ FINLINE Mat4 mat4_perspective(f32 fov, f32 aspect_ratio, f32 near_plane, f32 far
     f32 zoom = tan(rad * 0.5f);
 
     Mat4 m;
-    m.column[0] = _mm_setr_ps((1.0f / zoom * aspect_ratio), 0, 0, 0);
-    m.column[1] = _mm_setr_ps(0, (1.0f / zoom), 0, 0);
-    m.column[2] = _mm_setr_ps(0, 0, -((far_plane + near_plane) / (far_plane - near_plane)), -1);
-    m.column[3] = _mm_setr_ps(0, 0, -((2.0f * far_plane * near_plane) / (far_plane - near_plane)), 0);
+    m.column[0] = fvec4_set((1.0f / zoom * aspect_ratio), 0, 0, 0);
+    m.column[1] = fvec4_set(0, (1.0f / zoom), 0, 0);
+    m.column[2] = fvec4_set(0, 0, -((far_plane + near_plane) / (far_plane - near_plane)), -1);
+    m.column[3] = fvec4_set(0, 0, -((2.0f * far_plane * near_plane) / (far_plane - near_plane)), 0);
 
     return m;
 }
@@ -514,15 +1009,51 @@ FINLINE Mat4 look_at(Vec3 position, Vec3 target, Vec3 up)
     // Since I'm not multiplying Vec3 forward by -1, I need to invert its values
     // when passing to the matrix
     Mat4 m;
-    m.column[0] = _mm_setr_ps(right.x, up.x, -forward.x, 0);
-    m.column[1] = _mm_setr_ps(right.y, up.y, -forward.y, 0);
-    m.column[2] = _mm_setr_ps(right.z, up.z, -forward.z, 0);
-    m.column[3] = _mm_setr_ps(-vec3_dot_product(right, position),
+    m.column[0] = fvec4_set(right.x, up.x, -forward.x, 0);
+    m.column[1] = fvec4_set(right.y, up.y, -forward.y, 0);
+    m.column[2] = fvec4_set(right.z, up.z, -forward.z, 0);
+    m.column[3] = fvec4_set(-vec3_dot_product(right, position),
         -vec3_dot_product(up, position), vec3_dot_product(forward, position), 1);
 
     return m;
 }
 
+/* @brief Return left-handed view Mat4 (same layout as XMMatrixLookAtLH).
+ * Forward is +z, meant for the D3D renderers and the shaders written for them.
+ */
+FINLINE Mat4 mat4_look_at_lh(Vec3 position, Vec3 target, Vec3 up)
+{
+    Vec3 forward = vec3_normalize(vec3_minus(target, position));
+    Vec3 right = vec3_normalize(vec3_cross_product(up, forward));
+    up = vec3_cross_product(forward, right);
+
+    Mat4 m;
+    m.column[0] = fvec4_set(right.x, up.x, forward.x, 0);
+    m.column[1] = fvec4_set(right.y, up.y, forward.y, 0);
+    m.column[2] = fvec4_set(right.z, up.z, forward.z, 0);
+    m.column[3] = fvec4_set(-vec3_dot_product(right, position),
+        -vec3_dot_product(up, position), -vec3_dot_product(forward, position), 1);
+
+    return m;
+}
+
+/* @brief Return left-handed perspective Mat4 (same layout as XMMatrixPerspectiveFovLH).
+ * fov_y is in radians, depth is mapped to [0, 1].
+ */
+FINLINE Mat4 mat4_perspective_fov_lh(f32 fov_y, f32 aspect_ratio, f32 near_plane, f32 far_plane)
+{
+    f32 h = 1.0f / tanf(fov_y * 0.5f);
+    f32 range = far_plane / (far_plane - near_plane);
+
+    Mat4 m;
+    m.column[0] = fvec4_set(h / aspect_ratio, 0, 0, 0);
+    m.column[1] = fvec4_set(0, h, 0, 0);
+    m.column[2] = fvec4_set(0, 0, range, 1);
+    m.column[3] = fvec4_set(0, 0, -range * near_plane, 0);
+
+    return m;
+}
+
 // TODO: Test projection
 FINLINE Mat4 mat4_orthographic(f32 left, f32 right, f32 bottom, f32 top, f32 near_plane, f32 far_plane)
 {
@@ -537,16 +1068,17 @@ FINLINE Mat4 mat4_orthographic(f32 left, f32 right, f32 bottom, f32 top, f32 nea
     f32 bt = 1.0f / (bottom - top);
     f32 nf = 1.0f / (near_plane - far_plane);
 
-    m.column[0] = _mm_setr_ps(-2.0f * lr, 0, 0, 0);
-    m.column[1] = _mm_setr_ps(0, -2.0f * bt, 0, 0);
-    m.column[2] = _mm_setr_ps(0, 0, 2.0f * nf, 0);
-    m.column[3] = _mm_setr_ps((left + right) * lr, (top + bottom) * bt, (far_plane + near_plane) * nf, 1);
+    m.column[0] = fvec4_set(-2.0f * lr, 0, 0, 0);
+    m.column[1] = fvec4_set(0, -2.0f * bt, 0, 0);
+    m.column[2] = fvec4_set(0, 0, 2.0f * nf, 0);
+    m.column[3] = fvec4_set((left + right) * lr, (top + bottom) * bt, (far_plane + near_plane) * nf, 1);
 
     return m;
 }
 
 FINLINE Mat4 mat4_scale(Mat4 a, Vec3 b)
 {
+    (void)a;
     Mat4 m = mat4_identity();
 
     m.data[0] *= b.x;
@@ -558,6 +1090,7 @@ FINLINE Mat4 mat4_scale(Mat4 a, Vec3 b)
 
 FINLINE void mat4_print(Mat4 m)
 {
+    (void)m;
     /*
     f32 c0[4] = { m.column[0][0], m.column[0][1], m.column[0][2], m.column[0][3] };
     f32 c1[4] = { m.column[1][0], m.column[1][1], m.column[1][2], m.column[1][3] };
@@ -584,4 +1117,311 @@ FINLINE void mat4_print(Mat4 m)
         printf("%.2f ", c3[i]);
     printf(")\n");
     */
-}
\ No newline at end of file
+}
+
+/* Quaternion */
+
+// Return Quat created
+FINLINE Quat quat_create(f32 x, f32 y, f32 z, f32 w)
+{
+    return { x, y, z, w };
+}
+
+// Return identity Quat (no rotation)
+FINLINE Quat quat_identity()
+{
+    return { 0.0f, 0.0f, 0.0f, 1.0f };
+}
+
+// Return Quat rotating angle_radians around normalized axis
+FINLINE Quat quat_from_axis_angle(Vec3 axis, f32 angle_radians)
+{
+    f32 half = angle_radians * 0.5f;
+    f32 s = sinf(half);
+    return { axis.x * s, axis.y * s, axis.z * s, cosf(half) };
+}
+
+// Return dot product of Quat a and b
+FINLINE f32 quat_dot(Quat a, Quat b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+}
+
+// Return conjugate of Quat a (inverse rotation for unit quaternions)
+FINLINE Quat quat_conjugate(Quat a)
+{
+    return { -a.x, -a.y, -a.z, a.w };
+}
+
+// Return normalized Quat a - Scalar reference
+FINLINE Quat quat_normalize_scalar(Quat a)
+{
+    f32 inv_len = 1.0f / sqrtf(quat_dot(a, a));
+    return { a.x * inv_len, a.y * inv_len, a.z * inv_len, a.w * inv_len };
+}
+
+// Return normalized Quat a
+FINLINE Quat quat_normalize(Quat a)
+{
+#if FMATH_SSE
+    __m128 q = _mm_loadu_ps(a.elements);
+    __m128 d = _mm_mul_ps(q, q);
+    d = _mm_add_ps(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(2, 3, 0, 1)));
+    d = _mm_add_ps(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(1, 0, 3, 2)));
+
+    Quat r;
+    _mm_storeu_ps(r.elements, _mm_div_ps(q, _mm_sqrt_ps(d)));
+    return r;
+#else
+    return quat_normalize_scalar(a);
+#endif
+}
+
+// Return inverse of Quat a (works for non-unit quaternions)
+FINLINE Quat quat_inverse(Quat a)
+{
+    f32 inv_len_sq = 1.0f / quat_dot(a, a);
+    return { -a.x * inv_len_sq, -a.y * inv_len_sq, -a.z * inv_len_sq, a.w * inv_len_sq };
+}
+
+// Return Hamilton product a * b - Scalar reference
+FINLINE Quat quat_mul_scalar(Quat a, Quat b)
+{
+    return {
+        a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+        a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+        a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+        a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z
+    };
+}
+
+/* @brief Return Hamilton product a * b.
+ * The result rotates by b first, then by a.
+ */
+FINLINE Quat quat_mul(Quat a, Quat b)
+{
+#if FMATH_SSE
+    __m128 qa = _mm_loadu_ps(a.elements);
+    __m128 qb = _mm_loadu_ps(b.elements);
+
+    __m128 r = _mm_mul_ps(_mm_shuffle_ps(qa, qa, _MM_SHUFFLE(3, 3, 3, 3)), qb);
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(_mm_shuffle_ps(qa, qa, _MM_SHUFFLE(0, 0, 0, 0)),
+        _mm_shuffle_ps(qb, qb, _MM_SHUFFLE(0, 1, 2, 3))), _mm_setr_ps(1.0f, -1.0f, 1.0f, -1.0f)));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(_mm_shuffle_ps(qa, qa, _MM_SHUFFLE(1, 1, 1, 1)),
+        _mm_shuffle_ps(qb, qb, _MM_SHUFFLE(1, 0, 3, 2))), _mm_setr_ps(1.0f, 1.0f, -1.0f, -1.0f)));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(_mm_shuffle_ps(qa, qa, _MM_SHUFFLE(2, 2, 2, 2)),
+        _mm_shuffle_ps(qb, qb, _MM_SHUFFLE(2, 3, 0, 1))), _mm_setr_ps(-1.0f, 1.0f, 1.0f, -1.0f)));
+
+    Quat q;
+    _mm_storeu_ps(q.elements, r);
+    return q;
+#else
+    return quat_mul_scalar(a, b);
+#endif
+}
+
+/* @brief Return Quat from Euler angles in radians.
+ * Same order as DirectX RollPitchYaw: roll (Z) first, then pitch (X), then yaw (Y).
+ */
+FINLINE Quat quat_from_euler(f32 pitch, f32 yaw, f32 roll)
+{
+    Quat qx = quat_from_axis_angle(vec3_right(), pitch);
+    Quat qy = quat_from_axis_angle(vec3_up(), yaw);
+    Quat qz = quat_from_axis_angle(vec3_back(), roll);
+    return quat_mul(qy, quat_mul(qx, qz));
+}
+
+// Return Vec3 v rotated by unit Quat q - Scalar reference
+FINLINE Vec3 quat_rotate_vec3_scalar(Quat q, Vec3 v)
+{
+    // v' = v + 2w(q x v) + 2q x (q x v)
+    Vec3 qv = { q.x, q.y, q.z };
+    Vec3 t = vec3_multiply_by_scalar(vec3_cross_product(qv, v), 2.0f);
+    return vec3_add(vec3_add(v, vec3_multiply_by_scalar(t, q.w)), vec3_cross_product(qv, t));
+}
+
+// Return Vec3 v rotated by unit Quat q
+FINLINE Vec3 quat_rotate_vec3(Quat q, Vec3 v)
+{
+#if FMATH_SSE
+    // v' = v + 2w(q x v) + 2q x (q x v)
+    __m128 qv = _mm_setr_ps(q.x, q.y, q.z, 0.0f);
+    __m128 p = _mm_setr_ps(v.x, v.y, v.z, 0.0f);
+    __m128 t = _mm_mul_ps(vec3_cross_sse(qv, p), _mm_set1_ps(2.0f));
+    __m128 r = _mm_add_ps(_mm_add_ps(p, _mm_mul_ps(t, _mm_set1_ps(q.w))), vec3_cross_sse(qv, t));
+
+    f32 out[4];
+    _mm_storeu_ps(out, r);
+    return { out[0], out[1], out[2] };
+#else
+    return quat_rotate_vec3_scalar(q, v);
+#endif
+}
+
+// Return normalized linear interpolation between Quat a and b along the shortest path - Scalar reference
+FINLINE Quat quat_nlerp_scalar(Quat a, Quat b, f32 t)
+{
+    // Flip b to stay on the same hemisphere as a
+    f32 sign = quat_dot(a, b) < 0.0f ? -1.0f : 1.0f;
+    return quat_normalize_scalar({
+        a.x + (sign * b.x - a.x) * t,
+        a.y + (sign * b.y - a.y) * t,
+        a.z + (sign * b.z - a.z) * t,
+        a.w + (sign * b.w - a.w) * t });
+}
+
+// Return normalized linear interpolation between Quat a and b along the shortest path
+FINLINE Quat quat_nlerp(Quat a, Quat b, f32 t)
+{
+#if FMATH_SSE
+    // Flip b to stay on the same hemisphere as a
+    f32 sign = quat_dot(a, b) < 0.0f ? -1.0f : 1.0f;
+
+    __m128 qa = _mm_loadu_ps(a.elements);
+    __m128 qb = _mm_mul_ps(_mm_loadu_ps(b.elements), _mm_set1_ps(sign));
+    __m128 r = _mm_add_ps(qa, _mm_mul_ps(_mm_sub_ps(qb, qa), _mm_set1_ps(t)));
+
+    Quat q;
+    _mm_storeu_ps(q.elements, r);
+    return quat_normalize(q);
+#else
+    return quat_nlerp_scalar(a, b, t);
+#endif
+}
+
+/* @brief Return spherical linear interpolation between unit Quat a and b.
+ * Takes the shortest path and falls back to nlerp when a and b are almost
+ * parallel, where the sin(theta) division loses precision.
+ */
+FINLINE Quat quat_slerp(Quat a, Quat b, f32 t)
+{
+    f32 cos_theta = quat_dot(a, b);
+    f32 sign = 1.0f;
+
+    if (cos_theta < 0.0f)
+    {
+        cos_theta = -cos_theta;
+        sign = -1.0f;
+    }
+
+    if (cos_theta > 0.9995f)
+        return quat_nlerp(a, b, t);
+
+    f32 theta = acosf(cos_theta);
+    f32 inv_sin = 1.0f / sinf(theta);
+    f32 wa = sinf((1.0f - t) * theta) * inv_sin;
+    f32 wb = sinf(t * theta) * inv_sin * sign;
+
+#if FMATH_SSE
+    __m128 r = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(a.elements), _mm_set1_ps(wa)),
+        _mm_mul_ps(_mm_loadu_ps(b.elements), _mm_set1_ps(wb)));
+
+    Quat q;
+    _mm_storeu_ps(q.elements, r);
+    return q;
+#else
+    return { a.x * wa + b.x * wb, a.y * wa + b.y * wb, a.z * wa + b.z * wb, a.w * wa + b.w * wb };
+#endif
+}
+
+// Return rotation Mat4 from unit Quat q
+FINLINE Mat4 quat_to_mat4(Quat q)
+{
+    f32 xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    f32 xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    f32 wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+    Mat4 m;
+    m.column[0] = fvec4_set(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy), 0.0f);
+    m.column[1] = fvec4_set(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx), 0.0f);
+    m.column[2] = fvec4_set(2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy), 0.0f);
+    m.column[3] = fvec4_set(0.0f, 0.0f, 0.0f, 1.0f);
+    return m;
+}
+
+
+/* Transform */
+
+// Return Transform created
+FINLINE Transform transform_create(Vec3 translation, Quat rotation, Vec3 scale)
+{
+    return { translation, rotation, scale };
+}
+
+// Return identity Transform
+FINLINE Transform transform_identity()
+{
+    return { vec3_zero(), quat_identity(), vec3_create(1.0f, 1.0f, 1.0f) };
+}
+
+// Return point p transformed by t (scale, then rotate, then translate)
+FINLINE Vec3 transform_point(Transform t, Vec3 p)
+{
+    return vec3_add(t.translation, quat_rotate_vec3(t.rotation, vec3_multiply(t.scale, p)));
+}
+
+/* @brief Return Transform child expressed in the space of parent.
+ * Exact for uniform scale; non-uniform parent scale combined with child
+ * rotation produces shear, which TRS cannot represent, so it is dropped.
+ */
+FINLINE Transform transform_compose(Transform parent, Transform child)
+{
+    Transform r;
+    r.translation = transform_point(parent, child.translation);
+    r.rotation = quat_mul(parent.rotation, child.rotation);
+    r.scale = vec3_multiply(parent.scale, child.scale);
+    return r;
+}
+
+// Return inverse of Transform t (exact for uniform scale)
+FINLINE Transform transform_inverse(Transform t)
+{
+    Transform r;
+    r.scale = vec3_create(1.0f / t.scale.x, 1.0f / t.scale.y, 1.0f / t.scale.z);
+    r.rotation = quat_conjugate(t.rotation);
+    r.translation = vec3_multiply(r.scale, quat_rotate_vec3(r.rotation, vec3_multiply_by_scalar(t.translation, -1.0f)));
+    return r;
+}
+
+// Return interpolation between Transform a and b (lerp translation and scale, nlerp rotation)
+FINLINE Transform transform_lerp(Transform a, Transform b, f32 t)
+{
+    Transform r;
+    r.translation = vec3_lerp(a.translation, b.translation, t);
+    r.rotation = quat_nlerp(a.rotation, b.rotation, t);
+    r.scale = vec3_lerp(a.scale, b.scale, t);
+    return r;
+}
+
+// Return Mat4 from Transform t - Scalar reference
+FINLINE Mat4 transform_to_mat4_scalar(Transform t)
+{
+    Mat4 m = quat_to_mat4(t.rotation);
+
+    for (i32 i = 0; i < 3; ++i)
+    {
+        m.data[i] *= t.scale.x;
+        m.data[4 + i] *= t.scale.y;
+        m.data[8 + i] *= t.scale.z;
+    }
+    m.data[12] = t.translation.x;
+    m.data[13] = t.translation.y;
+    m.data[14] = t.translation.z;
+
+    return m;
+}
+
+// Return Mat4 from Transform t, only needed when uploading to the GPU
+FINLINE Mat4 transform_to_mat4(Transform t)
+{
+#if FMATH_SSE
+    Mat4 m = quat_to_mat4(t.rotation);
+    m.column[0] = _mm_mul_ps(m.column[0], _mm_set1_ps(t.scale.x));
+    m.column[1] = _mm_mul_ps(m.column[1], _mm_set1_ps(t.scale.y));
+    m.column[2] = _mm_mul_ps(m.column[2], _mm_set1_ps(t.scale.z));
+    m.column[3] = _mm_setr_ps(t.translation.x, t.translation.y, t.translation.z, 1.0f);
+    return m;
+#else
+    return transform_to_mat4_scalar(t);
+#endif
+}
@@ -0,0 +1,328 @@
+#include "fmath_batch.h"
+
+// ------------------------------------------------------------------------------
+// Vec3 structure-of-arrays
+// ------------------------------------------------------------------------------
+
+void vec3_soa_add(Vec3SoA out, Vec3SoA a, Vec3SoA b, u32 count)
+{
+    u32 i = 0;
+
+#if FMATH_AVX
+    for (; i + 8 <= count; i += 8)
+    {
+        _mm256_storeu_ps(out.x + i, _mm256_add_ps(_mm256_loadu_ps(a.x + i), _mm256_loadu_ps(b.x + i)));
+        _mm256_storeu_ps(out.y + i, _mm256_add_ps(_mm256_loadu_ps(a.y + i), _mm256_loadu_ps(b.y + i)));
+        _mm256_storeu_ps(out.z + i, _mm256_add_ps(_mm256_loadu_ps(a.z + i), _mm256_loadu_ps(b.z + i)));
+    }
+#endif
+
+#if FMATH_SSE
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(out.x + i, _mm_add_ps(_mm_loadu_ps(a.x + i), _mm_loadu_ps(b.x + i)));
+        _mm_storeu_ps(out.y + i, _mm_add_ps(_mm_loadu_ps(a.y + i), _mm_loadu_ps(b.y + i)));
+        _mm_storeu_ps(out.z + i, _mm_add_ps(_mm_loadu_ps(a.z + i), _mm_loadu_ps(b.z + i)));
+    }
+#elif FMATH_NEON
+    for (; i + 4 <= count; i += 4)
+    {
+        vst1q_f32(out.x + i, vaddq_f32(vld1q_f32(a.x + i), vld1q_f32(b.x + i)));
+        vst1q_f32(out.y + i, vaddq_f32(vld1q_f32(a.y + i), vld1q_f32(b.y + i)));
+        vst1q_f32(out.z + i, vaddq_f32(vld1q_f32(a.z + i), vld1q_f32(b.z + i)));
+    }
+#endif
+
+    // Scalar tail
+    for (; i < count; ++i)
+    {
+        out.x[i] = a.x[i] + b.x[i];
+        out.y[i] = a.y[i] + b.y[i];
+        out.z[i] = a.z[i] + b.z[i];
+    }
+}
+
+void vec3_soa_translate(Vec3SoA out, Vec3SoA a, Vec3 b, u32 count)
+{
+    u32 i = 0;
+
+#if FMATH_AVX
+    __m256 bx8 = _mm256_set1_ps(b.x);
+    __m256 by8 = _mm256_set1_ps(b.y);
+    __m256 bz8 = _mm256_set1_ps(b.z);
+
+    for (; i + 8 <= count; i += 8)
+    {
+        _mm256_storeu_ps(out.x + i, _mm256_add_ps(_mm256_loadu_ps(a.x + i), bx8));
+        _mm256_storeu_ps(out.y + i, _mm256_add_ps(_mm256_loadu_ps(a.y + i), by8));
+        _mm256_storeu_ps(out.z + i, _mm256_add_ps(_mm256_loadu_ps(a.z + i), bz8));
+    }
+#endif
+
+#if FMATH_SSE
+    __m128 bx4 = _mm_set1_ps(b.x);
+    __m128 by4 = _mm_set1_ps(b.y);
+    __m128 bz4 = _mm_set1_ps(b.z);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(out.x + i, _mm_add_ps(_mm_loadu_ps(a.x + i), bx4));
+        _mm_storeu_ps(out.y + i, _mm_add_ps(_mm_loadu_ps(a.y + i), by4));
+        _mm_storeu_ps(out.z + i, _mm_add_ps(_mm_loadu_ps(a.z + i), bz4));
+    }
+#elif FMATH_NEON
+    float32x4_t bx4 = vdupq_n_f32(b.x);
+    float32x4_t by4 = vdupq_n_f32(b.y);
+    float32x4_t bz4 = vdupq_n_f32(b.z);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        vst1q_f32(out.x + i, vaddq_f32(vld1q_f32(a.x + i), bx4));
+        vst1q_f32(out.y + i, vaddq_f32(vld1q_f32(a.y + i), by4));
+        vst1q_f32(out.z + i, vaddq_f32(vld1q_f32(a.z + i), bz4));
+    }
+#endif
+
+    // Scalar tail
+    for (; i < count; ++i)
+    {
+        out.x[i] = a.x[i] + b.x;
+        out.y[i] = a.y[i] + b.y;
+        out.z[i] = a.z[i] + b.z;
+    }
+}
+
+void vec3_soa_multiply_by_scalar(Vec3SoA out, Vec3SoA a, f32 k, u32 count)
+{
+    u32 i = 0;
+
+#if FMATH_AVX
+    __m256 k8 = _mm256_set1_ps(k);
+
+    for (; i + 8 <= count; i += 8)
+    {
+        _mm256_storeu_ps(out.x + i, _mm256_mul_ps(_mm256_loadu_ps(a.x + i), k8));
+        _mm256_storeu_ps(out.y + i, _mm256_mul_ps(_mm256_loadu_ps(a.y + i), k8));
+        _mm256_storeu_ps(out.z + i, _mm256_mul_ps(_mm256_loadu_ps(a.z + i), k8));
+    }
+#endif
+
+#if FMATH_SSE
+    __m128 k4 = _mm_set1_ps(k);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(out.x + i, _mm_mul_ps(_mm_loadu_ps(a.x + i), k4));
+        _mm_storeu_ps(out.y + i, _mm_mul_ps(_mm_loadu_ps(a.y + i), k4));
+        _mm_storeu_ps(out.z + i, _mm_mul_ps(_mm_loadu_ps(a.z + i), k4));
+    }
+#elif FMATH_NEON
+    for (; i + 4 <= count; i += 4)
+    {
+        vst1q_f32(out.x + i, vmulq_n_f32(vld1q_f32(a.x + i), k));
+        vst1q_f32(out.y + i, vmulq_n_f32(vld1q_f32(a.y + i), k));
+        vst1q_f32(out.z + i, vmulq_n_f32(vld1q_f32(a.z + i), k));
+    }
+#endif
+
+    // Scalar tail
+    for (; i < count; ++i)
+    {
+        out.x[i] = a.x[i] * k;
+        out.y[i] = a.y[i] * k;
+        out.z[i] = a.z[i] * k;
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Mat4 x Vec3 structure-of-arrays
+// ------------------------------------------------------------------------------
+
+/* Each matrix element is splat once, then every lane runs the same
+ * multiply-add sequence as mat4_transform_point_scalar.
+ * w_term selects between points (translation added) and vectors.
+ */
+static void mat4_transform_soa(Mat4 m, Vec3SoA in, Vec3SoA out, u32 count, b8 w_term)
+{
+    const f32* d = m.data;
+    f32 tx = w_term ? d[12] : 0.0f;
+    f32 ty = w_term ? d[13] : 0.0f;
+    f32 tz = w_term ? d[14] : 0.0f;
+
+    u32 i = 0;
+
+#if FMATH_AVX
+    {
+        __m256 m0 = _mm256_set1_ps(d[0]), m1 = _mm256_set1_ps(d[1]), m2 = _mm256_set1_ps(d[2]);
+        __m256 m4 = _mm256_set1_ps(d[4]), m5 = _mm256_set1_ps(d[5]), m6 = _mm256_set1_ps(d[6]);
+        __m256 m8 = _mm256_set1_ps(d[8]), m9 = _mm256_set1_ps(d[9]), m10 = _mm256_set1_ps(d[10]);
+        __m256 t0 = _mm256_set1_ps(tx), t1 = _mm256_set1_ps(ty), t2 = _mm256_set1_ps(tz);
+
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 x = _mm256_loadu_ps(in.x + i);
+            __m256 y = _mm256_loadu_ps(in.y + i);
+            __m256 z = _mm256_loadu_ps(in.z + i);
+
+            __m256 rx = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m0, x), _mm256_mul_ps(m4, y)), _mm256_mul_ps(m8, z)), t0);
+            __m256 ry = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m1, x), _mm256_mul_ps(m5, y)), _mm256_mul_ps(m9, z)), t1);
+            __m256 rz = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m2, x), _mm256_mul_ps(m6, y)), _mm256_mul_ps(m10, z)), t2);
+
+            _mm256_storeu_ps(out.x + i, rx);
+            _mm256_storeu_ps(out.y + i, ry);
+            _mm256_storeu_ps(out.z + i, rz);
+        }
+    }
+#endif
+
+#if FMATH_SSE
+    {
+        __m128 m0 = _mm_set1_ps(d[0]), m1 = _mm_set1_ps(d[1]), m2 = _mm_set1_ps(d[2]);
+        __m128 m4 = _mm_set1_ps(d[4]), m5 = _mm_set1_ps(d[5]), m6 = _mm_set1_ps(d[6]);
+        __m128 m8 = _mm_set1_ps(d[8]), m9 = _mm_set1_ps(d[9]), m10 = _mm_set1_ps(d[10]);
+        __m128 t0 = _mm_set1_ps(tx), t1 = _mm_set1_ps(ty), t2 = _mm_set1_ps(tz);
+
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 x = _mm_loadu_ps(in.x + i);
+            __m128 y = _mm_loadu_ps(in.y + i);
+            __m128 z = _mm_loadu_ps(in.z + i);
+
+            __m128 rx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m0, x), _mm_mul_ps(m4, y)), _mm_mul_ps(m8, z)), t0);
+            __m128 ry = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m1, x), _mm_mul_ps(m5, y)), _mm_mul_ps(m9, z)), t1);
+            __m128 rz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m2, x), _mm_mul_ps(m6, y)), _mm_mul_ps(m10, z)), t2);
+
+            _mm_storeu_ps(out.x + i, rx);
+            _mm_storeu_ps(out.y + i, ry);
+            _mm_storeu_ps(out.z + i, rz);
+        }
+    }
+#elif FMATH_NEON
+    {
+        float32x4_t t0 = vdupq_n_f32(tx), t1 = vdupq_n_f32(ty), t2 = vdupq_n_f32(tz);
+
+        for (; i + 4 <= count; i += 4)
+        {
+            float32x4_t x = vld1q_f32(in.x + i);
+            float32x4_t y = vld1q_f32(in.y + i);
+            float32x4_t z = vld1q_f32(in.z + i);
+
+            float32x4_t rx = vaddq_f32(vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(x, d[0]), y, d[4]), z, d[8]), t0);
+            float32x4_t ry = vaddq_f32(vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(x, d[1]), y, d[5]), z, d[9]), t1);
+            float32x4_t rz = vaddq_f32(vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(x, d[2]), y, d[6]), z, d[10]), t2);
+
+            vst1q_f32(out.x + i, rx);
+            vst1q_f32(out.y + i, ry);
+            vst1q_f32(out.z + i, rz);
+        }
+    }
+#endif
+
+    // Scalar tail
+    for (; i < count; ++i)
+    {
+        f32 x = in.x[i];
+        f32 y = in.y[i];
+        f32 z = in.z[i];
+
+        out.x[i] = d[0] * x + d[4] * y + d[8] * z + tx;
+        out.y[i] = d[1] * x + d[5] * y + d[9] * z + ty;
+        out.z[i] = d[2] * x + d[6] * y + d[10] * z + tz;
+    }
+}
+
+void mat4_transform_points_soa(Mat4 m, Vec3SoA in, Vec3SoA out, u32 count)
+{
+    mat4_transform_soa(m, in, out, count, true);
+}
+
+void mat4_transform_vectors_soa(Mat4 m, Vec3SoA in, Vec3SoA out, u32 count)
+{
+    mat4_transform_soa(m, in, out, count, false);
+}
+
+/* Transforms are array-of-structures, so this is the scalar gather that
+ * feeds the SoA kernels. Same arithmetic as quat_to_mat4 with the scale
+ * applied per column, as in transform_to_mat4.
+ */
+void transform_columns_soa(const Transform* t, Vec3SoA x_axis, Vec3SoA y_axis, Vec3SoA z_axis, Vec3SoA translation, u32 count)
+{
+    for (u32 i = 0; i < count; ++i)
+    {
+        Quat q = t[i].rotation;
+        f32 xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+        f32 xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+        f32 wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+        f32 sx = t[i].scale.x;
+        x_axis.x[i] = (1.0f - 2.0f * (yy + zz)) * sx;
+        x_axis.y[i] = 2.0f * (xy + wz) * sx;
+        x_axis.z[i] = 2.0f * (xz - wy) * sx;
+
+        f32 sy = t[i].scale.y;
+        y_axis.x[i] = 2.0f * (xy - wz) * sy;
+        y_axis.y[i] = (1.0f - 2.0f * (xx + zz)) * sy;
+        y_axis.z[i] = 2.0f * (yz + wx) * sy;
+
+        f32 sz = t[i].scale.z;
+        z_axis.x[i] = 2.0f * (xz + wy) * sz;
+        z_axis.y[i] = 2.0f * (yz - wx) * sz;
+        z_axis.z[i] = (1.0f - 2.0f * (xx + yy)) * sz;
+
+        translation.x[i] = t[i].translation.x;
+        translation.y[i] = t[i].translation.y;
+        translation.z[i] = t[i].translation.z;
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Mat4 arrays
+// ------------------------------------------------------------------------------
+
+void mat4_mul_batch(const Mat4* a, const Mat4* b, Mat4* out, u32 count)
+{
+    for (u32 i = 0; i < count; ++i)
+        out[i] = mat4_mul(a[i], b[i]);
+}
+
+void mat4_mul_batch_shared(const Mat4* a, Mat4 b, Mat4* out, u32 count)
+{
+#if FMATH_AVX
+    // Broadcast b once for the whole batch
+    __m256 b0 = _mm256_broadcast_ps(&b.column[0]);
+    __m256 b1 = _mm256_broadcast_ps(&b.column[1]);
+    __m256 b2 = _mm256_broadcast_ps(&b.column[2]);
+    __m256 b3 = _mm256_broadcast_ps(&b.column[3]);
+
+    for (u32 i = 0; i < count; ++i)
+    {
+        for (u32 j = 0; j < 2; ++j)
+        {
+            __m256 c = a[i].chunk[j];
+            __m256 r = _mm256_mul_ps(_mm256_shuffle_ps(c, c, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+            r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(c, c, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+            r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(c, c, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+            r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 3, 3)), b3));
+            out[i].chunk[j] = r;
+        }
+    }
+#else
+    for (u32 i = 0; i < count; ++i)
+        out[i] = mat4_mul(a[i], b);
+#endif
+}
+
+void mat4_translate_batch_soa(Mat4 base, Vec3SoA positions, Mat4* out, u32 count)
+{
+    for (u32 i = 0; i < count; ++i)
+    {
+        out[i] = base;
+#if FMATH_SSE
+        out[i].column[3] = _mm_add_ps(base.column[3], _mm_setr_ps(positions.x[i], positions.y[i], positions.z[i], 0.0f));
+#else
+        out[i].data[12] += positions.x[i];
+        out[i].data[13] += positions.y[i];
+        out[i].data[14] += positions.z[i];
+#endif
+    }
+}
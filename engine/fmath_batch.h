@@ -0,0 +1,68 @@
+#pragma once
+
+#include "defines.h"
+#include "fmath.h"
+
+/* Batched math kernels
+ * Work on whole arrays per call instead of one value per call. Positions are
+ * stored as structure-of-arrays (one array per component) so AVX handles 8
+ * and SSE/NEON handle 4 of them per instruction; the remainder goes through a
+ * scalar tail. Matrices stay array-of-structures since that is the upload
+ * format, each one is processed with the Mat4 SIMD kernels from fmath.h.
+ * Output arrays may alias the input arrays.
+ */
+
+// Structure-of-arrays view of Vec3 components
+typedef struct Vec3SoA
+{
+    f32* x;
+    f32* y;
+    f32* z;
+} Vec3SoA;
+
+// Return Vec3SoA view over three component arrays
+FINLINE Vec3SoA vec3_soa_create(f32* x, f32* y, f32* z)
+{
+    return { x, y, z };
+}
+
+// Read element i of Vec3SoA a
+FINLINE Vec3 vec3_soa_get(Vec3SoA a, u32 i)
+{
+    return { a.x[i], a.y[i], a.z[i] };
+}
+
+// Write Vec3 v to element i of Vec3SoA a
+FINLINE void vec3_soa_set(Vec3SoA a, u32 i, Vec3 v)
+{
+    a.x[i] = v.x;
+    a.y[i] = v.y;
+    a.z[i] = v.z;
+}
+
+// out[i] = a[i] + b[i]
+void vec3_soa_add(Vec3SoA out, Vec3SoA a, Vec3SoA b, u32 count);
+
+// out[i] = a[i] + b
+void vec3_soa_translate(Vec3SoA out, Vec3SoA a, Vec3 b, u32 count);
+
+// out[i] = a[i] * k
+void vec3_soa_multiply_by_scalar(Vec3SoA out, Vec3SoA a, f32 k, u32 count);
+
+// out[i] = mat4_transform_point(m, in[i])
+void mat4_transform_points_soa(Mat4 m, Vec3SoA in, Vec3SoA out, u32 count);
+
+// out[i] = mat4_transform_vector(m, in[i])
+void mat4_transform_vectors_soa(Mat4 m, Vec3SoA in, Vec3SoA out, u32 count);
+
+// x_axis[i], y_axis[i], z_axis[i], translation[i] = first four columns of transform_to_mat4(t[i])
+void transform_columns_soa(const Transform* t, Vec3SoA x_axis, Vec3SoA y_axis, Vec3SoA z_axis, Vec3SoA translation, u32 count);
+
+// out[i] = mat4_mul(a[i], b[i])
+void mat4_mul_batch(const Mat4* a, const Mat4* b, Mat4* out, u32 count);
+
+// out[i] = mat4_mul(a[i], b), e.g. world matrices times the view-projection
+void mat4_mul_batch_shared(const Mat4* a, Mat4 b, Mat4* out, u32 count);
+
+// out[i] = mat4_translate(base, positions[i]), e.g. world matrices from SoA positions
+void mat4_translate_batch_soa(Mat4 base, Vec3SoA positions, Mat4* out, u32 count);
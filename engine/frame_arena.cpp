@@ -0,0 +1,172 @@
+#include "frame_arena.h"
+
+#include "memory_tracker.h"
+#include <stdlib.h>
+
+// Blocks are aligned for any alignment the engine uses (SIMD and cache lines)
+static const u64 BLOCK_ALIGNMENT = 64;
+
+static void* allocate_block(u64 size)
+{
+#if defined(_MSC_VER)
+	return _aligned_malloc(size_t(size), size_t(BLOCK_ALIGNMENT));
+#else
+	return aligned_alloc(size_t(BLOCK_ALIGNMENT), size_t((size + BLOCK_ALIGNMENT - 1) & ~(BLOCK_ALIGNMENT - 1)));
+#endif
+}
+
+static void free_block(void* block)
+{
+#if defined(_MSC_VER)
+	_aligned_free(block);
+#else
+	free(block);
+#endif
+}
+
+JojEngine::LinearArena::LinearArena()
+{
+	block = nullptr;
+	capacity = 0;
+	offset = 0;
+	overflow_used = 0;
+	peak = 0;
+	overflow_count = 0;
+}
+
+JojEngine::LinearArena::~LinearArena()
+{
+	shutdown();
+}
+
+b8 JojEngine::LinearArena::init(u64 capacity)
+{
+	shutdown();
+
+	if (capacity > 0)
+	{
+		block = (u8*)allocate_block(capacity);
+		if (!block)
+			return false;
+		FMEMORY_ALLOC(MemoryTag::ENGINE, capacity);
+	}
+
+	this->capacity = capacity;
+	return true;
+}
+
+void JojEngine::LinearArena::shutdown()
+{
+	free_overflow();
+
+	if (block)
+	{
+		free_block(block);
+		FMEMORY_FREE(MemoryTag::ENGINE, capacity);
+	}
+
+	block = nullptr;
+	capacity = 0;
+	offset = 0;
+	overflow_used = 0;
+	peak = 0;
+	overflow_count = 0;
+}
+
+void* JojEngine::LinearArena::allocate_overflow(u64 size, u64 alignment)
+{
+	// Over-allocate so any alignment fits, overflow blocks are only a stopgap until the next reset
+	u8* heap_block = (u8*)allocate_block(size + alignment);
+	if (!heap_block)
+		return nullptr;
+
+	overflow.push_back({ heap_block, size });
+	overflow_used += size;
+	FMEMORY_ALLOC(MemoryTag::ENGINE, size);
+	overflow_count++;
+
+	u64 address = (u64(uintptr_t(heap_block)) + alignment - 1) & ~(alignment - 1);
+	return heap_block + (address - u64(uintptr_t(heap_block)));
+}
+
+void JojEngine::LinearArena::free_overflow()
+{
+	for (const OverflowBlock& heap_block : overflow)
+	{
+		free_block(heap_block.block);
+		FMEMORY_FREE(MemoryTag::ENGINE, heap_block.size);
+	}
+	overflow.clear();
+}
+
+void JojEngine::LinearArena::reset()
+{
+	u64 used = get_used();
+	peak = used > peak ? used : peak;
+
+	if (!overflow.empty())
+	{
+		free_overflow();
+
+		// Grow to the peak plus a margin so the next frames fit
+		u64 grown = peak + peak / 4;
+		u8* bigger = (u8*)allocate_block(grown);
+		if (bigger)
+		{
+			FMEMORY_ALLOC(MemoryTag::ENGINE, grown);
+			if (block)
+			{
+				free_block(block);
+				FMEMORY_FREE(MemoryTag::ENGINE, capacity);
+			}
+			block = bigger;
+			capacity = grown;
+		}
+	}
+
+	offset = 0;
+	overflow_used = 0;
+}
+
+// ------------------------------------------------------------------------------
+
+JojEngine::FrameArena::FrameArena()
+{
+	count = 0;
+	index = 0;
+}
+
+JojEngine::FrameArena::~FrameArena()
+{
+}
+
+b8 JojEngine::FrameArena::init(u32 count, u64 capacity)
+{
+	this->count = count > 0 ? count : 1;
+	index = 0;
+
+	arenas = std::make_unique<LinearArena[]>(this->count);
+	for (u32 i = 0; i < this->count; ++i)
+	{
+		if (!arenas[i].init(capacity))
+		{
+			shutdown();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void JojEngine::FrameArena::shutdown()
+{
+	arenas.reset();
+	count = 0;
+	index = 0;
+}
+
+void JojEngine::FrameArena::begin_frame()
+{
+	index = index + 1 < count ? index + 1 : 0;
+	arenas[index].reset();
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include "defines.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace JojEngine
+{
+	// Initial bytes of each engine frame arena (they grow to the peak use)
+	const u64 FRAME_ARENA_CAPACITY = 1 << 20;
+
+	/* Linear (bump) allocator
+	 * allocate() moves a pointer through one preallocated block and reset()
+	 * frees everything at once. Nothing is freed individually and
+	 * destructors are never run, so only trivially destructible objects (or
+	 * containers whose contents live in the arena too) belong in it.
+	 * Requests that don't fit go to overflow blocks from the heap, which
+	 * reset() frees while growing the main block to the peak seen, so a
+	 * steady workload stops touching the heap after its first frames.
+	 * Not thread safe: give each thread its own arena.
+	 */
+	class LinearArena
+	{
+	public:
+		LinearArena();
+		~LinearArena();
+
+		LinearArena(const LinearArena&) = delete;
+		LinearArena& operator=(const LinearArena&) = delete;
+
+		// Allocate the main block
+		b8 init(u64 capacity);
+
+		// Free every block
+		void shutdown();
+
+		// Return size bytes aligned to alignment (a power of two)
+		void* allocate(u64 size, u64 alignment = alignof(std::max_align_t));
+
+		// Return uninitialized storage for count objects
+		template <typename T>
+		T* allocate_array(u64 count);
+
+		// Construct an object in the arena (its destructor will never run)
+		template <typename T, typename... Args>
+		T* create(Args&&... args);
+
+		// Free everything allocated since the last reset
+		void reset();
+
+		u64 get_used() const;			// Bytes handed out since reset (with alignment padding)
+		u64 get_capacity() const;		// Size of the main block
+		u64 get_peak() const;			// Most bytes used between two resets
+		u64 get_overflow_count() const;	// Allocations that went to the heap since init
+
+	private:
+		u8* block;					// Main block
+		u64 capacity;				// Size of block
+		u64 offset;					// Bytes used in block
+		u64 overflow_used;			// Bytes handed out from overflow blocks since reset
+		u64 peak;
+		u64 overflow_count;
+
+		struct OverflowBlock
+		{
+			void* block;
+			u64 size;				// Bytes reported to the memory tracker
+		};
+
+		std::vector<OverflowBlock> overflow;	// Heap blocks of requests that didn't fit
+
+		void* allocate_overflow(u64 size, u64 alignment);	// Heap block for a request that doesn't fit
+		void free_overflow();								// Release every overflow block
+	};
+
+	/* Arenas of consecutive frames
+	 * Engine resets one arena at the top of every loop iteration and the
+	 * others keep their contents, so memory allocated in a frame is valid
+	 * until count - 1 further frames begin. Two arenas are enough for the
+	 * serial loop, the pipelined loop uses depth + 2 so frames the render
+	 * thread is still drawing keep their data.
+	 */
+	class FrameArena
+	{
+	public:
+		FrameArena();
+		~FrameArena();
+
+		// Allocate count arenas of capacity bytes each
+		b8 init(u32 count, u64 capacity);
+
+		// Free every arena
+		void shutdown();
+
+		// Switch to the next arena and reset it
+		void begin_frame();
+
+		// Return arena of the current frame
+		LinearArena& current();
+
+		// Allocate from the arena of the current frame
+		void* allocate(u64 size, u64 alignment = alignof(std::max_align_t));
+
+		// Return number of arenas in rotation
+		u32 get_count() const;
+
+	private:
+		std::unique_ptr<LinearArena[]> arenas;
+		u32 count;
+		u32 index;
+	};
+
+	/* STL allocator adapter. Containers using it allocate from the arena and
+	 * never give memory back, they must not outlive its next reset.
+	 */
+	template <typename T>
+	class ArenaAllocator
+	{
+	public:
+		typedef T value_type;
+
+		explicit ArenaAllocator(LinearArena* arena) : arena(arena) {}
+
+		template <typename U>
+		ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+		T* allocate(std::size_t count)
+		{ return arena->allocate_array<T>(count); }
+
+		void deallocate(T*, std::size_t)
+		{}
+
+		template <typename U>
+		b8 operator==(const ArenaAllocator<U>& other) const
+		{ return arena == other.arena; }
+
+		template <typename U>
+		b8 operator!=(const ArenaAllocator<U>& other) const
+		{ return arena != other.arena; }
+
+	private:
+		template <typename U> friend class ArenaAllocator;
+
+		LinearArena* arena;
+	};
+
+	// Vector in an arena, e.g. FrameVector<u32> ids(ArenaAllocator<u32>(&arena))
+	template <typename T>
+	using FrameVector = std::vector<T, ArenaAllocator<T>>;
+
+	template <typename T>
+	inline T* LinearArena::allocate_array(u64 count)
+	{ return (T*)allocate(count * sizeof(T), alignof(T)); }
+
+	template <typename T, typename... Args>
+	inline T* LinearArena::create(Args&&... args)
+	{ return new (allocate(sizeof(T), alignof(T))) T(static_cast<Args&&>(args)...); }
+
+	inline void* LinearArena::allocate(u64 size, u64 alignment)
+	{
+		u64 base = u64(uintptr_t(block));
+		u64 start = ((base + offset + alignment - 1) & ~(alignment - 1)) - base;
+		if (start + size > capacity)
+			return allocate_overflow(size, alignment);
+
+		offset = start + size;
+		return block + start;
+	}
+
+	inline u64 LinearArena::get_used() const
+	{ return offset + overflow_used; }
+
+	inline u64 LinearArena::get_capacity() const
+	{ return capacity; }
+
+	inline u64 LinearArena::get_peak() const
+	{ return peak > get_used() ? peak : get_used(); }
+
+	inline u64 LinearArena::get_overflow_count() const
+	{ return overflow_count; }
+
+	inline LinearArena& FrameArena::current()
+	{ return arenas[index]; }
+
+	inline void* FrameArena::allocate(u64 size, u64 alignment)
+	{ return arenas[index].allocate(size, alignment); }
+
+	inline u32 FrameArena::get_count() const
+	{ return count; }
+}
@@ -0,0 +1,134 @@
+#include "frame_pipeline.h"
+
+#include "profiler.h"
+
+JojEngine::FramePipeline::FramePipeline() :
+	slots(),
+	depth(0),
+	slot_count(0),
+	write_slot(0),
+	read_slot(0),
+	in_flight(0),
+	frames_submitted(0),
+	frames_rendered(0),
+	render(nullptr),
+	user(nullptr),
+	running(false),
+	quit(false)
+{
+}
+
+JojEngine::FramePipeline::~FramePipeline()
+{
+	shutdown();
+}
+
+b8 JojEngine::FramePipeline::init(u32 depth, FrameSnapshot** snapshots, FrameRenderFunc render, void* user)
+{
+	if (running || !snapshots || !render)
+		return false;
+
+	depth = depth < 1 ? 1 : (depth > MAX_PIPELINE_DEPTH ? MAX_PIPELINE_DEPTH : depth);
+
+	for (u32 i = 0; i < depth + 1; ++i)
+	{
+		if (!snapshots[i])
+			return false;
+		slots[i] = snapshots[i];
+	}
+
+	this->depth = depth;
+	this->render = render;
+	this->user = user;
+	slot_count = depth + 1;
+	write_slot = 0;
+	read_slot = 0;
+	in_flight = 0;
+	frames_submitted = 0;
+	frames_rendered.store(0, std::memory_order_relaxed);
+	quit = false;
+	running = true;
+
+	render_thread = std::thread(&FramePipeline::render_main, this);
+	return true;
+}
+
+void JojEngine::FramePipeline::shutdown()
+{
+	if (!running)
+		return;
+
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		quit = true;
+	}
+	frame_ready.notify_one();
+
+	render_thread.join();
+	running = false;
+}
+
+// ------------------------------------------------------------------------------
+
+JojEngine::FrameSnapshot* JojEngine::FramePipeline::begin_frame()
+{
+	// A slot is free when fewer than depth + 1 frames are queued or rendering
+	std::unique_lock<std::mutex> guard(lock);
+	slot_freed.wait(guard, [this]() { return in_flight < slot_count; });
+
+	FrameSnapshot* snapshot = slots[write_slot];
+	snapshot->frame = frames_submitted;
+	return snapshot;
+}
+
+void JojEngine::FramePipeline::end_frame()
+{
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		write_slot = (write_slot + 1) % slot_count;
+		in_flight++;
+		frames_submitted++;
+	}
+	frame_ready.notify_one();
+}
+
+void JojEngine::FramePipeline::flush()
+{
+	std::unique_lock<std::mutex> guard(lock);
+	slot_freed.wait(guard, [this]() { return in_flight == 0; });
+}
+
+// ------------------------------------------------------------------------------
+
+void JojEngine::FramePipeline::render_main()
+{
+	Profiler::set_thread_name("Render");
+
+	for (;;)
+	{
+		FrameSnapshot* snapshot = nullptr;
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			frame_ready.wait(guard, [this]() { return in_flight > 0 || quit; });
+
+			// Submitted frames are still rendered after quit
+			if (in_flight == 0)
+				break;
+
+			snapshot = slots[read_slot];
+		}
+
+		{
+			FPROFILE_ZONE("draw_snapshot");
+			render(snapshot, user);
+		}
+
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			read_slot = (read_slot + 1) % slot_count;
+			in_flight--;
+		}
+		frames_rendered.fetch_add(1, std::memory_order_release);
+		slot_freed.notify_all();
+	}
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "defines.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace JojEngine
+{
+	/* Pipelined frame execution
+	 * The main thread simulates frame N+1 into a snapshot while a render
+	 * thread draws and presents the snapshot of frame N, so the CPU keeps
+	 * working while present/fence waits block the render thread.
+	 * depth is how many frames the simulation may run ahead of the frame
+	 * being rendered: depth + 1 snapshots rotate between the two threads.
+	 * More depth hides longer render stalls at the cost of input latency.
+	 */
+
+	// Most frames the simulation may run ahead of rendering
+	const u32 MAX_PIPELINE_DEPTH = 3;
+
+	// Everything draw needs from a simulated frame, games derive from it
+	struct FrameSnapshot
+	{
+		u64 frame = 0;			// Frame number, set by FramePipeline::begin_frame
+		f32 frametime = 0.0f;	// Frametime the frame was simulated with
+		f32 alpha = 1.0f;		// Fraction of a tick to interpolate by when drawing (fixed timestep)
+
+		virtual ~FrameSnapshot() {}
+	};
+
+	// Render thread body: draw and present snapshot
+	typedef void(*FrameRenderFunc)(FrameSnapshot* snapshot, void* user);
+
+	class FramePipeline
+	{
+	public:
+		FramePipeline();
+		~FramePipeline();
+
+		/* @brief Start the render thread. snapshots holds depth + 1 entries
+		 * owned by the caller, depth is clamped to [1, MAX_PIPELINE_DEPTH].
+		 */
+		b8 init(u32 depth, FrameSnapshot** snapshots, FrameRenderFunc render, void* user);
+
+		// Render every submitted frame and stop the render thread
+		void shutdown();
+
+		// Return free snapshot to simulate the next frame into, blocks while depth frames are in flight
+		FrameSnapshot* begin_frame();
+
+		// Hand the snapshot returned by begin_frame to the render thread
+		void end_frame();
+
+		// Block until every submitted frame was rendered
+		void flush();
+
+		// Return number of frames the simulation may run ahead
+		u32 get_depth() const
+		{ return depth; }
+
+		// Return number of frames the render thread finished
+		u64 get_frames_rendered() const
+		{ return frames_rendered.load(std::memory_order_acquire); }
+
+		// Return true between init and shutdown
+		b8 is_running() const
+		{ return running; }
+
+	private:
+		FrameSnapshot* slots[MAX_PIPELINE_DEPTH + 1];	// Snapshot ring
+		u32 depth;										// Frames in flight allowed
+		u32 slot_count;									// depth + 1
+
+		u32 write_slot;					// Next slot the simulation writes (main thread)
+		u32 read_slot;					// Next slot the render thread draws (render thread)
+		u32 in_flight;					// Submitted slots not rendered yet
+		u64 frames_submitted;			// Frame counter of the simulation
+
+		std::atomic<u64> frames_rendered;
+
+		FrameRenderFunc render;
+		void* user;
+
+		std::mutex lock;
+		std::condition_variable slot_freed;		// Render thread finished a slot
+		std::condition_variable frame_ready;	// Simulation submitted a slot
+		std::thread render_thread;
+		b8 running;
+		b8 quit;
+
+		void render_main();				// Render thread body
+	};
+}
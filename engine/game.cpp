@@ -2,9 +2,14 @@
 
 #include "engine.h"
 
+#if PLATFORM_WINDOWS || PLATFORM_LINUX
+
 // Static members
 JojPlatform::Window* JojEngine::Game::window = nullptr;	// Pointer to window
 JojPlatform::Input* JojEngine::Game::input = nullptr;		// Pointer to input
+JojEngine::JobSystem* JojEngine::Game::jobs = nullptr;		// Pointer to job scheduler
+JojEngine::TimerWheel* JojEngine::Game::timers = nullptr;	// Pointer to gameplay timers
+JojEngine::FrameArena* JojEngine::Game::frame_arena = nullptr;	// Pointer to per-frame memory
 
 JojEngine::Game::Game()
 {
@@ -19,3 +24,5 @@ JojEngine::Game::Game()
 JojEngine::Game::~Game()
 {
 }
+
+#endif // PLATFORM_WINDOWS || PLATFORM_LINUX
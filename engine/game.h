@@ -2,9 +2,16 @@
 
 #include "defines.h"
 
-#if PLATFORM_WINDOWS
 #include "platform_manager.h"
-#endif	// PLATFORM_WINDOWS
+
+#include "frame_pipeline.h"
+#include "job_system.h"
+#include "timer_wheel.h"
+#include "frame_arena.h"
+#include <chrono>
+#include <thread>
+
+#if PLATFORM_WINDOWS || PLATFORM_LINUX
 
 namespace JojEngine
 {
@@ -28,10 +35,47 @@ namespace JojEngine
 
 		virtual void draw(){}					// Draw game (every cicle)
 		virtual void display(){}				// Display game (call manually when screen needs to be redrawn)
-		virtual void on_pause() { Sleep(10); }	// On pause
+		virtual void on_pause() { std::this_thread::sleep_for(std::chrono::milliseconds(10)); }	// On pause
+
+		/* Pipelined loop (Engine::set_pipeline_depth): games that return a
+		 * snapshot from create_snapshot() run update() on the main thread
+		 * followed by write_snapshot(), which copies everything drawing needs.
+		 * draw_snapshot() then runs on the render thread, one to depth frames
+		 * behind, and must only read the snapshot and use the renderer.
+		 * Other games keep the serial update/draw loop.
+		 */
+
+		virtual FrameSnapshot* create_snapshot() { return nullptr; }			// Allocate one snapshot (called depth + 1 times)
+		virtual void write_snapshot(FrameSnapshot*) {}							// Copy frame state after update (main thread)
+		virtual void draw_snapshot(const FrameSnapshot*) {}						// Draw and present snapshot (render thread)
+
+		// Return simulation ticks per second (0 = one variable update per frame)
+		f32 get_tick_rate() const { return tick_rate; }
+
+		// Return most fixed ticks simulated in one frame
+		u32 get_max_steps() const { return max_steps; }
 
 	protected:
+		friend class Engine;
+
 		static JojPlatform::Window* window;
 		static JojPlatform::Input* input;
+		static JojEngine::JobSystem* jobs;	// Engine job scheduler (run, wait, parallel_for)
+		static JojEngine::TimerWheel* timers;	// Gameplay timers, in game time (Engine::game_time)
+		static JojEngine::FrameArena* frame_arena;	// Memory valid until the next frames reuse it (FrameArena)
+
+		/* @brief Simulate in fixed ticks of 1 / tick_rate seconds (0 = variable).
+		 * update() runs up to max_steps times per frame with Engine::frametime
+		 * equal to the tick, draw() interpolates by Engine::alpha.
+		 * Call from the constructor or init().
+		 */
+		void set_fixed_timestep(f32 tick_rate, u32 max_steps = 5)
+		{ this->tick_rate = tick_rate; this->max_steps = max_steps; }
+
+	private:
+		f32 tick_rate = 0.0f;		// Simulation ticks per second (0 = variable)
+		u32 max_steps = 5;			// Most ticks per frame
 	};
-}
\ No newline at end of file
+}
+
+#endif // PLATFORM_WINDOWS || PLATFORM_LINUX
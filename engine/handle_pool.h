@@ -0,0 +1,203 @@
+#pragma once
+
+#include "defines.h"
+
+#include <utility>
+#include <vector>
+
+namespace JojEngine
+{
+	/* Generational handle
+	 * Refers to an object in a Pool<T> by slot index and the generation the
+	 * slot had when the object was created. Freeing an object bumps the
+	 * generation, so handles to it (and to anything freed before) are
+	 * detected as stale instead of reaching whatever reuses the slot.
+	 * The default handle (generation 0) is never valid.
+	 */
+	template <typename T>
+	struct Handle
+	{
+		u32 index = 0;
+		u32 generation = 0;
+
+		b8 is_null() const { return generation == 0; }
+
+		b8 operator==(const Handle& other) const { return index == other.index && generation == other.generation; }
+		b8 operator!=(const Handle& other) const { return !(*this == other); }
+	};
+
+	/* Fixed-capacity object pool
+	 * Objects are stored densely (begin/end walk them contiguously, in no
+	 * particular order) and found through a slot table indexed by handle.
+	 * create, destroy and get are O(1): destroy moves the last object into
+	 * the hole, so pointers returned by get are only valid until the next
+	 * destroy. Capacity is fixed by init, create returns a null handle when
+	 * the pool is full. Handles are typed by Tag, so a backend can store its
+	 * own type T behind handles shared with code that never sees T.
+	 * Not thread safe.
+	 */
+	template <typename T, typename Tag = T>
+	class Pool
+	{
+	public:
+		Pool() {}
+		~Pool() {}
+
+		// Reserve room for capacity objects, destroys current ones (their handles stay stale)
+		b8 init(u32 capacity);
+
+		// Destroy every object, handles given out become stale
+		void clear();
+
+		// Construct an object, return its handle (null if the pool is full)
+		template <typename... Args>
+		Handle<Tag> create(Args&&... args);
+
+		// Destroy object, return false if handle is stale
+		b8 destroy(Handle<Tag> handle);
+
+		// Return object of handle, nullptr if it is stale
+		T* get(Handle<Tag> handle);
+		const T* get(Handle<Tag> handle) const;
+
+		// Return true if handle refers to a live object
+		b8 is_alive(Handle<Tag> handle) const;
+
+		// Return handle of the object at position i of the dense storage
+		Handle<Tag> get_handle(u32 i) const;
+
+		u32 get_count() const;			// Live objects
+		u32 get_capacity() const;		// Most live objects
+
+		T* begin() { return items.data(); }
+		T* end() { return items.data() + items.size(); }
+		const T* begin() const { return items.data(); }
+		const T* end() const { return items.data() + items.size(); }
+
+	private:
+		static const u32 NONE = 0xFFFFFFFF;
+
+		struct Slot
+		{
+			u32 dense;			// Position in items, or next free slot while unused
+			u32 generation;		// Handles must match it, bumped on destroy
+		};
+
+		std::vector<T> items;				// Live objects, contiguous
+		std::vector<u32> owners;			// Slot of each entry of items
+		std::vector<Slot> slots;
+		u32 free_slot = NONE;				// First unused slot
+		u32 capacity = 0;
+	};
+
+	template <typename T, typename Tag>
+	inline b8 Pool<T, Tag>::init(u32 capacity)
+	{
+		// Slots keep their generations, handles from before init must not match new objects
+		clear();
+		this->capacity = capacity;
+
+		items.reserve(capacity);
+		owners.reserve(capacity);
+		slots.reserve(capacity);
+
+		return true;
+	}
+
+	template <typename T, typename Tag>
+	inline void Pool<T, Tag>::clear()
+	{
+		// Bump every live slot so old handles go stale, then chain all slots as free
+		for (u32 slot : owners)
+			slots[slot].generation = slots[slot].generation + 1 ? slots[slot].generation + 1 : 1;
+
+		items.clear();
+		owners.clear();
+
+		free_slot = NONE;
+		for (u32 i = u32(slots.size()); i-- > 0;)
+		{
+			slots[i].dense = free_slot;
+			free_slot = i;
+		}
+	}
+
+	template <typename T, typename Tag>
+	template <typename... Args>
+	inline Handle<Tag> Pool<T, Tag>::create(Args&&... args)
+	{
+		if (u32(items.size()) >= capacity)
+			return Handle<Tag>();
+
+		u32 slot = free_slot;
+		if (slot != NONE)
+		{
+			free_slot = slots[slot].dense;
+		}
+		else
+		{
+			slot = u32(slots.size());
+			slots.push_back({ NONE, 1 });
+		}
+
+		slots[slot].dense = u32(items.size());
+		items.emplace_back(std::forward<Args>(args)...);
+		owners.push_back(slot);
+
+		return { slot, slots[slot].generation };
+	}
+
+	template <typename T, typename Tag>
+	inline b8 Pool<T, Tag>::destroy(Handle<Tag> handle)
+	{
+		if (!is_alive(handle))
+			return false;
+
+		Slot& slot = slots[handle.index];
+		u32 dense = slot.dense;
+		u32 last = u32(items.size()) - 1;
+
+		// Fill the hole with the last object
+		if (dense != last)
+		{
+			items[dense] = std::move(items[last]);
+			owners[dense] = owners[last];
+			slots[owners[dense]].dense = dense;
+		}
+		items.pop_back();
+		owners.pop_back();
+
+		// Generation 0 is reserved for null handles
+		slot.generation = slot.generation + 1 ? slot.generation + 1 : 1;
+		slot.dense = free_slot;
+		free_slot = handle.index;
+		return true;
+	}
+
+	template <typename T, typename Tag>
+	inline b8 Pool<T, Tag>::is_alive(Handle<Tag> handle) const
+	{
+		// Unused slots were bumped past every handle given out for them
+		return handle.generation != 0 && handle.index < slots.size() && slots[handle.index].generation == handle.generation;
+	}
+
+	template <typename T, typename Tag>
+	inline T* Pool<T, Tag>::get(Handle<Tag> handle)
+	{ return is_alive(handle) ? &items[slots[handle.index].dense] : nullptr; }
+
+	template <typename T, typename Tag>
+	inline const T* Pool<T, Tag>::get(Handle<Tag> handle) const
+	{ return is_alive(handle) ? &items[slots[handle.index].dense] : nullptr; }
+
+	template <typename T, typename Tag>
+	inline Handle<Tag> Pool<T, Tag>::get_handle(u32 i) const
+	{ return { owners[i], slots[owners[i]].generation }; }
+
+	template <typename T, typename Tag>
+	inline u32 Pool<T, Tag>::get_count() const
+	{ return u32(items.size()); }
+
+	template <typename T, typename Tag>
+	inline u32 Pool<T, Tag>::get_capacity() const
+	{ return capacity; }
+}
@@ -0,0 +1,269 @@
+#include "job_system.h"
+
+#include "profiler.h"
+
+// Index of the calling thread in JobSystem::queues, NO_WORKER for other threads
+static const u32 NO_WORKER = ~0u;
+static thread_local u32 worker_index = NO_WORKER;
+
+JojEngine::JobSystem::JobSystem() :
+	pending(0),
+	next_queue(0),
+	running(false),
+	quit(false)
+{
+}
+
+JojEngine::JobSystem::~JobSystem()
+{
+	shutdown();
+}
+
+b8 JojEngine::JobSystem::init(u32 worker_count)
+{
+	if (running)
+		return true;
+
+	if (worker_count == 0)
+	{
+		worker_count = std::thread::hardware_concurrency();
+		worker_count = worker_count ? worker_count : 1;
+	}
+
+	for (u32 i = 0; i < worker_count; ++i)
+		queues.push_back(std::make_unique<WorkerQueue>());
+
+	quit = false;
+	running = true;
+	worker_index = 0;
+
+	threads.reserve(worker_count - 1);
+	for (u32 i = 1; i < worker_count; ++i)
+		threads.emplace_back(&JobSystem::worker_main, this, i);
+
+	return true;
+}
+
+void JojEngine::JobSystem::shutdown()
+{
+	if (!running)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(sleep_lock);
+		quit = true;
+	}
+	wake_up.notify_all();
+
+	// Help the workers drain what is left
+	while (pending.load(std::memory_order_acquire) > 0)
+	{
+		if (!try_run_one())
+			std::this_thread::yield();
+	}
+
+	for (std::thread& thread : threads)
+		thread.join();
+
+	threads.clear();
+	queues.clear();
+	running = false;
+	worker_index = NO_WORKER;
+}
+
+// ------------------------------------------------------------------------------
+
+void JojEngine::JobSystem::run(const Job& job)
+{
+	run(&job, 1);
+}
+
+void JojEngine::JobSystem::run(JobFunc func, void* data, JobCounter* counter)
+{
+	Job job = { func, data, counter };
+	run(&job, 1);
+}
+
+void JojEngine::JobSystem::run(const Job* jobs, u32 count)
+{
+	for (u32 i = 0; i < count; ++i)
+		if (jobs[i].counter)
+			jobs[i].counter->value.fetch_add(1, std::memory_order_relaxed);
+
+	submit(jobs, count);
+}
+
+void JojEngine::JobSystem::run_after(JobCounter* dependency, const Job& job)
+{
+	{
+		std::lock_guard<std::mutex> lock(dependency->lock);
+		if (dependency->value.load(std::memory_order_acquire) != 0)
+		{
+			// Count it now so a wait() on job.counter also covers the deferred job
+			if (job.counter)
+				job.counter->value.fetch_add(1, std::memory_order_relaxed);
+
+			dependency->continuations.push_back(job);
+			return;
+		}
+	}
+
+	run(job);
+}
+
+void JojEngine::JobSystem::wait(JobCounter* counter)
+{
+	while (counter->value.load(std::memory_order_acquire) != 0)
+	{
+		if (!try_run_one())
+			std::this_thread::yield();
+	}
+
+	// The last job may still hold the lock while releasing continuations
+	std::lock_guard<std::mutex> sync(counter->lock);
+}
+
+// ------------------------------------------------------------------------------
+
+void JojEngine::JobSystem::submit(const Job* jobs, u32 count)
+{
+	// Not started or shut down: run inline
+	if (!running)
+	{
+		for (u32 i = 0; i < count; ++i)
+			execute(jobs[i]);
+		return;
+	}
+
+	for (u32 i = 0; i < count; ++i)
+		push(jobs[i]);
+
+	wake_workers(count);
+}
+
+void JojEngine::JobSystem::push(const Job& job)
+{
+	u32 count = u32(queues.size());
+	u32 index = worker_index < count ? worker_index : next_queue.fetch_add(1, std::memory_order_relaxed) % count;
+
+	{
+		std::lock_guard<std::mutex> lock(queues[index]->lock);
+		queues[index]->jobs.push_back(job);
+	}
+
+	pending.fetch_add(1, std::memory_order_release);
+}
+
+void JojEngine::JobSystem::wake_workers(u32 count)
+{
+	if (threads.empty())
+		return;
+
+	// Workers check pending under sleep_lock, taking it here means none can miss this wake up
+	{
+		std::lock_guard<std::mutex> lock(sleep_lock);
+	}
+
+	if (count >= threads.size())
+		wake_up.notify_all();
+	else
+		for (u32 i = 0; i < count; ++i)
+			wake_up.notify_one();
+}
+
+b8 JojEngine::JobSystem::try_run_one()
+{
+	u32 count = u32(queues.size());
+	if (count == 0 || pending.load(std::memory_order_acquire) == 0)
+		return false;
+
+	Job job = {};
+	b8 found = false;
+
+	// Own deque first, newest job
+	if (worker_index < count)
+	{
+		WorkerQueue& own = *queues[worker_index];
+		std::lock_guard<std::mutex> lock(own.lock);
+		if (!own.jobs.empty())
+		{
+			job = own.jobs.back();
+			own.jobs.pop_back();
+			found = true;
+		}
+	}
+
+	// Steal the oldest job of another worker
+	u32 start = worker_index < count ? worker_index + 1 : 0;
+	for (u32 i = 0; !found && i < count; ++i)
+	{
+		u32 victim = (start + i) % count;
+		if (victim == worker_index)
+			continue;
+
+		WorkerQueue& other = *queues[victim];
+		std::lock_guard<std::mutex> lock(other.lock);
+		if (!other.jobs.empty())
+		{
+			job = other.jobs.front();
+			other.jobs.pop_front();
+			found = true;
+		}
+	}
+
+	if (!found)
+		return false;
+
+	pending.fetch_sub(1, std::memory_order_acq_rel);
+	execute(job);
+	return true;
+}
+
+void JojEngine::JobSystem::execute(const Job& job)
+{
+	job.func(job.data);
+
+	JobCounter* counter = job.counter;
+	if (!counter)
+		return;
+
+	// Not the last job: the waiter can't return before our decrement, and we don't touch counter after it
+	u32 value = counter->value.load(std::memory_order_relaxed);
+	while (value > 1)
+	{
+		if (counter->value.compare_exchange_weak(value, value - 1, std::memory_order_acq_rel))
+			return;
+	}
+
+	// Last job: reach zero under the lock, wait() takes it too before the counter can go away
+	std::vector<Job> ready;
+	{
+		std::lock_guard<std::mutex> lock(counter->lock);
+		if (counter->value.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			ready.swap(counter->continuations);
+	}
+
+	// Continuations were already counted on their counters by run_after
+	if (!ready.empty())
+		submit(ready.data(), u32(ready.size()));
+}
+
+void JojEngine::JobSystem::worker_main(u32 index)
+{
+	worker_index = index;
+	Profiler::set_thread_name("Worker");
+
+	for (;;)
+	{
+		if (try_run_one())
+			continue;
+
+		std::unique_lock<std::mutex> lock(sleep_lock);
+		wake_up.wait(lock, [this]() { return pending.load(std::memory_order_acquire) > 0 || quit; });
+
+		if (quit && pending.load(std::memory_order_acquire) == 0)
+			break;
+	}
+
+	worker_index = NO_WORKER;
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "defines.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace JojEngine
+{
+	/* Work-stealing job scheduler
+	 * Every worker owns a deque: it pushes and pops its own jobs at the back
+	 * (newest first, still hot in cache) and idle workers steal from the front
+	 * of other deques (oldest first, usually the biggest pieces of work).
+	 * The thread that calls init() is worker 0 and runs jobs whenever it
+	 * waits on a counter, so it never sits idle while its jobs are pending.
+	 * Jobs must not block on anything but JobSystem::wait.
+	 */
+
+	class JobSystem;
+	struct JobCounter;
+
+	// Job body
+	typedef void(*JobFunc)(void* data);
+
+	struct Job
+	{
+		JobFunc func;			// Job body
+		void* data;				// Argument of func, must outlive the job
+		JobCounter* counter;	// Decremented when the job finishes, can be nullptr
+	};
+
+	/* @brief Number of unfinished jobs attached to it. run() increments it
+	 * and every finished job decrements it. Jobs given to run_after() start
+	 * when it reaches zero. Must outlive its jobs.
+	 */
+	struct JobCounter
+	{
+		std::atomic<u32> value{ 0 };
+
+		// Return true if all attached jobs finished
+		b8 done() const { return value.load(std::memory_order_acquire) == 0; }
+
+	private:
+		friend class JobSystem;
+
+		std::mutex lock;				// Protects continuations
+		std::vector<Job> continuations;	// Jobs waiting for value to reach zero
+	};
+
+	class JobSystem
+	{
+	public:
+		JobSystem();
+		~JobSystem();
+
+		// Start worker_count - 1 threads (0 = one worker per hardware thread), calling thread becomes worker 0
+		b8 init(u32 worker_count = 0);
+
+		// Finish all queued jobs and join workers, later jobs run inline on the caller
+		void shutdown();
+
+		// Queue job, job.counter (if any) is incremented first
+		void run(const Job& job);
+
+		// Queue func(data) and attach it to counter
+		void run(JobFunc func, void* data, JobCounter* counter);
+
+		// Queue count jobs at once, waking workers only once
+		void run(const Job* jobs, u32 count);
+
+		// Queue job once dependency reaches zero (immediately if it already did)
+		void run_after(JobCounter* dependency, const Job& job);
+
+		// Run queued jobs on the calling thread until counter reaches zero
+		void wait(JobCounter* counter);
+
+		/* @brief Call func(begin, end) over [0, count) in ranges of at most
+		 * batch_size items spread across workers, return when all ranges ran.
+		 * The calling thread takes part in the work.
+		 */
+		template <typename Func>
+		void parallel_for(u32 count, u32 batch_size, const Func& func);
+
+		// Return number of workers, including the thread that called init
+		u32 get_worker_count() const
+		{ return u32(queues.size()); }
+
+		// Return true between init and shutdown
+		b8 is_running() const
+		{ return running; }
+
+	private:
+		struct WorkerQueue
+		{
+			std::mutex lock;
+			std::deque<Job> jobs;
+		};
+
+		std::vector<std::unique_ptr<WorkerQueue>> queues;	// One deque per worker
+		std::vector<std::thread> threads;					// Workers 1..n-1
+
+		std::atomic<u32> pending;			// Queued jobs not picked up yet
+		std::atomic<u32> next_queue;		// Round robin target of threads that aren't workers
+		std::mutex sleep_lock;				// Idle workers sleep on wake_up
+		std::condition_variable wake_up;
+		b8 running;
+		b8 quit;
+
+		void submit(const Job* jobs, u32 count);	// Queue counted jobs (inline when not running)
+		void push(const Job& job);			// Push job on the calling worker's deque
+		void wake_workers(u32 count);		// Wake sleeping workers for count new jobs
+		b8 try_run_one();					// Pop or steal one job and run it
+		void execute(const Job& job);		// Run job and signal its counter
+		void worker_main(u32 index);		// Worker thread body
+	};
+
+	// ------------------------------------------------------------------------------
+
+	template <typename Func>
+	void JobSystem::parallel_for(u32 count, u32 batch_size, const Func& func)
+	{
+		if (count == 0)
+			return;
+
+		batch_size = batch_size ? batch_size : 1;
+		u32 batches = (count + batch_size - 1) / batch_size;
+
+		if (batches == 1 || !running)
+		{
+			func(0u, count);
+			return;
+		}
+
+		struct Range
+		{
+			const Func* func;
+			u32 begin;
+			u32 end;
+		};
+
+		std::vector<Range> ranges(batches);
+		std::vector<Job> jobs(batches);
+		JobCounter counter;
+
+		for (u32 b = 0; b < batches; ++b)
+		{
+			u32 begin = b * batch_size;
+			ranges[b] = { &func, begin, begin + batch_size < count ? begin + batch_size : count };
+			jobs[b] = { [](void* data) { Range* r = (Range*)data; (*r->func)(r->begin, r->end); }, &ranges[b], &counter };
+		}
+
+		run(jobs.data(), batches);
+		wait(&counter);
+	}
+}
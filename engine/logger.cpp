@@ -2,6 +2,113 @@
 
 #include <stdio.h>
 #include <stdarg.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// ------------------------------------------------------------------------------
+// Channels
+// ------------------------------------------------------------------------------
+
+std::atomic<u8> log_channel_levels[LOG_CHANNEL_COUNT] = {
+    LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL
+};
+
+static const char* channel_names[LOG_CHANNEL_COUNT] = {
+    "engine", "renderer", "platform", "game"
+};
+
+static const char* level_names[5] = {
+    "fatal", "error", "warn", "debug", "info"
+};
+
+const char* log_channel_name(LogChannel channel)
+{
+    return u32(channel) < LOG_CHANNEL_COUNT ? channel_names[channel] : "unknown";
+}
+
+void log_set_level(LogChannel channel, LogLevel level)
+{
+    if (u32(channel) < LOG_CHANNEL_COUNT)
+        log_channel_levels[channel].store(u8(level), std::memory_order_relaxed);
+}
+
+LogLevel log_get_level(LogChannel channel)
+{
+    return LogLevel(log_channel_levels[channel].load(std::memory_order_relaxed));
+}
+
+// Return index of the length characters at name in names, -1 if absent
+static i32 find_name(const char* const* names, i32 count, const char* name, size_t length)
+{
+    for (i32 i = 0; i < count; ++i)
+        if (strlen(names[i]) == length && strncmp(names[i], name, length) == 0)
+            return i;
+    return -1;
+}
+
+b8 log_parse_levels(const char* spec)
+{
+    b8 ok = true;
+
+    while (spec && *spec)
+    {
+        const char* end = strchr(spec, ',');
+        size_t length = end ? size_t(end - spec) : strlen(spec);
+        const char* equals = (const char*)memchr(spec, '=', length);
+
+        if (equals)
+        {
+            i32 channel = find_name(channel_names, LOG_CHANNEL_COUNT, spec, size_t(equals - spec));
+            i32 level = find_name(level_names, 5, equals + 1, length - size_t(equals + 1 - spec));
+            if (channel >= 0 && level >= 0)
+                log_set_level(LogChannel(channel), LogLevel(level));
+            else
+                ok = false;
+        }
+        else if (length > 0)
+        {
+            i32 level = find_name(level_names, 5, spec, length);
+            if (level >= 0)
+                for (u32 channel = 0; channel < LOG_CHANNEL_COUNT; ++channel)
+                    log_set_level(LogChannel(channel), LogLevel(level));
+            else
+                ok = false;
+        }
+
+        spec = end ? end + 1 : nullptr;
+    }
+
+    return ok;
+}
+
+b8 log_rate_allow(LogRateLimit& limit, LogChannel channel, LogLevel level, u32 per_second)
+{
+    i64 now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    // First call of a new second: restart the count and report what the last ones dropped
+    i64 window = limit.window.load(std::memory_order_relaxed);
+    if (window != now && limit.window.compare_exchange_strong(window, now, std::memory_order_relaxed))
+    {
+        limit.count.store(0, std::memory_order_relaxed);
+        u32 suppressed = limit.suppressed.exchange(0, std::memory_order_relaxed);
+        if (suppressed)
+            log_output(channel, level, OK, "(%u similar messages suppressed)", suppressed);
+    }
+
+    if (limit.count.fetch_add(1, std::memory_order_relaxed) < per_second)
+        return true;
+
+    limit.suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+// ------------------------------------------------------------------------------
 
 #if PLATFORM_WINDOWS
 #include <Windows.h>
@@ -11,16 +118,10 @@ void log_output2(LogLevel level, const char* message)
     printf("PRINTEI\n");
 }
 
-void log_output(LogLevel level, enum Error err, const char* message, ...)
+// Add level prefix and colors to message and write it to the console
+static void write_message(LogChannel channel, LogLevel level, enum Error err, const char* out_msg)
 {
-    // Setup for sprintf and then printf
-    char out_msg[1000];
-    char out_msg2[1000];
-    memset(out_msg, 0, sizeof(out_msg));
-
-    va_list arg_ptr;
-    va_start(arg_ptr, message);
-    vsnprintf(out_msg, 1000, message, arg_ptr);
+    char out_msg2[LOG_MESSAGE_SIZE + 64];
 
     // Colors (Windows)
     WORD color_attributes[5] = {
@@ -40,13 +141,13 @@ void log_output(LogLevel level, enum Error err, const char* message, ...)
     };
 
     const char* level_strings[5] = {
-        "[FATAL]: ", "[ERROR]: ", "[WARN]: ", "[DEBUG]: ", "[INFO]: "
+        "[FATAL]", "[ERROR]", "[WARN]", "[DEBUG]", "[INFO]"
     };
 
     // FATAL log
     if (level == LOG_LEVEL_FATAL)
     {
-        sprintf(out_msg2, "%s%s%s", level_strings[level], error_strings[err], out_msg);
+        sprintf(out_msg2, "%s[%s]: %s%s", level_strings[level], log_channel_name(channel), error_strings[err], out_msg);
         SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE | BACKGROUND_RED);
         printf("%s\n", out_msg2);
         SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE); // Reset to default
@@ -55,14 +156,14 @@ void log_output(LogLevel level, enum Error err, const char* message, ...)
     // ERROR log
     else if (level == LOG_LEVEL_ERROR)
     {
-        sprintf(out_msg2, "%s%s%s", level_strings[level], error_strings[err], out_msg);
+        sprintf(out_msg2, "%s[%s]: %s%s", level_strings[level], log_channel_name(channel), error_strings[err], out_msg);
         SetConsoleTextAttribute(hConsole, color_attributes[level]);
         printf("%s\n", out_msg2);
         SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE); // Reset to default
         return;
     }
 
-    sprintf(out_msg2, "%s%s", level_strings[level], out_msg);
+    sprintf(out_msg2, "%s[%s]: %s", level_strings[level], log_channel_name(channel), out_msg);
     SetConsoleTextAttribute(hConsole, color_attributes[level]);
     printf("%s\n", out_msg2);
     SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE); // Reset to default
@@ -70,17 +171,10 @@ void log_output(LogLevel level, enum Error err, const char* message, ...)
 
 #else // PLATFORM_WINDOWS
 
-
-void log_output(LogLevel level, enum Error err, const char* message, ...)
+// Add level prefix and colors to message and write it to the console
+static void write_message(LogChannel channel, LogLevel level, enum Error err, const char* out_msg)
 {
-    // Setup for sprintf and then printf
-    char out_msg[1000];
-    char out_msg2[1000];
-    memset(out_msg, 0, sizeof(out_msg));
-
-    va_list arg_ptr;
-    va_start(arg_ptr, message);
-    vsnprintf(out_msg, 1000, message, arg_ptr);
+    char out_msg2[LOG_MESSAGE_SIZE + 64];
 
     /* Colors(Linux only) */
     const char* default_color = "\033[0m";
@@ -91,19 +185,269 @@ void log_output(LogLevel level, enum Error err, const char* message, ...)
     };
 
     const char* level_strings[5] = {
-        "[FATAL]: ", "[ERROR]: ", "[WARN]: ", "[DEBUG]: ", "[INFO]: "
+        "[FATAL]", "[ERROR]", "[WARN]", "[DEBUG]", "[INFO]"
     };
 
     // FATAL or ERROR log
     if (level < 2)
     {
-        sprintf(out_msg2, "%s%s%s", level_strings[level], error_strings[err], out_msg);
+        sprintf(out_msg2, "%s[%s]: %s%s", level_strings[level], log_channel_name(channel), error_strings[err], out_msg);
         printf("%s%s%s\n", color_strings[level], out_msg2, default_color);
         return;
     }
 
-    sprintf(out_msg2, "%s%s", level_strings[level], out_msg);
+    sprintf(out_msg2, "%s[%s]: %s", level_strings[level], log_channel_name(channel), out_msg);
     printf("%s%s%s\n", color_strings[level], out_msg2, default_color);
 }
 
-#endif
\ No newline at end of file
+#endif // PLATFORM_WINDOWS
+
+// ------------------------------------------------------------------------------
+// Asynchronous mode: bounded MPSC ring (Vyukov's sequence-numbered slots)
+// ------------------------------------------------------------------------------
+
+struct LogSlot
+{
+    std::atomic<u64> sequence;      // pos: free for producer pos, pos + 1: holds message pos
+    LogChannel channel;
+    LogLevel level;
+    enum Error err;
+    char text[LOG_MESSAGE_SIZE];
+};
+
+static std::unique_ptr<LogSlot[]> slots;
+static u64 slot_mask = 0;
+static LogOverflow overflow_policy = LOG_OVERFLOW_DROP;
+
+static std::atomic<u64> enqueue_pos{ 0 };       // Next slot producers claim
+static std::atomic<u64> dequeue_pos{ 0 };       // Next slot the writer reads (written by the writer only)
+static std::atomic<u64> dropped{ 0 };
+
+static std::atomic<b8> async_mode{ false };     // log_output enqueues
+static std::atomic<u32> producers{ 0 };         // Threads inside log_output while async_mode is set
+static std::atomic<b8> writer_quit{ false };
+static std::atomic<b8> writer_sleeping{ false };
+
+static std::mutex control_lock;                 // Serializes start and stop
+static std::mutex writer_lock;                  // Writer sleeps on writer_wake
+static std::condition_variable writer_wake;
+static std::thread writer;
+
+// Write queued messages, return false if the ring was empty
+static b8 drain()
+{
+    b8 wrote = false;
+    u64 pos = dequeue_pos.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+        LogSlot& slot = slots[pos & slot_mask];
+        if (slot.sequence.load(std::memory_order_acquire) != pos + 1)
+            break;
+
+        write_message(slot.channel, slot.level, slot.err, slot.text);
+
+        // Free the slot for the producer one lap ahead
+        slot.sequence.store(pos + slot_mask + 1, std::memory_order_release);
+        dequeue_pos.store(++pos, std::memory_order_release);
+        wrote = true;
+    }
+
+    if (wrote)
+        fflush(stdout);
+
+    return wrote;
+}
+
+static void writer_main()
+{
+    for (;;)
+    {
+        if (drain())
+            continue;
+
+        if (writer_quit.load(std::memory_order_acquire))
+        {
+            // Producers are gone, this drain sees every message
+            drain();
+            break;
+        }
+
+        // Producers notify without the lock, the timeout covers a wake up sent just before waiting
+        std::unique_lock<std::mutex> lock(writer_lock);
+        writer_sleeping.store(true, std::memory_order_seq_cst);
+        writer_wake.wait_for(lock, std::chrono::milliseconds(2));
+        writer_sleeping.store(false, std::memory_order_relaxed);
+    }
+}
+
+static void wake_writer()
+{
+    if (writer_sleeping.load(std::memory_order_seq_cst))
+        writer_wake.notify_one();
+}
+
+// Claim a slot, format message into it and publish it, return false if it was dropped
+static b8 enqueue(LogChannel channel, LogLevel level, enum Error err, const char* message, va_list arg_ptr)
+{
+    u64 pos = enqueue_pos.load(std::memory_order_relaxed);
+    LogSlot* slot = nullptr;
+
+    for (;;)
+    {
+        slot = &slots[pos & slot_mask];
+        i64 diff = i64(slot->sequence.load(std::memory_order_acquire)) - i64(pos);
+
+        if (diff == 0)
+        {
+            if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+        {
+            // Full: the writer hasn't freed the slot from the previous lap
+            if (overflow_policy == LOG_OVERFLOW_DROP)
+            {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            wake_writer();
+            std::this_thread::yield();
+            pos = enqueue_pos.load(std::memory_order_relaxed);
+        }
+        else
+        {
+            pos = enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->channel = channel;
+    slot->level = level;
+    slot->err = err;
+    vsnprintf(slot->text, LOG_MESSAGE_SIZE, message, arg_ptr);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    wake_writer();
+    return true;
+}
+
+// Wait until the writer passed every slot claimed before the call
+static void flush_async()
+{
+    u64 target = enqueue_pos.load(std::memory_order_acquire);
+    while (dequeue_pos.load(std::memory_order_acquire) < target)
+    {
+        writer_wake.notify_one();
+        std::this_thread::yield();
+    }
+
+    // The writer may not have flushed its last lines yet
+    fflush(stdout);
+}
+
+void log_start_async(u32 capacity, LogOverflow overflow)
+{
+    std::lock_guard<std::mutex> guard(control_lock);
+    if (async_mode.load())
+        return;
+
+    u64 size = 1;
+    while (size < (capacity ? capacity : 1))
+        size <<= 1;
+
+    slots.reset(new LogSlot[size]);
+    for (u64 i = 0; i < size; ++i)
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+
+    slot_mask = size - 1;
+    overflow_policy = overflow;
+    enqueue_pos.store(0, std::memory_order_relaxed);
+    dequeue_pos.store(0, std::memory_order_relaxed);
+    dropped.store(0, std::memory_order_relaxed);
+    writer_quit.store(false, std::memory_order_relaxed);
+
+    writer = std::thread(writer_main);
+    async_mode.store(true, std::memory_order_seq_cst);
+
+    // Messages still queued at exit are written too
+    static b8 registered = false;
+    if (!registered)
+    {
+        atexit(log_stop_async);
+        registered = true;
+    }
+}
+
+void log_stop_async()
+{
+    std::lock_guard<std::mutex> guard(control_lock);
+    if (!async_mode.load())
+        return;
+
+    // New messages go synchronous, wait for the ones being queued
+    async_mode.store(false, std::memory_order_seq_cst);
+    while (producers.load(std::memory_order_seq_cst) != 0)
+        std::this_thread::yield();
+
+    writer_quit.store(true, std::memory_order_release);
+    writer_wake.notify_one();
+    writer.join();
+}
+
+void log_flush()
+{
+    producers.fetch_add(1, std::memory_order_seq_cst);
+    if (async_mode.load(std::memory_order_seq_cst))
+        flush_async();
+    producers.fetch_sub(1, std::memory_order_seq_cst);
+
+    fflush(stdout);
+}
+
+u64 log_get_dropped()
+{
+    return dropped.load(std::memory_order_relaxed);
+}
+
+// ------------------------------------------------------------------------------
+
+void log_output(LogChannel channel, LogLevel level, enum Error err, const char* message, ...)
+{
+    va_list arg_ptr;
+    va_start(arg_ptr, message);
+
+    producers.fetch_add(1, std::memory_order_seq_cst);
+    if (async_mode.load(std::memory_order_seq_cst))
+    {
+        b8 queued = enqueue(channel, level, err, message, arg_ptr);
+
+        // FATAL is written before returning, after everything queued ahead of it
+        if (level == LOG_LEVEL_FATAL)
+            flush_async();
+
+        producers.fetch_sub(1, std::memory_order_seq_cst);
+        va_end(arg_ptr);
+
+        if (queued || level != LOG_LEVEL_FATAL)
+            return;
+
+        // A full ring never drops FATAL, write it here once the ring is flushed
+        va_start(arg_ptr, message);
+    }
+    else
+    {
+        producers.fetch_sub(1, std::memory_order_seq_cst);
+    }
+
+    // Synchronous: format and write on the calling thread
+    char out_msg[LOG_MESSAGE_SIZE];
+    memset(out_msg, 0, sizeof(out_msg));
+    vsnprintf(out_msg, LOG_MESSAGE_SIZE, message, arg_ptr);
+    va_end(arg_ptr);
+
+    write_message(channel, level, err, out_msg);
+
+    if (level == LOG_LEVEL_FATAL)
+        fflush(stdout);
+}
@@ -8,14 +8,15 @@
 
 #define FRELEASE 0
 
-#if FRELEASE == 1
-#define LOG_WARN_ENABLED 0
-#define LOG_DEBUG_ENABLED 0
-#define LOG_INFO_ENABLED 0
-#else
+// Every level stays compiled in, release builds start channels at WARN (log_set_level)
 #define LOG_WARN_ENABLED 1
 #define LOG_DEBUG_ENABLED 1
 #define LOG_INFO_ENABLED 1
+
+#if FRELEASE == 1
+#define LOG_DEFAULT_LEVEL LOG_LEVEL_WARN
+#else
+#define LOG_DEFAULT_LEVEL LOG_LEVEL_INFO
 #endif
 
 typedef enum LogLevel
@@ -27,32 +28,163 @@ typedef enum LogLevel
     LOG_LEVEL_INFO = 4,
 } LogLevel;
 
+/* Channels
+ * Every message belongs to the channel of its translation unit, LOG_CHANNEL
+ * (set for each engine library by CMake, LOG_CHANNEL_GAME everywhere else).
+ * Each channel has a runtime level and the macros skip every message above
+ * it with one relaxed load, before any formatting. Levels are ordered
+ * FATAL < ERROR < WARN < DEBUG < INFO, FATAL is never filtered.
+ */
+typedef enum LogChannel
+{
+    LOG_CHANNEL_ENGINE = 0,
+    LOG_CHANNEL_RENDERER = 1,
+    LOG_CHANNEL_PLATFORM = 2,
+    LOG_CHANNEL_GAME = 3,
+    LOG_CHANNEL_COUNT = 4,
+} LogChannel;
+
+#ifndef LOG_CHANNEL
+#define LOG_CHANNEL LOG_CHANNEL_GAME
+#endif
+
+#include <atomic>
+
+// Most verbose level written by each channel
+extern std::atomic<u8> log_channel_levels[LOG_CHANNEL_COUNT];
+
+// Return true if channel writes messages of level
+inline b8 log_enabled(LogChannel channel, LogLevel level)
+{
+    return u8(level) <= log_channel_levels[channel].load(std::memory_order_relaxed);
+}
+
+// Set the most verbose level channel writes
+void log_set_level(LogChannel channel, LogLevel level);
+LogLevel log_get_level(LogChannel channel);
+
+/* @brief Set levels from a comma separated list of "channel=level" entries,
+ * a bare level applies to every channel ("warn,renderer=debug"). Names are
+ * the lowercase enum names. Returns false if an entry was not understood,
+ * the others are still applied. Engine::start reads the JOJ_LOG variable.
+ */
+b8 log_parse_levels(const char* spec);
+
+// Return lowercase name of channel
+const char* log_channel_name(LogChannel channel);
+
+// State of one FLOG_RATE call site
+struct LogRateLimit
+{
+    std::atomic<i64> window{ 0 };       // Second the count belongs to
+    std::atomic<u32> count{ 0 };        // Calls in that second
+    std::atomic<u32> suppressed{ 0 };   // Calls dropped since the last written one
+};
+
+// Return true if the call site may write another message this second
+b8 log_rate_allow(LogRateLimit& limit, LogChannel channel, LogLevel level, u32 per_second);
+
+// FDEBUG/FINFO write binary records while a binary log is open
+#include "binary_log.h"
+
 void log_output2(LogLevel level, const char* message);
 
+/* Asynchronous logging
+ * Between log_start_async and log_stop_async, log_output formats the message
+ * into a slot of a fixed-size lock-free ring and returns. A background thread
+ * adds the level prefix and colors and writes it to the console, so a log
+ * line in a hot path no longer waits for the console.
+ * FATAL messages flush the ring and are written before log_output returns.
+ * Engine::start turns it on when asked to (Engine::set_async_logging or
+ * JOJ_LOG_ASYNC=1) and stops it when the engine exits.
+ */
+
+// Size of one message in the ring, longer messages are truncated
+#define LOG_MESSAGE_SIZE 1000
+
+typedef enum LogOverflow
+{
+    LOG_OVERFLOW_DROP = 0,      // Drop the message and count it (log_get_dropped)
+    LOG_OVERFLOW_BLOCK = 1,     // Wait for the writer thread to free a slot
+} LogOverflow;
+
+// Start the writer thread, capacity is rounded up to a power of two
+void log_start_async(u32 capacity = 1024, LogOverflow overflow = LOG_OVERFLOW_DROP);
+
+// Write everything queued and stop the writer thread, later messages are written synchronously
+void log_stop_async();
+
+// Block until every message queued so far was written
+void log_flush();
+
+// Return number of messages dropped because the ring was full
+u64 log_get_dropped();
+
+
+void log_output(LogChannel channel, LogLevel level, enum Error err, const char* message, ...);
+
+// Write a message of this translation unit's channel, as a binary record while a binary log is open
+#define FLOG_WRITE(level, message, ...) \
+    do { \
+        if (binary_log_active.load(std::memory_order_relaxed)) \
+            FLOG_BINARY(LOG_CHANNEL, level, message, ##__VA_ARGS__); \
+        else \
+            log_output(LOG_CHANNEL, level, OK, message, ##__VA_ARGS__); \
+    } while (0)
+
+// Write a message if its level passes the channel filter
+#define FLOG(level, message, ...) \
+    do { \
+        if (log_enabled(LOG_CHANNEL, level)) \
+            FLOG_WRITE(level, message, ##__VA_ARGS__); \
+    } while (0)
+
+// Write the first of every n messages of this call site that pass the filter
+#define FLOG_EVERY_N(level, n, message, ...) \
+    do { \
+        static std::atomic<u32> log_every_count{ 0 }; \
+        if (log_enabled(LOG_CHANNEL, level) && log_every_count.fetch_add(1, std::memory_order_relaxed) % (n) == 0) \
+            FLOG_WRITE(level, message, ##__VA_ARGS__); \
+    } while (0)
+
+// Write at most per_second messages of this call site per second, the next written message is preceded by the number dropped
+#define FLOG_RATE(level, per_second, message, ...) \
+    do { \
+        static LogRateLimit log_rate_limit; \
+        if (log_enabled(LOG_CHANNEL, level) && log_rate_allow(log_rate_limit, LOG_CHANNEL, level, per_second)) \
+            FLOG_WRITE(level, message, ##__VA_ARGS__); \
+    } while (0)
 
-void log_output(LogLevel level, enum Error err, const char* message, ...);
 #ifndef FFATAL
-#define FFATAL(error, message, ...) log_output(LOG_LEVEL_FATAL, error, message "\nFile: %s\nLine: %d", __FILE__, __LINE__, ##__VA_ARGS__);
+#define FFATAL(error, message, ...) log_output(LOG_CHANNEL, LOG_LEVEL_FATAL, error, message "\nFile: %s\nLine: %d", __FILE__, __LINE__, ##__VA_ARGS__);
 #endif
 
 #ifndef FERROR
-#define FERROR(error, message, ...) log_output(LOG_LEVEL_ERROR, error, message "\nFile: %s\nLine: %d", __FILE__, __LINE__, ##__VA_ARGS__);
+#define FERROR(error, message, ...) \
+    do { \
+        if (log_enabled(LOG_CHANNEL, LOG_LEVEL_ERROR)) \
+            log_output(LOG_CHANNEL, LOG_LEVEL_ERROR, error, message "\nFile: %s\nLine: %d", __FILE__, __LINE__, ##__VA_ARGS__); \
+    } while (0);
 #endif
 
 #if LOG_WARN_ENABLED == 1
-#define FWARN(message, ...) log_output(LOG_LEVEL_WARN, OK, message "\nFile: %s\nLine: %d", __FILE__, __LINE__, ##__VA_ARGS__);
+#define FWARN(message, ...) \
+    do { \
+        if (log_enabled(LOG_CHANNEL, LOG_LEVEL_WARN)) \
+            log_output(LOG_CHANNEL, LOG_LEVEL_WARN, OK, message "\nFile: %s\nLine: %d", __FILE__, __LINE__, ##__VA_ARGS__); \
+    } while (0);
 #else
 #define FWARN(message, ...);
 #endif
 
 #if LOG_DEBUG_ENABLED == 1
-#define FDEBUG(message, ...) log_output(LOG_LEVEL_DEBUG, OK, message, ##__VA_ARGS__);
+#define FDEBUG(message, ...) FLOG(LOG_LEVEL_DEBUG, message, ##__VA_ARGS__);
 #else
 #define FDEBUG(message, ...);
 #endif
 
 #if LOG_INFO_ENABLED == 1
-#define FINFO(message, ...) log_output(LOG_LEVEL_INFO, OK, message, ##__VA_ARGS__);
+#define FINFO(message, ...) FLOG(LOG_LEVEL_INFO, message, ##__VA_ARGS__);
 #else
 #define FINFO(message, ...);
 #endif
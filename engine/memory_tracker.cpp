@@ -0,0 +1,115 @@
+#include "memory_tracker.h"
+
+#include <atomic>
+#include <stdio.h>
+
+namespace
+{
+	struct TagCounters
+	{
+		std::atomic<u64> live_bytes{ 0 };
+		std::atomic<u64> peak_bytes{ 0 };
+		std::atomic<u64> allocations{ 0 };
+		std::atomic<u64> frees{ 0 };
+		std::atomic<u64> frame_start{ 0 };			// allocations when the current frame began
+		std::atomic<u64> frame_allocations{ 0 };	// Allocations of the last complete frame
+	};
+}
+
+static const u32 TAG_COUNT = u32(JojEngine::MemoryTag::COUNT);
+
+static TagCounters counters[TAG_COUNT];
+
+static const char* tag_names[TAG_COUNT] = {
+	"engine", "renderer", "geometry", "game"
+};
+
+void JojEngine::MemoryTracker::record_alloc(MemoryTag tag, u64 bytes)
+{
+	TagCounters& c = counters[u32(tag)];
+	c.allocations.fetch_add(1, std::memory_order_relaxed);
+	u64 live = c.live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+
+	u64 peak = c.peak_bytes.load(std::memory_order_relaxed);
+	while (live > peak && !c.peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+	{
+	}
+}
+
+void JojEngine::MemoryTracker::record_free(MemoryTag tag, u64 bytes)
+{
+	TagCounters& c = counters[u32(tag)];
+	c.frees.fetch_add(1, std::memory_order_relaxed);
+	c.live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void JojEngine::MemoryTracker::frame_mark()
+{
+	for (TagCounters& c : counters)
+	{
+		u64 allocations = c.allocations.load(std::memory_order_relaxed);
+		c.frame_allocations.store(allocations - c.frame_start.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		c.frame_start.store(allocations, std::memory_order_relaxed);
+	}
+}
+
+JojEngine::MemoryStats JojEngine::MemoryTracker::get_stats(MemoryTag tag)
+{
+	const TagCounters& c = counters[u32(tag) < TAG_COUNT ? u32(tag) : 0];
+
+	MemoryStats stats;
+	stats.live_bytes = c.live_bytes.load(std::memory_order_relaxed);
+	stats.peak_bytes = c.peak_bytes.load(std::memory_order_relaxed);
+	stats.allocations = c.allocations.load(std::memory_order_relaxed);
+
+	// Frees are read after allocations, so a racing free can't underflow live allocations
+	u64 frees = c.frees.load(std::memory_order_relaxed);
+	stats.live_allocations = stats.allocations > frees ? stats.allocations - frees : 0;
+	stats.frame_allocations = c.frame_allocations.load(std::memory_order_relaxed);
+	return stats;
+}
+
+JojEngine::MemoryStats JojEngine::MemoryTracker::get_total()
+{
+	// Peaks of different tags happen at different times, their sum is an upper bound
+	MemoryStats total;
+	for (u32 i = 0; i < TAG_COUNT; ++i)
+	{
+		MemoryStats stats = get_stats(MemoryTag(i));
+		total.live_bytes += stats.live_bytes;
+		total.peak_bytes += stats.peak_bytes;
+		total.allocations += stats.allocations;
+		total.live_allocations += stats.live_allocations;
+		total.frame_allocations += stats.frame_allocations;
+	}
+	return total;
+}
+
+const char* JojEngine::MemoryTracker::get_tag_name(MemoryTag tag)
+{
+	return u32(tag) < TAG_COUNT ? tag_names[u32(tag)] : "unknown";
+}
+
+b8 JojEngine::MemoryTracker::write_json(const char* path)
+{
+	FILE* file = fopen(path, "w");
+	if (!file)
+		return false;
+
+	fprintf(file, "{\n");
+	for (u32 i = 0; i <= TAG_COUNT; ++i)
+	{
+		// Last entry is the sum of every tag
+		MemoryStats stats = i < TAG_COUNT ? get_stats(MemoryTag(i)) : get_total();
+		const char* name = i < TAG_COUNT ? tag_names[i] : "total";
+
+		fprintf(file, "  \"%s\": {\"live_bytes\": %llu, \"peak_bytes\": %llu, \"allocations\": %llu, "
+			"\"live_allocations\": %llu, \"frame_allocations\": %llu}%s\n",
+			name, (unsigned long long)stats.live_bytes, (unsigned long long)stats.peak_bytes,
+			(unsigned long long)stats.allocations, (unsigned long long)stats.live_allocations,
+			(unsigned long long)stats.frame_allocations, i < TAG_COUNT ? "," : "");
+	}
+	fprintf(file, "}\n");
+
+	return fclose(file) == 0;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "defines.h"
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace JojEngine
+{
+	/* Memory accounting per subsystem
+	 * Allocations are reported with a tag and counted in relaxed atomics:
+	 * live and peak bytes, total and live allocations and allocations made
+	 * in the last frame (Engine::loop calls frame_mark). Tracked containers
+	 * (TrackedVector) report on their own, other code uses FMEMORY_ALLOC and
+	 * FMEMORY_FREE. Build with JOJ_MEMORY_TRACKING=OFF to compile it out:
+	 * the macros expand to nothing and TrackedVector is a plain std::vector.
+	 */
+
+	enum class MemoryTag : u8 { ENGINE, RENDERER, GEOMETRY, GAME, COUNT };
+
+	struct MemoryStats
+	{
+		u64 live_bytes = 0;				// Bytes allocated and not freed
+		u64 peak_bytes = 0;				// Most live bytes at once
+		u64 allocations = 0;			// Allocations since startup
+		u64 live_allocations = 0;		// Allocations not freed
+		u64 frame_allocations = 0;		// Allocations during the last complete frame
+	};
+
+	class MemoryTracker
+	{
+	public:
+		// Count an allocation or a free of bytes
+		static void record_alloc(MemoryTag tag, u64 bytes);
+		static void record_free(MemoryTag tag, u64 bytes);
+
+		// End the current frame for frame_allocations
+		static void frame_mark();
+
+		// Return counters of tag
+		static MemoryStats get_stats(MemoryTag tag);
+
+		// Return counters of every tag added together
+		static MemoryStats get_total();
+
+		// Return lowercase name of tag
+		static const char* get_tag_name(MemoryTag tag);
+
+		// Write the counters of every tag as JSON
+		static b8 write_json(const char* path);
+	};
+
+#if FMEMORY_TRACKING_DISABLED
+	template <typename T, MemoryTag tag>
+	using TrackedVector = std::vector<T>;
+#else
+	// std::allocator that reports to MemoryTracker under tag
+	template <typename T, MemoryTag tag>
+	class TrackedAllocator
+	{
+	public:
+		typedef T value_type;
+
+		template <typename U>
+		struct rebind { typedef TrackedAllocator<U, tag> other; };
+
+		TrackedAllocator() = default;
+
+		template <typename U>
+		TrackedAllocator(const TrackedAllocator<U, tag>&) {}
+
+		T* allocate(std::size_t count)
+		{
+			MemoryTracker::record_alloc(tag, u64(count) * sizeof(T));
+			return static_cast<T*>(::operator new(count * sizeof(T)));
+		}
+
+		void deallocate(T* p, std::size_t count)
+		{
+			MemoryTracker::record_free(tag, u64(count) * sizeof(T));
+			::operator delete(p);
+		}
+
+		template <typename U>
+		b8 operator==(const TrackedAllocator<U, tag>&) const { return true; }
+
+		template <typename U>
+		b8 operator!=(const TrackedAllocator<U, tag>&) const { return false; }
+	};
+
+	template <typename T, MemoryTag tag>
+	using TrackedVector = std::vector<T, TrackedAllocator<T, tag>>;
+#endif // FMEMORY_TRACKING_DISABLED
+}
+
+#if FMEMORY_TRACKING_DISABLED
+#define FMEMORY_ALLOC(tag, bytes)
+#define FMEMORY_FREE(tag, bytes)
+#else
+#define FMEMORY_ALLOC(tag, bytes) JojEngine::MemoryTracker::record_alloc(tag, bytes)
+#define FMEMORY_FREE(tag, bytes) JojEngine::MemoryTracker::record_free(tag, bytes)
+#endif // FMEMORY_TRACKING_DISABLED
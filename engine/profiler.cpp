@@ -0,0 +1,273 @@
+#include "profiler.h"
+
+#include "clock.h"
+#include "memory_tracker.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <stdio.h>
+
+namespace
+{
+	struct OpenZone
+	{
+		const char* name;
+		i64 begin;
+	};
+
+	// Written only by its thread, read by collect
+	struct ThreadBuffer
+	{
+		u32 thread = 0;						// Thread id in events, unique per registered thread
+		const char* name = nullptr;			// Name shown in traces
+		std::atomic<u64> head{ 0 };			// Events written so far
+		u32 depth = 0;						// Open zones
+		b8 in_use = true;					// Owned by a running thread
+		OpenZone stack[JojEngine::PROFILER_MAX_DEPTH];
+		JojEngine::ProfileEvent events[JojEngine::PROFILER_BUFFER_SIZE];
+	};
+}
+
+/* Buffers live until exit so events of finished threads can still be exported.
+ * A finished thread gives its buffer back and the next new thread takes it
+ * over, so threads that come and go (JobSystem restarts) don't add buffers.
+ * Its events are exported until overwritten, its name only until taken over.
+ */
+static std::mutex registry_lock;
+static std::vector<std::unique_ptr<ThreadBuffer>> registry;
+static u32 thread_count = 0;				// Threads registered so far, traces tell them apart
+
+static std::atomic<b8> enabled{ true };
+static std::atomic<i64> since{ 0 };			// Ticks of the last clear
+static std::atomic<u64> frames{ 0 };		// Frames marked since the last clear
+
+static thread_local ThreadBuffer* local = nullptr;
+
+// Gives the buffer of the calling thread back when the thread exits
+struct ThreadRelease
+{
+	~ThreadRelease()
+	{
+		std::lock_guard<std::mutex> lock(registry_lock);
+		local->in_use = false;
+	}
+};
+
+static thread_local ThreadRelease release;
+
+// Zone timestamps: the TSC where the Clock has one, reading the OS clock costs about as much as a zone
+static inline i64 ticks()
+{
+	return JojPlatform::Clock::ticks();
+}
+
+static f64 ticks_per_second()
+{
+	return f64(JojPlatform::Clock::get_ticks_per_second());
+}
+
+// Buffer of the calling thread, registered on first use
+static ThreadBuffer* thread_buffer()
+{
+	if (local)
+		return local;
+
+	{
+		std::lock_guard<std::mutex> lock(registry_lock);
+		for (const std::unique_ptr<ThreadBuffer>& buffer : registry)
+		{
+			if (!buffer->in_use)
+			{
+				// Events of the previous owner stay until the ring overwrites them
+				local = buffer.get();
+				local->name = nullptr;
+				local->depth = 0;
+				local->in_use = true;
+				break;
+			}
+		}
+
+		if (!local)
+		{
+			registry.push_back(std::make_unique<ThreadBuffer>());
+			FMEMORY_ALLOC(JojEngine::MemoryTag::ENGINE, sizeof(ThreadBuffer));
+			local = registry.back().get();
+		}
+
+		local->thread = thread_count++;
+	}
+
+	// First use constructs it, so its destructor runs when this thread exits
+	(void)&release;
+	return local;
+}
+
+static void record(ThreadBuffer* buffer, const JojEngine::ProfileEvent& event)
+{
+	u64 head = buffer->head.load(std::memory_order_relaxed);
+	buffer->events[head % JojEngine::PROFILER_BUFFER_SIZE] = event;
+	buffer->head.store(head + 1, std::memory_order_release);
+}
+
+// ------------------------------------------------------------------------------
+
+b8 JojEngine::Profiler::begin_zone(const char* name)
+{
+	if (!enabled.load(std::memory_order_relaxed))
+		return false;
+
+	ThreadBuffer* buffer = thread_buffer();
+	if (buffer->depth == PROFILER_MAX_DEPTH)
+		return false;
+
+	buffer->stack[buffer->depth++] = { name, ticks() };
+	return true;
+}
+
+void JojEngine::Profiler::end_zone()
+{
+	i64 end = ticks();
+
+	ThreadBuffer* buffer = local;
+	if (!buffer || buffer->depth == 0)
+		return;
+
+	const OpenZone& zone = buffer->stack[--buffer->depth];
+	record(buffer, { zone.name, zone.begin, end, buffer->thread, u16(buffer->depth), ProfileEventType::ZONE });
+}
+
+void JojEngine::Profiler::frame_mark()
+{
+	if (!enabled.load(std::memory_order_relaxed))
+		return;
+
+	ThreadBuffer* buffer = thread_buffer();
+	i64 now = ticks();
+	record(buffer, { "Frame", now, now, buffer->thread, u16(buffer->depth), ProfileEventType::FRAME });
+	frames.fetch_add(1, std::memory_order_relaxed);
+}
+
+void JojEngine::Profiler::set_thread_name(const char* name)
+{
+	thread_buffer()->name = name;
+}
+
+void JojEngine::Profiler::set_enabled(b8 enable)
+{
+	enabled.store(enable, std::memory_order_relaxed);
+}
+
+b8 JojEngine::Profiler::is_enabled()
+{
+	return enabled.load(std::memory_order_relaxed);
+}
+
+void JojEngine::Profiler::clear()
+{
+	// Older events stay in the rings but are skipped by collect
+	since.store(ticks(), std::memory_order_relaxed);
+	frames.store(0, std::memory_order_relaxed);
+}
+
+u64 JojEngine::Profiler::get_frame_count()
+{
+	return frames.load(std::memory_order_relaxed);
+}
+
+void JojEngine::Profiler::collect(std::vector<ProfileEvent>& events)
+{
+	i64 start = since.load(std::memory_order_relaxed);
+
+	std::lock_guard<std::mutex> lock(registry_lock);
+	for (const std::unique_ptr<ThreadBuffer>& buffer : registry)
+	{
+		u64 head = buffer->head.load(std::memory_order_acquire);
+		u64 count = head < PROFILER_BUFFER_SIZE ? head : PROFILER_BUFFER_SIZE;
+
+		for (u64 i = head - count; i < head; ++i)
+		{
+			const ProfileEvent& event = buffer->events[i % PROFILER_BUFFER_SIZE];
+			if (event.begin >= start)
+				events.push_back(event);
+		}
+	}
+}
+
+i64 JojEngine::Profiler::get_ticks()
+{
+	return ticks();
+}
+
+f64 JojEngine::Profiler::get_ticks_per_second()
+{
+	return ticks_per_second();
+}
+
+// ------------------------------------------------------------------------------
+
+// Write text as a JSON string
+static void write_json_string(FILE* file, const char* text)
+{
+	fputc('"', file);
+	for (const char* c = text ? text : ""; *c; ++c)
+	{
+		if (*c == '"' || *c == '\\')
+			fputc('\\', file);
+		if (u8(*c) >= 0x20)
+			fputc(*c, file);
+	}
+	fputc('"', file);
+}
+
+b8 JojEngine::Profiler::write_chrome_trace(const char* path)
+{
+	std::vector<ProfileEvent> events;
+	collect(events);
+
+	FILE* file = fopen(path, "w");
+	if (!file)
+		return false;
+
+	// Microseconds since the oldest event
+	i64 base = events.empty() ? 0 : events[0].begin;
+	for (const ProfileEvent& event : events)
+		base = event.begin < base ? event.begin : base;
+
+	f64 to_us = 1e6 / ticks_per_second();
+
+	fprintf(file, "{\"traceEvents\":[\n");
+	b8 first = true;
+
+	{
+		std::lock_guard<std::mutex> lock(registry_lock);
+		for (const std::unique_ptr<ThreadBuffer>& buffer : registry)
+		{
+			if (!buffer->name)
+				continue;
+
+			fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":", first ? "" : ",\n", buffer->thread);
+			write_json_string(file, buffer->name);
+			fprintf(file, "}}");
+			first = false;
+		}
+	}
+
+	for (const ProfileEvent& event : events)
+	{
+		fprintf(file, "%s{\"name\":", first ? "" : ",\n");
+		write_json_string(file, event.name);
+
+		if (event.type == ProfileEventType::FRAME)
+			fprintf(file, ",\"ph\":\"i\",\"s\":\"g\",\"ts\":%.3f,\"pid\":0,\"tid\":%u}",
+				f64(event.begin - base) * to_us, event.thread);
+		else
+			fprintf(file, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":%u}",
+				f64(event.begin - base) * to_us, f64(event.end - event.begin) * to_us, event.thread);
+
+		first = false;
+	}
+
+	fprintf(file, "\n]}\n");
+	return fclose(file) == 0;
+}
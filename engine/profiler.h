@@ -0,0 +1,100 @@
+#pragma once
+
+#include "defines.h"
+
+#include <vector>
+
+namespace JojEngine
+{
+	/* CPU frame profiler
+	 * Zones are named begin/end pairs timed with JojPlatform::Clock::ticks()
+	 * (the calibrated TSC on x86-64, the OS clock elsewhere).
+	 * Every thread records into its own ring buffer, so recording takes no
+	 * lock and never allocates: the newest PROFILER_BUFFER_SIZE events of a
+	 * thread are kept. Engine::loop marks every frame and times its stages,
+	 * games add zones with FPROFILE_ZONE. Zone names must be string literals
+	 * (or otherwise outlive the profiler), only the pointer is stored.
+	 * Build with JOJ_PROFILER=OFF to compile the macros out.
+	 */
+
+	// Events kept per thread (newest win)
+	const u32 PROFILER_BUFFER_SIZE = 1 << 14;
+
+	// Most zones open at once on one thread, deeper zones are not recorded
+	const u32 PROFILER_MAX_DEPTH = 32;
+
+	enum class ProfileEventType : u16 { ZONE, FRAME };
+
+	struct ProfileEvent
+	{
+		const char* name;		// Zone name
+		i64 begin;				// Profiler ticks
+		i64 end;				// Profiler ticks (begin for frame marks)
+		u32 thread;				// Index of the recording thread
+		u16 depth;				// Number of enclosing zones
+		ProfileEventType type;
+	};
+
+	class Profiler
+	{
+	public:
+		// Open zone on the calling thread, return false if it is not recorded
+		static b8 begin_zone(const char* name);
+
+		// Close the innermost zone opened by begin_zone
+		static void end_zone();
+
+		// Record the start of a new frame
+		static void frame_mark();
+
+		// Name the calling thread in exported traces
+		static void set_thread_name(const char* name);
+
+		// Start or stop recording (on by default)
+		static void set_enabled(b8 enabled);
+		static b8 is_enabled();
+
+		// Forget events recorded so far
+		static void clear();
+
+		/* @brief Copy recorded events of every thread, oldest first per thread.
+		 * Threads still recording may overwrite events being copied, collect
+		 * between frames or after the threads stopped for exact results.
+		 */
+		static void collect(std::vector<ProfileEvent>& events);
+
+		// Return frames marked since the last clear
+		static u64 get_frame_count();
+
+		// Write collected events as Chrome trace JSON (chrome://tracing, Perfetto)
+		static b8 write_chrome_trace(const char* path);
+
+		// Return current profiler ticks (JojPlatform::Clock::ticks)
+		static i64 get_ticks();
+
+		// Return profiler ticks per second
+		static f64 get_ticks_per_second();
+	};
+
+	// Zone open for the lifetime of the object
+	class ProfileZone
+	{
+	public:
+		explicit ProfileZone(const char* name) : active(Profiler::begin_zone(name)) {}
+		~ProfileZone() { if (active) Profiler::end_zone(); }
+
+	private:
+		b8 active;
+	};
+}
+
+#define FPROFILE_CONCAT_INNER(a, b) a##b
+#define FPROFILE_CONCAT(a, b) FPROFILE_CONCAT_INNER(a, b)
+
+#if FPROFILER_DISABLED
+#define FPROFILE_ZONE(name)
+#define FPROFILE_FRAME()
+#else
+#define FPROFILE_ZONE(name) JojEngine::ProfileZone FPROFILE_CONCAT(profile_zone_, __LINE__)(name)
+#define FPROFILE_FRAME() JojEngine::Profiler::frame_mark()
+#endif
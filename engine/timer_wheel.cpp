@@ -0,0 +1,182 @@
+#include "timer_wheel.h"
+
+// End of a slot list
+static const u32 NIL = 0xFFFFFFFF;
+
+// Bits of tick number per level
+static const u32 LEVEL_BITS = 8;
+
+JojEngine::TimerWheel::TimerWheel()
+{
+	init(0);
+}
+
+JojEngine::TimerWheel::~TimerWheel()
+{
+}
+
+void JojEngine::TimerWheel::init(i64 now, i64 tick)
+{
+	entries.clear();
+	for (u32& slot : slots)
+		slot = NIL;
+
+	free_list = NIL;
+	pending = 0;
+
+	origin = now;
+	this->tick = tick > 0 ? tick : 1;
+	current = 0;
+}
+
+void JojEngine::TimerWheel::insert(u32 index)
+{
+	Entry& entry = entries[index];
+
+	// Expiries past the last level wait in its farthest slot and are placed again when it cascades
+	i64 expires = entry.expires < current ? current : entry.expires;
+	i64 delta = expires - current;
+	const i64 range = i64(1) << (LEVEL_BITS * TIMER_WHEEL_LEVELS);
+	if (delta >= range)
+		expires = current + range - 1;
+
+	u32 level = 0;
+	while (level < TIMER_WHEEL_LEVELS - 1 && delta >= (i64(1) << (LEVEL_BITS * (level + 1))))
+		level++;
+
+	u32 slot = level * TIMER_WHEEL_SLOTS + u32(expires >> (LEVEL_BITS * level)) % TIMER_WHEEL_SLOTS;
+
+	entry.slot = slot;
+	entry.prev = NIL;
+	entry.next = slots[slot];
+	if (entry.next != NIL)
+		entries[entry.next].prev = index;
+	slots[slot] = index;
+}
+
+void JojEngine::TimerWheel::unlink(u32 index)
+{
+	Entry& entry = entries[index];
+
+	if (entry.prev != NIL)
+		entries[entry.prev].next = entry.next;
+	else
+		slots[entry.slot] = entry.next;
+
+	if (entry.next != NIL)
+		entries[entry.next].prev = entry.prev;
+}
+
+void JojEngine::TimerWheel::release(u32 index)
+{
+	Entry& entry = entries[index];
+	entry.active = false;
+	entry.generation++;
+	entry.next = free_list;
+	free_list = index;
+	pending--;
+}
+
+JojEngine::TimerHandle JojEngine::TimerWheel::schedule(i64 delay, TimerFunc func, void* data, i64 period)
+{
+	u32 index = free_list;
+	if (index != NIL)
+	{
+		free_list = entries[index].next;
+	}
+	else
+	{
+		index = u32(entries.size());
+		entries.push_back({});
+		entries[index].generation = 1;
+	}
+
+	// Round up, and never into the slot being fired
+	i64 ticks = delay > 0 ? (delay + tick - 1) / tick : 0;
+
+	Entry& entry = entries[index];
+	entry.expires = current + (ticks > 0 ? ticks : 1);
+	entry.period = period > 0 ? (period + tick - 1) / tick : 0;
+	entry.func = func;
+	entry.data = data;
+	entry.active = true;
+	pending++;
+
+	insert(index);
+	return (TimerHandle(entry.generation) << 32) | index;
+}
+
+b8 JojEngine::TimerWheel::cancel(TimerHandle handle)
+{
+	u32 index = u32(handle & 0xFFFFFFFF);
+	u32 generation = u32(handle >> 32);
+
+	if (index >= entries.size() || !entries[index].active || entries[index].generation != generation)
+		return false;
+
+	unlink(index);
+	release(index);
+	return true;
+}
+
+void JojEngine::TimerWheel::cascade(u32 level)
+{
+	u32 slot = level * TIMER_WHEEL_SLOTS + u32(current >> (LEVEL_BITS * level)) % TIMER_WHEEL_SLOTS;
+
+	u32 index = slots[slot];
+	slots[slot] = NIL;
+
+	while (index != NIL)
+	{
+		u32 next = entries[index].next;
+		insert(index);
+		index = next;
+	}
+}
+
+u32 JojEngine::TimerWheel::advance(i64 now)
+{
+	i64 target = (now - origin) / tick;
+	u32 fired = 0;
+
+	// Nothing to fire on the way
+	if (pending == 0 && target > current)
+		current = target;
+
+	while (current < target)
+	{
+		current++;
+
+		// Coarser slots whose range starts at this tick move down, farthest level first
+		for (u32 level = TIMER_WHEEL_LEVELS - 1; level > 0; --level)
+			if ((current & ((i64(1) << (LEVEL_BITS * level)) - 1)) == 0)
+				cascade(level);
+
+		u32& slot = slots[current % TIMER_WHEEL_SLOTS];
+		while (slot != NIL)
+		{
+			u32 index = slot;
+			unlink(index);
+
+			Entry& entry = entries[index];
+			TimerFunc func = entry.func;
+			void* data = entry.data;
+
+			// Reschedule before calling so the callback can cancel its own timer
+			if (entry.period > 0)
+			{
+				entry.expires += entry.period;
+				insert(index);
+			}
+			else
+			{
+				release(index);
+			}
+
+			func(data);
+			fired++;
+		}
+	}
+
+	return fired;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "defines.h"
+
+#include <vector>
+
+namespace JojEngine
+{
+	/* Hierarchical timer wheel
+	 * Timers wait in one of TIMER_WHEEL_LEVELS rings of TIMER_WHEEL_SLOTS
+	 * slots, each level 256 times coarser than the one below. Scheduling and
+	 * cancelling are O(1). advance() visits one slot per elapsed tick and,
+	 * every 256 ticks, moves the timers of one coarser slot down a level.
+	 * Times are integer nanoseconds (JojPlatform::Clock::now or the engine
+	 * game time), rounded up to whole ticks. Callbacks run on the thread
+	 * calling advance() and may schedule or cancel timers. Not thread safe.
+	 */
+
+	const u32 TIMER_WHEEL_LEVELS = 4;
+	const u32 TIMER_WHEEL_SLOTS = 256;
+
+	// Timer body
+	typedef void(*TimerFunc)(void* data);
+
+	// Identifies one scheduled timer, 0 is never a valid handle
+	typedef u64 TimerHandle;
+
+	class TimerWheel
+	{
+	public:
+		TimerWheel();
+		~TimerWheel();
+
+		// Start at time now with a resolution of tick nanoseconds, forgets scheduled timers
+		void init(i64 now, i64 tick = 1000000);
+
+		// Call func(data) delay nanoseconds from the last advance, then every period nanoseconds if period > 0
+		TimerHandle schedule(i64 delay, TimerFunc func, void* data, i64 period = 0);
+
+		// Remove timer, return false if it already fired (one shot) or was cancelled
+		b8 cancel(TimerHandle handle);
+
+		// Fire every timer due at time now, return number of callbacks run
+		u32 advance(i64 now);
+
+		// Return number of scheduled timers
+		u32 get_pending() const;
+
+		// Return time of the last tick reached by advance
+		i64 get_time() const;
+
+	private:
+		struct Entry
+		{
+			i64 expires;		// Tick to fire at
+			i64 period;			// Ticks between repeats (0 = one shot)
+			TimerFunc func;
+			void* data;
+			u32 generation;		// Upper half of the handle, bumped when the entry is freed
+			u32 next;			// Next entry in the slot (or the free list)
+			u32 prev;			// Previous entry in the slot
+			u32 slot;			// Slot holding the entry
+			b8 active;
+		};
+
+		std::vector<Entry> entries;
+		u32 slots[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS];
+		u32 free_list;			// First unused entry
+		u32 pending;			// Scheduled timers
+
+		i64 origin;				// Time of tick 0
+		i64 tick;				// Nanoseconds per tick
+		i64 current;			// Last tick processed
+
+		void insert(u32 index);					// Put entry in the slot of its expiry tick
+		void unlink(u32 index);					// Remove entry from its slot
+		void release(u32 index);				// Return entry to the free list
+		void cascade(u32 level);				// Move the current slot of level one level down
+	};
+
+	inline u32 TimerWheel::get_pending() const
+	{ return pending; }
+
+	inline i64 TimerWheel::get_time() const
+	{ return origin + current * tick; }
+}
@@ -0,0 +1,492 @@
+#include "transform_hierarchy.h"
+
+#include "fmath_batch.h"
+#include "profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <string.h>
+
+// Nodes sent through the SoA kernels per call
+static const u32 COLUMN_BATCH = 64;
+
+JojEngine::TransformHierarchy::TransformHierarchy()
+{
+}
+
+JojEngine::TransformHierarchy::~TransformHierarchy()
+{
+}
+
+b8 JojEngine::TransformHierarchy::init(u32 capacity)
+{
+	clear();
+
+	locals.reserve(capacity);
+	worlds.reserve(capacity);
+	parents.reserve(capacity);
+	children.reserve(capacity + 1);
+	flags.reserve(capacity);
+	owners.reserve(capacity);
+	slots.reserve(capacity);
+	return true;
+}
+
+void JojEngine::TransformHierarchy::clear()
+{
+	// Bump every live slot so old handles go stale, then chain all slots as free
+	for (u32 i = 0; i < owners.size(); ++i)
+	{
+		if (!(flags[i] & NODE_REMOVED))
+			slots[owners[i]].generation = slots[owners[i]].generation + 1 ? slots[owners[i]].generation + 1 : 1;
+	}
+
+	free_slot = NONE;
+	for (u32 i = u32(slots.size()); i-- > 0;)
+	{
+		slots[i].index = free_slot;
+		free_slot = i;
+	}
+
+	locals.clear();
+	worlds.clear();
+	parents.clear();
+	children.clear();
+	flags.clear();
+	owners.clear();
+	level_begin.clear();
+	level_dirty.clear();
+	count = 0;
+	unsorted = false;
+	removed = false;
+	changed = false;
+}
+
+JojEngine::TransformNode JojEngine::TransformHierarchy::create(const Transform& local, TransformNode parent)
+{
+	u32 parent_index = NONE;
+	if (!parent.is_null())
+	{
+		parent_index = find(parent);
+		if (parent_index == NONE)
+			return TransformNode();
+	}
+
+	u32 slot = free_slot;
+	if (slot != NONE)
+	{
+		free_slot = slots[slot].index;
+	}
+	else
+	{
+		slot = u32(slots.size());
+		slots.push_back({ NONE, 1 });
+	}
+
+	// Appended after its parent, the next update moves it to its level
+	u32 index = u32(locals.size());
+	slots[slot].index = index;
+	locals.push_back(local);
+	worlds.push_back(mat4_identity());
+	parents.push_back(parent_index);
+	flags.push_back(NODE_DIRTY);
+	owners.push_back(slot);
+
+	count++;
+	unsorted = true;
+	changed = true;
+	return { slot, slots[slot].generation };
+}
+
+b8 JojEngine::TransformHierarchy::destroy(TransformNode node)
+{
+	u32 root = find(node);
+	if (root == NONE)
+		return false;
+
+	if (!unsorted)
+	{
+		// Sorted (holes left by other destroys are fine): one range per level below root
+		Range range = { root, root + 1 };
+		while (range.begin != range.end)
+		{
+			for (u32 i = range.begin; i < range.end; ++i)
+				release(i);
+			range = { children[range.begin], children[range.end] };
+		}
+
+		removed = true;
+		return true;
+	}
+
+	// New or moved nodes may sit anywhere: walk up from each node once, ancestors of live nodes are live
+	std::vector<u8> below(locals.size(), 0);	// 0 not known yet, 1 kept, 2 in the subtree
+	std::vector<u32> path;
+	below[root] = 2;
+	for (u32 i = 0; i < locals.size(); ++i)
+	{
+		if (flags[i] & NODE_REMOVED)
+			continue;
+
+		u32 j = i;
+		while (j != NONE && below[j] == 0)
+		{
+			path.push_back(j);
+			j = parents[j];
+		}
+
+		u8 state = j == NONE ? 1 : below[j];
+		for (u32 k : path)
+			below[k] = state;
+		path.clear();
+	}
+
+	for (u32 i = 0; i < locals.size(); ++i)
+	{
+		if (below[i] == 2)
+			release(i);
+	}
+
+	removed = true;
+	return true;
+}
+
+b8 JojEngine::TransformHierarchy::set_parent(TransformNode node, TransformNode parent)
+{
+	u32 index = find(node);
+	if (index == NONE)
+		return false;
+
+	u32 parent_index = NONE;
+	if (!parent.is_null())
+	{
+		parent_index = find(parent);
+		if (parent_index == NONE)
+			return false;
+
+		// node must not be parent or one of its ancestors
+		for (u32 i = parent_index; i != NONE; i = parents[i])
+		{
+			if (i == index)
+				return false;
+		}
+	}
+
+	if (parents[index] == parent_index)
+		return true;
+
+	parents[index] = parent_index;
+	mark_dirty(index);
+	unsorted = true;
+	return true;
+}
+
+b8 JojEngine::TransformHierarchy::set_local(TransformNode node, const Transform& local)
+{
+	u32 index = find(node);
+	if (index == NONE)
+		return false;
+
+	locals[index] = local;
+	mark_dirty(index);
+	return true;
+}
+
+const Transform* JojEngine::TransformHierarchy::get_local(TransformNode node) const
+{
+	u32 index = find(node);
+	return index != NONE ? &locals[index] : nullptr;
+}
+
+const Mat4* JojEngine::TransformHierarchy::get_world(TransformNode node) const
+{
+	u32 index = find(node);
+	return index != NONE ? &worlds[index] : nullptr;
+}
+
+JojEngine::TransformNode JojEngine::TransformHierarchy::get_parent(TransformNode node) const
+{
+	u32 index = find(node);
+	if (index == NONE || parents[index] == NONE)
+		return TransformNode();
+
+	u32 slot = owners[parents[index]];
+	return { slot, slots[slot].generation };
+}
+
+b8 JojEngine::TransformHierarchy::is_alive(TransformNode node) const
+{
+	return find(node) != NONE;
+}
+
+u32 JojEngine::TransformHierarchy::update(JobSystem* jobs)
+{
+	if (unsorted || removed)
+		sort();
+
+	if (!changed)
+		return 0;
+
+	FPROFILE_ZONE("transform_update");
+
+	u32 updated = 0;
+	Range carried = { 0, 0 };		// Children of the range recomputed on the previous level
+	u32 levels = get_level_count();
+	visited.clear();
+
+	for (u32 level = 0; level < levels; ++level)
+	{
+		Range dirty = level_dirty[level];
+		if (carried.begin == carried.end && dirty.begin == dirty.end)
+			continue;
+
+		u32 begin = dirty.begin;
+		u32 end = dirty.end;
+		if (carried.begin != carried.end)
+		{
+			begin = dirty.begin != dirty.end && dirty.begin < carried.begin ? dirty.begin : carried.begin;
+			end = dirty.begin != dirty.end && dirty.end > carried.end ? dirty.end : carried.end;
+		}
+
+		u32 level_updated = 0;
+
+		if (jobs && end - begin >= TRANSFORM_PARALLEL_MIN && level == 0)
+		{
+			std::atomic<u32> total{ 0 };
+			jobs->parallel_for(end - begin, TRANSFORM_BATCH_SIZE, [&](u32 b, u32 e)
+			{
+				total.fetch_add(update_range(begin + b, begin + e), std::memory_order_relaxed);
+			});
+			level_updated = total.load(std::memory_order_relaxed);
+		}
+		else if (jobs && end - begin >= TRANSFORM_PARALLEL_MIN)
+		{
+			// Split on parents so each job sees whole runs of children, batched as on one thread
+			u32 first = parents[begin];
+			u32 last = parents[end - 1] + 1;
+			u32 batch = u32(u64(TRANSFORM_BATCH_SIZE) * (last - first) / (end - begin));
+
+			std::atomic<u32> total{ 0 };
+			jobs->parallel_for(last - first, batch ? batch : 1, [&](u32 b, u32 e)
+			{
+				u32 from = children[first + b] > begin ? children[first + b] : begin;
+				u32 to = children[first + e] < end ? children[first + e] : end;
+				total.fetch_add(update_range(from, to), std::memory_order_relaxed);
+			});
+			level_updated = total.load(std::memory_order_relaxed);
+		}
+		else
+		{
+			level_updated = update_range(begin, end);
+		}
+
+		updated += level_updated;
+		carried = level_updated > 0 ? Range{ children[begin], children[end] } : Range{ 0, 0 };
+		visited.push_back({ begin, end });
+	}
+
+	// Every flag was read by the children that needed it
+	for (const Range& range : visited)
+		memset(flags.data() + range.begin, 0, range.end - range.begin);
+	for (Range& range : level_dirty)
+		range = { 0, 0 };
+	changed = false;
+
+	return updated;
+}
+
+u32 JojEngine::TransformHierarchy::get_count() const
+{
+	return count;
+}
+
+u32 JojEngine::TransformHierarchy::get_level_count() const
+{
+	return level_begin.empty() ? 0 : u32(level_begin.size()) - 1;
+}
+
+u32 JojEngine::TransformHierarchy::find(TransformNode node) const
+{
+	if (node.generation == 0 || node.index >= slots.size() || slots[node.index].generation != node.generation)
+		return NONE;
+	return slots[node.index].index;
+}
+
+u32 JojEngine::TransformHierarchy::find_level(u32 index) const
+{
+	return u32(std::upper_bound(level_begin.begin(), level_begin.end(), index) - level_begin.begin()) - 1;
+}
+
+void JojEngine::TransformHierarchy::mark_dirty(u32 index)
+{
+	flags[index] |= NODE_DIRTY;
+	changed = true;
+
+	// Sorting recomputes the level ranges
+	if (unsorted)
+		return;
+
+	Range& range = level_dirty[find_level(index)];
+	if (range.begin == range.end)
+	{
+		range = { index, index + 1 };
+	}
+	else
+	{
+		range.begin = index < range.begin ? index : range.begin;
+		range.end = index + 1 > range.end ? index + 1 : range.end;
+	}
+}
+
+void JojEngine::TransformHierarchy::release(u32 index)
+{
+	flags[index] |= NODE_REMOVED;
+	Slot& slot = slots[owners[index]];
+	slot.generation = slot.generation + 1 ? slot.generation + 1 : 1;
+	slot.index = free_slot;
+	free_slot = owners[index];
+	count--;
+}
+
+void JojEngine::TransformHierarchy::sort()
+{
+	FPROFILE_ZONE("transform_sort");
+
+	u32 total = u32(locals.size());
+
+	// Children of every live node, in index order
+	std::vector<u32> first(total + 1, 0);
+	for (u32 i = 0; i < total; ++i)
+	{
+		if (!(flags[i] & NODE_REMOVED) && parents[i] != NONE)
+			first[parents[i] + 1]++;
+	}
+	for (u32 i = 0; i < total; ++i)
+		first[i + 1] += first[i];
+
+	std::vector<u32> child_list(first[total]);
+	std::vector<u32> fill(first.begin(), first.end() - 1);
+	for (u32 i = 0; i < total; ++i)
+	{
+		if (!(flags[i] & NODE_REMOVED) && parents[i] != NONE)
+			child_list[fill[parents[i]]++] = i;
+	}
+
+	// Breadth-first: roots, then the children of each node of a level in the order of the level
+	std::vector<u32> order;
+	order.reserve(count);
+	for (u32 i = 0; i < total; ++i)
+	{
+		if (!(flags[i] & NODE_REMOVED) && parents[i] == NONE)
+			order.push_back(i);
+	}
+
+	std::vector<u32> sorted_children(count + 1);
+	level_begin.clear();
+	u32 begin = 0;
+	while (begin < order.size())
+	{
+		level_begin.push_back(begin);
+		u32 end = u32(order.size());
+		for (u32 k = begin; k < end; ++k)
+		{
+			sorted_children[k] = u32(order.size());
+			order.insert(order.end(), child_list.begin() + first[order[k]], child_list.begin() + first[order[k] + 1]);
+		}
+		begin = end;
+	}
+	level_begin.push_back(u32(order.size()));
+	sorted_children[order.size()] = u32(order.size());
+
+	std::vector<u32> remap(total, NONE);
+	for (u32 k = 0; k < order.size(); ++k)
+		remap[order[k]] = k;
+
+	std::vector<Transform> sorted_locals(order.size());
+	std::vector<Mat4> sorted_worlds(order.size());
+	std::vector<u32> sorted_parents(order.size());
+	std::vector<u8> sorted_flags(order.size());
+	std::vector<u32> sorted_owners(order.size());
+
+	for (u32 k = 0; k < order.size(); ++k)
+	{
+		u32 i = order[k];
+		sorted_locals[k] = locals[i];
+		sorted_worlds[k] = worlds[i];
+		sorted_parents[k] = parents[i] == NONE ? NONE : remap[parents[i]];
+		sorted_flags[k] = flags[i];
+		sorted_owners[k] = owners[i];
+		slots[owners[i]].index = k;
+	}
+
+	locals.swap(sorted_locals);
+	worlds.swap(sorted_worlds);
+	parents.swap(sorted_parents);
+	children.swap(sorted_children);
+	flags.swap(sorted_flags);
+	owners.swap(sorted_owners);
+	unsorted = false;
+	removed = false;
+
+	level_dirty.assign(get_level_count(), Range{ 0, 0 });
+	for (u32 k = 0; k < order.size(); ++k)
+	{
+		if (flags[k] & NODE_DIRTY)
+			mark_dirty(k);
+	}
+}
+
+u32 JojEngine::TransformHierarchy::update_range(u32 begin, u32 end)
+{
+	f32 lanes[12][COLUMN_BATCH];
+	Vec3SoA x_axis = vec3_soa_create(lanes[0], lanes[1], lanes[2]);
+	Vec3SoA y_axis = vec3_soa_create(lanes[3], lanes[4], lanes[5]);
+	Vec3SoA z_axis = vec3_soa_create(lanes[6], lanes[7], lanes[8]);
+	Vec3SoA translation = vec3_soa_create(lanes[9], lanes[10], lanes[11]);
+
+	u32 updated = 0;
+	u32 i = begin;
+
+	while (i < end)
+	{
+		// Run of consecutive nodes to recompute that share a parent (roots only share the level)
+		u32 parent = parents[i];
+		b8 parent_dirty = parent != NONE && (flags[parent] & NODE_DIRTY);
+		if (!parent_dirty && !(flags[i] & NODE_DIRTY))
+		{
+			i++;
+			continue;
+		}
+
+		u32 run = i;
+		while (i < end && i - run < COLUMN_BATCH && parents[i] == parent && (parent_dirty || (flags[i] & NODE_DIRTY)))
+		{
+			// Children on the next level see the flag
+			flags[i] |= NODE_DIRTY;
+			i++;
+		}
+		u32 n = i - run;
+
+		// world = local * parent world: the parent transforms the local axes as vectors and the translation as a point
+		transform_columns_soa(&locals[run], x_axis, y_axis, z_axis, translation, n);
+		if (parent != NONE)
+		{
+			Mat4 parent_world = worlds[parent];
+			mat4_transform_vectors_soa(parent_world, x_axis, x_axis, n);
+			mat4_transform_vectors_soa(parent_world, y_axis, y_axis, n);
+			mat4_transform_vectors_soa(parent_world, z_axis, z_axis, n);
+			mat4_transform_points_soa(parent_world, translation, translation, n);
+		}
+
+		for (u32 k = 0; k < n; ++k)
+		{
+			f32* m = worlds[run + k].data;
+			m[0] = x_axis.x[k];			m[1] = x_axis.y[k];			m[2] = x_axis.z[k];			m[3] = 0.0f;
+			m[4] = y_axis.x[k];			m[5] = y_axis.y[k];			m[6] = y_axis.z[k];			m[7] = 0.0f;
+			m[8] = z_axis.x[k];			m[9] = z_axis.y[k];			m[10] = z_axis.z[k];		m[11] = 0.0f;
+			m[12] = translation.x[k];	m[13] = translation.y[k];	m[14] = translation.z[k];	m[15] = 1.0f;
+		}
+		updated += n;
+	}
+
+	return updated;
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "defines.h"
+
+#include "fmath.h"
+#include "handle_pool.h"
+#include "job_system.h"
+#include <vector>
+
+namespace JojEngine
+{
+	/* Scene transform hierarchy
+	 * Nodes have a local transform (relative to their parent) and a world
+	 * matrix, world = local * parent world (the child transform is applied
+	 * first, as with mat4_mul). Nodes are stored breadth-first in parallel
+	 * arrays: every level is one contiguous range whose parents all lie in
+	 * the level before it, and the children of consecutive nodes are
+	 * consecutive. Each level keeps the index range of its dirty nodes.
+	 * update() walks the levels in order, visiting only that range plus the
+	 * children of what it recomputed on the level above, so it costs about
+	 * as much as the changed subtrees and an update without changes returns
+	 * at once: static scenery costs nothing per frame. Children of one
+	 * parent go through the SoA kernels of fmath_batch.h together, big
+	 * ranges are split across jobs on parent boundaries.
+	 * create and set_parent only record the change, destroy frees the
+	 * subtree at once and leaves holes: the arrays are re-sorted by the
+	 * next update. Not thread safe.
+	 */
+
+	struct TransformTag;
+	typedef Handle<TransformTag> TransformNode;
+
+	// Nodes of a level below which update() stays on the calling thread
+	const u32 TRANSFORM_PARALLEL_MIN = 4096;
+
+	// Nodes per job of a parallel level
+	const u32 TRANSFORM_BATCH_SIZE = 1024;
+
+	class TransformHierarchy
+	{
+	public:
+		TransformHierarchy();
+		~TransformHierarchy();
+
+		// Reserve room for capacity nodes, destroys current ones
+		b8 init(u32 capacity);
+
+		// Destroy every node, handles given out become stale
+		void clear();
+
+		// Add a node below parent (a root if parent is null), null if parent is stale
+		TransformNode create(const Transform& local, TransformNode parent = TransformNode());
+
+		// Destroy node and every node below it, return false if node is stale
+		b8 destroy(TransformNode node);
+
+		// Move node below parent (a root if parent is null), return false if it would create a cycle
+		b8 set_parent(TransformNode node, TransformNode parent);
+
+		// Replace local transform of node, its subtree is recomputed by the next update
+		b8 set_local(TransformNode node, const Transform& local);
+
+		// Return local transform of node, nullptr if node is stale
+		const Transform* get_local(TransformNode node) const;
+
+		// Return world matrix of node as of the last update, nullptr if node is stale
+		const Mat4* get_world(TransformNode node) const;
+
+		// Return parent of node (null for roots and stale nodes)
+		TransformNode get_parent(TransformNode node) const;
+
+		// Return true if node refers to a live node
+		b8 is_alive(TransformNode node) const;
+
+		/* @brief Recompute world matrices of changed subtrees, level by level.
+		 * Levels with at least TRANSFORM_PARALLEL_MIN nodes run on jobs when
+		 * given. Returns number of world matrices recomputed.
+		 */
+		u32 update(JobSystem* jobs = nullptr);
+
+		u32 get_count() const;				// Live nodes
+		u32 get_level_count() const;		// Depth of the deepest node plus one (after update)
+
+	private:
+		static constexpr u32 NONE = 0xFFFFFFFF;
+
+		enum NodeFlags : u8
+		{
+			NODE_DIRTY = 1,				// World matrix must be recomputed
+			NODE_REMOVED = 2,			// Destroyed, dropped by the next sort
+		};
+
+		struct Range
+		{
+			u32 begin;
+			u32 end;
+		};
+
+		struct Slot
+		{
+			u32 index;					// Position in the arrays, or next free slot while unused
+			u32 generation;				// Handles must match it, bumped on destroy
+		};
+
+		// Per node, in breadth-first order once sorted
+		std::vector<Transform> locals;
+		std::vector<Mat4> worlds;
+		std::vector<u32> parents;			// Index of the parent (NONE for roots)
+		std::vector<u32> children;			// Index of the first child, node i has children [children[i], children[i + 1])
+		std::vector<u8> flags;				// NodeFlags
+		std::vector<u32> owners;			// Slot of each node
+
+		std::vector<u32> level_begin;		// First node of each level, plus the node count
+		std::vector<Range> level_dirty;		// Nodes with NODE_DIRTY of each level are in this range
+		std::vector<Range> visited;			// Ranges walked by the current update
+
+		std::vector<Slot> slots;
+		u32 free_slot = NONE;				// First unused slot
+		u32 count = 0;						// Live nodes
+		b8 unsorted = false;				// Arrays are not breadth-first
+		b8 removed = false;					// Destroyed nodes wait in the arrays for the next sort
+		b8 changed = false;					// Some node has NODE_DIRTY
+
+		u32 find(TransformNode node) const;	// Index of node, NONE if stale
+		u32 find_level(u32 index) const;	// Level of a node of the sorted arrays
+		void sort();						// Drop removed nodes and restore breadth-first order
+		void mark_dirty(u32 index);			// Flag node for the next update
+		void release(u32 index);			// Flag node removed and free its slot
+		u32 update_range(u32 begin, u32 end);	// Recompute dirty nodes and children of dirty nodes in range
+	};
+}
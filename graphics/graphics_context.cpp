@@ -1,9 +1,13 @@
 #include "graphics_context.h"
 
+#if PLATFORM_WINDOWS
+
 JojGraphics::GraphicsContext::GraphicsContext()
 {
 }
 
 JojGraphics::GraphicsContext::~GraphicsContext()
 {
-}
\ No newline at end of file
+}
+
+#endif // PLATFORM_WINDOWS
@@ -5,6 +5,8 @@
 #include <memory>
 #include "platform_manager.h"
 
+#if PLATFORM_WINDOWS
+
 namespace JojGraphics
 {
 	class GraphicsContext
@@ -18,4 +20,6 @@ namespace JojGraphics
 	protected:
 		virtual void log_hardware_info() = 0;	// Show hardware information
 	};
-}
\ No newline at end of file
+}
+
+#endif // PLATFORM_WINDOWS
@@ -3,15 +3,14 @@
 #include "engine.h"
 #include <d3dcompiler.h>
 #include "error.h"
-
-using namespace DirectX;
+#include "logger.h"
 
 
 void D3D11App::init()
 {
 	// controla rotao do cubo
-	theta = DirectX::XM_PIDIV4;
-	phi = DirectX::XM_PIDIV4;
+	theta = F_PI / 4.0f;
+	phi = F_PI / 4.0f;
 	radius = 10.0f;
 
 	// pega ltima posio do mouse
@@ -19,17 +18,13 @@ void D3D11App::init()
 	last_ymouse = (f32)input->get_ymouse();
 
 	// inicializa as matrizes World e View para a identidade
-	World = View = {
-		1.0f, 0.0f, 0.0f, 0.0f,
-		0.0f, 1.0f, 0.0f, 0.0f,
-		0.0f, 0.0f, 1.0f, 0.0f,
-		0.0f, 0.0f, 0.0f, 1.0f };
+	World = View = mat4_identity();
 
 	// inicializa a matriz de projeo
-	XMStoreFloat4x4(&Proj, DirectX::XMMatrixPerspectiveFovLH(
-		DirectX::XMConvertToRadians(45.0f),
+	Proj = mat4_perspective_fov_lh(
+		to_radians(45.0f),
 		JojEngine::Engine::pm->get_window()->get_aspect_ratio(),
-		1.0f, 100.0f));
+		1.0f, 100.0f);
 
     // --------------------------------
     // Vertex Buffer
@@ -43,53 +38,61 @@ void D3D11App::init()
 	//geo = JojRenderer::Grid(100.0f, 20.0f, 20, 20);
 	//geo = JojRenderer::Quad(3.0f, 1.0f);
 
+	// Reorder indices and vertices for the post-transform cache before upload
+	JojRenderer::MeshOptimizationReport report = JojRenderer::optimize_mesh(geo);
+	FINFO("Mesh ACMR %.3f -> %.3f, ATVR %.3f -> %.3f.", report.before.acmr, report.after.acmr,
+	    report.before.atvr, report.after.atvr);
+
+	// Convert vertices to the GPU format, quantized positions are decoded by the world matrix
+	JojRenderer::PackedVertices packed_vertices = JojRenderer::pack_vertices(geo, vertex_format);
+	World = packed_vertices.get_position_transform();
+
 	// ------------------------------------------------------------------
 	// ------->> Transformation, Visualization and Projection <<---------
 	// ------------------------------------------------------------------
 
 	// World Matrix
-	DirectX::XMMATRIX S = DirectX::XMMatrixScaling(1.0f, 1.0f, 1.0f);
-	DirectX::XMMATRIX Ry = DirectX::XMMatrixRotationY(DirectX::XMConvertToRadians(30));
-	DirectX::XMMATRIX Rx = DirectX::XMMatrixRotationX(DirectX::XMConvertToRadians(-30));
-	DirectX::XMMATRIX T = DirectX::XMMatrixTranslation(0, 0, 0);
-	DirectX::XMMATRIX W = S * Ry * Rx * T;
+	Mat4 S = mat4_scale(mat4_identity(), vec3_create(1.0f, 1.0f, 1.0f));
+	Mat4 Ry = mat4_euler_y(to_radians(30));
+	Mat4 Rx = mat4_euler_x(to_radians(-30));
+	Mat4 T = mat4_translate(mat4_identity(), vec3_zero());
+	Mat4 W = mat4_mul(World, mat4_mul(mat4_mul(mat4_mul(S, Ry), Rx), T));
 
 	// View Matrix
-	DirectX::XMVECTOR pos = DirectX::XMVectorSet(0, 0, -6, 1);
-	DirectX::XMVECTOR target = DirectX::XMVectorZero();
-	DirectX::XMVECTOR up = DirectX::XMVectorSet(0, 1, 0, 0);
-	DirectX::XMMATRIX V = DirectX::XMMatrixLookAtLH(pos, target, up);
+	Vec3 pos = vec3_create(0, 0, -6);
+	Vec3 target = vec3_zero();
+	Vec3 up = vec3_up();
+	Mat4 V = mat4_look_at_lh(pos, target, up);
 
 	// Projection Matrix
-	DirectX::XMMATRIX P = DirectX::XMMatrixPerspectiveFovLH(
-		DirectX::XMConvertToRadians(45),
+	Mat4 P = mat4_perspective_fov_lh(
+		to_radians(45),
 		JojEngine::Engine::pm->get_window()->get_aspect_ratio(),
 		1.0f, 100.0f);
 
 	// Word-View-Projection Matrix
-	DirectX::XMMATRIX WorldViewProj = W * V * P;
+	Mat4 WorldViewProj = mat4_mul(mat4_mul(W, V), P);
 
 	// --------------------------------
 	// Constant Buffer
 	// --------------------------------
 
-	constBufferDesc.ByteWidth = sizeof(XMMATRIX);
-	constBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
-	constBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-	constBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-
-	XMMATRIX world_view_proj = XMMatrixTranspose(WorldViewProj);
-	constantData.pSysMem = &world_view_proj;
-
-	JojEngine::Engine::renderer->get_device()->CreateBuffer(&constBufferDesc, &constantData, &constant_buffer);
+	Mat4 world_view_proj = mat4_transpose(WorldViewProj);
 
-	JojEngine::Engine::renderer->get_device_context()->VSSetConstantBuffers(0, 1, &constant_buffer);
+	JojRenderer::BufferDesc constant_desc;
+	constant_desc.type = JojRenderer::BufferType::CONSTANT;
+	constant_desc.size = sizeof(Mat4);
+	constant_desc.data = &world_view_proj;
+	constant_buffer = JojEngine::Engine::renderer->create_buffer(constant_desc);
 
 	// Create vertex buffer
-	vertexBuffer = JojEngine::Engine::renderer->create_vertex_buffer(sizeof(Vertex), geo.get_vertex_count(), geo.get_vertex_data());
+	vertex_buffer = JojEngine::Engine::renderer->create_vertex_buffer(packed_vertices);
 
 	// Create index buffer
-	index_buffer = JojEngine::Engine::renderer->create_index_buffer(sizeof(u32), geo.get_index_count(), geo.get_index_data());
+	index_buffer = JojEngine::Engine::renderer->create_index_buffer(geo);
+
+	// Draw the whole index buffer
+	mesh = JojEngine::Engine::renderer->create_mesh(vertex_buffer, index_buffer, geo.get_index_count());
 
 	DWORD shaderFlags = 0;
 #ifndef _DEBUG
@@ -98,46 +101,23 @@ void D3D11App::init()
 #endif // !_DEBUG
 
 	// --------------------------------
-	// Vertex Shader
+	// Shaders and Input Layout
 	// --------------------------------
 
-	// Compile and Create Vertex Shader
-	ID3DBlob* vs_blob = nullptr;			// Vertex shader
-	
 	// Joj\--out\-build\-x64-debug\-joj\-Debug
-	// Compile and create Vertex Shader
-	vertex_shader = JojEngine::Engine::renderer->compile_and_create_vs_from_file(L"../../../../../joj/vertex.hlsl", vs_blob, shaderFlags);
-
-	// Compile and Create Pixel Shader
-	ID3DBlob* ps_blob = nullptr;			// Pixel shader
-	pixel_shader = JojEngine::Engine::renderer->compile_and_create_ps_from_file(L"../../../../../joj/pixel.hlsl", ps_blob, shaderFlags);
-
-
-	// --------------------------------
-	// Input Assembler
-	// --------------------------------
+	// Compile Vertex and Pixel Shaders, input layout comes from the packed vertex format
+	JojRenderer::ShaderDesc shader_desc;
+	shader_desc.vertex = "../../../../../joj/vertex.hlsl";
+	shader_desc.pixel = "../../../../../joj/pixel.hlsl";
+	shader_desc.vertex_format = &vertex_format;
+	shader_desc.flags = shaderFlags;
+	shader = JojEngine::Engine::renderer->create_shader(shader_desc);
 
-	// Input layout
-	ID3D11InputLayout* input_layout = nullptr;
-
-	// Description of Vertex Structure we created
-	D3D11_INPUT_ELEMENT_DESC input_desc[2] =
-	{
-		{ "POSITION",	0, DXGI_FORMAT_R32G32B32_FLOAT, 0,  0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
-		{ "COLOR",		0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0 }				// 3 'floats' x 4 bytes = 12 bytes
-	};
-
-	// Create and bind input layout to Input Assembler Stage
-	if (!JojEngine::Engine::renderer->create_and_set_input_layout(input_desc, ARRAYSIZE(input_desc), vs_blob, input_layout))
-		OutputDebugString("Failed to create and set input layout\n");
+	if (mesh.is_null() || shader.is_null() || constant_buffer.is_null())
+		FERROR(ERR_RENDERER, "Failed to create D3D11App resources.");
 
 	// Tell how Direct3D will form geometric primitives from vertex data
 	JojEngine::Engine::renderer->set_primitive_topology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-	// ------------------------------------------------------------------------------------------------------------------------------------------------
-
-	// Relase Direct3D resources
-	vs_blob->Release();
-	ps_blob->Release();
 }
 
 void D3D11App::update()
@@ -152,8 +132,8 @@ void D3D11App::update()
 	if (input->is_key_down(VK_LBUTTON))
 	{
 		// cada pixel corresponde a 1/4 de grau
-		f32 dx = DirectX::XMConvertToRadians(0.4f * (xmouse - last_xmouse));
-		f32 dy = DirectX::XMConvertToRadians(0.4f * (ymouse - last_ymouse));
+		f32 dx = to_radians(0.4f * (xmouse - last_xmouse));
+		f32 dy = to_radians(0.4f * (ymouse - last_ymouse));
 
 		// atualiza ngulos com base no deslocamento do mouse 
 		// para orbitar a cmera ao redor da caixa
@@ -161,7 +141,7 @@ void D3D11App::update()
 		phi += dy;
 
 		// restringe o ngulo de phi ]0-180[ graus
-		phi = phi < 0.1f ? 0.1f : (phi > (DirectX::XM_PI - 0.1f) ? DirectX::XM_PI - 0.1f : phi);
+		phi = phi < 0.1f ? 0.1f : (phi > (F_PI - 0.1f) ? F_PI - 0.1f : phi);
 	}
 	else if (input->is_key_down(VK_RBUTTON))
 	{
@@ -185,81 +165,40 @@ void D3D11App::update()
 	f32 y = radius * cosf(phi);
 
 	// constri a matriz da cmera (view matrix)
-	DirectX::XMVECTOR pos = DirectX::XMVectorSet(x, y, z, 1.0f);
-	DirectX::XMVECTOR target = DirectX::XMVectorZero();
-	DirectX::XMVECTOR up = DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
-	DirectX::XMMATRIX view = DirectX::XMMatrixLookAtLH(pos, target, up);
-	XMStoreFloat4x4(&View, view);
+	Vec3 pos = vec3_create(x, y, z);
+	Vec3 target = vec3_zero();
+	Vec3 up = vec3_up();
+	View = mat4_look_at_lh(pos, target, up);
 
 	// constri matriz combinada (world x view x proj)
-	DirectX::XMMATRIX world = XMLoadFloat4x4(&World);
-	DirectX::XMMATRIX proj = XMLoadFloat4x4(&Proj);
-	DirectX::XMMATRIX WorldViewProj = world * view * proj;
+	Mat4 WorldViewProj = mat4_mul(mat4_mul(World, View), Proj);
 
 	// Update constant buffer with combined matrix (Word-View-Projection Matrix)
 	JojRenderer::ObjectConstant obj_constant;
-	XMStoreFloat4x4(&obj_constant.world_view_proj, DirectX::XMMatrixTranspose(WorldViewProj));
-	constantData.pSysMem = &obj_constant.world_view_proj;
-
-	//JojEngine::Engine::renderer->get_device()->CreateBuffer(&constBufferDesc, &constantData, &constant_buffer);
-	//JojEngine::Engine::renderer->get_device_context()->VSSetConstantBuffers(0, 1, &constant_buffer);
-
-	// Get a pointer to the constant buffer data.
-	D3D11_MAPPED_SUBRESOURCE mapped_buffer = {};
-	JojEngine::Engine::renderer->get_device_context()->Map(constant_buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped_buffer);
+	obj_constant.world_view_proj = mat4_transpose(WorldViewProj);
 
-	// Copy the new data to the constant buffer data.
-	memcpy(mapped_buffer.pData, &obj_constant, sizeof(JojRenderer::ObjectConstant));
-
-	// Release the pointer to the constant buffer data.
-	JojEngine::Engine::renderer->get_device_context()->Unmap(constant_buffer, 0);
+	JojEngine::Engine::renderer->update_buffer(constant_buffer, &obj_constant, sizeof(JojRenderer::ObjectConstant));
 }
 
 void D3D11App::draw()
 {
 	JojEngine::Engine::renderer->clear();
 
-	UINT stride = sizeof(Vertex);	// Store size os Vertex Structure
-	UINT offset = 0;				// Pointer to where the first Vertex Buffer is in array
-
-	// Bind Vertex Buffer to an input slot of the device
-	JojEngine::Engine::renderer->get_device_context()->IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
-
-	// Bind index buffer to the pipeline
-	JojEngine::Engine::renderer->get_device_context()->IASetIndexBuffer(index_buffer, DXGI_FORMAT_R32_UINT, 0);
-
-	// Bind Vertex and Pixel Shaders
-	JojEngine::Engine::renderer->get_device_context()->VSSetShader(vertex_shader, nullptr, 0);
-	JojEngine::Engine::renderer->get_device_context()->PSSetShader(pixel_shader, nullptr, 0);
-
-	// Bind constant buffer
-	JojEngine::Engine::renderer->get_device_context()->VSSetConstantBuffers(0, 1, &constant_buffer);
+	// Bind Vertex and Pixel Shaders and the constant buffer
+	JojEngine::Engine::renderer->set_shader(shader);
+	JojEngine::Engine::renderer->set_constant_buffer(0, constant_buffer);
 
 	// Draw
-	JojEngine::Engine::renderer->get_device_context()->DrawIndexedInstanced(geo.get_index_count(), 1, 0, 0, 0);
+	JojEngine::Engine::renderer->draw_mesh(mesh);
 
 	JojEngine::Engine::renderer->swap_buffers();
 }
 
 void D3D11App::shutdown()
 {
-	// Release constant buffer
-	if (constant_buffer)
-		constant_buffer->Release();
-
-	// Release Buffer resource
-	if (vertexBuffer)
-		vertexBuffer->Release();
-
-	// Release Index buffer;
-	if (index_buffer)
-		index_buffer->Release();
-
-	// Release Vertex Shader
-	if (vertex_shader)
-		vertex_shader->Release();
-
-	// Release Pixel Shader
-	if (pixel_shader)
-		pixel_shader->Release();
-}
\ No newline at end of file
+	JojEngine::Engine::renderer->destroy_mesh(mesh);
+	JojEngine::Engine::renderer->destroy_shader(shader);
+	JojEngine::Engine::renderer->destroy_buffer(constant_buffer);
+	JojEngine::Engine::renderer->destroy_buffer(vertex_buffer);
+	JojEngine::Engine::renderer->destroy_buffer(index_buffer);
+}
@@ -1,16 +1,11 @@
 #pragma once
 
 #include "game.h"
-#include "DirectXMath.h"
-#include <d3d11.h>
+#include "fmath.h"
 
 #include "geometry.h"
-
-struct Vertex
-{
-	DirectX::XMFLOAT3 pos;
-	DirectX::XMFLOAT4 color;
-};
+#include "mesh_optimizer.h"
+#include "vertex_format.h"
 
 class D3D11App : public JojEngine::Game
 {
@@ -21,14 +16,11 @@ public:
 	void shutdown();
 
 private:
-	ID3D11Buffer* vertexBuffer = nullptr;		// Buffer resource
-	ID3D11Buffer* index_buffer = nullptr;		// Index buffer;
-	ID3D11VertexShader* vertex_shader = nullptr;	// Manages Vertex Shade Program and control Vertex Shader Stage 
-	ID3D11PixelShader* pixel_shader = nullptr;	// Manages Pixel Shader Program and controls Pixel Shader Stage
-
-	ID3D11Buffer* constant_buffer = nullptr;
-	D3D11_SUBRESOURCE_DATA constantData = { 0 };
-	D3D11_BUFFER_DESC constBufferDesc = { 0 };
+	JojRenderer::BufferHandle vertex_buffer;	// Buffer resource
+	JojRenderer::BufferHandle index_buffer;		// Index buffer
+	JojRenderer::BufferHandle constant_buffer;	// World-View-Projection matrix
+	JojRenderer::MeshHandle mesh;				// Vertex and index buffers drawn together
+	JojRenderer::ShaderHandle shader;			// Vertex and Pixel Shaders with their input layout
 
 	//JojRenderer::Cube geo = {};
 	//JojRenderer::Cylinder geo = {};
@@ -37,12 +29,13 @@ private:
 	//JojRenderer::Grid geo = {};
 	//JojRenderer::Quad geo = {};
 
-	ID3D11RasterizerState* raster_state = nullptr;	// Rasterizer state
+	// Vertex layout uploaded to the GPU
+	JojRenderer::VertexFormat vertex_format = JojRenderer::VertexFormat::compact();
 
 	// Camera settings
-	DirectX::XMFLOAT4X4 World = {};
-	DirectX::XMFLOAT4X4 View = {};
-	DirectX::XMFLOAT4X4 Proj = {};
+	Mat4 World = mat4_identity();
+	Mat4 View = mat4_identity();
+	Mat4 Proj = mat4_identity();
 
 	f32 theta = 0;
 	f32 phi = 0;
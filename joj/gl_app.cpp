@@ -12,63 +12,25 @@ using namespace std;
 
 void GLApp::build_buffers()
 {
-    DirectX::XMFLOAT3 vertices[] = {
-        DirectX::XMFLOAT3{ +0.5f, +0.5f, +0.0f },  // top right
-        DirectX::XMFLOAT3{ +0.5f, -0.5f, +0.0f },  // bottom right
-        DirectX::XMFLOAT3{ -0.5f, -0.5f, +0.0f },  // bottom left
-        DirectX::XMFLOAT3{ -0.5f, +0.5f, +0.0f }   // top left 
-    };
-
-    unsigned int indices[] = {  // note that we start from 0!
-        0, 1, 3,  // first Triangle
-        1, 2, 3   // second Triangle
-    };
-
-    // Create a vbo and a vao
-    glGenBuffers(1, &vbo);
-    glGenBuffers(1, &ebo);
-    glGenVertexArrays(1, &vao);
-    glGenVertexArrays(1, &light_vao);
-
-    // Bind the vbo and the vao
-    glBindVertexArray(vao);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-
-    // Fill the vbo with the vertex data
-    glBufferData(GL_ARRAY_BUFFER, (geo.get_vertex_count() * sizeof(JojRenderer::Vertex)), geo.get_vertex_data(), GL_STATIC_DRAW);
-
-    // Bind ebo and fill the ebo with the index data
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, geo.get_index_count() * sizeof(u32), geo.get_index_data(), GL_STATIC_DRAW);
-
-    // Specify the layout of the vertex(pos) data
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 7 * sizeof(f32), (GLvoid*)0);
-
-    // Specify the layout of the vertex(color) data
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 7 * sizeof(f32), (GLvoid*)(3 * sizeof(f32)));
-
-    // second, configure the light's VAO (VBO stays the same; the vertices are the same for the light object which is also a 3D cube)
-    glBindVertexArray(light_vao);
-
-    // we only need to bind to the VBO (to link it with glVertexAttribPointer), no need to fill it; the VBO's data already contains all we need (it's already bound, but we do it again for educational purposes)
-    //glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    
-    // Need to bind the ebo
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-
-    // Specify the layout of the vertex(pos) data
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 7 * sizeof(f32), (GLvoid*)0);
-    glEnableVertexAttribArray(0);
-
-    // Specify the layout of the vertex(color) data
-    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 7 * sizeof(f32), (GLvoid*)(3 * sizeof(f32)));
-    glEnableVertexAttribArray(1);
-
-    // Unbind the vbo and the vao
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    // Vertex buffer with JojRenderer::Vertex as is (pos, color)
+    JojRenderer::BufferDesc vertex_desc;
+    vertex_desc.type = JojRenderer::BufferType::VERTEX;
+    vertex_desc.size = u32(geo.get_vertex_count() * sizeof(JojRenderer::Vertex));
+    vertex_desc.stride = sizeof(JojRenderer::Vertex);
+    vertex_desc.data = geo.get_vertex_data();
+    vertex_buffer = JojEngine::Engine::gl_renderer->create_buffer(vertex_desc);
+
+    JojRenderer::BufferDesc index_desc;
+    index_desc.type = JojRenderer::BufferType::INDEX;
+    index_desc.size = geo.get_index_data_size();
+    index_desc.stride = geo.get_index_size();
+    index_desc.data = geo.get_index_data();
+    index_buffer = JojEngine::Engine::gl_renderer->create_buffer(index_desc);
+
+    mesh = JojEngine::Engine::gl_renderer->create_mesh(vertex_buffer, index_buffer, geo.get_index_count(), JojRenderer::VertexFormat::full());
+
+    // The light is also a cube: its vertex array reads the same buffers
+    light_mesh = JojEngine::Engine::gl_renderer->create_mesh(vertex_buffer, index_buffer, light_cube.get_index_count(), JojRenderer::VertexFormat::full());
 }
 
 f32 x = 0;
@@ -77,55 +39,57 @@ f32 z = 20;
 f32 velocity = 10.0f;
 
 // lighting
-DirectX::XMFLOAT3 lightPos{ 30.0f, 10.0f, 10.0f };
+Vec3 lightPos{ 30.0f, 10.0f, 10.0f };
 void GLApp::init()
 {
     // Geometries
-    cube_color = DirectX::XMFLOAT4{ 1.0f, 0.5f, 0.31f, 1.0f };
+    cube_color = Vec4{ 1.0f, 0.5f, 0.31f, 1.0f };
     geo = JojRenderer::Cube{ 3.0f, 3.0f, 3.0f, cube_color };
     //light_cube.move_to(lightPos.x, lightPos.y, lightPos.z);
 
     build_buffers();
 
-    shader.compile_shaders(geo_vertex, geo_frag);
-    light_shader.compile_shaders(light_vertex, light_frag);
+    JojRenderer::ShaderDesc shader_desc;
+    shader_desc.vertex = geo_vertex;
+    shader_desc.pixel = geo_frag;
+    shader = JojEngine::Engine::gl_renderer->create_shader(shader_desc);
+
+    shader_desc.vertex = light_vertex;
+    shader_desc.pixel = light_frag;
+    light_shader = JojEngine::Engine::gl_renderer->create_shader(shader_desc);
 
     // inicializa as matrizes World e View para a identidade
-    World = View = {
-        1.0f, 0.0f, 0.0f, 0.0f,
-        0.0f, 1.0f, 0.0f, 0.0f,
-        0.0f, 0.0f, 1.0f, 0.0f,
-        0.0f, 0.0f, 0.0f, 1.0f };
+    World = View = mat4_identity();
 
     // inicializa a matriz de projeo
-    XMStoreFloat4x4(&Proj, DirectX::XMMatrixPerspectiveFovLH(
-        DirectX::XMConvertToRadians(45.0f),
+    Proj = mat4_perspective_fov_lh(
+        to_radians(45.0f),
         JojEngine::Engine::pm->get_window()->get_aspect_ratio(),
-        1.0f, 100.0f));
+        1.0f, 100.0f);
 
     // World Matrix
-    DirectX::XMMATRIX W = DirectX::XMMatrixIdentity();
+    Mat4 W = mat4_identity();
 
     // View Matrix
-    camera.position = DirectX::XMFLOAT3{ 0.64f, -0.56f, camera.position.z -3 };
-    DirectX::XMMATRIX V = camera.get_view_mat();
+    camera.position = Vec3{ 0.64f, -0.56f, camera.position.z -3 };
+    Mat4 V = camera.get_view_mat();
 
     // Projection Matrix
-    DirectX::XMMATRIX P = DirectX::XMMatrixPerspectiveFovLH(
-        DirectX::XMConvertToRadians(camera.zoom),
+    Mat4 P = mat4_perspective_fov_lh(
+        to_radians(camera.zoom),
         JojEngine::Engine::pm->get_window()->get_aspect_ratio(),
         1.0f, 100.0f);
 
     // Word-View-Projection Matrix
-    DirectX::XMMATRIX WorldViewProj = W * V * P;
+    Mat4 WorldViewProj = mat4_mul(mat4_mul(W, V), P);
 
-    shader.use();
-    shader.set_dxmat4("transform", WorldViewProj);
+    JojEngine::Engine::gl_renderer->set_shader(shader);
+    JojEngine::Engine::gl_renderer->get_shader(shader)->set_mat4("transform", WorldViewProj);
 
 
-    WorldViewProj = W * V * P;
-    light_shader.use();
-    light_shader.set_dxmat4("transform", WorldViewProj);
+    WorldViewProj = mat4_mul(mat4_mul(W, V), P);
+    JojEngine::Engine::gl_renderer->set_shader(light_shader);
+    JojEngine::Engine::gl_renderer->get_shader(light_shader)->set_mat4("transform", WorldViewProj);
 
     mouse_callback(JojEngine::Engine::pm->get_xmouse(), JojEngine::Engine::pm->get_ymouse());
 
@@ -185,31 +149,30 @@ void GLApp::update()
     }
 
     // Transformations
-    DirectX::XMMATRIX world = XMLoadFloat4x4(&World);
+    Mat4 world = World;
 
     // constri a matriz da cmera (view matrix)
-    DirectX::XMMATRIX view = camera.get_view_mat();
-    XMStoreFloat4x4(&View, view);
+    View = camera.get_view_mat();
 
     // Projection Matrix
-    DirectX::XMMATRIX proj = XMLoadFloat4x4(&Proj);
+    Mat4 proj = Proj;
 
     // Word-View-Projection Matrix
-    DirectX::XMMATRIX WorldViewProj = world * view * proj;
+    Mat4 WorldViewProj = mat4_mul(mat4_mul(world, View), proj);
 
-    shader.use();
-    shader.set_dxmat4("transform", WorldViewProj);
+    JojEngine::Engine::gl_renderer->set_shader(shader);
+    JojEngine::Engine::gl_renderer->get_shader(shader)->set_mat4("transform", WorldViewProj);
 
     
-    world = DirectX::XMMatrixIdentity();
-    world = DirectX::XMMatrixTranslation(lightPos.x, lightPos.y, lightPos.z);
-    DirectX::XMMATRIX scale = DirectX::XMMatrixScaling(0.2f, 0.2f, 0.2f);
-    world = DirectX::XMMatrixMultiply(world, scale);
+    world = mat4_identity();
+    world = mat4_translate(world, lightPos);
+    Mat4 scale = mat4_scale(mat4_identity(), vec3_create(0.2f, 0.2f, 0.2f));
+    world = mat4_mul(world, scale);
     // Word-View-Projection Matrix
-    WorldViewProj = world * view * proj;
+    WorldViewProj = mat4_mul(mat4_mul(world, View), proj);
     
-    light_shader.use();
-    light_shader.set_dxmat4("transform", WorldViewProj);
+    JojEngine::Engine::gl_renderer->set_shader(light_shader);
+    JojEngine::Engine::gl_renderer->get_shader(light_shader)->set_mat4("transform", WorldViewProj);
 }
 
 void GLApp::draw()
@@ -218,15 +181,13 @@ void GLApp::draw()
     glClearColor(0.0f, 0.0f, 0.1f, 1.0f);
 
     // be sure to activate shader when setting uniforms/drawing objects
-    light_shader.use();
-    glBindVertexArray(light_vao);
-    glDrawElements(GL_TRIANGLES, light_cube.get_index_count(), GL_UNSIGNED_INT, 0);
-
-    shader.use();
-    glBindVertexArray(vao);         // seeing as we only have a single VAO there's no need to bind it every time, but we'll do so to keep things a bit more organized
-    shader.set_vec3("objectColor", cube_color.x, cube_color.y, cube_color.z);
-    shader.set_vec3("lightColor", 1.0f, 1.0f, 1.0f);
-    glDrawElements(GL_TRIANGLES, geo.get_index_count(), GL_UNSIGNED_INT, 0);
+    JojEngine::Engine::gl_renderer->set_shader(light_shader);
+    JojEngine::Engine::gl_renderer->draw_mesh(light_mesh);
+
+    JojEngine::Engine::gl_renderer->set_shader(shader);
+    JojEngine::Engine::gl_renderer->get_shader(shader)->set_vec3("objectColor", cube_color.x, cube_color.y, cube_color.z);
+    JojEngine::Engine::gl_renderer->get_shader(shader)->set_vec3("lightColor", 1.0f, 1.0f, 1.0f);
+    JojEngine::Engine::gl_renderer->draw_mesh(mesh);
     
 
     JojEngine::Engine::pm->swap_buffers();
@@ -236,6 +197,13 @@ void GLApp::shutdown()
 {
     ShowCursor(TRUE);
     ClipCursor(NULL);
+
+    JojEngine::Engine::gl_renderer->destroy_mesh(light_mesh);
+    JojEngine::Engine::gl_renderer->destroy_mesh(mesh);
+    JojEngine::Engine::gl_renderer->destroy_shader(light_shader);
+    JojEngine::Engine::gl_renderer->destroy_shader(shader);
+    JojEngine::Engine::gl_renderer->destroy_buffer(vertex_buffer);
+    JojEngine::Engine::gl_renderer->destroy_buffer(index_buffer);
 }
 
 void GLApp::process_camera_input()
@@ -3,9 +3,7 @@
 #include "game.h"
 #include "fmath.h"
 #include "opengl/shader.h"
-#include "opengl/quad.h"
 #include "geometry.h"
-#include "DirectXMath.h"
 #include "opengl/camera.h"
 
 class GLApp : public JojEngine::Game
@@ -106,31 +104,28 @@ private:
 	const char* vshader_path = "../shaders/vert.glsl";
 	const char* vfrag_path = "../shaders/frag.glsl";
 
-	u32 vbo = 0;
-	u32 vao = 0;
-	u32 ebo = 0;
-	i32 shader_program = 0;
-	JojRenderer::Shader shader;
+	JojRenderer::BufferHandle vertex_buffer;
+	JojRenderer::BufferHandle index_buffer;
+	JojRenderer::MeshHandle mesh;
+	JojRenderer::ShaderHandle shader;
 
 	JojRenderer::Cube geo;
-	DirectX::XMFLOAT4 cube_color;
+	Vec4 cube_color;
 
 	// Light settings
-	JojRenderer::Cube light_cube = JojRenderer::Cube{ 1.0f, 1.0f, 1.0f, DirectX::XMFLOAT4{1.0f, 1.0f, 1.0f, 1.0f} };
-	JojRenderer::Shader light_shader;
-	u32 light_vao;
-	u32 lvbo = 0;
-	u32 lebo = 0;
+	JojRenderer::Cube light_cube = JojRenderer::Cube{ 1.0f, 1.0f, 1.0f, Vec4{1.0f, 1.0f, 1.0f, 1.0f} };
+	JojRenderer::ShaderHandle light_shader;
+	JojRenderer::MeshHandle light_mesh;		// Same buffers as the cube
 
 
 
 	// Camera settings
-	DirectX::XMFLOAT4X4 World = {};
-	DirectX::XMFLOAT4X4 View = {};
-	DirectX::XMFLOAT4X4 Proj = {};
+	Mat4 World = mat4_identity();
+	Mat4 View = mat4_identity();
+	Mat4 Proj = mat4_identity();
 
 	// Camera object
-	JojRenderer::Camera camera = JojRenderer::Camera{ DirectX::XMFLOAT3{ 0.0f, 0.0f, 3.0f } };
+	JojRenderer::Camera camera = JojRenderer::Camera{ Vec3{ 0.0f, 0.0f, 3.0f } };
 	f32 lastX;
 	f32 lastY;
 	bool firstMouse = true;
@@ -138,55 +133,4 @@ private:
 	i32 centerY;
 	i32 cmouseX;
 	i32 cmouseY;
-};
-
-
-
-inline DirectX::XMFLOAT3 vec3_to_dxf3(Vec3 v)
-{
-	return DirectX::XMFLOAT3{ v.x, v.y, v.z };
-}
-
-inline Vec3 dxf3_to_vec3(DirectX::XMFLOAT3 v)
-{
-	return Vec3{ v.x, v.y, v.z };
-}
-
-inline DirectX::XMFLOAT4 vec4_to_dx4(Vec4 v)
-{
-	return DirectX::XMFLOAT4{ v.x, v.y, v.z, v.w };
-}
-
-inline Vec4 dxf4_to_vec4(DirectX::XMFLOAT4 v)
-{
-	return Vec4{ v.x, v.y, v.z, v.w };
-}
-
-inline DirectX::XMMATRIX mat4_to_dxmat(Mat4 m)
-{
-	return DirectX::XMMATRIX{ m.data };
-}
-
-inline Mat4 dxmat_to_mat4(DirectX::XMMATRIX m)
-{
-	DirectX::XMFLOAT4X4 aux;
-	XMStoreFloat4x4(&aux, m);
-	return Mat4{ 
-		aux._11, aux._12, aux._13, aux._14,
-		aux._21, aux._22, aux._23, aux._24,
-		aux._31, aux._32, aux._33, aux._34,
-		aux._41, aux._42, aux._43, aux._44
-	};
-}
-
-inline Mat4 dxmat_to_mat4trans(DirectX::XMMATRIX m)
-{
-	DirectX::XMFLOAT4X4 aux;
-	XMStoreFloat4x4(&aux, m);
-	return Mat4{
-		aux._11, aux._21, aux._31, aux._41,
-		aux._12, aux._22, aux._32, aux._42,
-		aux._13, aux._23, aux._33, aux._43,
-		aux._14, aux._24, aux._34, aux._44
-	};
-}
\ No newline at end of file
+};
\ No newline at end of file
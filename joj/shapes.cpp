@@ -3,12 +3,13 @@
 #include <d3dcompiler.h>
 #include "error.h"
 #include "engine.h"
+#include "logger.h"
 
 void Shapes::init()
 {
     // controla rotao do cubo
-    theta = DirectX::XM_PIDIV4;
-    phi = DirectX::XM_PIDIV4;
+    theta = F_PI / 4.0f;
+    phi = F_PI / 4.0f;
     radius = 10.0f;
 
     // pega ltima posio do mouse
@@ -16,17 +17,13 @@ void Shapes::init()
     last_ymouse  = (f32)input->get_ymouse();
 
     // inicializa as matrizes World e View para a identidade
-    World = View = {
-        1.0f, 0.0f, 0.0f, 0.0f,
-        0.0f, 1.0f, 0.0f, 0.0f,
-        0.0f, 0.0f, 1.0f, 0.0f,
-        0.0f, 0.0f, 0.0f, 1.0f };
+    World = View = mat4_identity();
 
     // inicializa a matriz de projeo
-    XMStoreFloat4x4(&Proj, DirectX::XMMatrixPerspectiveFovLH(
-        DirectX::XMConvertToRadians(45.0f),
+    Proj = mat4_perspective_fov_lh(
+        to_radians(45.0f),
         JojEngine::Engine::pm->get_window()->get_aspect_ratio(),
-        1.0f, 100.0f));
+        1.0f, 100.0f);
 
     JojEngine::Engine::dx12_renderer->reset_commands();
 
@@ -52,8 +49,8 @@ void Shapes::update()
     if (JojEngine::Engine::pm->is_key_down(VK_LBUTTON))
     {
         // cada pixel corresponde a 1/4 de grau
-        f32 dx = DirectX::XMConvertToRadians(0.4f * (xmouse - last_xmouse));
-        f32 dy = DirectX::XMConvertToRadians(0.4f * (ymouse - last_ymouse));
+        f32 dx = to_radians(0.4f * (xmouse - last_xmouse));
+        f32 dy = to_radians(0.4f * (ymouse - last_ymouse));
 
         // atualiza ngulos com base no deslocamento do mouse 
         // para orbitar a cmera ao redor da caixa
@@ -61,7 +58,7 @@ void Shapes::update()
         phi += dy;
 
         // restringe o ngulo de phi ]0-180[ graus
-        phi = phi < 0.1f ? 0.1f : (phi > (DirectX::XM_PI - 0.1f) ? DirectX::XM_PI - 0.1f : phi);
+        phi = phi < 0.1f ? 0.1f : (phi > (F_PI - 0.1f) ? F_PI - 0.1f : phi);
     }
     else if (JojEngine::Engine::pm->is_key_down(VK_RBUTTON))
     {
@@ -85,21 +82,18 @@ void Shapes::update()
     f32 y = radius * cosf(phi);
 
     // constri a matriz da cmera (view matrix)
-    DirectX::XMVECTOR pos = DirectX::XMVectorSet(x, y, z, 1.0f);
-    DirectX::XMVECTOR target = DirectX::XMVectorZero();
-    DirectX::XMVECTOR up = DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
-    DirectX::XMMATRIX view = DirectX::XMMatrixLookAtLH(pos, target, up);
-    XMStoreFloat4x4(&View, view);
+    Vec3 pos = vec3_create(x, y, z);
+    Vec3 target = vec3_zero();
+    Vec3 up = vec3_up();
+    View = mat4_look_at_lh(pos, target, up);
 
     // constri matriz combinada (world x view x proj)
-    DirectX::XMMATRIX world = XMLoadFloat4x4(&World);
-    DirectX::XMMATRIX proj = XMLoadFloat4x4(&Proj);
-    DirectX::XMMATRIX WorldViewProj = world * view * proj;
+    Mat4 WorldViewProj = mat4_mul(mat4_mul(World, View), Proj);
 
     // Update constant buffer with combined matrix (Word-View-Projection Matrix)
     JojRenderer::ObjectConstant obj_constant;
-    XMStoreFloat4x4(&obj_constant.world_view_proj, DirectX::XMMatrixTranspose(WorldViewProj));
-    memcpy(constant_buffer_data, &obj_constant, sizeof(JojRenderer::ObjectConstant));
+    obj_constant.world_view_proj = mat4_transpose(WorldViewProj);
+    JojEngine::Engine::dx12_renderer->update_buffer(constant_buffer, &obj_constant, sizeof(JojRenderer::ObjectConstant));
 }
 
 void Shapes::draw()
@@ -112,55 +106,24 @@ void Shapes::draw()
 
     JojEngine::Engine::dx12_renderer->get_command_list()->SetGraphicsRootSignature(root_signature);
 
-    vertex_buffer_view.BufferLocation = vertex_buffer_gpu->GetGPUVirtualAddress();
-    vertex_buffer_view.StrideInBytes = vertex_byte_stride;
-    vertex_buffer_view.SizeInBytes = vertex_buffer_size;
-    JojEngine::Engine::dx12_renderer->get_command_list()->IASetVertexBuffers(0, 1, &vertex_buffer_view);
-
-    index_buffer_view.BufferLocation = index_buffer_gpu->GetGPUVirtualAddress();
-    index_buffer_view.Format = index_format;
-    index_buffer_view.SizeInBytes = index_buffer_size;
-    JojEngine::Engine::dx12_renderer->get_command_list()->IASetIndexBuffer(&index_buffer_view);
-
-    JojEngine::Engine::dx12_renderer->get_command_list()->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-
     JojEngine::Engine::dx12_renderer->get_command_list()->SetGraphicsRootDescriptorTable(0, constant_buffer_heap->GetGPUDescriptorHandleForHeapStart());
 
     // Submit Drawing Commands
-    JojEngine::Engine::dx12_renderer->get_command_list()->DrawIndexedInstanced(geo.get_index_count() , 1, 0, 0, 0);
+    JojEngine::Engine::dx12_renderer->draw_mesh(mesh);
 
     JojEngine::Engine::dx12_renderer->swap_buffers();
 }
 
 void Shapes::shutdown()
 {
-    if (vertex_buffer_cpu)
-        vertex_buffer_cpu->Release();
-
-    if (index_buffer_cpu)
-        index_buffer_cpu->Release();
-
-    if (constant_buffer_upload)
-    {
-        constant_buffer_upload->Unmap(0, nullptr);
-        constant_buffer_upload->Release();
-    }
+    JojEngine::Engine::dx12_renderer->destroy_mesh(mesh);
+    JojEngine::Engine::dx12_renderer->destroy_buffer(vertex_buffer);
+    JojEngine::Engine::dx12_renderer->destroy_buffer(index_buffer);
+    JojEngine::Engine::dx12_renderer->destroy_buffer(constant_buffer);
 
     if (constant_buffer_heap)
         constant_buffer_heap->Release();
 
-    if (vertex_buffer_upload)
-        vertex_buffer_upload->Release();
-
-    if (index_buffer_upload)
-        index_buffer_upload->Release();
-
-    if (vertex_buffer_gpu)
-        vertex_buffer_gpu->Release();
-            
-    if (index_buffer_gpu)
-        index_buffer_gpu->Release();
-
     root_signature->Release();
     pipeline_state->Release();
 }
@@ -179,56 +142,21 @@ void Shapes::build_descriptor_heaps()
 
 void Shapes::build_constant_buffers()
 {
-    // Upload buffer heap properties
-    D3D12_HEAP_PROPERTIES upload_heap_properties = {};
-    upload_heap_properties.Type = D3D12_HEAP_TYPE_UPLOAD;
-    upload_heap_properties.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
-    upload_heap_properties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
-    upload_heap_properties.CreationNodeMask = 1;
-    upload_heap_properties.VisibleNodeMask = 1;
-
-    /* The size of the "Constant Buffers" must be multiple
-      of the minimum allocation size of the hardware (256 bytes) */
-    u32 constant_buffer_size = (sizeof(JojRenderer::ObjectConstant) + 255) & ~255;
-
-    // Upload buffer descriptor
-    D3D12_RESOURCE_DESC upload_buffer_desc = {};
-    upload_buffer_desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-    upload_buffer_desc.Alignment = 0;
-    upload_buffer_desc.Width = constant_buffer_size;
-    upload_buffer_desc.Height = 1;
-    upload_buffer_desc.DepthOrArraySize = 1;
-    upload_buffer_desc.MipLevels = 1;
-    upload_buffer_desc.Format = DXGI_FORMAT_UNKNOWN;
-    upload_buffer_desc.SampleDesc.Count = 1;
-    upload_buffer_desc.SampleDesc.Quality = 0;
-    upload_buffer_desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-    upload_buffer_desc.Flags = D3D12_RESOURCE_FLAG_NONE;
-
-    // Create an upload buffer for the constant buffer
-    JojEngine::Engine::dx12_renderer->get_device()->CreateCommittedResource(
-        &upload_heap_properties,
-        D3D12_HEAP_FLAG_NONE,
-        &upload_buffer_desc,
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(&constant_buffer_upload));
-
-    // Upload buffer address in GPU
-    D3D12_GPU_VIRTUAL_ADDRESS upload_address = constant_buffer_upload->GetGPUVirtualAddress();
-
-    // Describe constant buffer view
+    // Persistently mapped upload buffer, rewritten every update
+    JojRenderer::BufferDesc constant_desc;
+    constant_desc.type = JojRenderer::BufferType::CONSTANT;
+    constant_desc.size = sizeof(JojRenderer::ObjectConstant);
+    constant_buffer = JojEngine::Engine::dx12_renderer->create_buffer(constant_desc);
+
+    // Describe constant buffer view, the size is rounded up to 256 bytes by the renderer
     D3D12_CONSTANT_BUFFER_VIEW_DESC cbv_desc;
-    cbv_desc.BufferLocation = upload_address;
-    cbv_desc.SizeInBytes = constant_buffer_size;
+    cbv_desc.BufferLocation = JojEngine::Engine::dx12_renderer->get_buffer_address(constant_buffer);
+    cbv_desc.SizeInBytes = JojEngine::Engine::dx12_renderer->get_buffer_size(constant_buffer);
 
     // Create a view for constant buffer
     JojEngine::Engine::dx12_renderer->get_device()->CreateConstantBufferView(
         &cbv_desc,
         constant_buffer_heap->GetCPUDescriptorHandleForHeapStart());
-
-    // Map memory from the upload buffer to a CPU-accessible address
-    constant_buffer_upload->Map(0, nullptr, reinterpret_cast<void**>(&constant_buffer_data));
 }
 
 void Shapes::build_geometry()
@@ -245,37 +173,35 @@ void Shapes::build_geometry()
     //geo = JojRenderer::Grid(100.0f, 20.0f, 20, 20);
     //geo = JojRenderer::Quad(3.0f, 1.0f);
 
+    // Reorder indices and vertices for the post-transform cache before upload
+    JojRenderer::MeshOptimizationReport report = JojRenderer::optimize_mesh(geo);
+    FINFO("Mesh ACMR %.3f -> %.3f, ATVR %.3f -> %.3f.", report.before.acmr, report.after.acmr,
+        report.before.atvr, report.after.atvr);
+
     // -----------------------------------------------------------
     // >> Allocate and Copy Vertex and Index Buffers to the GPU <<
     // -----------------------------------------------------------
 
-    // Byte size of vertices and indexes
-    const u32 vb_size = geo.get_vertex_count() * sizeof(JojRenderer::Vertex);
-    const u32 ib_size = geo.get_index_count() * sizeof(u32);
-
-    // Setup geometry attributes (Mesh)
-    vertex_byte_stride = sizeof(JojRenderer::Vertex);
-    vertex_buffer_size = vb_size;
-    index_format = DXGI_FORMAT_R32_UINT;
-    index_buffer_size = ib_size;
-
-    // Allocate resources to the Vertex Buffer
-    JojEngine::Engine::dx12_renderer->allocate_resource_in_cpu(vb_size, &vertex_buffer_cpu);
-    JojEngine::Engine::dx12_renderer->allocate_resource_in_gpu(JojRenderer::AllocationType::UPLOAD, vb_size, &vertex_buffer_upload);
-    JojEngine::Engine::dx12_renderer->allocate_resource_in_gpu(JojRenderer::AllocationType::GPU, vb_size, &vertex_buffer_gpu);
-
-    // Allocate resources to the Index Buffer
-    JojEngine::Engine::dx12_renderer->allocate_resource_in_cpu(ib_size, &index_buffer_cpu);
-    JojEngine::Engine::dx12_renderer->allocate_resource_in_gpu(JojRenderer::AllocationType::UPLOAD, ib_size, &index_buffer_upload);
-    JojEngine::Engine::dx12_renderer->allocate_resource_in_gpu(JojRenderer::AllocationType::GPU, ib_size, &index_buffer_gpu);
-
-    // Save a copy of the vertices and indexes in the 'mesh'
-    JojEngine::Engine::dx12_renderer->copy_verts_to_cpu_blob(geo.get_vertex_data(), vb_size, vertex_buffer_cpu);
-    JojEngine::Engine::dx12_renderer->copy_verts_to_cpu_blob(geo.get_index_data(), ib_size, index_buffer_cpu);
-
-    // Copy vertices and indexes to the GPU using the Upload buffer
-    JojEngine::Engine::dx12_renderer->copy_verts_to_gpu(geo.get_vertex_data(), vb_size, vertex_buffer_upload, vertex_buffer_gpu);
-    JojEngine::Engine::dx12_renderer->copy_verts_to_gpu(geo.get_index_data(), ib_size, index_buffer_upload, index_buffer_gpu);
+    // Convert vertices to the GPU format, quantized positions are decoded by the world matrix
+    JojRenderer::PackedVertices packed_vertices = JojRenderer::pack_vertices(geo, vertex_format);
+    World = packed_vertices.get_position_transform();
+
+    // Vertex and index buffers keep a CPU copy and are copied to the GPU through an upload buffer
+    JojRenderer::BufferDesc vertex_desc;
+    vertex_desc.type = JojRenderer::BufferType::VERTEX;
+    vertex_desc.size = packed_vertices.get_data_size();
+    vertex_desc.stride = vertex_format.get_stride();
+    vertex_desc.data = packed_vertices.data.data();
+    vertex_buffer = JojEngine::Engine::dx12_renderer->create_buffer(vertex_desc);
+
+    JojRenderer::BufferDesc index_desc;
+    index_desc.type = JojRenderer::BufferType::INDEX;
+    index_desc.size = geo.get_index_data_size();
+    index_desc.stride = geo.get_index_size();
+    index_desc.data = geo.get_index_data();
+    index_buffer = JojEngine::Engine::dx12_renderer->create_buffer(index_desc);
+
+    mesh = JojEngine::Engine::dx12_renderer->create_mesh(vertex_buffer, index_buffer, geo.get_index_count());
 }
 
 void Shapes::build_root_signature()
@@ -334,38 +260,18 @@ void Shapes::build_pipeline_state()
     // Input Assembler
     // --------------------------------
 
-    // Setup vertex description
-    D3D12_INPUT_ELEMENT_DESC input_layout[2] =
-    {
-        {
-            "POSITION",                                     // Semantic name
-            0,                                              // Semantic index
-            DXGI_FORMAT_R32G32B32_FLOAT,                    // Format of this vertex element (3D 32-bit f32 vector)
-            0,                                              // Input slot index this element will come from
-            0,                                              // Aligned byte offset
-            D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,     // Input slot class (simple technique of instancing)
-            0                                               // Instance data step rate (0 = no advanced technique of instancing)
-        },
-        {
-            "COLOR",                                        // Semantic name
-            0,                                              // Semantic index
-            DXGI_FORMAT_R32G32B32A32_FLOAT,                 // Format of this vertex element (3D 32-bit f32 vector)
-            0,                                              // Input slot index this element will come from
-            12,                                             // Aligned byte offset (4 bytes * XMFLOAT3 = 12)
-            D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,     // Input slot class (simple technique of instancing)
-            0                                               // Instance data step rate (0 = no advanced technique of instancing)
-        }
-    };
+    // Setup vertex description from the vertex format
+    D3D12_INPUT_ELEMENT_DESC input_layout[JojRenderer::MAX_VERTEX_ATTRIBUTES];
+    u32 input_layout_count = JojRenderer::DX12Renderer::get_input_layout(vertex_format, input_layout);
 
     // --------------------
     // ----- Shaders ------
     // --------------------
 
-    ID3DBlob* vertex_shader;
-    ID3DBlob* pixel_shader;
-
-    D3DReadFileToBlob(L"../vertex.cso", &vertex_shader);
-    D3DReadFileToBlob(L"../pixel.cso", &pixel_shader);
+    JojRenderer::ShaderDesc shader_desc;
+    shader_desc.vertex = "../vertex.cso";
+    shader_desc.pixel = "../pixel.cso";
+    JojRenderer::ShaderHandle shader = JojEngine::Engine::dx12_renderer->create_shader(shader_desc);
 
     // --------------------
     // ---- Rasterizer ----
@@ -435,13 +341,13 @@ void Shapes::build_pipeline_state()
     // Describe Depth/Stencil
     D3D12_GRAPHICS_PIPELINE_STATE_DESC pso = {};
     pso.pRootSignature = root_signature;
-    pso.VS = { reinterpret_cast<BYTE*>(vertex_shader->GetBufferPointer()), vertex_shader->GetBufferSize() };
-    pso.PS = { reinterpret_cast<BYTE*>(pixel_shader->GetBufferPointer()), pixel_shader->GetBufferSize() };
+    pso.VS = JojEngine::Engine::dx12_renderer->get_vertex_shader(shader);
+    pso.PS = JojEngine::Engine::dx12_renderer->get_pixel_shader(shader);
     pso.BlendState = blender;
     pso.SampleMask = UINT_MAX;
     pso.RasterizerState = rasterizer;
     pso.DepthStencilState = depth_stencil;
-    pso.InputLayout = { input_layout, 2 };
+    pso.InputLayout = { input_layout, input_layout_count };
     pso.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
     pso.NumRenderTargets = 1;
     pso.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
@@ -450,6 +356,6 @@ void Shapes::build_pipeline_state()
     pso.SampleDesc.Quality = JojEngine::Engine::dx12_renderer->get_quality();
     JojEngine::Engine::dx12_renderer->get_device()->CreateGraphicsPipelineState(&pso, IID_PPV_ARGS(&pipeline_state));
 
-    vertex_shader->Release();
-    pixel_shader->Release();
+    // The pipeline state keeps its own copy of the bytecode
+    JojEngine::Engine::dx12_renderer->destroy_shader(shader);
 }
\ No newline at end of file
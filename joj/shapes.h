@@ -2,8 +2,10 @@
 
 #include "game.h"
 #include "dx12/renderer_dx12.h"
-#include "DirectXMath.h"
+#include "fmath.h"
 #include "geometry.h"
+#include "mesh_optimizer.h"
+#include "vertex_format.h"
 
 class Shapes : public JojEngine::Game
 {
@@ -24,39 +26,22 @@ private:
 	ID3D12RootSignature* root_signature = nullptr;
 	ID3D12PipelineState* pipeline_state = nullptr;
 	
-	// Buffers in CPU
-	ID3DBlob* vertex_buffer_cpu = nullptr;
-	ID3DBlob* index_buffer_cpu = nullptr;
-
-	// Upload buffers: CPU -> GPU
-	ID3D12Resource* vertex_buffer_upload = nullptr;
-	ID3D12Resource* index_buffer_upload = nullptr;
-
-	// Buffers in GPU
-	ID3D12Resource* vertex_buffer_gpu = nullptr;
-	ID3D12Resource* index_buffer_gpu = nullptr;
-
-	// Buffer descriptors
-	D3D12_VERTEX_BUFFER_VIEW vertex_buffer_view = { 0 };	// Vertex buffer descriptor
-	D3D12_INDEX_BUFFER_VIEW index_buffer_view = { 0 };		// Index buffer descriptor
+	// Vertex and index buffers, drawn together as a mesh
+	JojRenderer::BufferHandle vertex_buffer;
+	JojRenderer::BufferHandle index_buffer;
+	JojRenderer::MeshHandle mesh;
 
 	// Vertex buffer characteristics
-	u32 vertex_byte_stride = 0;
-	u32 vertex_buffer_size = 0;
-
-	// Index buffer characteristics
-	DXGI_FORMAT index_format = DXGI_FORMAT_UNKNOWN;
-	u32 index_buffer_size = 0;
+	JojRenderer::VertexFormat vertex_format = JojRenderer::VertexFormat::compact();
 
 	// Constant buffer attributes
 	ID3D12DescriptorHeap* constant_buffer_heap = nullptr;
-	ID3D12Resource* constant_buffer_upload = nullptr;
-	BYTE* constant_buffer_data = nullptr;
+	JojRenderer::BufferHandle constant_buffer;
 
 	// Camera settings
-	DirectX::XMFLOAT4X4 World = {};
-	DirectX::XMFLOAT4X4 View = {};
-	DirectX::XMFLOAT4X4 Proj = {};
+	Mat4 World = mat4_identity();
+	Mat4 View = mat4_identity();
+	Mat4 Proj = mat4_identity();
 
 	f32 theta = 0;
 	f32 phi = 0;
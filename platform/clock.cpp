@@ -0,0 +1,130 @@
+#include "clock.h"
+
+#if PLATFORM_WINDOWS
+#include <windows.h>
+#else
+#include <time.h>
+#endif // PLATFORM_WINDOWS
+
+#if !CLOCK_NO_TSC && (defined(_M_X64) || defined(__x86_64__))
+#define CLOCK_TSC 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+#endif
+
+// Split the product so count * 1e9 never overflows
+static inline i64 scale_to_ns(i64 count, i64 per_second)
+{
+	return (count / per_second) * 1000000000 + (count % per_second) * 1000000000 / per_second;
+}
+
+#if PLATFORM_WINDOWS
+
+static i64 query_frequency()
+{
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	return freq.QuadPart;
+}
+
+i64 JojPlatform::Clock::now()
+{
+	static const i64 frequency = query_frequency();
+
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return scale_to_ns(counter.QuadPart, frequency);
+}
+
+#else
+
+i64 JojPlatform::Clock::now()
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return i64(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+#endif // PLATFORM_WINDOWS
+
+#if CLOCK_TSC
+
+// Invariant TSC: constant rate in every P-state and C-state (CPUID 0x80000007, EDX bit 8)
+static b8 has_invariant_tsc()
+{
+#if defined(_MSC_VER)
+	i32 regs[4] = {};
+	__cpuid(regs, 0x80000000);
+	if (u32(regs[0]) < 0x80000007)
+		return false;
+	__cpuid(regs, 0x80000007);
+	return (regs[3] & (1 << 8)) != 0;
+#else
+	u32 eax = 0, ebx = 0, ecx = 0, edx = 0;
+	if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx))
+		return false;
+	return (edx & (1 << 8)) != 0;
+#endif
+}
+
+static const b8 use_tsc = has_invariant_tsc();
+
+// Both counters sampled together at startup, the calibration baseline
+static const i64 origin_ns = JojPlatform::Clock::now();
+static const i64 origin_tsc = i64(__rdtsc());
+
+#endif // CLOCK_TSC
+
+i64 JojPlatform::Clock::ticks()
+{
+#if CLOCK_TSC
+	if (use_tsc)
+		return i64(__rdtsc());
+#endif // CLOCK_TSC
+	return now();
+}
+
+b8 JojPlatform::Clock::is_tsc()
+{
+#if CLOCK_TSC
+	return use_tsc;
+#else
+	return false;
+#endif // CLOCK_TSC
+}
+
+// TSC rate measured against now() over at least 10 ms since startup
+static i64 measure_ticks_per_second()
+{
+#if CLOCK_TSC
+	if (use_tsc)
+	{
+		i64 ns = JojPlatform::Clock::now();
+		while (ns - origin_ns < 10000000)
+			ns = JojPlatform::Clock::now();
+
+		f64 rate = f64(i64(__rdtsc()) - origin_tsc) * 1e9 / f64(ns - origin_ns);
+		return i64(rate + 0.5);
+	}
+#endif // CLOCK_TSC
+	return 1000000000;
+}
+
+i64 JojPlatform::Clock::get_ticks_per_second()
+{
+	static const i64 rate = measure_ticks_per_second();
+	return rate;
+}
+
+i64 JojPlatform::Clock::ticks_to_ns(i64 ticks)
+{
+#if CLOCK_TSC
+	if (use_tsc)
+		return scale_to_ns(ticks, get_ticks_per_second());
+#endif // CLOCK_TSC
+	return ticks;
+}
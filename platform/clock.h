@@ -0,0 +1,38 @@
+#pragma once
+
+#include "defines.h"
+
+namespace JojPlatform
+{
+	/* Monotonic clock in integer nanoseconds
+	 * now() reads the OS clock (QueryPerformanceCounter on Windows,
+	 * clock_gettime(CLOCK_MONOTONIC) elsewhere) and is exact over any
+	 * session length. ticks() is the cheapest counter available: the TSC on
+	 * x86-64 CPUs with an invariant TSC (calibrated against now() over the
+	 * first 10 ms), now() otherwise or when built with CLOCK_NO_TSC.
+	 * Time stamps stay integers, convert to seconds only for short intervals.
+	 */
+	class Clock
+	{
+	public:
+		// Return nanoseconds since an arbitrary fixed point
+		static i64 now();
+
+		// Return raw counter value (TSC or nanoseconds)
+		static i64 ticks();
+
+		// Return ticks() counts per second (calibrated once on the first call)
+		static i64 get_ticks_per_second();
+
+		// Convert a ticks() difference to nanoseconds
+		static i64 ticks_to_ns(i64 ticks);
+
+		// Return true if ticks() reads the TSC
+		static b8 is_tsc();
+	};
+
+	// Return seconds between two nanosecond time stamps
+	inline f64 seconds_between(i64 begin, i64 end)
+	{ return f64(end - begin) * 1e-9; }
+
+}	// namespace JojPlatform
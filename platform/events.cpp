@@ -0,0 +1,50 @@
+#include "events.h"
+
+JojPlatform::EventQueue::EventQueue() :
+    count(0),
+    received(0),
+    dropped(0)
+{
+}
+
+void JojPlatform::EventQueue::clear()
+{
+    count = 0;
+    received = 0;
+    dropped = 0;
+}
+
+void JojPlatform::EventQueue::push(const Event& event)
+{
+    received++;
+
+    if (count > 0)
+    {
+        Event& last = events[count - 1];
+
+        // Only the newest position of a run of mouse moves matters
+        if (event.type == EventType::MOUSE_MOVE && last.type == EventType::MOUSE_MOVE)
+        {
+            last.x = event.x;
+            last.y = event.y;
+            return;
+        }
+
+        if (event.type == EventType::MOUSE_WHEEL && last.type == EventType::MOUSE_WHEEL)
+        {
+            last.wheel += event.wheel;
+            return;
+        }
+    }
+
+    // Keep QUIT even when full, it must never be lost
+    if (count == MAX_FRAME_EVENTS)
+    {
+        dropped++;
+        if (event.type != EventType::QUIT)
+            return;
+        count--;
+    }
+
+    events[count++] = event;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "defines.h"
+
+namespace JojPlatform
+{
+	/* Per-frame event buffer
+	 * PlatformManager::pump_events drains every pending OS message once per
+	 * frame and records the input ones here, so update sees all input that
+	 * arrived since the last frame no matter how many messages piled up.
+	 * Consecutive mouse moves collapse into one event (last position wins)
+	 * and consecutive wheel events add up, which keeps a flood of mouse
+	 * messages from filling the buffer while preserving the order of
+	 * everything else.
+	 */
+
+	enum class EventType { KEY_DOWN, KEY_UP, MOUSE_MOVE, MOUSE_WHEEL, QUIT };
+
+	struct Event
+	{
+		EventType type;
+		u32 key;		// Virtual key code (KEY_DOWN, KEY_UP)
+		i32 x;			// Mouse position (MOUSE_MOVE)
+		i32 y;
+		i32 wheel;		// Accumulated wheel rotation (MOUSE_WHEEL)
+	};
+
+	// Most distinct events kept per frame
+	const u32 MAX_FRAME_EVENTS = 256;
+
+	class EventQueue
+	{
+	public:
+		EventQueue();
+
+		// Forget last frame's events
+		void clear();
+
+		// Record event, merging it into the previous one when possible
+		void push(const Event& event);
+
+		// Return number of events recorded this frame
+		u32 size() const
+		{ return count; }
+
+		// Return event at index (oldest first)
+		const Event& operator[](u32 index) const
+		{ return events[index]; }
+
+		const Event* begin() const
+		{ return events; }
+
+		const Event* end() const
+		{ return events + count; }
+
+		// Return number of OS messages recorded this frame, merged ones included
+		u32 get_received() const
+		{ return received; }
+
+		// Return number of events dropped because the buffer was full this frame
+		u32 get_dropped() const
+		{ return dropped; }
+
+	private:
+		Event events[MAX_FRAME_EVENTS];
+		u32 count;
+		u32 received;
+		u32 dropped;
+	};
+}
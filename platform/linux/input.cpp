@@ -0,0 +1,72 @@
+#include "input.h"
+
+#if PLATFORM_LINUX
+
+// Static members
+b8 JojPlatform::Input::keys[256] = { 0 };	// Keyboard/Mouse state
+b8 JojPlatform::Input::ctrl[256] = { 0 };	// Key release control
+
+i32	JojPlatform::Input::xmouse = 0;			// X mouse position
+i32	JojPlatform::Input::ymouse = 0;			// Y mouse position
+i16 JojPlatform::Input::mouse_wheel = 0;	// Mouse wheel value
+
+JojPlatform::Input::Input()
+{
+}
+
+JojPlatform::Input::~Input()
+{
+}
+
+b8 JojPlatform::Input::is_key_pressed(u32 vkcode)
+{
+	if (ctrl[vkcode])
+	{
+		if (is_key_down(vkcode))
+		{
+			ctrl[vkcode] = false;
+			return true;
+		}
+	}
+	else if (is_key_up(vkcode))
+	{
+		ctrl[vkcode] = true;
+	}
+
+	return false;
+}
+
+i16 JojPlatform::Input::get_mouse_wheel()
+{
+	i16 val = mouse_wheel;
+	mouse_wheel = 0;
+	return val;
+}
+
+void JojPlatform::Input::process_event(const Event& event)
+{
+	switch (event.type)
+	{
+	case EventType::KEY_DOWN:
+		keys[event.key & 0xFF] = true;
+		break;
+
+	case EventType::KEY_UP:
+		keys[event.key & 0xFF] = false;
+		break;
+
+	case EventType::MOUSE_MOVE:
+		xmouse = event.x;
+		ymouse = event.y;
+		break;
+
+	case EventType::MOUSE_WHEEL:
+		mouse_wheel = i16(event.wheel);
+		break;
+
+	default:
+		break;
+	}
+}
+
+#endif // PLATFORM_LINUX
@@ -0,0 +1,96 @@
+#include "timer.h"
+
+#if PLATFORM_LINUX
+
+#include <time.h>
+
+JojPlatform::Timer::Timer()
+{
+	counter_start = 0;
+	end = 0;
+
+	// Timer working
+	stopped = false;
+}
+
+JojPlatform::Timer::~Timer()
+{
+}
+
+i64 JojPlatform::Timer::now()
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return i64(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+void JojPlatform::Timer::start()
+{
+	if (stopped)
+	{
+		// Takes into account time already elapsed before the stop
+		i64 elapsed = end - counter_start;
+		counter_start = now() - elapsed;
+
+		// Resume normal counting
+		stopped = false;
+	}
+	else
+	{
+		// Start counting time
+		counter_start = now();
+	}
+}
+
+void JojPlatform::Timer::stop()
+{
+	if (!stopped)
+	{
+		// Mark the stopping point of time
+		end = now();
+		stopped = true;
+	}
+}
+
+f32 JojPlatform::Timer::reset()
+{
+	// To keep track of time elapsed
+	i64 elapsed;
+
+	if (stopped)
+	{
+		// Get time elapsed before stopping
+		elapsed = end - counter_start;
+
+		// Reset time count
+		counter_start = now();
+
+		// Count reactivated
+		stopped = false;
+	}
+	else
+	{
+		// End time counting
+		end = now();
+
+		// Calculate elapsed time
+		elapsed = end - counter_start;
+
+		// Reset counter
+		counter_start = end;
+	}
+
+	// Convert time to seconds
+	return f32(elapsed / 1e9);
+}
+
+f32 JojPlatform::Timer::elapsed()
+{
+	// Time elapsed until the stop, or until now
+	i64 elapsed = (stopped ? end : now()) - counter_start;
+
+	// Convert time to seconds
+	return f32(elapsed / 1e9);
+}
+
+#endif // PLATFORM_LINUX
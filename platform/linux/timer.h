@@ -0,0 +1,49 @@
+#pragma once
+
+#include "defines.h"
+
+#if PLATFORM_LINUX
+
+namespace JojPlatform
+{
+	/* Timer on CLOCK_MONOTONIC
+	 * Same interface as the Win32 Timer, counting nanoseconds read with
+	 * clock_gettime instead of QueryPerformanceCounter ticks.
+	 */
+	class Timer
+	{
+	public:
+		Timer();
+		~Timer();
+
+		void start();				// Start/resume counting time
+		void stop();				// Stop counting time
+		f32 reset();				// Restarts counter and returns elapsed time
+		f32 elapsed();				// Returns elapsed time in seconds
+		b8 was_elapsed(f32 secs);	// Checks if "secs" seconds have passed
+		void time_begin_period();	// Sleep resolution is already fine-grained on Linux
+		void time_end_period();		// Sleep resolution is already fine-grained on Linux
+
+	private:
+		i64 counter_start;	// Start of counter (ns)
+		i64 end;			// End of counter (ns)
+		b8 stopped;			// Counter state
+
+		static i64 now();	// Monotonic time in nanoseconds
+	};
+
+	// Checks if "secs" seconds have passed
+	inline b8 Timer::was_elapsed(f32 secs)
+	{ return (elapsed() >= secs ? true : false); }
+
+	// Sleep resolution is already fine-grained on Linux
+	inline void Timer::time_begin_period()
+	{}
+
+	// Sleep resolution is already fine-grained on Linux
+	inline void Timer::time_end_period()
+	{}
+
+}	// namespace JojPlatform
+
+#endif // PLATFORM_LINUX
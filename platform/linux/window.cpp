@@ -0,0 +1,40 @@
+#include "window.h"
+
+#if PLATFORM_LINUX
+
+// Static members
+void (*JojPlatform::Window::on_focus)() = nullptr;		// Do nothing when gaining focus
+void (*JojPlatform::Window::lost_focus)() = nullptr;	// Do nothing when losing focus
+
+JojPlatform::Window::Window()
+{
+	width = 1366;							// No screen to fill, use the default engine size
+	height = 768;
+	title = std::string("Joj Window");		// Default window title
+	mode = WindowMode::FULLSCREEN;			// Default mode is fullscreen
+	xcenter = width / 2;                    // Window center on the x-axis
+	ycenter = height / 2;                   // Window center on the y-axis
+}
+
+JojPlatform::Window::~Window()
+{
+}
+
+void JojPlatform::Window::set_size(i32 width, i32 height)
+{
+	this->width = width;
+	this->height = height;
+
+	xcenter = width / 2;
+	ycenter = height / 2;
+}
+
+void JojPlatform::Window::focus(b8 gained)
+{
+	if (gained && on_focus)
+		on_focus();
+	else if (!gained && lost_focus)
+		lost_focus();
+}
+
+#endif // PLATFORM_LINUX
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "defines.h"
+
+#if PLATFORM_LINUX
+
+#include <string>
+
+namespace JojPlatform
+{
+	enum class WindowMode { FULLSCREEN, WINDOWED };
+
+	/* Headless window
+	 * Keeps the size, title and focus callbacks of a window without opening
+	 * one, so the engine and games run unchanged on machines with no display.
+	 */
+	class Window
+	{
+	public:
+		Window();
+		~Window();
+
+		i32 get_width() const;          // Return window width
+		i32 get_height() const;         // Return window height
+		WindowMode get_mode() const;	// Return window mode (Fullscreen, windowed or borderless mode)
+		i32 get_xcenter() const;        // Return center position in x
+		i32 get_ycenter() const;        // Return center position in y
+		std::string get_title() const;  // Return window title
+		f32 get_aspect_ratio() const;   // Return window aspect ratio
+
+		void set_title(const std::string title);    // Set window title
+		void set_size(i32 width, i32 height);       // Set window width and height
+		void set_mode(WindowMode mode);             // Set window mode (Full-screen, windowed or borderless mode)
+		void set_color(u32 r, u32 g, u32 b);        // Set window background color
+
+		void hide_cursor(b8 hide);                  // Enable or disable cursor display
+
+		void close();
+		void clear();
+		b8 create();
+
+		void set_on_focus(void(*func)());	// Set function to be executed when regaining focus
+		void set_lost_focus(void(*func)());	// Set function to be executed when losing focus
+
+		void focus(b8 gained);				// Run focus callback, as when the window gains or loses focus
+
+	private:
+		i32 width;          // Window width
+		i32 height;         // Window heigh
+		std::string title;  // Window title
+		WindowMode mode;    // Full-screen, windowed or borderless mode
+		i32 xcenter;        // Window center on the x-axis
+		i32 ycenter;        // Window center on the y-axis
+
+		static void (*on_focus)();      // Run when window regains focus
+		static void (*lost_focus)();    // Run when window loses focus
+	};
+
+	// Return window width
+	inline i32 Window::get_width() const
+	{ return width; }
+
+	// Return window height
+	inline i32 Window::get_height() const
+	{ return height; }
+
+	// Return window mode (Fullscreen, windowed, or borderless mode)
+	inline WindowMode Window::get_mode() const
+	{ return mode; }
+
+	// Return center position in x
+	inline i32 Window::get_xcenter() const
+	{ return xcenter; }
+
+	// Return center position in y
+	inline i32 Window::get_ycenter() const
+	{ return ycenter; }
+
+	// Return window title
+	inline std::string Window::get_title() const
+	{ return title; }
+
+	// Return window aspect ratio
+	inline f32 Window::get_aspect_ratio() const
+	{ return width / f32(height); }
+
+	// Set window title
+	inline void Window::set_title(const std::string title)
+	{ this->title = title; }
+
+	// Set window mode
+	inline void Window::set_mode(WindowMode mode)
+	{ this->mode = mode; }
+
+	// Nothing is drawn without a window
+	inline void Window::set_color(u32, u32, u32)
+	{}
+
+	// There is no cursor without a window
+	inline void Window::hide_cursor(b8)
+	{}
+
+	// Nothing to close
+	inline void Window::close()
+	{}
+
+	// Nothing to clear
+	inline void Window::clear()
+	{}
+
+	// Nothing to create
+	inline b8 Window::create()
+	{ return true; }
+
+	// Set function to be executed when regaining focus
+	inline void Window::set_on_focus(void(*func)())
+	{ on_focus = func; }
+
+	// Set function to be executed when losing focus
+	inline void Window::set_lost_focus(void(*func)())
+	{ lost_focus = func; }
+
+} // namespace JojPlatform
+
+#endif // PLATFORM_LINUX
@@ -1,5 +1,7 @@
 #include "platform_manager.h"
 
+#if PLATFORM_WINDOWS || PLATFORM_LINUX
+
 JojPlatform::PlatformManager::PlatformManager()
 {
     window = std::make_unique<Window>();
@@ -8,6 +10,8 @@ JojPlatform::PlatformManager::PlatformManager()
     input = nullptr;
 
     timer = std::make_unique<Timer>();
+
+    exit_code = 0;
 }
 
 JojPlatform::PlatformManager::~PlatformManager()
@@ -30,4 +34,92 @@ b8 JojPlatform::PlatformManager::init(i32 width, i32 height, std::string title)
     input = std::make_unique<Input>();
 
     return true;
-}
\ No newline at end of file
+}
+
+#if PLATFORM_WINDOWS
+
+b8 JojPlatform::PlatformManager::pump_events()
+{
+    events.clear();
+
+    // Drain the whole queue so a burst of messages can't hold frames back
+    MSG msg = { 0 };
+    while (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE))
+    {
+        if (msg.message == WM_QUIT)
+        {
+            exit_code = i32(msg.wParam);
+            events.push({ EventType::QUIT, 0, 0, 0, 0 });
+            return false;
+        }
+
+        switch (msg.message)
+        {
+        case WM_KEYDOWN:
+            events.push({ EventType::KEY_DOWN, u32(msg.wParam), 0, 0, 0 });
+            break;
+        case WM_KEYUP:
+            events.push({ EventType::KEY_UP, u32(msg.wParam), 0, 0, 0 });
+            break;
+        case WM_MOUSEMOVE:
+            events.push({ EventType::MOUSE_MOVE, 0, GET_X_LPARAM(msg.lParam), GET_Y_LPARAM(msg.lParam), 0 });
+            break;
+        case WM_MOUSEWHEEL:
+            events.push({ EventType::MOUSE_WHEEL, 0, 0, 0, GET_WHEEL_DELTA_WPARAM(msg.wParam) });
+            break;
+        case WM_LBUTTONDOWN:
+            events.push({ EventType::KEY_DOWN, VK_LBUTTON, 0, 0, 0 });
+            break;
+        case WM_LBUTTONUP:
+            events.push({ EventType::KEY_UP, VK_LBUTTON, 0, 0, 0 });
+            break;
+        case WM_MBUTTONDOWN:
+            events.push({ EventType::KEY_DOWN, VK_MBUTTON, 0, 0, 0 });
+            break;
+        case WM_MBUTTONUP:
+            events.push({ EventType::KEY_UP, VK_MBUTTON, 0, 0, 0 });
+            break;
+        case WM_RBUTTONDOWN:
+            events.push({ EventType::KEY_DOWN, VK_RBUTTON, 0, 0, 0 });
+            break;
+        case WM_RBUTTONUP:
+            events.push({ EventType::KEY_UP, VK_RBUTTON, 0, 0, 0 });
+            break;
+        }
+
+        // Input still tracks key and mouse state through its window procedure
+        TranslateMessage(&msg);
+        DispatchMessage(&msg);
+    }
+
+    return true;
+}
+
+#elif PLATFORM_LINUX
+
+b8 JojPlatform::PlatformManager::pump_events()
+{
+    events.clear();
+
+    // Headless: the events posted since the last frame stand in for the OS queue
+    while (!posted.empty())
+    {
+        Event event = posted.front();
+        posted.pop_front();
+
+        events.push(event);
+        if (event.type == EventType::QUIT)
+        {
+            exit_code = i32(event.key);
+            return false;
+        }
+
+        Input::process_event(event);
+    }
+
+    return true;
+}
+
+#endif // PLATFORM_WINDOWS
+
+#endif // PLATFORM_WINDOWS || PLATFORM_LINUX // PLATFORM_WINDOWS
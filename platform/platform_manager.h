@@ -2,14 +2,22 @@
 
 #include "defines.h"
 
+#include "events.h"
 #include <memory>
 
 #if PLATFORM_WINDOWS
 #include "win32/window.h"
 #include "win32/input.h"
 #include "win32/timer.h"
+#elif PLATFORM_LINUX
+#include "linux/window.h"
+#include "linux/input.h"
+#include "linux/timer.h"
+#include <deque>
 #endif // PLATFORM_WINDOWS
 
+#if PLATFORM_WINDOWS || PLATFORM_LINUX
+
 namespace JojPlatform
 {
 	class PlatformManager
@@ -19,14 +27,14 @@ namespace JojPlatform
 		~PlatformManager();
 
 		b8 init(i32 width = 1366, i32 height = 768, std::string title = "Joj Engine");	// Initialize platform specifics
-#if PLATFORM_WINDOWS
-		void process_events(MSG msg);													// Process Window events
-#endif // PLATFORM_WINDOWS
+		b8 pump_events();																// Drain pending OS events, false once quit was requested
 		void swap_buffers();															// Change back and front buffers
 		void shutdown();																// Finalize PlatformManager resources
 
 		std::unique_ptr<Window>& get_window();	// Pass refence of Window but keep ownership after function
 		std::unique_ptr<Input>& get_input();	// Pass refence of Input but keep ownership after function
+		const EventQueue& get_events() const;	// Events received by the last pump_events
+		i32 get_exit_code() const;				// Exit code of the quit request
 
 		b8 is_key_down(u32 key_code);		// Check if key is pressed
 		b8 is_key_up(u32 key_code);	        // Check if key is released
@@ -51,12 +59,20 @@ namespace JojPlatform
 #if PLATFORM_WINDOWS
 		// Change window procedure to new_win_proc
 		void change_window_procedure(HWND window_id, u32 index, LONG_PTR new_win_proc);
+#elif PLATFORM_LINUX
+		// Queue event for the next pump_events, headless runs have no OS to send input
+		void post_event(const Event& event);
 #endif // PLATFORM_WINDOWS
 
 	private:
 		std::unique_ptr<Window> window;
 		std::unique_ptr<Input> input;
 		std::unique_ptr<Timer> timer;
+		EventQueue events;
+		i32 exit_code;
+#if PLATFORM_LINUX
+		std::deque<Event> posted;		// Events waiting for pump_events
+#endif // PLATFORM_LINUX
 	};
 
 	// Pass refence of Window but keep ownership after function
@@ -67,6 +83,14 @@ namespace JojPlatform
 	inline std::unique_ptr<Input>& PlatformManager::get_input()
 	{ return input; }
 
+	// Events received by the last pump_events
+	inline const EventQueue& PlatformManager::get_events() const
+	{ return events; }
+
+	// Exit code of the quit request
+	inline i32 PlatformManager::get_exit_code() const
+	{ return exit_code; }
+
 	// Check if key is pressed
 	inline b8 PlatformManager::is_key_down(u32 key_code)
 	{ return input->is_key_down(key_code); }
@@ -120,17 +144,6 @@ namespace JojPlatform
 	{ window->set_lost_focus(func); }
 
 #if PLATFORM_WINDOWS
-	// Process Window events
-	inline void PlatformManager::process_events(MSG msg)
-	{
-		// Handle all events before updating game
-		if (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE))
-		{
-			TranslateMessage(&msg);
-			DispatchMessage(&msg);
-		}
-	}
-
 	// Change back and front buffers
 	inline void PlatformManager::swap_buffers()
 	{ SwapBuffers(window->get_device_context()); }
@@ -155,6 +168,24 @@ namespace JojPlatform
 	// Change window procedure to new_win_proc
 	inline void PlatformManager::change_window_procedure(HWND window_id, u32 index, LONG_PTR new_win_proc)
 	{ SetWindowLongPtr(window_id, index, new_win_proc); }
+#elif PLATFORM_LINUX
+	// Nothing to present without a window
+	inline void PlatformManager::swap_buffers()
+	{}
+
+	// Finalize PlatformManager resources
+	inline void PlatformManager::shutdown()
+	{ window->close(); }
+
+	// Output already goes to the terminal
+	inline void PlatformManager::create_console()
+	{}
+
+	// Queue event for the next pump_events
+	inline void PlatformManager::post_event(const Event& event)
+	{ posted.push_back(event); }
 #endif // PLATFORM_WINDOWS
 
 } // namespace JojPlatform
+
+#endif // PLATFORM_WINDOWS || PLATFORM_LINUX
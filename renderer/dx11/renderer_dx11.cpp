@@ -3,6 +3,8 @@
 #include <dxgi.h>
 #include <d3dcompiler.h>
 #include "logger.h"
+#include "memory_tracker.h"
+#include <string.h>
 
 JojRenderer::DX11Renderer::DX11Renderer()
 {
@@ -33,6 +35,9 @@ JojRenderer::DX11Renderer::DX11Renderer()
 
 JojRenderer::DX11Renderer::~DX11Renderer()
 {
+	// Release buffers and shaders
+	release_resources();
+
 	// Release rasterizer state
 	if (rasterizer_state)
 		rasterizer_state->Release();
@@ -98,6 +103,11 @@ b8 JojRenderer::DX11Renderer::init(std::unique_ptr<JojPlatform::Window>& window)
 	device = context->get_device();
 	device_context = context->get_context();
 
+	// Resource pools
+	buffers.init(DX11_MAX_BUFFERS);
+	meshes.init(DX11_MAX_MESHES);
+	shaders.init(DX11_MAX_SHADERS);
+
 	// ------------------------------------------------------------------------------------------------------
 	//                                          PIPELINE SETUP
 	// ------------------------------------------------------------------------------------------------------
@@ -281,93 +291,290 @@ void JojRenderer::DX11Renderer::swap_buffers()
 
 void JojRenderer::DX11Renderer::shutdown()
 {
+	release_resources();
+}
+
+void JojRenderer::DX11Renderer::release_resources()
+{
+	for (DX11Shader& shader : shaders)
+	{
+		shader.input_layout->Release();
+		shader.pixel_shader->Release();
+		shader.vertex_shader->Release();
+	}
+
+	for (DX11Buffer& buffer : buffers)
+	{
+		buffer.buffer->Release();
+		FMEMORY_FREE(JojEngine::MemoryTag::RENDERER, buffer.size);
+	}
+
+	shaders.clear();
+	meshes.clear();
+	buffers.clear();
 }
 
-ID3D11Buffer* JojRenderer::DX11Renderer::create_vertex_buffer(u64 vertex_size, u32 vertex_count, const void* vertex_data)
+JojRenderer::BufferHandle JojRenderer::DX11Renderer::create_buffer(const BufferDesc& desc)
 {
-	// TODO: comment specifications on buffer_desc
 	// Describe Buffer - Resource structure
 	D3D11_BUFFER_DESC buffer_desc = { 0 };
-	buffer_desc.ByteWidth = vertex_size * vertex_count;
-	buffer_desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-	buffer_desc.Usage = D3D11_USAGE_DYNAMIC;
+	buffer_desc.ByteWidth = desc.size;
+	buffer_desc.Usage = D3D11_USAGE_DYNAMIC;				// GPU reads, CPU rewrites with update_buffer
 	buffer_desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
 	buffer_desc.MiscFlags = 0;
 	buffer_desc.StructureByteStride = 0;
 
+	switch (desc.type)
+	{
+	case BufferType::VERTEX:
+		buffer_desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+		break;
+	case BufferType::INDEX:
+		buffer_desc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+		buffer_desc.Usage = D3D11_USAGE_IMMUTABLE;			// Written once at creation
+		buffer_desc.CPUAccessFlags = 0;
+		break;
+	case BufferType::CONSTANT:
+		buffer_desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+		buffer_desc.ByteWidth = (desc.size + 15) & ~15u;	// Multiple of 16 bytes
+		break;
+	}
+
+	// Immutable buffers must be initialized
+	if (desc.type == BufferType::INDEX && !desc.data)
+	{
+		FERROR(ERR_RENDERER, "Index buffer created without data.");
+		return BufferHandle();
+	}
+
 	// Set data we want to initialize the buffer contents with
-	D3D11_SUBRESOURCE_DATA srd = { vertex_data, 0, 0 };
+	D3D11_SUBRESOURCE_DATA srd = { desc.data, 0, 0 };
 
 	// Create Buffer
-	ID3D11Buffer* vertex_buffer = nullptr;
-	if FAILED(device->CreateBuffer(&buffer_desc, &srd, &vertex_buffer))
-		MessageBoxA(nullptr, "Failed to create Vertex Buffer", 0, 0);
+	ID3D11Buffer* buffer = nullptr;
+	if FAILED(device->CreateBuffer(&buffer_desc, desc.data ? &srd : nullptr, &buffer))
+	{
+		FERROR(ERR_RENDERER, "Failed to CreateBuffer.");
+		return BufferHandle();
+	}
+
+	BufferHandle handle = buffers.create(DX11Buffer{ buffer, desc.type, buffer_desc.ByteWidth, desc.stride });
+	if (handle.is_null())
+	{
+		FERROR(ERR_RENDERER, "Too many buffers.");
+		buffer->Release();
+		return handle;
+	}
 
-	return vertex_buffer;
+	FMEMORY_ALLOC(JojEngine::MemoryTag::RENDERER, buffer_desc.ByteWidth);
+	return handle;
 }
 
-ID3D11Buffer* JojRenderer::DX11Renderer::create_index_buffer(u64 index_size, u32 index_count, const void* index_data)
+JojRenderer::BufferHandle JojRenderer::DX11Renderer::create_vertex_buffer(u32 vertex_size, u32 vertex_count, const void* vertex_data)
 {
-	// Describe index buffer
-	D3D11_BUFFER_DESC index_buffer_desc;
-	index_buffer_desc.Usage = D3D11_USAGE_IMMUTABLE;
-	index_buffer_desc.ByteWidth = index_size * index_count;
-	index_buffer_desc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-	index_buffer_desc.CPUAccessFlags = 0;
-	index_buffer_desc.MiscFlags = 0;
-	index_buffer_desc.StructureByteStride = 0;
-
-	// Specify the data to initialize the index buffer.
-	D3D11_SUBRESOURCE_DATA indices_init_data;
-	indices_init_data.pSysMem = index_data;
-
-	// Create the index buffer.
-	ID3D11Buffer* index_buffer = nullptr;
-	if FAILED(device->CreateBuffer(&index_buffer_desc, &indices_init_data, &index_buffer))
-		MessageBoxA(nullptr, "Failed to create Index Buffer", 0, 0);
-
-	return index_buffer;
+	BufferDesc desc;
+	desc.type = BufferType::VERTEX;
+	desc.size = vertex_size * vertex_count;
+	desc.stride = vertex_size;
+	desc.data = vertex_data;
+	return create_buffer(desc);
 }
 
-ID3D11VertexShader* JojRenderer::DX11Renderer::compile_and_create_vs_from_file(LPCWSTR file_path, ID3DBlob*& blob, unsigned long shader_flags)
+JojRenderer::BufferHandle JojRenderer::DX11Renderer::create_index_buffer(u32 index_size, u32 index_count, const void* index_data)
 {
-	ID3DBlob* compile_errors_blob;  // To get info about compilation
+	BufferDesc desc;
+	desc.type = BufferType::INDEX;
+	desc.size = index_size * index_count;
+	desc.stride = index_size;
+	desc.data = index_data;
+	return create_buffer(desc);
+}
 
-	if FAILED(D3DCompileFromFile(file_path, nullptr, nullptr, "main", "vs_5_0", shader_flags, NULL, &blob, &compile_errors_blob))
-		MessageBoxA(nullptr, "Failed to compile Vertex Shader.", 0, 0);
+b8 JojRenderer::DX11Renderer::destroy_buffer(BufferHandle buffer)
+{
+	DX11Buffer* data = buffers.get(buffer);
+	if (!data)
+		return false;
 
-	ID3D11VertexShader* vertex_shader = nullptr;
-	if FAILED(device->CreateVertexShader(blob->GetBufferPointer(), blob->GetBufferSize(), nullptr, &vertex_shader))
-		MessageBoxA(nullptr, "Failed to create Vertex Shader.", 0, 0);
+	data->buffer->Release();
+	FMEMORY_FREE(JojEngine::MemoryTag::RENDERER, data->size);
+	return buffers.destroy(buffer);
+}
 
-	return vertex_shader;
+b8 JojRenderer::DX11Renderer::update_buffer(BufferHandle buffer, const void* data, u32 size)
+{
+	DX11Buffer* target = buffers.get(buffer);
+	if (!target || target->type == BufferType::INDEX || size > target->size)
+		return false;
+
+	// Get a pointer to the buffer data, previous contents are discarded
+	D3D11_MAPPED_SUBRESOURCE mapped_buffer = {};
+	if FAILED(device_context->Map(target->buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped_buffer))
+		return false;
+
+	memcpy(mapped_buffer.pData, data, size);
+	device_context->Unmap(target->buffer, 0);
+	return true;
 }
 
-ID3D11PixelShader* JojRenderer::DX11Renderer::compile_and_create_ps_from_file(LPCWSTR file_path, ID3DBlob*& blob, unsigned long shader_flags)
+JojRenderer::MeshHandle JojRenderer::DX11Renderer::create_mesh(BufferHandle vertices, BufferHandle indices, u32 index_count)
 {
-	ID3DBlob* compile_errors_blob;  // To get info about compilation
+	if (!buffers.is_alive(vertices) || !buffers.is_alive(indices))
+		return MeshHandle();
+
+	return meshes.create(DX11Mesh{ vertices, indices, index_count });
+}
 
-	if FAILED(D3DCompileFromFile(file_path, nullptr, nullptr, "main", "ps_5_0", shader_flags, NULL, &blob, &compile_errors_blob))
-		MessageBoxA(nullptr, "Failed to compile Pixel Shader.", 0, 0);
+b8 JojRenderer::DX11Renderer::destroy_mesh(MeshHandle mesh)
+{
+	return meshes.destroy(mesh);
+}
 
-	ID3D11PixelShader* pixel_shader = nullptr;
-	if FAILED(device->CreatePixelShader(blob->GetBufferPointer(), blob->GetBufferSize(), nullptr, &pixel_shader))
-		MessageBoxA(nullptr, "Failed to create Vertex Shader.", 0, 0);
+DXGI_FORMAT JojRenderer::DX11Renderer::get_attribute_format(VertexAttributeFormat format)
+{
+	switch (format)
+	{
+	case VertexAttributeFormat::FLOAT3:			return DXGI_FORMAT_R32G32B32_FLOAT;
+	case VertexAttributeFormat::FLOAT4:			return DXGI_FORMAT_R32G32B32A32_FLOAT;
+	case VertexAttributeFormat::HALF4:			return DXGI_FORMAT_R16G16B16A16_FLOAT;
+	case VertexAttributeFormat::SNORM16_4:		return DXGI_FORMAT_R16G16B16A16_SNORM;
+	case VertexAttributeFormat::UNORM8_4:		return DXGI_FORMAT_R8G8B8A8_UNORM;
+	case VertexAttributeFormat::OCT_SNORM16_2:	return DXGI_FORMAT_R16G16_SNORM;
+	}
 
-	return pixel_shader;
+	return DXGI_FORMAT_UNKNOWN;
 }
 
-b8 JojRenderer::DX11Renderer::create_and_set_input_layout(D3D11_INPUT_ELEMENT_DESC* input_desc, u32 array_size, ID3DBlob* blob, ID3D11InputLayout* input_layout)
+u32 JojRenderer::DX11Renderer::get_input_layout(const VertexFormat& format, D3D11_INPUT_ELEMENT_DESC* input_desc)
 {
-	// Create input layout
-	if FAILED(device->CreateInputLayout(input_desc, array_size, blob->GetBufferPointer(), blob->GetBufferSize(), &input_layout))
+	for (u32 i = 0; i < format.get_attribute_count(); ++i)
 	{
-		MessageBoxA(nullptr, "Failed to create Input Layout.", 0, 0);
+		const VertexAttribute& attribute = format.get_attribute(i);
+		input_desc[i] = { get_semantic_name(attribute.semantic), 0, get_attribute_format(attribute.format),
+			0, attribute.offset, D3D11_INPUT_PER_VERTEX_DATA, 0 };
+	}
+
+	return format.get_attribute_count();
+}
+
+b8 JojRenderer::DX11Renderer::compile_shader(const char* file_path, const char* target, u32 flags, ID3DBlob*& blob)
+{
+	// D3DCompileFromFile takes a wide path
+	wchar_t path[MAX_PATH];
+	if (!MultiByteToWideChar(CP_UTF8, 0, file_path, -1, path, MAX_PATH))
 		return false;
+
+	ID3DBlob* compile_errors_blob = nullptr;  // To get info about compilation
+	HRESULT result = D3DCompileFromFile(path, nullptr, nullptr, "main", target, flags, NULL, &blob, &compile_errors_blob);
+
+	if (compile_errors_blob)
+	{
+		OutputDebugStringA((const char*)compile_errors_blob->GetBufferPointer());
+		compile_errors_blob->Release();
+	}
+
+	return SUCCEEDED(result);
+}
+
+JojRenderer::ShaderHandle JojRenderer::DX11Renderer::create_shader(const ShaderDesc& desc)
+{
+	if (!desc.vertex || !desc.pixel || !desc.vertex_format)
+	{
+		FERROR(ERR_RENDERER, "Shader needs vertex and pixel files and a vertex format.");
+		return ShaderHandle();
+	}
+
+	ID3DBlob* vs_blob = nullptr;
+	ID3DBlob* ps_blob = nullptr;
+	DX11Shader shader = { nullptr, nullptr, nullptr };
+
+	// Description of the vertex format
+	D3D11_INPUT_ELEMENT_DESC input_desc[MAX_VERTEX_ATTRIBUTES];
+	u32 input_desc_count = get_input_layout(*desc.vertex_format, input_desc);
+
+	b8 created = compile_shader(desc.vertex, "vs_5_0", desc.flags, vs_blob)
+		&& compile_shader(desc.pixel, "ps_5_0", desc.flags, ps_blob)
+		&& SUCCEEDED(device->CreateVertexShader(vs_blob->GetBufferPointer(), vs_blob->GetBufferSize(), nullptr, &shader.vertex_shader))
+		&& SUCCEEDED(device->CreatePixelShader(ps_blob->GetBufferPointer(), ps_blob->GetBufferSize(), nullptr, &shader.pixel_shader))
+		&& SUCCEEDED(device->CreateInputLayout(input_desc, input_desc_count, vs_blob->GetBufferPointer(), vs_blob->GetBufferSize(), &shader.input_layout));
+
+	if (vs_blob)
+		vs_blob->Release();
+	if (ps_blob)
+		ps_blob->Release();
+
+	ShaderHandle handle;
+	if (created)
+		handle = shaders.create(shader);
+
+	if (handle.is_null())
+	{
+		FERROR(ERR_RENDERER, "Failed to create shader.");
+
+		if (shader.input_layout)
+			shader.input_layout->Release();
+		if (shader.pixel_shader)
+			shader.pixel_shader->Release();
+		if (shader.vertex_shader)
+			shader.vertex_shader->Release();
 	}
 
-	// Bind input layout to the Input Assembler Stage
-	device_context->IASetInputLayout(input_layout);
+	return handle;
+}
 
+b8 JojRenderer::DX11Renderer::destroy_shader(ShaderHandle shader)
+{
+	DX11Shader* data = shaders.get(shader);
+	if (!data)
+		return false;
+
+	data->input_layout->Release();
+	data->pixel_shader->Release();
+	data->vertex_shader->Release();
+	return shaders.destroy(shader);
+}
+
+b8 JojRenderer::DX11Renderer::set_shader(ShaderHandle shader)
+{
+	const DX11Shader* data = shaders.get(shader);
+	if (!data)
+		return false;
+
+	// Bind input layout to the Input Assembler Stage, then Vertex and Pixel Shaders
+	device_context->IASetInputLayout(data->input_layout);
+	device_context->VSSetShader(data->vertex_shader, nullptr, 0);
+	device_context->PSSetShader(data->pixel_shader, nullptr, 0);
 	return true;
-}
\ No newline at end of file
+}
+
+b8 JojRenderer::DX11Renderer::set_constant_buffer(u32 slot, BufferHandle buffer)
+{
+	const DX11Buffer* data = buffers.get(buffer);
+	if (!data || data->type != BufferType::CONSTANT)
+		return false;
+
+	device_context->VSSetConstantBuffers(slot, 1, &data->buffer);
+	return true;
+}
+
+b8 JojRenderer::DX11Renderer::draw_mesh(MeshHandle mesh)
+{
+	const DX11Mesh* data = meshes.get(mesh);
+	if (!data)
+		return false;
+
+	const DX11Buffer* vertices = buffers.get(data->vertices);
+	const DX11Buffer* indices = buffers.get(data->indices);
+	if (!vertices || !indices)
+		return false;
+
+	UINT stride = vertices->stride;		// Size of one vertex
+	UINT offset = 0;					// First vertex in the buffer
+
+	// Bind Vertex and Index Buffers to the Input Assembler Stage
+	device_context->IASetVertexBuffers(0, 1, &vertices->buffer, &stride, &offset);
+	device_context->IASetIndexBuffer(indices->buffer, get_index_format(indices->stride == 2 ? IndexFormat::U16 : IndexFormat::U32), 0);
+
+	device_context->DrawIndexed(data->index_count, 0, 0);
+	return true;
+}
@@ -6,10 +6,17 @@
 
 #include "renderer.h"
 #include "dx11/context_dx11.h"
+#include "geometry.h"
+#include "vertex_format.h"
 #include <d3d11.h>      // Main Direct3D functions
 
 namespace JojRenderer
 {
+	// Most resources alive at once
+	const u32 DX11_MAX_BUFFERS = 4096;
+	const u32 DX11_MAX_MESHES = 2048;
+	const u32 DX11_MAX_SHADERS = 256;
+
 	class DX11Renderer : public Renderer
 	{
 	public:
@@ -32,21 +39,57 @@ namespace JojRenderer
 		// Handle resources
 		// ---------------------------------------------------
 
+		// Create buffer, return null handle on failure
+		// Vertex and constant buffers are dynamic (update_buffer), index buffers are immutable
+		BufferHandle create_buffer(const BufferDesc& desc);
+
 		// Create vertex buffer
-		// TODO: Check if using templates is better than using void*
-		ID3D11Buffer* create_vertex_buffer(u64 vertex_size, u32 vertex_count, const void* vertex_data);
+		BufferHandle create_vertex_buffer(u32 vertex_size, u32 vertex_count, const void* vertex_data);
 
 		// Create index buffer
-		ID3D11Buffer* create_index_buffer(u64 index_size, u32 index_count, const void* index_data);
+		BufferHandle create_index_buffer(u32 index_size, u32 index_count, const void* index_data);
+
+		// Create index buffer from geometry index data, 16 or 32-bit
+		BufferHandle create_index_buffer(const Geometry& geometry);
+
+		// Create vertex buffer from packed vertices
+		BufferHandle create_vertex_buffer(const PackedVertices& vertices);
+
+		// Release buffer, return false if it was already destroyed
+		b8 destroy_buffer(BufferHandle buffer);
+
+		// Overwrite the contents of a dynamic buffer
+		b8 update_buffer(BufferHandle buffer, const void* data, u32 size);
 
-		// Compile and create Vertex Shader from file
-		ID3D11VertexShader* compile_and_create_vs_from_file(LPCWSTR file_path, ID3DBlob*& blob, unsigned long shader_flags);
+		// Mesh drawn from a vertex and an index buffer
+		MeshHandle create_mesh(BufferHandle vertices, BufferHandle indices, u32 index_count);
+		b8 destroy_mesh(MeshHandle mesh);
 
-		// Compile and create Pixel Shader from file
-		ID3D11PixelShader* compile_and_create_ps_from_file(LPCWSTR file_path, ID3DBlob*& blob, unsigned long shader_flags);
+		// Compile vertex and pixel shaders from file and create the input layout of desc.vertex_format
+		ShaderHandle create_shader(const ShaderDesc& desc);
+		b8 destroy_shader(ShaderHandle shader);
 
-		// Create and set input layout
-		b8 create_and_set_input_layout(D3D11_INPUT_ELEMENT_DESC* input_desc, u32 array_size, ID3DBlob* blob, ID3D11InputLayout* input_layout);
+		// Return DXGI format of an index buffer with the given width
+		static DXGI_FORMAT get_index_format(IndexFormat format);
+
+		// Return DXGI format of a vertex attribute
+		static DXGI_FORMAT get_attribute_format(VertexAttributeFormat format);
+
+		// Fill input_desc (MAX_VERTEX_ATTRIBUTES entries) from format, return number of elements
+		static u32 get_input_layout(const VertexFormat& format, D3D11_INPUT_ELEMENT_DESC* input_desc);
+
+		// ---------------------------------------------------
+		// Bind resources
+		// ---------------------------------------------------
+
+		// Bind input layout, vertex and pixel shaders
+		b8 set_shader(ShaderHandle shader);
+
+		// Bind constant buffer to a vertex shader slot
+		b8 set_constant_buffer(u32 slot, BufferHandle buffer);
+
+		// Bind mesh buffers and draw, return false if it or its buffers were destroyed
+		b8 draw_mesh(MeshHandle mesh);
 
 		// ---------------------------------------------------
 		// Change pipeline state
@@ -56,6 +99,34 @@ namespace JojRenderer
 		void set_primitive_topology(D3D11_PRIMITIVE_TOPOLOGY topology);
 
 	private:
+		struct DX11Buffer
+		{
+			ID3D11Buffer* buffer;
+			BufferType type;
+			u32 size;
+			u32 stride;
+		};
+
+		struct DX11Mesh
+		{
+			BufferHandle vertices;
+			BufferHandle indices;
+			u32 index_count;
+		};
+
+		struct DX11Shader
+		{
+			ID3D11VertexShader* vertex_shader;
+			ID3D11PixelShader* pixel_shader;
+			ID3D11InputLayout* input_layout;
+		};
+
+		// Compile shader from file into blob, return false on failure
+		static b8 compile_shader(const char* file_path, const char* target, u32 flags, ID3DBlob*& blob);
+
+		// Release every buffer and shader still alive
+		void release_resources();
+
 		std::unique_ptr<JojGraphics::DX11Context> context;
 
 		ID3D11Device* device;					// Graphics device
@@ -75,6 +146,13 @@ namespace JojRenderer
 		D3D11_VIEWPORT viewport;						// Viewport
 		ID3D11BlendState* blend_state;					// Color mix settings
 		ID3D11RasterizerState* rasterizer_state;	// Rasterizer state
+
+		// ---------------------------------------------------
+		// Resources
+		// ---------------------------------------------------
+		JojEngine::Pool<DX11Buffer, Buffer> buffers;
+		JojEngine::Pool<DX11Mesh, Mesh> meshes;
+		JojEngine::Pool<DX11Shader, ShaderProgram> shaders;
 	};
 
 	// Return Graphics device
@@ -95,6 +173,18 @@ namespace JojRenderer
 	{ return device_context; }
 */
 
+	// Create index buffer from geometry index data, 16 or 32-bit
+	inline BufferHandle DX11Renderer::create_index_buffer(const Geometry& geometry)
+	{ return create_index_buffer(geometry.get_index_size(), geometry.get_index_count(), geometry.get_index_data()); }
+
+	// Return DXGI format of an index buffer with the given width
+	inline DXGI_FORMAT DX11Renderer::get_index_format(IndexFormat format)
+	{ return format == IndexFormat::U16 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT; }
+
+	// Create vertex buffer from packed vertices
+	inline BufferHandle DX11Renderer::create_vertex_buffer(const PackedVertices& vertices)
+	{ return create_vertex_buffer(vertices.format.get_stride(), vertices.vertex_count, vertices.data.data()); }
+
 	// Set primitive topology
 	inline void DX11Renderer::set_primitive_topology(D3D11_PRIMITIVE_TOPOLOGY topology)
 	{ device_context->IASetPrimitiveTopology(topology); }
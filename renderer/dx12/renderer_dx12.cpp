@@ -1,6 +1,7 @@
 #include "renderer_dx12.h"
 
 #include "logger.h"
+#include "memory_tracker.h"
 #include <d3dcompiler.h>
 
 JojRenderer::DX12Renderer::DX12Renderer()
@@ -49,8 +50,8 @@ JojRenderer::DX12Renderer::DX12Renderer()
 
 JojRenderer::DX12Renderer::~DX12Renderer()
 {
-    // Wait for GPU to finish queued commands
-    wait_command_queue();
+    // Wait for GPU to finish queued commands, release buffers and shaders
+    release_resources();
 
     // Release depth stencil buffer
     if (depth_stencil)
@@ -116,6 +117,11 @@ b8 JojRenderer::DX12Renderer::init(std::unique_ptr<JojPlatform::Window>& window)
     // Get pointer to D3D11 Device
     device = context->get_device();
 
+    // Resource pools
+    buffers.init(DX12_MAX_BUFFERS);
+    meshes.init(DX12_MAX_MESHES);
+    shaders.init(DX12_MAX_SHADERS);
+
     // ------------------------------------------------------------------------------------------------------
     //                                          PIPELINE SETUP
     // ------------------------------------------------------------------------------------------------------
@@ -372,6 +378,7 @@ void JojRenderer::DX12Renderer::swap_buffers()
 
 void JojRenderer::DX12Renderer::shutdown()
 {
+    release_resources();
 }
 
 void JojRenderer::DX12Renderer::custom_clear(ID3D12PipelineState* pso)
@@ -466,7 +473,13 @@ void JojRenderer::DX12Renderer::reset_commands()
 
 void JojRenderer::DX12Renderer::allocate_resource_in_cpu(u32 size_in_bytes, ID3DBlob** resource)
 {
-    D3DCreateBlob(size_in_bytes, resource);
+    if FAILED(D3DCreateBlob(size_in_bytes, resource))
+    {
+        FERROR(ERR_RENDERER, "Failed to create blob.");
+        return;
+    }
+
+    FMEMORY_ALLOC(JojEngine::MemoryTag::RENDERER, size_in_bytes);
 }
 
 void JojRenderer::DX12Renderer::allocate_resource_in_gpu(AllocationType alloc_type, u32 size_in_bytes, ID3D12Resource** resource)
@@ -515,6 +528,8 @@ void JojRenderer::DX12Renderer::allocate_resource_in_gpu(AllocationType alloc_ty
         FERROR(ERR_RENDERER, "Failed to create buffer for commited resource.");
         return;
     }
+
+    FMEMORY_ALLOC(JojEngine::MemoryTag::RENDERER, size_in_bytes);
 }
 
 void JojRenderer::DX12Renderer::copy_verts_to_cpu_blob(const void* vertices, u32 size_in_bytes, ID3DBlob* buffer_cpu)
@@ -608,4 +623,264 @@ void JojRenderer::DX12Renderer::copy_verts_to_gpu(const void* vertices, u32 size
     barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_GENERIC_READ;
     barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
     command_list->ResourceBarrier(1, &barrier);
-}
\ No newline at end of file
+}
+
+DXGI_FORMAT JojRenderer::DX12Renderer::get_attribute_format(VertexAttributeFormat format)
+{
+    switch (format)
+    {
+    case VertexAttributeFormat::FLOAT3:         return DXGI_FORMAT_R32G32B32_FLOAT;
+    case VertexAttributeFormat::FLOAT4:         return DXGI_FORMAT_R32G32B32A32_FLOAT;
+    case VertexAttributeFormat::HALF4:          return DXGI_FORMAT_R16G16B16A16_FLOAT;
+    case VertexAttributeFormat::SNORM16_4:      return DXGI_FORMAT_R16G16B16A16_SNORM;
+    case VertexAttributeFormat::UNORM8_4:       return DXGI_FORMAT_R8G8B8A8_UNORM;
+    case VertexAttributeFormat::OCT_SNORM16_2:  return DXGI_FORMAT_R16G16_SNORM;
+    }
+
+    return DXGI_FORMAT_UNKNOWN;
+}
+
+u32 JojRenderer::DX12Renderer::get_input_layout(const VertexFormat& format, D3D12_INPUT_ELEMENT_DESC* input_layout)
+{
+    for (u32 i = 0; i < format.get_attribute_count(); ++i)
+    {
+        const VertexAttribute& attribute = format.get_attribute(i);
+        input_layout[i] = { get_semantic_name(attribute.semantic), 0, get_attribute_format(attribute.format),
+            0, attribute.offset, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 };
+    }
+
+    return format.get_attribute_count();
+}
+
+void JojRenderer::DX12Renderer::release_buffer(DX12Buffer& buffer)
+{
+    if (buffer.mapped)
+        buffer.upload->Unmap(0, nullptr);
+
+    // Sizes recorded by allocate_resource_in_cpu and allocate_resource_in_gpu
+    if (buffer.cpu)
+    {
+        FMEMORY_FREE(JojEngine::MemoryTag::RENDERER, buffer.cpu->GetBufferSize());
+        buffer.cpu->Release();
+    }
+
+    if (buffer.upload)
+    {
+        FMEMORY_FREE(JojEngine::MemoryTag::RENDERER, buffer.upload->GetDesc().Width);
+        buffer.upload->Release();
+    }
+
+    if (buffer.gpu)
+    {
+        FMEMORY_FREE(JojEngine::MemoryTag::RENDERER, buffer.gpu->GetDesc().Width);
+        buffer.gpu->Release();
+    }
+}
+
+void JojRenderer::DX12Renderer::release_resources()
+{
+    // Nothing was created before init
+    if (!fence)
+        return;
+
+    // Resources can still be referenced by commands in flight
+    wait_command_queue();
+
+    for (DX12Shader& shader : shaders)
+    {
+        shader.vertex_shader->Release();
+        shader.pixel_shader->Release();
+    }
+
+    for (DX12Buffer& buffer : buffers)
+        release_buffer(buffer);
+
+    shaders.clear();
+    meshes.clear();
+    buffers.clear();
+}
+
+JojRenderer::BufferHandle JojRenderer::DX12Renderer::create_buffer(const BufferDesc& desc)
+{
+    DX12Buffer buffer = { nullptr, nullptr, nullptr, nullptr, desc.type, desc.size, desc.stride };
+
+    if (desc.type == BufferType::CONSTANT)
+    {
+        /* The size of the "Constant Buffers" must be multiple
+          of the minimum allocation size of the hardware (256 bytes) */
+        buffer.size = (desc.size + 255) & ~255u;
+
+        // Map memory from the upload buffer to a CPU-accessible address, it stays mapped
+        allocate_resource_in_gpu(AllocationType::UPLOAD, buffer.size, &buffer.upload);
+        if (buffer.upload && FAILED(buffer.upload->Map(0, nullptr, reinterpret_cast<void**>(&buffer.mapped))))
+            buffer.mapped = nullptr;
+
+        if (buffer.mapped && desc.data)
+            memcpy(buffer.mapped, desc.data, desc.size);
+    }
+    else if (desc.data)
+    {
+        // Allocate CPU copy, upload and default heap buffers
+        allocate_resource_in_cpu(desc.size, &buffer.cpu);
+        allocate_resource_in_gpu(AllocationType::UPLOAD, desc.size, &buffer.upload);
+        allocate_resource_in_gpu(AllocationType::GPU, desc.size, &buffer.gpu);
+
+        if (buffer.cpu && buffer.upload && buffer.gpu)
+        {
+            copy_verts_to_cpu_blob(desc.data, desc.size, buffer.cpu);
+            copy_verts_to_gpu(desc.data, desc.size, buffer.upload, buffer.gpu);
+        }
+    }
+
+    b8 created = desc.type == BufferType::CONSTANT ? buffer.mapped != nullptr : buffer.cpu && buffer.upload && buffer.gpu;
+
+    BufferHandle handle;
+    if (created)
+        handle = buffers.create(buffer);
+
+    if (handle.is_null())
+    {
+        FERROR(ERR_RENDERER, "Failed to create buffer.");
+        release_buffer(buffer);
+    }
+
+    return handle;
+}
+
+b8 JojRenderer::DX12Renderer::destroy_buffer(BufferHandle buffer)
+{
+    DX12Buffer* data = buffers.get(buffer);
+    if (!data)
+        return false;
+
+    // The buffer can still be referenced by commands in flight
+    wait_command_queue();
+
+    release_buffer(*data);
+    return buffers.destroy(buffer);
+}
+
+b8 JojRenderer::DX12Renderer::update_buffer(BufferHandle buffer, const void* data, u32 size)
+{
+    DX12Buffer* target = buffers.get(buffer);
+    if (!target || !target->mapped || size > target->size)
+        return false;
+
+    memcpy(target->mapped, data, size);
+    return true;
+}
+
+D3D12_GPU_VIRTUAL_ADDRESS JojRenderer::DX12Renderer::get_buffer_address(BufferHandle buffer) const
+{
+    const DX12Buffer* data = buffers.get(buffer);
+    if (!data)
+        return 0;
+
+    return data->gpu ? data->gpu->GetGPUVirtualAddress() : data->upload->GetGPUVirtualAddress();
+}
+
+u32 JojRenderer::DX12Renderer::get_buffer_size(BufferHandle buffer) const
+{
+    const DX12Buffer* data = buffers.get(buffer);
+    return data ? data->size : 0;
+}
+
+JojRenderer::MeshHandle JojRenderer::DX12Renderer::create_mesh(BufferHandle vertices, BufferHandle indices, u32 index_count)
+{
+    if (!buffers.is_alive(vertices) || !buffers.is_alive(indices))
+        return MeshHandle();
+
+    return meshes.create(DX12Mesh{ vertices, indices, index_count });
+}
+
+b8 JojRenderer::DX12Renderer::destroy_mesh(MeshHandle mesh)
+{
+    return meshes.destroy(mesh);
+}
+
+JojRenderer::ShaderHandle JojRenderer::DX12Renderer::create_shader(const ShaderDesc& desc)
+{
+    DX12Shader shader = { nullptr, nullptr };
+    wchar_t path[MAX_PATH];
+
+    // D3DReadFileToBlob takes a wide path
+    if (desc.vertex && MultiByteToWideChar(CP_UTF8, 0, desc.vertex, -1, path, MAX_PATH))
+        D3DReadFileToBlob(path, &shader.vertex_shader);
+
+    if (desc.pixel && MultiByteToWideChar(CP_UTF8, 0, desc.pixel, -1, path, MAX_PATH))
+        D3DReadFileToBlob(path, &shader.pixel_shader);
+
+    ShaderHandle handle;
+    if (shader.vertex_shader && shader.pixel_shader)
+        handle = shaders.create(shader);
+
+    if (handle.is_null())
+    {
+        FERROR(ERR_RENDERER, "Failed to load shader.");
+
+        if (shader.vertex_shader)
+            shader.vertex_shader->Release();
+        if (shader.pixel_shader)
+            shader.pixel_shader->Release();
+    }
+
+    return handle;
+}
+
+b8 JojRenderer::DX12Renderer::destroy_shader(ShaderHandle shader)
+{
+    DX12Shader* data = shaders.get(shader);
+    if (!data)
+        return false;
+
+    data->vertex_shader->Release();
+    data->pixel_shader->Release();
+    return shaders.destroy(shader);
+}
+
+D3D12_SHADER_BYTECODE JojRenderer::DX12Renderer::get_vertex_shader(ShaderHandle shader) const
+{
+    const DX12Shader* data = shaders.get(shader);
+    if (!data)
+        return { nullptr, 0 };
+
+    return { data->vertex_shader->GetBufferPointer(), data->vertex_shader->GetBufferSize() };
+}
+
+D3D12_SHADER_BYTECODE JojRenderer::DX12Renderer::get_pixel_shader(ShaderHandle shader) const
+{
+    const DX12Shader* data = shaders.get(shader);
+    if (!data)
+        return { nullptr, 0 };
+
+    return { data->pixel_shader->GetBufferPointer(), data->pixel_shader->GetBufferSize() };
+}
+
+b8 JojRenderer::DX12Renderer::draw_mesh(MeshHandle mesh)
+{
+    const DX12Mesh* data = meshes.get(mesh);
+    if (!data)
+        return false;
+
+    const DX12Buffer* vertices = buffers.get(data->vertices);
+    const DX12Buffer* indices = buffers.get(data->indices);
+    if (!vertices || !indices)
+        return false;
+
+    // Buffer descriptors
+    D3D12_VERTEX_BUFFER_VIEW vertex_buffer_view;
+    vertex_buffer_view.BufferLocation = vertices->gpu->GetGPUVirtualAddress();
+    vertex_buffer_view.StrideInBytes = vertices->stride;
+    vertex_buffer_view.SizeInBytes = vertices->size;
+
+    D3D12_INDEX_BUFFER_VIEW index_buffer_view;
+    index_buffer_view.BufferLocation = indices->gpu->GetGPUVirtualAddress();
+    index_buffer_view.Format = get_index_format(indices->stride == 2 ? IndexFormat::U16 : IndexFormat::U32);
+    index_buffer_view.SizeInBytes = indices->size;
+
+    command_list->IASetVertexBuffers(0, 1, &vertex_buffer_view);
+    command_list->IASetIndexBuffer(&index_buffer_view);
+    command_list->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    command_list->DrawIndexedInstanced(data->index_count, 1, 0, 0, 0);
+    return true;
+}
@@ -6,24 +6,25 @@
 
 #include "renderer.h"
 #include "dx12/context_dx12.h"
-#include <DirectXColors.h>
+#include "fmath.h"
+#include "geometry.h"
+#include "vertex_format.h"
 #include <d3d12.h>
 
 namespace JojRenderer
 {
 	struct ObjectConstant
 	{
-		DirectX::XMFLOAT4X4 world_view_proj =
-		{
-			1.0f, 0.0f, 0.0f, 0.0f,
-			0.0f, 1.0f, 0.0f, 0.0f,
-			0.0f, 0.0f, 1.0f, 0.0f,
-			0.0f, 0.0f, 0.0f, 1.0f
-		};
+		Mat4 world_view_proj = mat4_identity();
 	};
 
 	enum class AllocationType { GPU, UPLOAD };
 
+	// Most resources alive at once
+	const u32 DX12_MAX_BUFFERS = 4096;
+	const u32 DX12_MAX_MESHES = 2048;
+	const u32 DX12_MAX_SHADERS = 256;
+
 	class DX12Renderer : public Renderer
 	{
 	public:
@@ -46,6 +47,81 @@ namespace JojRenderer
 		void reset_commands();          // reinicia lista para receber novos comandos
 		void submit_commands();			// Submit pending commands for execution
 
+		// ---------------------------------------------------
+		// Handle resources
+		// ---------------------------------------------------
+
+		/* Create buffer, return null handle on failure
+		 * Vertex and index buffers keep a CPU copy and are copied to a default
+		 * heap, the copy is recorded on the command list so creation must sit
+		 * between reset_commands and submit_commands. Constant buffers live in
+		 * a persistently mapped upload heap and are rewritten with update_buffer.
+		 */
+		BufferHandle create_buffer(const BufferDesc& desc);
+
+		// Release buffer once the GPU is done with it, return false if it was already destroyed
+		b8 destroy_buffer(BufferHandle buffer);
+
+		// Overwrite the contents of a constant buffer
+		b8 update_buffer(BufferHandle buffer, const void* data, u32 size);
+
+		// Return GPU address and allocated size of a buffer (0 if it was destroyed)
+		D3D12_GPU_VIRTUAL_ADDRESS get_buffer_address(BufferHandle buffer) const;
+		u32 get_buffer_size(BufferHandle buffer) const;
+
+		// Mesh drawn from a vertex and an index buffer
+		MeshHandle create_mesh(BufferHandle vertices, BufferHandle indices, u32 index_count);
+		b8 destroy_mesh(MeshHandle mesh);
+
+		// Load compiled vertex and pixel shaders (.cso files)
+		ShaderHandle create_shader(const ShaderDesc& desc);
+		b8 destroy_shader(ShaderHandle shader);
+
+		// Return shader bytecode for a pipeline state (empty if it was destroyed)
+		D3D12_SHADER_BYTECODE get_vertex_shader(ShaderHandle shader) const;
+		D3D12_SHADER_BYTECODE get_pixel_shader(ShaderHandle shader) const;
+
+		// Record binding of mesh buffers and an indexed draw, return false if it or its buffers were destroyed
+		b8 draw_mesh(MeshHandle mesh);
+
+		// Return DXGI format of an index buffer view with the given width
+		static DXGI_FORMAT get_index_format(IndexFormat format);
+
+		// Return DXGI format of a vertex attribute
+		static DXGI_FORMAT get_attribute_format(VertexAttributeFormat format);
+
+		// Fill input_layout (MAX_VERTEX_ATTRIBUTES entries) from format, return number of elements
+		static u32 get_input_layout(const VertexFormat& format, D3D12_INPUT_ELEMENT_DESC* input_layout);
+
+		ID3D12CommandQueue* get_command_queue();			// Return GPU command queue
+		ID3D12GraphicsCommandList* get_command_list();      // Return list of commands to submit to GPU
+		ID3D12CommandAllocator* get_command_list_alloc();   // Return memory used by the command list
+
+	private:
+		struct DX12Buffer
+		{
+			ID3DBlob* cpu;				// CPU copy (vertex and index buffers)
+			ID3D12Resource* upload;		// Upload heap: CPU -> GPU
+			ID3D12Resource* gpu;		// Default heap (vertex and index buffers)
+			u8* mapped;					// Upload heap address (constant buffers)
+			BufferType type;
+			u32 size;
+			u32 stride;
+		};
+
+		struct DX12Mesh
+		{
+			BufferHandle vertices;
+			BufferHandle indices;
+			u32 index_count;
+		};
+
+		struct DX12Shader
+		{
+			ID3DBlob* vertex_shader;
+			ID3DBlob* pixel_shader;
+		};
+
 		// Allocate CPU memory to resource
 		void allocate_resource_in_cpu(u32 size_in_bytes, ID3DBlob** resource);
 
@@ -58,11 +134,12 @@ namespace JojRenderer
 		// Copy vertices to GPU
 		void copy_verts_to_gpu(const void* vertices, u32 size_in_bytes, ID3D12Resource* buffer_upload, ID3D12Resource* buffer_gpu);
 
-		ID3D12CommandQueue* get_command_queue();			// Return GPU command queue
-		ID3D12GraphicsCommandList* get_command_list();      // Return list of commands to submit to GPU
-		ID3D12CommandAllocator* get_command_list_alloc();   // Return memory used by the command list
+		// Release the resources of one buffer
+		static void release_buffer(DX12Buffer& buffer);
+
+		// Wait for the GPU, then release every buffer and shader still alive
+		void release_resources();
 
-	private:
 		std::unique_ptr<JojGraphics::DX12Context> context;
 
 		// Graphics Infrastructure
@@ -99,6 +176,13 @@ namespace JojRenderer
 		D3D12_VIEWPORT viewport;						// Viewport
 		D3D12_RECT scissor_rect;						// Scissor rect
 
+		// ---------------------------------------------------
+		// Resources
+		// ---------------------------------------------------
+		JojEngine::Pool<DX12Buffer, Buffer> buffers;
+		JojEngine::Pool<DX12Mesh, Mesh> meshes;
+		JojEngine::Pool<DX12Shader, ShaderProgram> shaders;
+
 		b8 wait_command_queue();	// Wait for command queue execution
 	};
 
@@ -114,6 +198,10 @@ namespace JojRenderer
 	inline u32 DX12Renderer::get_quality()
 	{ return quality; }
 
+	// Return DXGI format of an index buffer view with the given width
+	inline DXGI_FORMAT DX12Renderer::get_index_format(IndexFormat format)
+	{ return format == IndexFormat::U16 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT; }
+
 	// Return GPU command queue
 	inline ID3D12CommandQueue* DX12Renderer::get_command_queue()
 	{ return command_queue; }
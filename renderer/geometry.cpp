@@ -1,15 +1,42 @@
 #include "geometry.h"
 
-#include <DirectXMath.h>
-using namespace DirectX;
+#include "job_system.h"
+
+// Minimum number of vertices (or indices) one job must produce before generation is split
+static const u32 MIN_ITEMS_PER_JOB = 16384;
+
+/* @brief Call func(begin, end) over [0, count), split in contiguous ranges
+ * across the workers of Geometry::jobs. Every item is written by exactly one
+ * call with the same arithmetic as a serial loop, so the output does not
+ * depend on the split. items_per_step is the output size of one step, small
+ * meshes (or no running job system) run inline.
+ */
+template <typename Func>
+static void parallel_range(u32 count, u32 items_per_step, Func func)
+{
+    JojEngine::JobSystem* jobs = JojRenderer::Geometry::jobs;
+    items_per_step = items_per_step ? items_per_step : 1;
+    u32 batch = (MIN_ITEMS_PER_JOB + items_per_step - 1) / items_per_step;
+
+    if (!jobs || !jobs->is_running() || batch >= count)
+    {
+        func(0u, count);
+        return;
+    }
+
+    jobs->parallel_for(count, batch, func);
+}
 
 // ==============================================================================
 // Geometry
 // ==============================================================================
 
+JojEngine::JobSystem* JojRenderer::Geometry::jobs = nullptr;		// Job scheduler used by generation
+
 JojRenderer::Geometry::Geometry() :
-    position(0, 0, 0),
-    type(GeometryType::UNKNOWN)
+    position(vec3_zero()),
+    type(GeometryType::UNKNOWN),
+    index_format(IndexFormat::U32)
 {
 }
 
@@ -21,61 +48,139 @@ JojRenderer::Geometry::~Geometry()
 
 // ------------------------------------------------------------------------------
 
+void JojRenderer::Geometry::pack_indices()
+{
+    // 0xFFFF is left unused, it is the strip cut value of 16-bit index buffers
+    if (vertices.size() < 0xFFFF)
+    {
+        index_format = IndexFormat::U16;
+        packed_indices.resize(indices.size());
+
+        for (size_t i = 0; i < indices.size(); ++i)
+            packed_indices[i] = u16(indices[i]);
+    }
+    else
+    {
+        index_format = IndexFormat::U32;
+        PackedIndexArray().swap(packed_indices);
+    }
+}
+
+// ------------------------------------------------------------------------------
+
+// Open-addressing table from an edge (pair of vertex indices) to its midpoint vertex
+struct EdgeMidpointCache
+{
+    std::vector<u64> keys;      // Edge key, EMPTY_EDGE when slot is free
+    std::vector<u32> values;    // Index of midpoint vertex
+    u64 mask;
+
+    static constexpr u64 EMPTY_EDGE = ~0ULL;
+
+    explicit EdgeMidpointCache(u32 edge_count)
+    {
+        // Keep load factor at or below 0.5
+        u64 capacity = 16;
+        while (capacity < u64(edge_count) * 2)
+            capacity <<= 1;
+
+        keys.assign(capacity, EMPTY_EDGE);
+        values.resize(capacity);
+        mask = capacity - 1;
+    }
+
+    // Return slot of edge (a, b), either holding it or free
+    u64 find(u32 a, u32 b, u64& key) const
+    {
+        key = a < b ? (u64(a) << 32) | b : (u64(b) << 32) | a;
+
+        // Fibonacci hashing spreads neighbouring indices across the table
+        u64 slot = (key * 0x9E3779B97F4A7C15ULL) >> 32 & mask;
+        while (keys[slot] != EMPTY_EDGE && keys[slot] != key)
+            slot = (slot + 1) & mask;
+
+        return slot;
+    }
+};
+
+// Return index of the midpoint of edge (a, b), creating the vertex the first time the edge is seen
+static u32 edge_midpoint(JojRenderer::VertexArray& vertices, EdgeMidpointCache& cache, u32 a, u32 b)
+{
+    u64 key;
+    u64 slot = cache.find(a, b, key);
+
+    if (cache.keys[slot] == key)
+        return cache.values[slot];
+
+    const JojRenderer::Vertex& va = vertices[a];
+    const JojRenderer::Vertex& vb = vertices[b];
+
+    JojRenderer::Vertex m;
+    m.pos = vec3_multiply_by_scalar(vec3_add(va.pos, vb.pos), 0.5f);
+    m.color = { 0.5f * (va.color.x + vb.color.x), 0.5f * (va.color.y + vb.color.y),
+        0.5f * (va.color.z + vb.color.z), 0.5f * (va.color.w + vb.color.w) };
+
+    u32 index = u32(vertices.size());
+    vertices.push_back(m);
+
+    cache.keys[slot] = key;
+    cache.values[slot] = index;
+    return index;
+}
+
 void JojRenderer::Geometry::subdivide()
 {
-    // Save a copy of the original geometry
-    std::vector <JojRenderer::Vertex> vertices_copy = vertices;
-    std::vector <u32> indices_copy = indices;
-
-    vertices.resize(0);
-    indices.resize(0);
-
-    //       v1
-    //       *
-    //      / \
-    //     /   \
-    //  m0*-----*m1
-    //   / \   / \
-    //  /   \ /   \
-    // *-----*-----*
-    // v0    m2     v2
-
-    u32 num_tris = (u32)indices_copy.size() / 3;
-    for (u32 i = 0; i < num_tris; ++i)
+    /*       v1
+     *       *
+     *      / \
+     *     /   \
+     *  m0*-----*m1
+     *   / \   / \
+     *  /   \ /   \
+     * *-----*-----*
+     * v0    m2     v2
+     */
+
+    // Triangles sharing an edge share its midpoint, so a closed mesh gains
+    // E = 3T/2 vertices per level instead of 6T (open edges grow the vector)
+    u32 num_tris = (u32)indices.size() / 3;
+    u32 num_edges = num_tris * 3 / 2;
+
+    vertices.reserve(vertices.size() + num_edges);
+    EdgeMidpointCache cache(num_edges);
+
+    // Every triangle becomes four. Walking backwards lets the output of
+    // triangle i (indices 12i..12i+11) overwrite only triangles already read.
+    indices.resize(size_t(num_tris) * 12);
+
+    for (u32 i = num_tris; i-- > 0;)
     {
-        JojRenderer::Vertex v0 = vertices_copy[indices_copy[size_t(i) * 3 + 0]];
-        JojRenderer::Vertex v1 = vertices_copy[indices_copy[size_t(i) * 3 + 1]];
-        JojRenderer::Vertex v2 = vertices_copy[indices_copy[size_t(i) * 3 + 2]];
+        u32 v0 = indices[size_t(i) * 3 + 0];
+        u32 v1 = indices[size_t(i) * 3 + 1];
+        u32 v2 = indices[size_t(i) * 3 + 2];
 
         // Find center points of each edge
-        JojRenderer::Vertex m0, m1, m2;
-        XMStoreFloat3(&m0.pos, 0.5f * (XMLoadFloat3(&v0.pos) + XMLoadFloat3(&v1.pos)));
-        XMStoreFloat3(&m1.pos, 0.5f * (XMLoadFloat3(&v1.pos) + XMLoadFloat3(&v2.pos)));
-        XMStoreFloat3(&m2.pos, 0.5f * (XMLoadFloat3(&v0.pos) + XMLoadFloat3(&v2.pos)));
-
-        // Add new geometry
-        vertices.push_back(v0); // 0
-        vertices.push_back(v1); // 1
-        vertices.push_back(v2); // 2
-        vertices.push_back(m0); // 3
-        vertices.push_back(m1); // 4
-        vertices.push_back(m2); // 5
-
-        indices.push_back(i * 6 + 0);
-        indices.push_back(i * 6 + 3);
-        indices.push_back(i * 6 + 5);
-
-        indices.push_back(i * 6 + 3);
-        indices.push_back(i * 6 + 4);
-        indices.push_back(i * 6 + 5);
-
-        indices.push_back(i * 6 + 5);
-        indices.push_back(i * 6 + 4);
-        indices.push_back(i * 6 + 2);
-
-        indices.push_back(i * 6 + 3);
-        indices.push_back(i * 6 + 1);
-        indices.push_back(i * 6 + 4);
+        u32 m0 = edge_midpoint(vertices, cache, v0, v1);
+        u32 m1 = edge_midpoint(vertices, cache, v1, v2);
+        u32 m2 = edge_midpoint(vertices, cache, v0, v2);
+
+        u32* out = &indices[size_t(i) * 12];
+
+        out[0] = v0;
+        out[1] = m0;
+        out[2] = m2;
+
+        out[3] = m0;
+        out[4] = m1;
+        out[5] = m2;
+
+        out[6] = m2;
+        out[7] = m1;
+        out[8] = v2;
+
+        out[9] = m0;
+        out[10] = v1;
+        out[11] = m1;
     }
 }
 
@@ -99,14 +204,14 @@ JojRenderer::Cube::Cube(f32 width, f32 height, f32 depth)
     // Create geometry vertices
     Vertex cube_vertices[8] =
     {
-        { DirectX::XMFLOAT3(-w, -h, -d), DirectX::XMFLOAT4(DirectX::Colors::Yellow) },
-        { DirectX::XMFLOAT3(-w, +h, -d), DirectX::XMFLOAT4(DirectX::Colors::Yellow) },
-        { DirectX::XMFLOAT3(+w, +h, -d), DirectX::XMFLOAT4(DirectX::Colors::Yellow) },
-        { DirectX::XMFLOAT3(+w, -h, -d), DirectX::XMFLOAT4(DirectX::Colors::Yellow) },
-        { DirectX::XMFLOAT3(-w, -h, +d), DirectX::XMFLOAT4(DirectX::Colors::Yellow) },
-        { DirectX::XMFLOAT3(-w, +h, +d), DirectX::XMFLOAT4(DirectX::Colors::Yellow) },
-        { DirectX::XMFLOAT3(+w, +h, +d), DirectX::XMFLOAT4(DirectX::Colors::Yellow) },
-        { DirectX::XMFLOAT3(+w, -h, +d), DirectX::XMFLOAT4(DirectX::Colors::Yellow) }
+        { vec3_create(-w, -h, -d), vec4_yellow() },
+        { vec3_create(-w, +h, -d), vec4_yellow() },
+        { vec3_create(+w, +h, -d), vec4_yellow() },
+        { vec3_create(+w, -h, -d), vec4_yellow() },
+        { vec3_create(-w, -h, +d), vec4_yellow() },
+        { vec3_create(-w, +h, +d), vec4_yellow() },
+        { vec3_create(+w, +h, +d), vec4_yellow() },
+        { vec3_create(+w, -h, +d), vec4_yellow() }
     };
 
     // Add vertices to mesh
@@ -144,9 +249,11 @@ JojRenderer::Cube::Cube(f32 width, f32 height, f32 depth)
     // Add indices to mesh
     for (u16 i : cube_indices)
         indices.push_back(i);
+
+    pack_indices();
 }
 
-JojRenderer::Cube::Cube(f32 width, f32 height, f32 depth, DirectX::XMFLOAT4 color)
+JojRenderer::Cube::Cube(f32 width, f32 height, f32 depth, Vec4 color)
 {
     type = GeometryType::CUBE;
 
@@ -157,14 +264,14 @@ JojRenderer::Cube::Cube(f32 width, f32 height, f32 depth, DirectX::XMFLOAT4 colo
     // Create geometry vertices
     Vertex cube_vertices[8] =
     {
-        { DirectX::XMFLOAT3(-w, -h, -d), color },
-        { DirectX::XMFLOAT3(-w, +h, -d), color },
-        { DirectX::XMFLOAT3(+w, +h, -d), color },
-        { DirectX::XMFLOAT3(+w, -h, -d), color },
-        { DirectX::XMFLOAT3(-w, -h, +d), color },
-        { DirectX::XMFLOAT3(-w, +h, +d), color },
-        { DirectX::XMFLOAT3(+w, +h, +d), color },
-        { DirectX::XMFLOAT3(+w, -h, +d), color }
+        { vec3_create(-w, -h, -d), color },
+        { vec3_create(-w, +h, -d), color },
+        { vec3_create(+w, +h, -d), color },
+        { vec3_create(+w, -h, -d), color },
+        { vec3_create(-w, -h, +d), color },
+        { vec3_create(-w, +h, +d), color },
+        { vec3_create(+w, +h, +d), color },
+        { vec3_create(+w, -h, +d), color }
     };
 
     // Add vertices to mesh
@@ -202,6 +309,8 @@ JojRenderer::Cube::Cube(f32 width, f32 height, f32 depth, DirectX::XMFLOAT4 colo
     // Add indices to mesh
     for (u16 i : cube_indices)
         indices.push_back(i);
+
+    pack_indices();
 }
 
 // ==============================================================================
@@ -226,77 +335,88 @@ JojRenderer::Cylinder::Cylinder(f32 bottom, f32 top, f32 height, u32 slice_count
     // Number of cylinder rings
     u32 ring_count = layer_count + 1;
 
+    // Number of vertices in each cylinder ring
+    u32 ring_vertex_count = slice_count + 1;
+
+    // Side rings, then two lids (ring plus central vertex each)
+    u32 side_vertex_count = ring_count * ring_vertex_count;
+    u32 side_index_count = layer_count * slice_count * 6;
+    vertices.resize(size_t(side_vertex_count) + 2 * (size_t(ring_vertex_count) + 1));
+    indices.resize(size_t(side_index_count) + 2 * size_t(slice_count) * 3);
+
     // Calculate vertices of each ring
-    for (u32 i = 0; i < ring_count; ++i)
+    parallel_range(ring_count, ring_vertex_count, [&](u32 begin, u32 end)
     {
-        f32 y = -0.5f * height + i * layer_height;
-        f32 r = bottom + i * radius_step;
-        f32 theta = 2.0f * DirectX::XM_PI / slice_count;
-
-        for (u32 j = 0; j <= slice_count; ++j)
+        for (u32 i = begin; i < end; ++i)
         {
-            f32 c = cosf(j * theta);
-            f32 s = sinf(j * theta);
-
-            Vertex vertex;
-            vertex.pos = DirectX::XMFLOAT3(r * c, y, r * s);
-            vertex.color = DirectX::XMFLOAT4(DirectX::Colors::Yellow);
-            vertices.push_back(vertex);
+            f32 y = -0.5f * height + i * layer_height;
+            f32 r = bottom + i * radius_step;
+            f32 theta = 2.0f * F_PI / slice_count;
+
+            Vertex* ring = &vertices[size_t(i) * ring_vertex_count];
+            for (u32 j = 0; j <= slice_count; ++j)
+            {
+                f32 c = cosf(j * theta);
+                f32 s = sinf(j * theta);
+
+                ring[j].pos = vec3_create(r * c, y, r * s);
+                ring[j].color = vec4_yellow();
+            }
         }
-    }
-
-    // Number of vertices in each cylinder ring
-    u32 ring_vertex_count = slice_count + 1;
+    });
 
     // Calculate indexes for each layer
-    for (u32 i = 0; i < layer_count; ++i)
+    parallel_range(layer_count, slice_count * 6, [&](u32 begin, u32 end)
     {
-        for (u32 j = 0; j < slice_count; ++j)
+        for (u32 i = begin; i < end; ++i)
         {
-            indices.push_back(i * ring_vertex_count + j);
-            indices.push_back((i + 1) * ring_vertex_count + j);
-            indices.push_back((i + 1) * ring_vertex_count + j + 1);
-            indices.push_back(i * ring_vertex_count + j);
-            indices.push_back((i + 1) * ring_vertex_count + j + 1);
-            indices.push_back(i * ring_vertex_count + j + 1);
+            u32* out = &indices[size_t(i) * slice_count * 6];
+            for (u32 j = 0; j < slice_count; ++j)
+            {
+                *out++ = i * ring_vertex_count + j;
+                *out++ = (i + 1) * ring_vertex_count + j;
+                *out++ = (i + 1) * ring_vertex_count + j + 1;
+                *out++ = i * ring_vertex_count + j;
+                *out++ = (i + 1) * ring_vertex_count + j + 1;
+                *out++ = i * ring_vertex_count + j + 1;
+            }
         }
-    }
+    });
 
     // Constructs vertices of cylinder covers
     for (u32 k = 0; k < 2; ++k)
     {
-        u32 base_index = u32(vertices.size());
+        u32 base_index = side_vertex_count + k * (ring_vertex_count + 1);
 
         f32 y = (k - 0.5f) * height;
-        f32 theta = 2.0f * DirectX::XM_PI / slice_count;
+        f32 theta = 2.0f * F_PI / slice_count;
         f32 r = (k ? top : bottom);
-        Vertex vertex;
 
         for (u32 i = 0; i <= slice_count; i++)
         {
             f32 x = r * cosf(i * theta);
             f32 z = r * sinf(i * theta);
 
-            vertex.pos = DirectX::XMFLOAT3(x, y, z);
-            vertex.color = DirectX::XMFLOAT4(DirectX::Colors::Yellow);
-            vertices.push_back(vertex);
+            vertices[size_t(base_index) + i].pos = vec3_create(x, y, z);
+            vertices[size_t(base_index) + i].color = vec4_yellow();
         }
 
         // Central vertex of the lid
-        vertex.pos = DirectX::XMFLOAT3(0.0f, y, 0.0f);
-        vertex.color = DirectX::XMFLOAT4(DirectX::Colors::Yellow);
-        vertices.push_back(vertex);
-
-        u32 center_index = u32(vertices.size() - 1);
+        u32 center_index = base_index + ring_vertex_count;
+        vertices[center_index].pos = vec3_create(0.0f, y, 0.0f);
+        vertices[center_index].color = vec4_yellow();
 
         // Indices for the lid
+        u32* out = &indices[side_index_count + size_t(k) * slice_count * 3];
         for (u32 i = 0; i < slice_count; ++i)
         {
-            indices.push_back(center_index);
-            indices.push_back(base_index + i + k);
-            indices.push_back(base_index + i + 1 - k);
+            *out++ = center_index;
+            *out++ = base_index + i + k;
+            *out++ = base_index + i + 1 - k;
         }
     }
+
+    pack_indices();
 }
 
 // ==============================================================================
@@ -314,69 +434,81 @@ JojRenderer::Sphere::Sphere(f32 radius, u32 slice_count, u32 layer_count)
 
     // Calculate the vertex by starting at the top pole and working its way down through the layers
 
-    Vertex top_vertex;
-    top_vertex.pos = DirectX::XMFLOAT3(0.0f, radius, 0.0f);
-    top_vertex.color = DirectX::XMFLOAT4(DirectX::Colors::Yellow);
+    u32 ring_vertex_count = slice_count + 1;
+    u32 ring_count = layer_count - 1;       // Poles are not counted as rings
+    u32 inner_layer_count = layer_count - 2;
+
+    // Top pole, rings, bottom pole
+    vertices.resize(2 + size_t(ring_count) * ring_vertex_count);
 
-    Vertex bottom_vertex;
-    bottom_vertex.pos = DirectX::XMFLOAT3(0.0f, -radius, 0.0f);
-    bottom_vertex.color = DirectX::XMFLOAT4(DirectX::Colors::Yellow);
+    // Top fan, inner layers, bottom fan
+    indices.resize(size_t(slice_count) * 6 + size_t(inner_layer_count) * slice_count * 6);
 
-    vertices.push_back(top_vertex);
+    Vertex& top_vertex = vertices.front();
+    top_vertex.pos = vec3_create(0.0f, radius, 0.0f);
+    top_vertex.color = vec4_yellow();
 
-    f32 phiStep = DirectX::XM_PI / layer_count;
-    f32 thetaStep = 2.0f * DirectX::XM_PI / slice_count;
+    Vertex& bottom_vertex = vertices.back();
+    bottom_vertex.pos = vec3_create(0.0f, -radius, 0.0f);
+    bottom_vertex.color = vec4_yellow();
+
+    f32 phiStep = F_PI / layer_count;
+    f32 thetaStep = 2.0f * F_PI / slice_count;
 
     // Calculate the vertices for each ring (does not count the poles as rings)
-    for (u32 i = 1; i <= layer_count - 1; ++i)
+    parallel_range(ring_count, ring_vertex_count, [&](u32 begin, u32 end)
     {
-        f32 phi = i * phiStep;
-
-        // Ring vertices
-        for (u32 j = 0; j <= slice_count; ++j)
+        for (u32 i = begin + 1; i <= end; ++i)
         {
-            f32 theta = j * thetaStep;
+            f32 phi = i * phiStep;
 
-            Vertex v;
+            // Ring vertices
+            Vertex* ring = &vertices[1 + size_t(i - 1) * ring_vertex_count];
+            for (u32 j = 0; j <= slice_count; ++j)
+            {
+                f32 theta = j * thetaStep;
 
-            // Spherical coordinates for Cartesian coordinates
-            v.pos.x = radius * sinf(phi) * cosf(theta);
-            v.pos.y = radius * cosf(phi);
-            v.pos.z = radius * sinf(phi) * sinf(theta);
+                // Spherical coordinates for Cartesian coordinates
+                ring[j].pos.x = radius * sinf(phi) * cosf(theta);
+                ring[j].pos.y = radius * cosf(phi);
+                ring[j].pos.z = radius * sinf(phi) * sinf(theta);
 
-            v.color = DirectX::XMFLOAT4(DirectX::Colors::Yellow);
-
-            vertices.push_back(v);
+                ring[j].color = vec4_yellow();
+            }
         }
-    }
-
-    vertices.push_back(bottom_vertex);
+    });
 
     // Calculate the indexes of the top layer
     // This layer connects the top pole to the first ring
+    u32* out = indices.data();
     for (u32 i = 1; i <= slice_count; ++i)
     {
-        indices.push_back(0);
-        indices.push_back(i + 1);
-        indices.push_back(i);
+        *out++ = 0;
+        *out++ = i + 1;
+        *out++ = i;
     }
 
     // Calculate the indexes for the inner layers (not connected to the poles)
     u32 base_index = 1;
-    u32 ring_vertex_count = slice_count + 1;
-    for (u32 i = 0; i < layer_count - 2; ++i)
+    u32* inner = out;
+    parallel_range(inner_layer_count, slice_count * 6, [&](u32 begin, u32 end)
     {
-        for (u32 j = 0; j < slice_count; ++j)
+        for (u32 i = begin; i < end; ++i)
         {
-            indices.push_back(base_index + i * ring_vertex_count + j);
-            indices.push_back(base_index + i * ring_vertex_count + j + 1);
-            indices.push_back(base_index + (i + 1) * ring_vertex_count + j);
-
-            indices.push_back(base_index + (i + 1) * ring_vertex_count + j);
-            indices.push_back(base_index + i * ring_vertex_count + j + 1);
-            indices.push_back(base_index + (i + 1) * ring_vertex_count + j + 1);
+            u32* layer = inner + size_t(i) * slice_count * 6;
+            for (u32 j = 0; j < slice_count; ++j)
+            {
+                *layer++ = base_index + i * ring_vertex_count + j;
+                *layer++ = base_index + i * ring_vertex_count + j + 1;
+                *layer++ = base_index + (i + 1) * ring_vertex_count + j;
+
+                *layer++ = base_index + (i + 1) * ring_vertex_count + j;
+                *layer++ = base_index + i * ring_vertex_count + j + 1;
+                *layer++ = base_index + (i + 1) * ring_vertex_count + j + 1;
+            }
         }
-    }
+    });
+    out += size_t(inner_layer_count) * slice_count * 6;
 
     // Calculate the indexes of the bottom layer
     // This layer connects the bottom pole to the last ring
@@ -389,10 +521,12 @@ JojRenderer::Sphere::Sphere(f32 radius, u32 slice_count, u32 layer_count)
 
     for (u32 i = 0; i < slice_count; ++i)
     {
-        indices.push_back(south_pole_index);
-        indices.push_back(base_index + i);
-        indices.push_back(base_index + i + 1);
+        *out++ = south_pole_index;
+        *out++ = base_index + i;
+        *out++ = base_index + i + 1;
     }
+
+    pack_indices();
 }
 
 // ==============================================================================
@@ -416,14 +550,14 @@ JojRenderer::GeoSphere::GeoSphere(f32 radius, u32 subdivisions)
     const f32 Z = 0.850651f;
 
     // Vertices of the icosahedron
-    DirectX::XMFLOAT3 pos[12] =
+    Vec3 pos[12] =
     {
-        DirectX::XMFLOAT3(-X, 0.0f, Z),  DirectX::XMFLOAT3(X, 0.0f, Z),
-        DirectX::XMFLOAT3(-X, 0.0f, -Z), DirectX::XMFLOAT3(X, 0.0f, -Z),
-        DirectX::XMFLOAT3(0.0f, Z, X),   DirectX::XMFLOAT3(0.0f, Z, -X),
-        DirectX::XMFLOAT3(0.0f, -Z, X),  DirectX::XMFLOAT3(0.0f, -Z, -X),
-        DirectX::XMFLOAT3(Z, X, 0.0f),   DirectX::XMFLOAT3(-Z, X, 0.0f),
-        DirectX::XMFLOAT3(Z, -X, 0.0f),  DirectX::XMFLOAT3(-Z, -X, 0.0f)
+        vec3_create(-X, 0.0f, Z),  vec3_create(X, 0.0f, Z),
+        vec3_create(-X, 0.0f, -Z), vec3_create(X, 0.0f, -Z),
+        vec3_create(0.0f, Z, X),   vec3_create(0.0f, Z, -X),
+        vec3_create(0.0f, -Z, X),  vec3_create(0.0f, -Z, -X),
+        vec3_create(Z, X, 0.0f),   vec3_create(-Z, X, 0.0f),
+        vec3_create(Z, -X, 0.0f),  vec3_create(-Z, -X, 0.0f)
     };
 
     // Indices of the icosahedron
@@ -447,17 +581,20 @@ JojRenderer::GeoSphere::GeoSphere(f32 radius, u32 subdivisions)
         subdivide();
 
     // Project the vertices onto a sphere and adjust the scale
-    for (u32 i = 0; i < vertices.size(); ++i)
+    parallel_range(u32(vertices.size()), 1, [&](u32 begin, u32 end)
     {
-        // Normalize vetor (point)
-        DirectX::XMVECTOR n = DirectX::XMVector3Normalize(XMLoadFloat3(&vertices[i].pos));
+        for (u32 i = begin; i < end; ++i)
+        {
+            // Normalize vetor (point)
+            Vec3 n = vec3_normalize(vertices[i].pos);
 
-        // Project on sphere
-        DirectX::XMVECTOR p = radius * n;
+            // Project on sphere
+            vertices[i].pos = vec3_multiply_by_scalar(n, radius);
+            vertices[i].color = vec4_yellow();
+        }
+    });
 
-        XMStoreFloat3(&vertices[i].pos, p);
-        vertices[i].color = DirectX::XMFLOAT4(DirectX::Colors::Yellow);
-    }
+    pack_indices();
 }
 
 // ==============================================================================
@@ -486,39 +623,48 @@ JojRenderer::Grid::Grid(f32 width, f32 depth, u32 m, u32 n)
     // Adjust vertex vector size
     vertices.resize(vertex_count);
 
-    for (u32 i = 0; i < m; ++i)
+    // Rows are independent, split them across threads
+    parallel_range(m, n, [&](u32 begin, u32 end)
     {
-        f32 z = half_depth - i * dz;
-
-        for (u32 j = 0; j < n; ++j)
+        for (u32 i = begin; i < end; ++i)
         {
-            f32 x = -half_width + j * dx;
+            f32 z = half_depth - i * dz;
+
+            for (u32 j = 0; j < n; ++j)
+            {
+                f32 x = -half_width + j * dx;
 
-            // Define grid vertices
-            vertices[size_t(i) * n + j].pos = DirectX::XMFLOAT3(x, 0.0f, z);
-            vertices[size_t(i) * n + j].color = DirectX::XMFLOAT4(DirectX::Colors::Yellow);
+                // Define grid vertices
+                vertices[size_t(i) * n + j].pos = vec3_create(x, 0.0f, z);
+                vertices[size_t(i) * n + j].color = vec4_yellow();
+            }
         }
-    }
+    });
 
     // Adjust vector size of indexes
     indices.resize(size_t(triangle_count) * 3);
 
-    size_t k = 0;
-
-    for (u32 i = 0; i < m - 1; ++i)
+    parallel_range(m - 1, (n - 1) * 6, [&](u32 begin, u32 end)
     {
-        for (u32 j = 0; j < n - 1; ++j)
+        size_t k = size_t(begin) * (n - 1) * 6;
+
+        for (u32 i = begin; i < end; ++i)
         {
-            indices[k] = i * n + j;
-            indices[k + 1] = i * n + j + 1;
-            indices[k + 2] = (i + 1) * n + j;
-            indices[k + 3] = (i + 1) * n + j;
-            indices[k + 4] = i * n + j + 1;
-            indices[k + 5] = (i + 1) * n + j + 1;
-
-            k += 6; // Next quad
+            for (u32 j = 0; j < n - 1; ++j)
+            {
+                indices[k] = i * n + j;
+                indices[k + 1] = i * n + j + 1;
+                indices[k + 2] = (i + 1) * n + j;
+                indices[k + 3] = (i + 1) * n + j;
+                indices[k + 4] = i * n + j + 1;
+                indices[k + 5] = (i + 1) * n + j + 1;
+
+                k += 6; // Next quad
+            }
         }
-    }
+    });
+
+    pack_indices();
 }
 
 // ==============================================================================
@@ -542,10 +688,10 @@ JojRenderer::Quad::Quad(f32 width, f32 height)
     // Create vertex buffer
     Vertex quad_vertices[4] =
     {
-        { DirectX::XMFLOAT3(-w, -h, 0.0f), DirectX::XMFLOAT4(DirectX::Colors::Yellow) },
-        { DirectX::XMFLOAT3(-w, +h, 0.0f), DirectX::XMFLOAT4(DirectX::Colors::Yellow) },
-        { DirectX::XMFLOAT3(+w, +h, 0.0f), DirectX::XMFLOAT4(DirectX::Colors::Yellow) },
-        { DirectX::XMFLOAT3(+w, -h, 0.0f), DirectX::XMFLOAT4(DirectX::Colors::Yellow) }
+        { vec3_create(-w, -h, 0.0f), vec4_yellow() },
+        { vec3_create(-w, +h, 0.0f), vec4_yellow() },
+        { vec3_create(+w, +h, 0.0f), vec4_yellow() },
+        { vec3_create(+w, -h, 0.0f), vec4_yellow() }
     };
 
     // Add vertices to mesh
@@ -562,4 +708,6 @@ JojRenderer::Quad::Quad(f32 width, f32 height)
     // insere ndices na malha
     for (u32 i : quad_indices)
         indices.push_back(i);
+
+    pack_indices();
 }
\ No newline at end of file
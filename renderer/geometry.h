@@ -2,20 +2,33 @@
 
 #include "defines.h"
 
-#include <DirectXMath.h>
+#include "fmath.h"
+#include "memory_tracker.h"
 #include <vector>
-#include <DirectXColors.h>
+
+namespace JojEngine
+{
+	class JobSystem;
+}
 
 namespace JojRenderer
 {
 	enum class GeometryType { UNKNOWN, CUBE, CYLINDER, SPHERE, GEOSPHERE, GRID, QUAD};
 
+	// Width of the indices uploaded to the GPU
+	enum class IndexFormat { U16, U32 };
+
 	struct Vertex
 	{
-		DirectX::XMFLOAT3 pos;
-		DirectX::XMFLOAT4 color;
+		Vec3 pos;
+		Vec4 color;
 	};
 
+	// Geometry arrays are counted under MemoryTag::GEOMETRY
+	typedef JojEngine::TrackedVector<Vertex, JojEngine::MemoryTag::GEOMETRY> VertexArray;
+	typedef JojEngine::TrackedVector<u32, JojEngine::MemoryTag::GEOMETRY> IndexArray;
+	typedef JojEngine::TrackedVector<u16, JojEngine::MemoryTag::GEOMETRY> PackedIndexArray;
+
 	// -------------------------------------------------------------------------------
 	// Geometry
 	// -------------------------------------------------------------------------------
@@ -26,15 +39,15 @@ namespace JojRenderer
 		Geometry();
 		virtual ~Geometry();
 
-		std::vector<Vertex> vertices;					// Geometry vertices
-		std::vector<u32> indices;						// Geometry indices
+		VertexArray vertices;							// Geometry vertices
+		IndexArray indices;								// Geometry indices (always 32-bit, used to build and edit the mesh)
 
 		virtual f32 x() const { return position.x;  }	// Return x position of geometry
 		virtual f32 y() const { return position.y;  }	// Return y position of geometry
 		virtual f32 z() const { return position.z;  }	// Return z position of geometry
 
 		// Return geometry position
-		virtual DirectX::XMFLOAT3 get_position() const { return position; }
+		virtual Vec3 get_position() const { return position; }
 		
 		// Return geometry type
 		virtual GeometryType get_type() const { return type; }
@@ -51,9 +64,27 @@ namespace JojRenderer
 		const Vertex* get_vertex_data() const
 		{ return vertices.data(); }
 
-		// Return geometry indices
-		const u32* get_index_data() const
-		{ return indices.data(); }
+		/* @brief Rebuild the GPU index data from indices, 16-bit when every
+		 * index fits. Geometry constructors call it, call it again after
+		 * editing indices or vertices.
+		 */
+		void pack_indices();
+
+		// Return width of the index data
+		IndexFormat get_index_format() const
+		{ return index_format; }
+
+		// Return size in bytes of one index of the index data (2 or 4)
+		u32 get_index_size() const
+		{ return index_format == IndexFormat::U16 ? sizeof(u16) : sizeof(u32); }
+
+		// Return index data to upload, get_index_format() tells its width
+		const void* get_index_data() const
+		{ return index_format == IndexFormat::U16 ? (const void*)packed_indices.data() : (const void*)indices.data(); }
+
+		// Return size in bytes of the index data
+		u32 get_index_data_size() const
+		{ return get_index_count() * get_index_size(); }
 
 		// Return number of geometry vertices
 		u32 get_vertex_count() const
@@ -63,9 +94,14 @@ namespace JojRenderer
 		u32 get_index_count() const
 		{ return u32(indices.size()); }
 
+		// Job scheduler large meshes are generated on, inline when null or not running
+		static JojEngine::JobSystem* jobs;
+
 	protected:
-		DirectX::XMFLOAT3 position;			// Geometry position
+		Vec3 position;						// Geometry position
 		GeometryType type;					// Geometry type
+		IndexFormat index_format;			// Width of the index data
+		PackedIndexArray packed_indices;	// 16-bit copy of indices when index_format is U16
 
 		void subdivide();					// Subdivide triangles
 
@@ -81,7 +117,7 @@ namespace JojRenderer
 	public:
 		Cube();
 		Cube(f32 width, f32 height, f32 depth);
-		Cube(f32 width, f32 height, f32 depth, DirectX::XMFLOAT4 color);
+		Cube(f32 width, f32 height, f32 depth, Vec4 color);
 	};
 
 	// -------------------------------------------------------------------------------
@@ -0,0 +1,345 @@
+#include "mesh_optimizer.h"
+
+#include <algorithm>
+
+static const u32 INVALID_INDEX = ~0u;
+
+// ==============================================================================
+// Analysis
+// ==============================================================================
+
+JojRenderer::VertexCacheStats JojRenderer::analyze_vertex_cache(const u32* indices, u32 index_count,
+    u32 vertex_count, u32 cache_size)
+{
+    VertexCacheStats stats = { 0.0f, 0.0f, 0 };
+    if (index_count < 3)
+        return stats;
+
+    // A vertex is in the FIFO if it was inserted in the last cache_size insertions
+    std::vector<u32> timestamps(vertex_count, 0);
+    std::vector<u8> referenced(vertex_count, 0);
+    u32 time = cache_size + 1;
+    u32 unique = 0;
+
+    for (u32 i = 0; i < index_count; ++i)
+    {
+        u32 v = indices[i];
+
+        if (time - timestamps[v] > cache_size)
+        {
+            timestamps[v] = time++;
+            stats.transformed++;
+        }
+
+        if (!referenced[v])
+        {
+            referenced[v] = 1;
+            unique++;
+        }
+    }
+
+    stats.acmr = f32(stats.transformed) / f32(index_count / 3);
+    stats.atvr = f32(stats.transformed) / f32(unique);
+    return stats;
+}
+
+// ==============================================================================
+// Vertex cache (Tipsify)
+// ==============================================================================
+
+void JojRenderer::optimize_vertex_cache(u32* destination, const u32* indices, u32 index_count,
+    u32 vertex_count, u32 cache_size)
+{
+    u32 tri_count = index_count / 3;
+    if (tri_count == 0)
+        return;
+
+    // Triangles not yet emitted per vertex
+    std::vector<u32> live(vertex_count, 0);
+    for (u32 i = 0; i < tri_count * 3; ++i)
+        live[indices[i]]++;
+
+    // Vertex -> triangle adjacency (CSR)
+    std::vector<u32> offsets(size_t(vertex_count) + 1, 0);
+    for (u32 v = 0; v < vertex_count; ++v)
+        offsets[size_t(v) + 1] = offsets[v] + live[v];
+
+    std::vector<u32> adjacency(size_t(tri_count) * 3);
+    std::vector<u32> fill(offsets.begin(), offsets.end() - 1);
+    for (u32 t = 0; t < tri_count; ++t)
+        for (u32 c = 0; c < 3; ++c)
+            adjacency[fill[indices[t * 3 + c]]++] = t;
+
+    std::vector<u32> timestamps(vertex_count, 0);
+    std::vector<u8> emitted(tri_count, 0);
+    std::vector<u32> dead_end;
+    dead_end.reserve(size_t(tri_count) * 3);
+
+    u32 time = cache_size + 1;
+    u32 out = 0;
+    u32 cursor = 0;
+    u32 fan = indices[0];
+
+    while (fan != INVALID_INDEX)
+    {
+        size_t candidates_begin = dead_end.size();
+
+        // Emit every remaining triangle around the fanning vertex
+        for (u32 k = offsets[fan]; k < offsets[size_t(fan) + 1]; ++k)
+        {
+            u32 t = adjacency[k];
+            if (emitted[t])
+                continue;
+
+            for (u32 c = 0; c < 3; ++c)
+            {
+                u32 v = indices[t * 3 + c];
+                destination[out++] = v;
+                dead_end.push_back(v);
+                live[v]--;
+
+                if (time - timestamps[v] > cache_size)
+                    timestamps[v] = time++;
+            }
+
+            emitted[t] = 1;
+        }
+
+        // Next fan: oldest 1-ring vertex that stays in cache while its triangles are emitted
+        u32 next = INVALID_INDEX;
+        i32 best_priority = -1;
+
+        for (size_t j = candidates_begin; j < dead_end.size(); ++j)
+        {
+            u32 v = dead_end[j];
+            if (live[v] == 0)
+                continue;
+
+            i32 priority = 0;
+            if (time - timestamps[v] + 2 * live[v] <= cache_size)
+                priority = i32(time - timestamps[v]);
+
+            if (priority > best_priority)
+            {
+                best_priority = priority;
+                next = v;
+            }
+        }
+
+        // Dead end: recently used vertices first, then input order
+        while (next == INVALID_INDEX && !dead_end.empty())
+        {
+            u32 v = dead_end.back();
+            dead_end.pop_back();
+            if (live[v] > 0)
+                next = v;
+        }
+
+        while (next == INVALID_INDEX && cursor < vertex_count)
+        {
+            if (live[cursor] > 0)
+                next = cursor;
+            cursor++;
+        }
+
+        fan = next;
+    }
+}
+
+// ==============================================================================
+// Overdraw
+// ==============================================================================
+
+void JojRenderer::optimize_overdraw(u32* destination, const u32* indices, u32 index_count,
+    const Vertex* vertices, u32 vertex_count, f32 threshold, u32 cache_size)
+{
+    u32 tri_count = index_count / 3;
+    if (tri_count == 0)
+        return;
+
+    // Cache misses of every triangle in the given order
+    std::vector<u8> misses(tri_count, 0);
+    {
+        std::vector<u32> timestamps(vertex_count, 0);
+        u32 time = cache_size + 1;
+
+        for (u32 t = 0; t < tri_count; ++t)
+        {
+            for (u32 c = 0; c < 3; ++c)
+            {
+                u32 v = indices[t * 3 + c];
+                if (time - timestamps[v] > cache_size)
+                {
+                    timestamps[v] = time++;
+                    misses[t]++;
+                }
+            }
+        }
+    }
+
+    // Hard boundaries: triangles whose vertices all missed start a new cache run
+    std::vector<u32> hard;
+    for (u32 t = 0; t < tri_count; ++t)
+        if (t == 0 || misses[t] == 3)
+            hard.push_back(t);
+    hard.push_back(tri_count);
+
+    // Soft boundaries: every cluster starts with a cold cache once reordered, so cut a run
+    // only where the ACMR of the piece so far, cold start included, is within threshold
+    // of the ACMR of the whole run
+    std::vector<u32> clusters;
+    std::vector<u32> timestamps(vertex_count, 0);
+    u32 time = cache_size + 1;
+
+    for (size_t h = 0; h + 1 < hard.size(); ++h)
+    {
+        u32 begin = hard[h];
+        u32 end = hard[h + 1];
+
+        u32 run_misses = 0;
+        for (u32 t = begin; t < end; ++t)
+            run_misses += misses[t];
+
+        f32 run_threshold = threshold * f32(run_misses) / f32(end - begin);
+
+        // Skipping past every timestamp flushes the simulated cache
+        u32 start = begin;
+        u32 acc = 0;
+        time += cache_size + 1;
+        clusters.push_back(start);
+
+        for (u32 t = begin; t < end; ++t)
+        {
+            for (u32 c = 0; c < 3; ++c)
+            {
+                u32 v = indices[t * 3 + c];
+                if (time - timestamps[v] > cache_size)
+                {
+                    timestamps[v] = time++;
+                    acc++;
+                }
+            }
+
+            if (t + 1 < end && f32(acc) / f32(t - start + 1) <= run_threshold)
+            {
+                start = t + 1;
+                acc = 0;
+                time += cache_size + 1;
+                clusters.push_back(start);
+            }
+        }
+    }
+    u32 cluster_count = u32(clusters.size());
+    clusters.push_back(tri_count);
+
+    // Area weighted centroid and normal of every cluster
+    std::vector<Vec3> centroids(cluster_count);
+    std::vector<Vec3> normals(cluster_count);
+    Vec3 mesh_centroid = vec3_zero();
+    f32 mesh_area = 0.0f;
+
+    for (u32 c = 0; c < cluster_count; ++c)
+    {
+        Vec3 centroid = vec3_zero();
+        Vec3 normal = vec3_zero();
+        f32 area = 0.0f;
+
+        for (u32 t = clusters[c]; t < clusters[size_t(c) + 1]; ++t)
+        {
+            Vec3 p0 = vertices[indices[t * 3 + 0]].pos;
+            Vec3 p1 = vertices[indices[t * 3 + 1]].pos;
+            Vec3 p2 = vertices[indices[t * 3 + 2]].pos;
+
+            Vec3 n = vec3_cross_product(vec3_minus(p1, p0), vec3_minus(p2, p0));
+            f32 a = f32(vec3_length(n));
+
+            Vec3 center = vec3_multiply_by_scalar(vec3_add(vec3_add(p0, p1), p2), 1.0f / 3.0f);
+            centroid = vec3_add(centroid, vec3_multiply_by_scalar(center, a));
+            normal = vec3_add(normal, n);
+            area += a;
+        }
+
+        mesh_centroid = vec3_add(mesh_centroid, centroid);
+        mesh_area += area;
+
+        centroids[c] = area > 0.0f ? vec3_multiply_by_scalar(centroid, 1.0f / area) : centroid;
+        f32 length = f32(vec3_length(normal));
+        normals[c] = length > 0.0f ? vec3_multiply_by_scalar(normal, 1.0f / length) : normal;
+    }
+
+    if (mesh_area > 0.0f)
+        mesh_centroid = vec3_multiply_by_scalar(mesh_centroid, 1.0f / mesh_area);
+
+    // Clusters facing away from the mesh center occlude the rest, draw them first
+    std::vector<f32> keys(cluster_count);
+    std::vector<u32> order(cluster_count);
+    for (u32 c = 0; c < cluster_count; ++c)
+    {
+        keys[c] = f32(vec3_dot_product(vec3_minus(centroids[c], mesh_centroid), normals[c]));
+        order[c] = c;
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&](u32 a, u32 b) { return keys[a] > keys[b]; });
+
+    u32 out = 0;
+    for (u32 c : order)
+        for (u32 t = clusters[c]; t < clusters[size_t(c) + 1]; ++t)
+            for (u32 k = 0; k < 3; ++k)
+                destination[out++] = indices[t * 3 + k];
+}
+
+// ==============================================================================
+// Vertex fetch
+// ==============================================================================
+
+u32 JojRenderer::optimize_vertex_fetch(Vertex* destination, u32* indices, u32 index_count,
+    const Vertex* vertices, u32 vertex_count)
+{
+    std::vector<u32> remap(vertex_count, INVALID_INDEX);
+    u32 next = 0;
+
+    for (u32 i = 0; i < index_count; ++i)
+    {
+        u32 v = indices[i];
+
+        if (remap[v] == INVALID_INDEX)
+        {
+            remap[v] = next;
+            destination[next] = vertices[v];
+            next++;
+        }
+
+        indices[i] = remap[v];
+    }
+
+    return next;
+}
+
+// ==============================================================================
+// Geometry
+// ==============================================================================
+
+JojRenderer::MeshOptimizationReport JojRenderer::optimize_mesh(Geometry& geometry, f32 overdraw_threshold,
+    u32 cache_size)
+{
+    u32 index_count = geometry.get_index_count();
+    u32 vertex_count = geometry.get_vertex_count();
+
+    MeshOptimizationReport report;
+    report.before = analyze_vertex_cache(geometry.indices.data(), index_count, vertex_count, cache_size);
+
+    std::vector<u32> cache_order(index_count);
+    optimize_vertex_cache(cache_order.data(), geometry.indices.data(), index_count, vertex_count, cache_size);
+    optimize_overdraw(geometry.indices.data(), cache_order.data(), index_count,
+        geometry.vertices.data(), vertex_count, overdraw_threshold, cache_size);
+
+    VertexArray fetch_order(vertex_count);
+    u32 used = optimize_vertex_fetch(fetch_order.data(), geometry.indices.data(), index_count,
+        geometry.vertices.data(), vertex_count);
+    fetch_order.resize(used);
+    geometry.vertices.swap(fetch_order);
+    geometry.pack_indices();
+
+    report.after = analyze_vertex_cache(geometry.indices.data(), index_count, used, cache_size);
+    return report;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "defines.h"
+
+#include "geometry.h"
+
+namespace JojRenderer
+{
+	// -------------------------------------------------------------------------------
+	// Mesh optimizer
+	// -------------------------------------------------------------------------------
+
+	/* Index and vertex reordering for triangle lists, run once when a mesh is
+	 * built or loaded, before it is uploaded:
+	 * 1. optimize_vertex_cache: Tipsify (Sander et al. 2007) order for the
+	 *    post-transform vertex cache.
+	 * 2. optimize_overdraw: splits the cache-ordered list into clusters and
+	 *    draws outward-facing clusters first, keeping ACMR within threshold.
+	 * 3. optimize_vertex_fetch: renumbers vertices in first-use order so vertex
+	 *    fetch walks the vertex buffer linearly.
+	 * The passes only reorder, the rendered image is unchanged.
+	 */
+
+	// Post-transform cache statistics of an index buffer
+	struct VertexCacheStats
+	{
+		f32 acmr;				// Average cache miss ratio: transformed vertices per triangle (0.5 best, 3 worst)
+		f32 atvr;				// Average transformed vertex ratio: transformed / referenced vertices (1 best)
+		u32 transformed;		// Vertex shader invocations
+	};
+
+	// Statistics before and after optimize_mesh
+	struct MeshOptimizationReport
+	{
+		VertexCacheStats before;
+		VertexCacheStats after;
+	};
+
+	// Default FIFO size used to simulate the post-transform cache
+	const u32 DEFAULT_VERTEX_CACHE_SIZE = 16;
+
+	// Simulate a FIFO post-transform cache of cache_size entries over indices
+	VertexCacheStats analyze_vertex_cache(const u32* indices, u32 index_count, u32 vertex_count,
+		u32 cache_size = DEFAULT_VERTEX_CACHE_SIZE);
+
+	// Write indices reordered for the post-transform cache to destination (must not alias indices)
+	void optimize_vertex_cache(u32* destination, const u32* indices, u32 index_count, u32 vertex_count,
+		u32 cache_size = DEFAULT_VERTEX_CACHE_SIZE);
+
+	/* @brief Write cache-ordered indices reordered to reduce overdraw to destination.
+	 * indices should come from optimize_vertex_cache. threshold bounds the ACMR
+	 * loss (1.05 allows 5% more vertex shader invocations).
+	 */
+	void optimize_overdraw(u32* destination, const u32* indices, u32 index_count,
+		const Vertex* vertices, u32 vertex_count, f32 threshold = 1.05f,
+		u32 cache_size = DEFAULT_VERTEX_CACHE_SIZE);
+
+	/* @brief Reorder vertices in first-use order and remap indices in place.
+	 * Unreferenced vertices are dropped, return the new vertex count.
+	 */
+	u32 optimize_vertex_fetch(Vertex* destination, u32* indices, u32 index_count,
+		const Vertex* vertices, u32 vertex_count);
+
+	// Run the three passes on geometry, repack its index data and return cache statistics before and after
+	MeshOptimizationReport optimize_mesh(Geometry& geometry, f32 overdraw_threshold = 1.05f,
+		u32 cache_size = DEFAULT_VERTEX_CACHE_SIZE);
+}
@@ -0,0 +1,131 @@
+#include "renderer_null.h"
+
+#include "memory_tracker.h"
+#include <thread>
+
+JojRenderer::NullRenderer::NullRenderer()
+{
+    gpu_frametime = 0.0;
+    frame_count = 0;
+    gpu_done = Clock::now();
+    buffer_memory = 0;
+    draw_count = 0;
+}
+
+JojRenderer::NullRenderer::~NullRenderer()
+{
+}
+
+b8 JojRenderer::NullRenderer::init(std::unique_ptr<JojPlatform::Window>&)
+{
+    return init();
+}
+
+b8 JojRenderer::NullRenderer::init()
+{
+    frame_count = 0;
+    gpu_done = Clock::now();
+
+    buffers.init(NULL_RENDERER_MAX_BUFFERS);
+    meshes.init(NULL_RENDERER_MAX_MESHES);
+    shaders.init(NULL_RENDERER_MAX_SHADERS);
+    buffer_memory = 0;
+    draw_count = 0;
+    return true;
+}
+
+void JojRenderer::NullRenderer::render()
+{
+}
+
+void JojRenderer::NullRenderer::clear()
+{
+}
+
+void JojRenderer::NullRenderer::swap_buffers()
+{
+    frame_count++;
+
+    if (gpu_frametime <= 0.0)
+        return;
+
+    // The GPU starts this frame once the previous one is done and the CPU waits for it
+    Clock::time_point now = Clock::now();
+    Clock::time_point start = gpu_done > now ? gpu_done : now;
+    gpu_done = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<f64>(gpu_frametime));
+
+    std::this_thread::sleep_until(gpu_done);
+}
+
+void JojRenderer::NullRenderer::shutdown()
+{
+#if !FMEMORY_TRACKING_DISABLED
+    for (const NullBuffer& buffer : buffers)
+        FMEMORY_FREE(JojEngine::MemoryTag::RENDERER, buffer.size);
+#endif // !FMEMORY_TRACKING_DISABLED
+
+    shaders.clear();
+    meshes.clear();
+    buffers.clear();
+    buffer_memory = 0;
+}
+
+JojRenderer::BufferHandle JojRenderer::NullRenderer::create_buffer(const BufferDesc& desc)
+{
+    BufferHandle buffer = buffers.create(NullBuffer{ desc.type, desc.size });
+    if (!buffer.is_null())
+    {
+        buffer_memory += desc.size;
+        FMEMORY_ALLOC(JojEngine::MemoryTag::RENDERER, desc.size);
+    }
+    return buffer;
+}
+
+b8 JojRenderer::NullRenderer::destroy_buffer(BufferHandle buffer)
+{
+    NullBuffer* data = buffers.get(buffer);
+    if (!data)
+        return false;
+
+    buffer_memory -= data->size;
+    FMEMORY_FREE(JojEngine::MemoryTag::RENDERER, data->size);
+    return buffers.destroy(buffer);
+}
+
+JojRenderer::MeshHandle JojRenderer::NullRenderer::create_mesh(BufferHandle vertices, BufferHandle indices, u32 index_count)
+{
+    if (!buffers.is_alive(vertices) || !buffers.is_alive(indices))
+        return MeshHandle();
+
+    return meshes.create(NullMesh{ vertices, indices, index_count });
+}
+
+b8 JojRenderer::NullRenderer::destroy_mesh(MeshHandle mesh)
+{
+    return meshes.destroy(mesh);
+}
+
+JojRenderer::ShaderHandle JojRenderer::NullRenderer::create_shader(const ShaderDesc& desc)
+{
+    return shaders.create(NullShader{ desc.vertex_format });
+}
+
+b8 JojRenderer::NullRenderer::destroy_shader(ShaderHandle shader)
+{
+    return shaders.destroy(shader);
+}
+
+b8 JojRenderer::NullRenderer::set_shader(ShaderHandle shader)
+{
+    return shaders.is_alive(shader);
+}
+
+b8 JojRenderer::NullRenderer::draw_mesh(MeshHandle mesh)
+{
+    const NullMesh* data = meshes.get(mesh);
+    if (!data || !buffers.is_alive(data->vertices) || !buffers.is_alive(data->indices))
+        return false;
+
+    draw_count++;
+    return true;
+}
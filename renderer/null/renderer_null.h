@@ -0,0 +1,109 @@
+#pragma once
+
+#include "defines.h"
+
+#include "renderer.h"
+#include <chrono>
+
+namespace JojRenderer
+{
+	// Most buffers and meshes alive at once
+	const u32 NULL_RENDERER_MAX_BUFFERS = 4096;
+	const u32 NULL_RENDERER_MAX_MESHES = 2048;
+	const u32 NULL_RENDERER_MAX_SHADERS = 256;
+
+	/* Headless stub renderer (RendererBackend::NULL_RENDERER)
+	 * Draws nothing and needs no GPU or window. swap_buffers blocks for a
+	 * configurable simulated GPU frametime, the way a present or fence wait
+	 * blocks a real backend, so loop modes can be measured on any machine.
+	 */
+	class NullRenderer : public Renderer
+	{
+	public:
+		NullRenderer();
+		~NullRenderer();
+
+		b8 init(std::unique_ptr<JojPlatform::Window>& window) override;	// Initialize renderer
+		b8 init();						// Initialize renderer without a window
+		void render() override;			// Draw to screen
+		void clear() override;			// Clear screen
+		void swap_buffers() override;	// Wait for the simulated GPU frame
+		void shutdown() override;		// Clear resources
+
+		// Set simulated GPU time of one frame in seconds (0 = present returns immediately)
+		void set_gpu_frametime(f64 seconds);
+
+		// Return number of presented frames
+		u64 get_frame_count() const;
+
+		// Resources are bookkeeping only: sizes are tracked, contents are dropped
+		BufferHandle create_buffer(const BufferDesc& desc);
+		b8 destroy_buffer(BufferHandle buffer);
+		MeshHandle create_mesh(BufferHandle vertices, BufferHandle indices, u32 index_count);
+		b8 destroy_mesh(MeshHandle mesh);
+		ShaderHandle create_shader(const ShaderDesc& desc);
+		b8 destroy_shader(ShaderHandle shader);
+
+		// Bind shader for the next draws, return false if it was destroyed
+		b8 set_shader(ShaderHandle shader);
+
+		// Count a draw of mesh, return false if it or its buffers were destroyed
+		b8 draw_mesh(MeshHandle mesh);
+
+		u32 get_buffer_count() const;		// Live buffers
+		u32 get_shader_count() const;		// Live shaders
+		u64 get_buffer_memory() const;		// Bytes of live buffers
+		u64 get_draw_count() const;			// Meshes drawn since init
+
+	private:
+		typedef std::chrono::steady_clock Clock;
+
+		struct NullBuffer
+		{
+			BufferType type;
+			u32 size;
+		};
+
+		struct NullMesh
+		{
+			BufferHandle vertices;
+			BufferHandle indices;
+			u32 index_count;
+		};
+
+		struct NullShader
+		{
+			const VertexFormat* vertex_format;
+		};
+
+		JojEngine::Pool<NullBuffer, Buffer> buffers;
+		JojEngine::Pool<NullMesh, Mesh> meshes;
+		JojEngine::Pool<NullShader, ShaderProgram> shaders;
+		u64 buffer_memory;				// Bytes of live buffers
+		u64 draw_count;					// Meshes drawn
+
+		f64 gpu_frametime;				// Simulated GPU time of one frame
+		u64 frame_count;				// Presented frames
+		Clock::time_point gpu_done;		// When the simulated GPU finishes the last frame
+	};
+
+	// Set simulated GPU time of one frame in seconds
+	inline void NullRenderer::set_gpu_frametime(f64 seconds)
+	{ gpu_frametime = seconds; }
+
+	// Return number of presented frames
+	inline u64 NullRenderer::get_frame_count() const
+	{ return frame_count; }
+
+	inline u32 NullRenderer::get_buffer_count() const
+	{ return buffers.get_count(); }
+
+	inline u32 NullRenderer::get_shader_count() const
+	{ return shaders.get_count(); }
+
+	inline u64 NullRenderer::get_buffer_memory() const
+	{ return buffer_memory; }
+
+	inline u64 NullRenderer::get_draw_count() const
+	{ return draw_count; }
+}
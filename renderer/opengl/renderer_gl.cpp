@@ -1,6 +1,8 @@
 #include "renderer_gl.h"
 
 #include "logger.h"
+#include "memory_tracker.h"
+#include "opengl/joj_gl.h"
 
 JojRenderer::GLRenderer::GLRenderer()
 {
@@ -21,6 +23,11 @@ b8 JojRenderer::GLRenderer::init(std::unique_ptr<JojPlatform::Window>& window)
         return false;
     }
 
+    // Resource pools
+    buffers.init(OPENGL_MAX_BUFFERS);
+    meshes.init(OPENGL_MAX_MESHES);
+    shaders.init(OPENGL_MAX_SHADERS);
+
     return true;
 }
 
@@ -39,4 +46,215 @@ void JojRenderer::GLRenderer::swap_buffers()
 
 void JojRenderer::GLRenderer::shutdown()
 {
-}
\ No newline at end of file
+    for (Shader& shader : shaders)
+        glDeleteProgram(shader.get_id());
+
+    for (GLMesh& mesh : meshes)
+        glDeleteVertexArrays(1, &mesh.vertex_array);
+
+    for (GLBuffer& buffer : buffers)
+    {
+        glDeleteBuffers(1, &buffer.id);
+        FMEMORY_FREE(JojEngine::MemoryTag::RENDERER, buffer.size);
+    }
+
+    shaders.clear();
+    meshes.clear();
+    buffers.clear();
+}
+
+u32 JojRenderer::GLRenderer::get_index_type(IndexFormat format)
+{
+    return format == IndexFormat::U16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
+
+void JojRenderer::GLRenderer::set_vertex_layout(const VertexFormat& format)
+{
+    for (u32 i = 0; i < format.get_attribute_count(); ++i)
+    {
+        const VertexAttribute& attribute = format.get_attribute(i);
+
+        GLenum type = GL_FLOAT;
+        GLboolean normalized = GL_FALSE;
+
+        switch (attribute.format)
+        {
+        case VertexAttributeFormat::HALF4:          type = GL_HALF_FLOAT; break;
+        case VertexAttributeFormat::SNORM16_4:
+        case VertexAttributeFormat::OCT_SNORM16_2:  type = GL_SHORT; normalized = GL_TRUE; break;
+        case VertexAttributeFormat::UNORM8_4:       type = GL_UNSIGNED_BYTE; normalized = GL_TRUE; break;
+        default:                                    break;
+        }
+
+        glEnableVertexAttribArray(i);
+        glVertexAttribPointer(i, get_attribute_components(attribute.format), type, normalized,
+            format.get_stride(), (GLvoid*)(size_t)attribute.offset);
+    }
+}
+
+u32 JojRenderer::GLRenderer::get_buffer_target(BufferType type)
+{
+    switch (type)
+    {
+    case BufferType::VERTEX:    return GL_ARRAY_BUFFER;
+    case BufferType::INDEX:     return GL_ELEMENT_ARRAY_BUFFER;
+    case BufferType::CONSTANT:  return GL_UNIFORM_BUFFER;
+    }
+
+    return GL_ARRAY_BUFFER;
+}
+
+JojRenderer::BufferHandle JojRenderer::GLRenderer::create_buffer(const BufferDesc& desc)
+{
+    GLBuffer buffer = { 0, desc.type, desc.size, desc.stride };
+    glGenBuffers(1, &buffer.id);
+    if (!buffer.id)
+    {
+        FERROR(ERR_RENDERER, "Failed to create buffer.");
+        return BufferHandle();
+    }
+
+    // Binding an index buffer is recorded by the bound vertex array, keep none bound
+    u32 target = get_buffer_target(desc.type);
+    glBindVertexArray(0);
+    glBindBuffer(target, buffer.id);
+    glBufferData(target, desc.size, desc.data, desc.type == BufferType::CONSTANT ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+    glBindBuffer(target, 0);
+
+    BufferHandle handle = buffers.create(buffer);
+    if (handle.is_null())
+    {
+        FERROR(ERR_RENDERER, "Too many buffers.");
+        glDeleteBuffers(1, &buffer.id);
+        return handle;
+    }
+
+    FMEMORY_ALLOC(JojEngine::MemoryTag::RENDERER, desc.size);
+    return handle;
+}
+
+b8 JojRenderer::GLRenderer::destroy_buffer(BufferHandle buffer)
+{
+    GLBuffer* data = buffers.get(buffer);
+    if (!data)
+        return false;
+
+    glDeleteBuffers(1, &data->id);
+    FMEMORY_FREE(JojEngine::MemoryTag::RENDERER, data->size);
+    return buffers.destroy(buffer);
+}
+
+b8 JojRenderer::GLRenderer::update_buffer(BufferHandle buffer, const void* data, u32 size)
+{
+    const GLBuffer* target = buffers.get(buffer);
+    if (!target || size > target->size)
+        return false;
+
+    u32 bind_target = get_buffer_target(target->type);
+    glBindVertexArray(0);
+    glBindBuffer(bind_target, target->id);
+    glBufferSubData(bind_target, 0, size, data);
+    glBindBuffer(bind_target, 0);
+    return true;
+}
+
+JojRenderer::MeshHandle JojRenderer::GLRenderer::create_mesh(BufferHandle vertices, BufferHandle indices, u32 index_count, const VertexFormat& format)
+{
+    const GLBuffer* vertex_buffer = buffers.get(vertices);
+    const GLBuffer* index_buffer = buffers.get(indices);
+    if (!vertex_buffer || !index_buffer)
+        return MeshHandle();
+
+    GLMesh mesh = { vertices, indices, index_count, 0 };
+    glGenVertexArrays(1, &mesh.vertex_array);
+
+    // The vertex array records the index buffer and the layout of the vertex buffer
+    glBindVertexArray(mesh.vertex_array);
+    glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer->id);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer->id);
+    set_vertex_layout(format);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    MeshHandle handle = meshes.create(mesh);
+    if (handle.is_null())
+        glDeleteVertexArrays(1, &mesh.vertex_array);
+
+    return handle;
+}
+
+b8 JojRenderer::GLRenderer::destroy_mesh(MeshHandle mesh)
+{
+    GLMesh* data = meshes.get(mesh);
+    if (!data)
+        return false;
+
+    glDeleteVertexArrays(1, &data->vertex_array);
+    return meshes.destroy(mesh);
+}
+
+JojRenderer::ShaderHandle JojRenderer::GLRenderer::create_shader(const ShaderDesc& desc)
+{
+    if (!desc.vertex || !desc.pixel)
+    {
+        FERROR(ERR_RENDERER, "Shader needs vertex and fragment source.");
+        return ShaderHandle();
+    }
+
+    Shader shader;
+    shader.compile_shaders(desc.vertex, desc.pixel);
+
+    ShaderHandle handle = shaders.create(shader);
+    if (handle.is_null())
+    {
+        FERROR(ERR_RENDERER, "Too many shaders.");
+        glDeleteProgram(shader.get_id());
+    }
+
+    return handle;
+}
+
+b8 JojRenderer::GLRenderer::destroy_shader(ShaderHandle shader)
+{
+    Shader* data = shaders.get(shader);
+    if (!data)
+        return false;
+
+    glDeleteProgram(data->get_id());
+    return shaders.destroy(shader);
+}
+
+b8 JojRenderer::GLRenderer::set_shader(ShaderHandle shader)
+{
+    Shader* data = shaders.get(shader);
+    if (!data)
+        return false;
+
+    data->use();
+    return true;
+}
+
+b8 JojRenderer::GLRenderer::set_constant_buffer(u32 slot, BufferHandle buffer)
+{
+    const GLBuffer* data = buffers.get(buffer);
+    if (!data || data->type != BufferType::CONSTANT)
+        return false;
+
+    glBindBufferBase(GL_UNIFORM_BUFFER, slot, data->id);
+    return true;
+}
+
+b8 JojRenderer::GLRenderer::draw_mesh(MeshHandle mesh)
+{
+    const GLMesh* data = meshes.get(mesh);
+    if (!data)
+        return false;
+
+    const GLBuffer* indices = buffers.get(data->indices);
+    if (!indices || !buffers.is_alive(data->vertices))
+        return false;
+
+    glBindVertexArray(data->vertex_array);
+    glDrawElements(GL_TRIANGLES, data->index_count, get_index_type(indices->stride == 2 ? IndexFormat::U16 : IndexFormat::U32), 0);
+    return true;
+}
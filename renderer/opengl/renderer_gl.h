@@ -6,9 +6,17 @@
 
 #include "renderer.h"
 #include "opengl/context_gl.h"
+#include "opengl/shader.h"
+#include "geometry.h"
+#include "vertex_format.h"
 
 namespace JojRenderer
 {
+	// Most resources alive at once
+	const u32 OPENGL_MAX_BUFFERS = 4096;
+	const u32 OPENGL_MAX_MESHES = 2048;
+	const u32 OPENGL_MAX_SHADERS = 256;
+
 	class GLRenderer : public Renderer
 	{
 	public:
@@ -21,11 +29,80 @@ namespace JojRenderer
 		void swap_buffers();									// Change front and back buffers
 		void shutdown();										// Clear resources
 
+		// Return GL index type (GL_UNSIGNED_SHORT or GL_UNSIGNED_INT) of the given width
+		static u32 get_index_type(IndexFormat format);
+
+		// Enable and describe vertex attributes of the bound vertex array from format (location = attribute index)
+		static void set_vertex_layout(const VertexFormat& format);
+
+		// ---------------------------------------------------
+		// Handle resources
+		// ---------------------------------------------------
+
+		// Create buffer object, return null handle on failure (constant buffers are uniform buffers)
+		BufferHandle create_buffer(const BufferDesc& desc);
+		b8 destroy_buffer(BufferHandle buffer);
+
+		// Overwrite the start of a buffer
+		b8 update_buffer(BufferHandle buffer, const void* data, u32 size);
+
+		// Vertex array reading vertices laid out as format, several meshes can share buffers
+		MeshHandle create_mesh(BufferHandle vertices, BufferHandle indices, u32 index_count, const VertexFormat& format);
+		b8 destroy_mesh(MeshHandle mesh);
+
+		// Compile and link a program from vertex and fragment source text
+		ShaderHandle create_shader(const ShaderDesc& desc);
+		b8 destroy_shader(ShaderHandle shader);
+
+		// Return shader to set uniforms on (nullptr if it was destroyed)
+		Shader* get_shader(ShaderHandle shader);
+
+		// ---------------------------------------------------
+		// Bind resources
+		// ---------------------------------------------------
+
+		// Use shader program for the next draws
+		b8 set_shader(ShaderHandle shader);
+
+		// Bind constant buffer to a uniform block binding point
+		b8 set_constant_buffer(u32 slot, BufferHandle buffer);
+
+		// Draw mesh triangles, return false if it or its buffers were destroyed
+		b8 draw_mesh(MeshHandle mesh);
+
 	private:
+		struct GLBuffer
+		{
+			u32 id;
+			BufferType type;
+			u32 size;
+			u32 stride;
+		};
+
+		struct GLMesh
+		{
+			BufferHandle vertices;
+			BufferHandle indices;
+			u32 index_count;
+			u32 vertex_array;
+		};
+
+		// Return the bind target of a buffer type
+		static u32 get_buffer_target(BufferType type);
+
 		std::unique_ptr<JojGraphics::GLContext> context;
 
-		
+		// ---------------------------------------------------
+		// Resources
+		// ---------------------------------------------------
+		JojEngine::Pool<GLBuffer, Buffer> buffers;
+		JojEngine::Pool<GLMesh, Mesh> meshes;
+		JojEngine::Pool<Shader, ShaderProgram> shaders;
 	};
+
+	// Return shader to set uniforms on (nullptr if it was destroyed)
+	inline Shader* GLRenderer::get_shader(ShaderHandle shader)
+	{ return shaders.get(shader); }
 }
 
 #endif  // PLATFORM_WINDOWS
\ No newline at end of file
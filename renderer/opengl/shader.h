@@ -8,7 +8,6 @@
 #define JOJ_GL_DEFINE_EXTERN
 #include "opengl/joj_gl.h"
 #include "fmath.h"
-#include <DirectXMath.h>
 
 namespace JojRenderer
 {
@@ -26,13 +25,12 @@ namespace JojRenderer
         void compile_shaders(const char* vertex_shader, const char* fragment_shader);
 
         void use();
-        void set_bool(const std::string& name, bool value) const;
-        void set_int(const std::string& name, i32 value) const;
-        void set_float(const std::string& name, f32 value) const;
-        void set_vec3(const std::string& name, f32 x, f32 y, f32 z) const;
-        void set_vec4(const std::string& name, f32 x, f32 y, f32 z, f32 w) const;
-        void set_mat4(const std::string& name, const Mat4 mat) const;
-        void set_dxmat4(const std::string& name, const DirectX::XMMATRIX mat) const;
+        void set_bool(const char* name, bool value) const;
+        void set_int(const char* name, i32 value) const;
+        void set_float(const char* name, f32 value) const;
+        void set_vec3(const char* name, f32 x, f32 y, f32 z) const;
+        void set_vec4(const char* name, f32 x, f32 y, f32 z, f32 w) const;
+        void set_mat4(const char* name, const Mat4 mat) const;
 
     private:
         u32 id;
@@ -46,31 +44,23 @@ namespace JojRenderer
     inline void Shader::use()
     { glUseProgram(id); }
 
-    inline void Shader::set_bool(const std::string& name, bool value) const
-    { glUniform1i(glGetUniformLocation(id, name.c_str()), static_cast<i32>(value)); }
+    inline void Shader::set_bool(const char* name, bool value) const
+    { glUniform1i(glGetUniformLocation(id, name), static_cast<i32>(value)); }
     
-    inline void Shader::set_int(const std::string& name, i32 value) const
-    { glUniform1i(glGetUniformLocation(id, name.c_str()), value); }
+    inline void Shader::set_int(const char* name, i32 value) const
+    { glUniform1i(glGetUniformLocation(id, name), value); }
     
-    inline void Shader::set_float(const std::string& name, f32 value) const
-    { glUniform1i(glGetUniformLocation(id, name.c_str()), value); }
+    inline void Shader::set_float(const char* name, f32 value) const
+    { glUniform1i(glGetUniformLocation(id, name), value); }
 
-    inline void Shader::set_vec3(const std::string& name, f32 x, f32 y, f32 z) const
-    { glUniform3f(glGetUniformLocation(id, name.c_str()), x, y, z); }
+    inline void Shader::set_vec3(const char* name, f32 x, f32 y, f32 z) const
+    { glUniform3f(glGetUniformLocation(id, name), x, y, z); }
 
-    inline void Shader::set_vec4(const std::string& name, f32 x, f32 y, f32 z, f32 w) const
-    { glUniform4f(glGetUniformLocation(id, name.c_str()), x, y, z, w); }
+    inline void Shader::set_vec4(const char* name, f32 x, f32 y, f32 z, f32 w) const
+    { glUniform4f(glGetUniformLocation(id, name), x, y, z, w); }
 
-    inline void Shader::set_mat4(const std::string& name, const Mat4 mat) const
-    { glUniformMatrix4fv(glGetUniformLocation(id, name.c_str()), 1, GL_FALSE, mat.data); }
-
-    inline void Shader::set_dxmat4(const std::string& name, const DirectX::XMMATRIX mat) const
-    {
-        // Convert DirectX::XMMATRIX to a compatible format
-        float mat_array[16];
-        memcpy(mat_array, &mat, sizeof(float) * 16);
-        glUniformMatrix4fv(glGetUniformLocation(id, name.c_str()), 1, GL_FALSE, mat_array);
-    }
+    inline void Shader::set_mat4(const char* name, const Mat4 mat) const
+    { glUniformMatrix4fv(glGetUniformLocation(id, name), 1, GL_FALSE, mat.data); }
 }
 
 #endif // PLATFORM_WINDOWS
\ No newline at end of file
@@ -1,9 +1,13 @@
 #include "renderer.h"
 
+#if PLATFORM_WINDOWS || PLATFORM_LINUX
+
 JojRenderer::Renderer::Renderer()
 {
 }
 
 JojRenderer::Renderer::~Renderer()
 {
-}
\ No newline at end of file
+}
+
+#endif // PLATFORM_WINDOWS || PLATFORM_LINUX
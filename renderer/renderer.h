@@ -3,10 +3,46 @@
 #include "defines.h"
 
 #include <memory>
+#include "handle_pool.h"
 #include "platform_manager.h"
 
+#if PLATFORM_WINDOWS || PLATFORM_LINUX
+
 namespace JojRenderer
 {
+	/* GPU resources are owned by the renderer and referred to by
+	 * generational handles, so the engine and games never hold backend
+	 * pointers and a destroyed resource can't be reached by mistake.
+	 */
+	struct Buffer;
+	struct Mesh;
+	struct ShaderProgram;
+
+	typedef JojEngine::Handle<Buffer> BufferHandle;
+	typedef JojEngine::Handle<Mesh> MeshHandle;
+	typedef JojEngine::Handle<ShaderProgram> ShaderHandle;
+
+	class VertexFormat;
+
+	enum class BufferType { VERTEX, INDEX, CONSTANT };
+
+	struct BufferDesc
+	{
+		BufferType type = BufferType::VERTEX;
+		u32 size = 0;					// Bytes
+		u32 stride = 0;					// Bytes per vertex or index
+		const void* data = nullptr;		// Initial contents (can be nullptr)
+	};
+
+	// Shader stages: file paths on D3D, source text on OpenGL
+	struct ShaderDesc
+	{
+		const char* vertex = nullptr;
+		const char* pixel = nullptr;
+		const VertexFormat* vertex_format = nullptr;	// Input layout (D3D11)
+		u32 flags = 0;									// Compile flags (D3D11)
+	};
+
 	class Renderer
 	{
 	public:
@@ -21,4 +57,6 @@ namespace JojRenderer
 	private:
 
 	};
-}
\ No newline at end of file
+}
+
+#endif // PLATFORM_WINDOWS || PLATFORM_LINUX
@@ -0,0 +1,343 @@
+#include "vertex_format.h"
+
+#include <string.h>
+
+// ==============================================================================
+// VertexFormat
+// ==============================================================================
+
+JojRenderer::VertexFormat::VertexFormat() :
+    attributes(),
+    attribute_count(0),
+    stride(0)
+{
+}
+
+// ------------------------------------------------------------------------------
+
+JojRenderer::VertexFormat& JojRenderer::VertexFormat::add(VertexSemantic semantic, VertexAttributeFormat format)
+{
+    if (attribute_count < MAX_VERTEX_ATTRIBUTES)
+    {
+        attributes[attribute_count] = { semantic, format, stride };
+        attribute_count++;
+        stride += get_attribute_size(format);
+    }
+
+    return *this;
+}
+
+// ------------------------------------------------------------------------------
+
+const JojRenderer::VertexAttribute* JojRenderer::VertexFormat::find(VertexSemantic semantic) const
+{
+    for (u32 i = 0; i < attribute_count; ++i)
+        if (attributes[i].semantic == semantic)
+            return &attributes[i];
+
+    return nullptr;
+}
+
+// ------------------------------------------------------------------------------
+
+b8 JojRenderer::VertexFormat::is_quantized() const
+{
+    const VertexAttribute* position = find(VertexSemantic::POSITION);
+    return position && (position->format == VertexAttributeFormat::HALF4 ||
+        position->format == VertexAttributeFormat::SNORM16_4);
+}
+
+// ------------------------------------------------------------------------------
+
+JojRenderer::VertexFormat JojRenderer::VertexFormat::full()
+{
+    return VertexFormat()
+        .add(VertexSemantic::POSITION, VertexAttributeFormat::FLOAT3)
+        .add(VertexSemantic::COLOR, VertexAttributeFormat::FLOAT4);
+}
+
+JojRenderer::VertexFormat JojRenderer::VertexFormat::compact()
+{
+    return VertexFormat()
+        .add(VertexSemantic::POSITION, VertexAttributeFormat::SNORM16_4)
+        .add(VertexSemantic::COLOR, VertexAttributeFormat::UNORM8_4);
+}
+
+JojRenderer::VertexFormat JojRenderer::VertexFormat::half()
+{
+    return VertexFormat()
+        .add(VertexSemantic::POSITION, VertexAttributeFormat::HALF4)
+        .add(VertexSemantic::COLOR, VertexAttributeFormat::UNORM8_4);
+}
+
+JojRenderer::VertexFormat JojRenderer::VertexFormat::lit()
+{
+    return VertexFormat()
+        .add(VertexSemantic::POSITION, VertexAttributeFormat::SNORM16_4)
+        .add(VertexSemantic::NORMAL, VertexAttributeFormat::OCT_SNORM16_2)
+        .add(VertexSemantic::COLOR, VertexAttributeFormat::UNORM8_4);
+}
+
+// ------------------------------------------------------------------------------
+
+u32 JojRenderer::get_attribute_size(VertexAttributeFormat format)
+{
+    switch (format)
+    {
+    case VertexAttributeFormat::FLOAT3:         return 12;
+    case VertexAttributeFormat::FLOAT4:         return 16;
+    case VertexAttributeFormat::HALF4:          return 8;
+    case VertexAttributeFormat::SNORM16_4:      return 8;
+    case VertexAttributeFormat::UNORM8_4:       return 4;
+    case VertexAttributeFormat::OCT_SNORM16_2:  return 4;
+    }
+
+    return 0;
+}
+
+u32 JojRenderer::get_attribute_components(VertexAttributeFormat format)
+{
+    switch (format)
+    {
+    case VertexAttributeFormat::FLOAT3:         return 3;
+    case VertexAttributeFormat::OCT_SNORM16_2:  return 2;
+    default:                                    return 4;
+    }
+}
+
+const char* JojRenderer::get_semantic_name(VertexSemantic semantic)
+{
+    switch (semantic)
+    {
+    case VertexSemantic::POSITION:  return "POSITION";
+    case VertexSemantic::NORMAL:    return "NORMAL";
+    case VertexSemantic::COLOR:     return "COLOR";
+    }
+
+    return "";
+}
+
+// ==============================================================================
+// Encoding
+// ==============================================================================
+
+// Round to nearest even, overflow goes to infinity and tiny values to subnormals or zero
+static u16 f32_to_f16(f32 value)
+{
+    u32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    u32 sign = (bits >> 16) & 0x8000;
+    u32 mantissa = bits & 0x7FFFFF;
+    i32 exponent = i32((bits >> 23) & 0xFF) - 127 + 15;
+
+    // Infinity and NaN
+    if (((bits >> 23) & 0xFF) == 0xFF)
+        return u16(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+
+    if (exponent >= 31)
+        return u16(sign | 0x7C00);
+
+    if (exponent <= 0)
+    {
+        if (exponent < -10)
+            return u16(sign);
+
+        mantissa |= 0x800000;
+        u32 shift = u32(14 - exponent);
+        u32 half = mantissa >> shift;
+        u32 rest = mantissa & ((1u << shift) - 1);
+        u32 halfway = 1u << (shift - 1);
+
+        if (rest > halfway || (rest == halfway && (half & 1)))
+            half++;
+
+        return u16(sign | half);
+    }
+
+    // A carry out of the mantissa correctly bumps the exponent
+    u32 half = sign | (u32(exponent) << 10) | (mantissa >> 13);
+    u32 rest = mantissa & 0x1FFF;
+
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+        half++;
+
+    return u16(half);
+}
+
+static i16 encode_snorm16(f32 value)
+{
+    value = value < -1.0f ? -1.0f : (value > 1.0f ? 1.0f : value);
+    return i16(roundf(value * 32767.0f));
+}
+
+static u8 encode_unorm8(f32 value)
+{
+    value = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+    return u8(roundf(value * 255.0f));
+}
+
+// Project a unit vector on the octahedron |x| + |y| + |z| = 1 and unfold it on [-1, 1]^2
+static void encode_octahedral(Vec3 n, f32& u, f32& v)
+{
+    f32 l1 = fabsf(n.x) + fabsf(n.y) + fabsf(n.z);
+    if (l1 == 0.0f)
+    {
+        u = 0.0f;
+        v = 0.0f;
+        return;
+    }
+
+    u = n.x / l1;
+    v = n.y / l1;
+
+    if (n.z < 0.0f)
+    {
+        f32 fu = (1.0f - fabsf(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+        f32 fv = (1.0f - fabsf(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+        u = fu;
+        v = fv;
+    }
+}
+
+static void encode_attribute(u8* out, JojRenderer::VertexAttributeFormat format, Vec4 value)
+{
+    using JojRenderer::VertexAttributeFormat;
+
+    switch (format)
+    {
+    case VertexAttributeFormat::FLOAT3:
+    {
+        f32 v[3] = { value.x, value.y, value.z };
+        memcpy(out, v, sizeof(v));
+        break;
+    }
+    case VertexAttributeFormat::FLOAT4:
+    {
+        f32 v[4] = { value.x, value.y, value.z, value.w };
+        memcpy(out, v, sizeof(v));
+        break;
+    }
+    case VertexAttributeFormat::HALF4:
+    {
+        u16 v[4] = { f32_to_f16(value.x), f32_to_f16(value.y), f32_to_f16(value.z), f32_to_f16(value.w) };
+        memcpy(out, v, sizeof(v));
+        break;
+    }
+    case VertexAttributeFormat::SNORM16_4:
+    {
+        i16 v[4] = { encode_snorm16(value.x), encode_snorm16(value.y), encode_snorm16(value.z), encode_snorm16(value.w) };
+        memcpy(out, v, sizeof(v));
+        break;
+    }
+    case VertexAttributeFormat::UNORM8_4:
+    {
+        u8 v[4] = { encode_unorm8(value.x), encode_unorm8(value.y), encode_unorm8(value.z), encode_unorm8(value.w) };
+        memcpy(out, v, sizeof(v));
+        break;
+    }
+    case VertexAttributeFormat::OCT_SNORM16_2:
+    {
+        f32 u, w;
+        encode_octahedral(vec3_create(value.x, value.y, value.z), u, w);
+        i16 v[2] = { encode_snorm16(u), encode_snorm16(w) };
+        memcpy(out, v, sizeof(v));
+        break;
+    }
+    }
+}
+
+// ==============================================================================
+// pack_vertices
+// ==============================================================================
+
+JojRenderer::PackedVertices JojRenderer::pack_vertices(const Geometry& geometry, const VertexFormat& format)
+{
+    const Vertex* vertices = geometry.get_vertex_data();
+    u32 vertex_count = geometry.get_vertex_count();
+
+    PackedVertices packed;
+    packed.format = format;
+    packed.vertex_count = vertex_count;
+    packed.data.resize(size_t(vertex_count) * format.get_stride());
+    packed.position_scale = vec3_create(1.0f, 1.0f, 1.0f);
+    packed.position_offset = vec3_zero();
+
+    // Quantized positions are stored relative to the center and half extent of the bounds
+    if (format.is_quantized() && vertex_count > 0)
+    {
+        Vec3 lo = vertices[0].pos;
+        Vec3 hi = vertices[0].pos;
+
+        for (u32 i = 1; i < vertex_count; ++i)
+        {
+            Vec3 p = vertices[i].pos;
+            lo = vec3_create(p.x < lo.x ? p.x : lo.x, p.y < lo.y ? p.y : lo.y, p.z < lo.z ? p.z : lo.z);
+            hi = vec3_create(p.x > hi.x ? p.x : hi.x, p.y > hi.y ? p.y : hi.y, p.z > hi.z ? p.z : hi.z);
+        }
+
+        Vec3 extent = vec3_multiply_by_scalar(vec3_minus(hi, lo), 0.5f);
+        packed.position_offset = vec3_multiply_by_scalar(vec3_add(lo, hi), 0.5f);
+        packed.position_scale = vec3_create(extent.x > 0.0f ? extent.x : 1.0f,
+            extent.y > 0.0f ? extent.y : 1.0f, extent.z > 0.0f ? extent.z : 1.0f);
+    }
+
+    // Vertex normals, only when the format stores them
+    std::vector<Vec3> normals;
+    if (format.find(VertexSemantic::NORMAL))
+    {
+        normals.assign(vertex_count, vec3_zero());
+
+        const u32* indices = geometry.indices.data();
+        for (u32 t = 0; t + 2 < geometry.get_index_count(); t += 3)
+        {
+            Vec3 p0 = vertices[indices[t + 0]].pos;
+            Vec3 p1 = vertices[indices[t + 1]].pos;
+            Vec3 p2 = vertices[indices[t + 2]].pos;
+
+            // Cross product length is twice the triangle area
+            Vec3 n = vec3_cross_product(vec3_minus(p1, p0), vec3_minus(p2, p0));
+            for (u32 c = 0; c < 3; ++c)
+                normals[indices[t + c]] = vec3_add(normals[indices[t + c]], n);
+        }
+
+        for (Vec3& n : normals)
+            if (vec3_length_squared(n) > 0.0)
+                n = vec3_normalize(n);
+    }
+
+    Vec3 inv_scale = vec3_create(1.0f / packed.position_scale.x, 1.0f / packed.position_scale.y,
+        1.0f / packed.position_scale.z);
+
+    for (u32 i = 0; i < vertex_count; ++i)
+    {
+        u8* out = packed.data.data() + size_t(i) * format.get_stride();
+
+        for (u32 a = 0; a < format.get_attribute_count(); ++a)
+        {
+            const VertexAttribute& attribute = format.get_attribute(a);
+            Vec4 value;
+
+            switch (attribute.semantic)
+            {
+            case VertexSemantic::POSITION:
+            {
+                Vec3 p = vec3_minus(vertices[i].pos, packed.position_offset);
+                value = vec4_create(p.x * inv_scale.x, p.y * inv_scale.y, p.z * inv_scale.z, 1.0f);
+                break;
+            }
+            case VertexSemantic::NORMAL:
+                value = vec4_create(normals[i].x, normals[i].y, normals[i].z, 0.0f);
+                break;
+            case VertexSemantic::COLOR:
+            default:
+                value = vertices[i].color;
+                break;
+            }
+
+            encode_attribute(out + attribute.offset, attribute.format, value);
+        }
+    }
+
+    return packed;
+}
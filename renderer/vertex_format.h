@@ -0,0 +1,118 @@
+#pragma once
+
+#include "defines.h"
+
+#include "fmath.h"
+#include "geometry.h"
+#include <vector>
+
+namespace JojRenderer
+{
+	// -------------------------------------------------------------------------------
+	// Vertex format
+	// -------------------------------------------------------------------------------
+
+	/* GPU layout of a vertex, independent of the graphics API. Geometry keeps
+	 * full precision Vertex data, pack_vertices converts it into a VertexFormat
+	 * and the DX11/DX12/GL renderers build their input layouts from the same
+	 * description.
+	 */
+
+	// Attribute meaning, also the POSITION/NORMAL/COLOR shader input semantic
+	enum class VertexSemantic { POSITION, NORMAL, COLOR };
+
+	// Storage of one attribute
+	enum class VertexAttributeFormat
+	{
+		FLOAT3,				// 3 x f32 (12 bytes)
+		FLOAT4,				// 4 x f32 (16 bytes)
+		HALF4,				// 4 x f16 (8 bytes), positions relative to the mesh bounds
+		SNORM16_4,			// 4 x snorm16 (8 bytes), positions relative to the mesh bounds
+		UNORM8_4,			// 4 x unorm8 (4 bytes), RGBA8 color
+		OCT_SNORM16_2		// Octahedral unit vector in 2 x snorm16 (4 bytes), normals
+	};
+
+	// Maximum number of attributes in a VertexFormat
+	const u32 MAX_VERTEX_ATTRIBUTES = 8;
+
+	struct VertexAttribute
+	{
+		VertexSemantic semantic;		// Attribute meaning
+		VertexAttributeFormat format;	// Attribute storage
+		u32 offset;						// Byte offset in the vertex
+	};
+
+	class VertexFormat
+	{
+	public:
+		VertexFormat();
+
+		// Append attribute after the previous ones (4-byte aligned)
+		VertexFormat& add(VertexSemantic semantic, VertexAttributeFormat format);
+
+		// Return size in bytes of one vertex
+		u32 get_stride() const
+		{ return stride; }
+
+		// Return number of attributes
+		u32 get_attribute_count() const
+		{ return attribute_count; }
+
+		// Return attribute i
+		const VertexAttribute& get_attribute(u32 i) const
+		{ return attributes[i]; }
+
+		// Return attribute with semantic or nullptr
+		const VertexAttribute* find(VertexSemantic semantic) const;
+
+		// Return true if positions are stored relative to the mesh bounds
+		b8 is_quantized() const;
+
+		static VertexFormat full();			// FLOAT3 position + FLOAT4 color (28 bytes, same as Vertex)
+		static VertexFormat compact();		// SNORM16_4 position + UNORM8_4 color (12 bytes)
+		static VertexFormat half();			// HALF4 position + UNORM8_4 color (12 bytes)
+		static VertexFormat lit();			// SNORM16_4 position + OCT_SNORM16_2 normal + UNORM8_4 color (16 bytes)
+
+	private:
+		VertexAttribute attributes[MAX_VERTEX_ATTRIBUTES];
+		u32 attribute_count;
+		u32 stride;
+	};
+
+	// Return size in bytes of format
+	u32 get_attribute_size(VertexAttributeFormat format);
+
+	// Return number of components of format
+	u32 get_attribute_components(VertexAttributeFormat format);
+
+	// Return shader input semantic name of semantic
+	const char* get_semantic_name(VertexSemantic semantic);
+
+	// -------------------------------------------------------------------------------
+	// Packed vertices
+	// -------------------------------------------------------------------------------
+
+	// Vertex data converted to a VertexFormat, ready to upload
+	struct PackedVertices
+	{
+		VertexFormat format;			// Layout of data
+		std::vector<u8> data;			// vertex_count * format.get_stride() bytes
+		u32 vertex_count;				// Number of vertices
+		Vec3 position_scale;			// Quantized positions decode as pos * position_scale + position_offset
+		Vec3 position_offset;
+
+		// Return size in bytes of data
+		u32 get_data_size() const
+		{ return u32(data.size()); }
+
+		// Return matrix that decodes quantized positions, multiply it before the world matrix
+		Mat4 get_position_transform() const
+		{ return mat4_translate(mat4_scale(mat4_identity(), position_scale), position_offset); }
+	};
+
+	/* @brief Convert geometry vertices into format. Quantized positions are
+	 * mapped from the mesh bounds to [-1, 1], normals are area weighted
+	 * averages of the triangle normals.
+	 */
+	PackedVertices pack_vertices(const Geometry& geometry, const VertexFormat& format);
+}
@@ -0,0 +1,212 @@
+#include "test.h"
+
+#include "ecs.h"
+#include "job_system.h"
+
+#include <atomic>
+
+struct TestPosition { f32 x, y, z; };
+struct TestVelocity { f32 x, y, z; };
+struct TestSpin { f32 angle, speed; };
+
+// Enough entities to fill several chunks, every third without velocity
+static std::vector<JojEngine::Entity> populate(JojEngine::World& world, u32 count)
+{
+    std::vector<JojEngine::Entity> entities;
+    for (u32 i = 0; i < count; ++i)
+    {
+        if (i % 3 == 0)
+            entities.push_back(world.create(TestPosition{ f32(i), 0.0f, 0.0f }));
+        else
+            entities.push_back(world.create(TestPosition{ f32(i), 0.0f, 0.0f }, TestVelocity{ 1.0f, 0.0f, 0.0f }));
+    }
+    return entities;
+}
+
+// Queries see matching archetypes only, destroy fills holes, components survive moves between archetypes
+TEST_CASE(ecs, world)
+{
+    JojEngine::World world;
+    TEST_CHECK(world.init(4096));
+
+    std::vector<JojEngine::Entity> entities = populate(world, 3000);
+    TEST_CHECK(world.get_entity_count() == 3000);
+    TEST_CHECK(world.get_chunk_count() > 2);
+
+    u32 moving = 0;
+    world.each<TestPosition, const TestVelocity>([&](TestPosition& p, const TestVelocity& v) { p.x += v.x; moving++; });
+    TEST_CHECK(moving == 2000);
+
+    u32 wrong = 0;
+    for (u32 i = 0; i < 3000; ++i)
+    {
+        wrong += world.get<TestPosition>(entities[i])->x != f32(i) + (i % 3 == 0 ? 0.0f : 1.0f)
+            || world.has<TestVelocity>(entities[i]) != (i % 3 != 0);
+    }
+    TEST_CHECK(wrong == 0);
+
+    // Destroying fills holes with the last entity of the archetype
+    u32 failed_destroys = 0;
+    for (u32 i = 0; i < 3000; i += 7)
+        failed_destroys += !world.destroy(entities[i]);
+    TEST_CHECK(failed_destroys == 0);
+    TEST_CHECK(!world.destroy(entities[0]));
+    TEST_CHECK(!world.get<TestPosition>(entities[7]));
+
+    // Moves between archetypes keep the other components
+    TEST_CHECK(world.add(entities[1], TestSpin{ 0.5f, 2.0f }));
+    TEST_CHECK(world.has<TestSpin>(entities[1]));
+    TEST_CHECK(world.get<TestPosition>(entities[1])->x == 2.0f);
+    TEST_CHECK(world.get<TestVelocity>(entities[1])->x == 1.0f);
+    TEST_CHECK(world.remove<TestVelocity>(entities[1]));
+    TEST_CHECK(!world.remove<TestVelocity>(entities[1]));
+    TEST_CHECK(world.get<TestSpin>(entities[1])->speed == 2.0f);
+    TEST_CHECK(world.get<TestPosition>(entities[1])->x == 2.0f);
+
+    u32 alive = 0;
+    wrong = 0;
+    for (u32 i = 0; i < 3000; ++i)
+    {
+        if (!world.is_alive(entities[i]))
+            continue;
+        alive++;
+        wrong += world.get<TestPosition>(entities[i])->x != f32(i) + (i % 3 == 0 ? 0.0f : 1.0f);
+    }
+    TEST_CHECK(wrong == 0);
+    TEST_CHECK(alive == world.get_entity_count());
+
+    world.shutdown();
+    TEST_CHECK(world.get_entity_count() == 0);
+    TEST_CHECK(world.get_chunk_count() == 0);
+    TEST_CHECK(!world.is_alive(entities[1]));
+}
+
+// Commands recorded during a query change nothing until the flush
+TEST_CASE(ecs, command_buffer)
+{
+    JojEngine::World world;
+    world.init(4096);
+    std::vector<JojEngine::Entity> entities = populate(world, 300);
+
+    JojEngine::CommandBuffer commands;
+    world.each_chunk<const TestVelocity>([&](u32 count, const JojEngine::Entity* ids, const TestVelocity*)
+    {
+        for (u32 i = 0; i < count; ++i)
+            commands.remove<TestVelocity>(ids[i]);
+    });
+    commands.create(TestPosition{ -1.0f, 0.0f, 0.0f }, TestSpin{});
+    commands.destroy(entities[2]);
+    commands.add(entities[3], TestVelocity{ 3.0f, 0.0f, 0.0f });
+    u32 recorded = commands.get_count();
+
+    u32 before = world.get_entity_count();
+    TEST_CHECK(world.has<TestVelocity>(entities[2]));
+    world.flush(commands);
+    TEST_CHECK(recorded == 200 + 3);
+    TEST_CHECK(commands.get_count() == 0);
+    TEST_CHECK(world.get_entity_count() == before);
+    TEST_CHECK(!world.is_alive(entities[2]));
+    TEST_CHECK(world.get<TestVelocity>(entities[3]) && world.get<TestVelocity>(entities[3])->x == 3.0f);
+
+    u32 moving = 0;
+    world.each<const TestVelocity>([&](const TestVelocity&) { moving++; });
+    TEST_CHECK(moving == 1);
+
+    world.shutdown();
+}
+
+// Readers of velocity share a stage, its writer waits for them, commands apply between stages
+TEST_CASE(ecs, system_schedule)
+{
+    JojEngine::JobSystem jobs;
+    jobs.init(4);
+
+    JojEngine::World world;
+    world.init(4096);
+    populate(world, 300);
+    world.create(TestPosition{}, TestSpin{ 0.0f, 1.0f });
+    world.create(TestPosition{}, TestSpin{ 0.0f, 1.0f });
+
+    struct Counters
+    {
+        std::atomic<u32> runs{ 0 };
+        std::atomic<u32> spun{ 0 };
+    } counters;
+
+    JojEngine::SystemSchedule schedule;
+    JojEngine::ComponentMask position = JojEngine::component_mask<TestPosition>();
+    JojEngine::ComponentMask velocity = JojEngine::component_mask<TestVelocity>();
+    JojEngine::ComponentMask spin = JojEngine::component_mask<TestSpin>();
+    schedule.add("move", [](JojEngine::World& w, JojEngine::CommandBuffer&, void* data)
+    {
+        w.each<TestPosition, const TestVelocity>([](TestPosition& p, const TestVelocity& v) { p.x += v.x; });
+        ((Counters*)data)->runs++;
+    }, &counters, velocity, position);
+    schedule.add("spin", [](JojEngine::World& w, JojEngine::CommandBuffer& c, void* data)
+    {
+        w.each_chunk<TestSpin>([&](u32 count, const JojEngine::Entity* ids, TestSpin* s)
+        {
+            for (u32 i = 0; i < count; ++i)
+            {
+                s[i].angle += s[i].speed;
+                c.add(ids[i], TestVelocity{ 1.0f, 0.0f, 0.0f });
+            }
+            ((Counters*)data)->spun += count;
+        });
+        ((Counters*)data)->runs++;
+    }, &counters, 0, spin);
+    schedule.add("stop", [](JojEngine::World& w, JojEngine::CommandBuffer&, void* data)
+    {
+        w.each_chunk<TestVelocity>([&](u32 count, const JojEngine::Entity*, TestVelocity* v)
+        {
+            for (u32 i = 0; i < count; ++i)
+                v[i].x = 0.0f;
+        });
+        ((Counters*)data)->runs++;
+    }, &counters, 0, velocity);
+
+    // Stage job lists come from the frame memory
+    JojEngine::LinearArena arena;
+    arena.init(4096);
+    schedule.run(world, &jobs, &arena);
+    TEST_CHECK(arena.get_used() >= 3 * sizeof(JojEngine::Job) && arena.get_overflow_count() == 0);
+    TEST_CHECK(schedule.get_stage_count() == 2);
+    TEST_CHECK(schedule.get_stage(0) == 0 && schedule.get_stage(1) == 0 && schedule.get_stage(2) == 1);
+    TEST_CHECK(counters.runs == 3);
+    TEST_CHECK(counters.spun == 2);
+
+    // The spinning entities got a velocity at the sync point, then stop zeroed every velocity
+    u32 stopped = 0;
+    world.each<const TestVelocity, const TestSpin>([&](const TestVelocity& v, const TestSpin&) { stopped += v.x == 0.0f; });
+    TEST_CHECK(stopped == 2);
+
+    world.shutdown();
+    jobs.shutdown();
+    arena.shutdown();
+}
+
+// Parallel queries visit every chunk once
+TEST_CASE(ecs, parallel_each)
+{
+    JojEngine::JobSystem jobs;
+    jobs.init(4);
+
+    JojEngine::World world;
+    world.init(4096);
+    populate(world, 3000);
+
+    std::atomic<u32> visited{ 0 };
+    world.parallel_each<const TestPosition>(&jobs, [&](const TestPosition&) { visited++; });
+    TEST_CHECK(visited == world.get_entity_count());
+
+    // After shutdown, and without a job system, chunks are visited on the caller
+    jobs.shutdown();
+    visited = 0;
+    world.parallel_each<const TestPosition>(&jobs, [&](const TestPosition&) { visited++; });
+    TEST_CHECK(visited == world.get_entity_count());
+    visited = 0;
+    world.parallel_each<const TestPosition>(nullptr, [&](const TestPosition&) { visited++; });
+    TEST_CHECK(visited == world.get_entity_count());
+
+    world.shutdown();
+}
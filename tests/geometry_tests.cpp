@@ -0,0 +1,176 @@
+#include "test.h"
+
+#include "fmath.h"
+#include "geometry.h"
+#include "job_system.h"
+#include "mesh_optimizer.h"
+#include "vertex_format.h"
+
+#include <algorithm>
+#include <array>
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+// Subdivision shares edge midpoints: an icosphere of level n has V = 10 * 4^n + 2 vertices
+TEST_CASE(geometry, geosphere_counts)
+{
+    for (u32 n = 0; n <= 6; ++n)
+    {
+        JojRenderer::GeoSphere geosphere(1.0f, n);
+        TEST_CHECK(geosphere.get_vertex_count() == 10 * (1u << (2 * n)) + 2);
+        TEST_CHECK(geosphere.get_index_count() == 60 * (1u << (2 * n)));
+    }
+}
+
+// Generation split across workers writes the same vertices and indices as the inline loops
+TEST_CASE(geometry, parallel_generation)
+{
+    JojRenderer::Sphere inline_sphere(1.0f, 400, 400);
+    JojRenderer::Grid inline_grid(10.0f, 10.0f, 300, 300);
+    JojRenderer::GeoSphere inline_geosphere(1.0f, 5);
+
+    JojEngine::JobSystem jobs;
+    jobs.init(4);
+    JojRenderer::Geometry::jobs = &jobs;
+    JojRenderer::Sphere sphere(1.0f, 400, 400);
+    JojRenderer::Grid grid(10.0f, 10.0f, 300, 300);
+    JojRenderer::GeoSphere geosphere(1.0f, 5);
+    JojRenderer::Geometry::jobs = nullptr;
+    jobs.shutdown();
+
+    auto same = [](const JojRenderer::Geometry& a, const JojRenderer::Geometry& b)
+    {
+        return a.get_vertex_count() == b.get_vertex_count() && a.get_index_count() == b.get_index_count()
+            && memcmp(a.get_vertex_data(), b.get_vertex_data(), a.get_vertex_count() * sizeof(JojRenderer::Vertex)) == 0
+            && memcmp(a.indices.data(), b.indices.data(), a.get_index_count() * sizeof(u32)) == 0;
+    };
+
+    TEST_CHECK(same(sphere, inline_sphere));
+    TEST_CHECK(same(grid, inline_grid));
+    TEST_CHECK(same(geosphere, inline_geosphere));
+}
+
+// Meshes below 65535 vertices upload 16-bit indices with the same values
+TEST_CASE(geometry, index_formats)
+{
+    JojRenderer::Sphere small(1.0f, 40, 40);
+    JojRenderer::Grid large(100.0f, 100.0f, 300, 300);
+    TEST_CHECK(small.get_index_format() == JojRenderer::IndexFormat::U16);
+    TEST_CHECK(large.get_index_format() == JojRenderer::IndexFormat::U32);
+
+    const u16* packed = (const u16*)small.get_index_data();
+    u32 mismatches = 0;
+    for (u32 i = 0; i < small.get_index_count(); ++i)
+        mismatches += packed[i] != small.indices[i];
+    TEST_CHECK(mismatches == 0);
+}
+
+// Packed formats decode back to the source vertices within their precision
+TEST_CASE(geometry, vertex_formats)
+{
+    JojRenderer::GeoSphere sphere(2.0f, 3);
+
+    JojRenderer::PackedVertices full = JojRenderer::pack_vertices(sphere, JojRenderer::VertexFormat::full());
+    TEST_CHECK(full.get_data_size() == sphere.get_vertex_count() * sizeof(JojRenderer::Vertex));
+    TEST_CHECK(memcmp(full.data.data(), sphere.get_vertex_data(), full.get_data_size()) == 0);
+
+    JojRenderer::PackedVertices lit = JojRenderer::pack_vertices(sphere, JojRenderer::VertexFormat::lit());
+    if (!TEST_CHECK(lit.format.get_stride() == 16))
+        return;
+
+    u32 bad_positions = 0;
+    u32 bad_normals = 0;
+    for (u32 i = 0; i < sphere.get_vertex_count(); ++i)
+    {
+        const u8* v = lit.data.data() + i * lit.format.get_stride();
+        i16 p[4], n[2];
+        memcpy(p, v, sizeof(p));
+        memcpy(n, v + 8, sizeof(n));
+
+        // snorm16 position relative to the bounds
+        Vec3 pos = vec3_create(
+            f32(p[0]) / 32767.0f * lit.position_scale.x + lit.position_offset.x,
+            f32(p[1]) / 32767.0f * lit.position_scale.y + lit.position_offset.y,
+            f32(p[2]) / 32767.0f * lit.position_scale.z + lit.position_offset.z);
+        bad_positions += vec3_distance(pos, sphere.vertices[i].pos) >= 1e-4;
+
+        // Octahedral normal of a sphere points away from the center
+        f32 x = f32(n[0]) / 32767.0f;
+        f32 y = f32(n[1]) / 32767.0f;
+        f32 z = 1.0f - fabsf(x) - fabsf(y);
+        if (z < 0.0f)
+        {
+            f32 ox = x;
+            x = (1.0f - fabsf(y)) * (ox >= 0.0f ? 1.0f : -1.0f);
+            y = (1.0f - fabsf(ox)) * (y >= 0.0f ? 1.0f : -1.0f);
+        }
+        Vec3 normal = vec3_normalize(vec3_create(x, y, z));
+        bad_normals += vec3_dot_product(normal, vec3_normalize(sphere.vertices[i].pos)) <= 0.99;
+    }
+
+    TEST_CHECK(bad_positions == 0);
+    TEST_CHECK(bad_normals == 0);
+}
+
+// Triangle by vertex contents, rotated to start at its smallest corner so winding is kept
+typedef std::array<f32, 21> TriangleKey;
+
+static std::vector<TriangleKey> triangle_keys(const JojRenderer::Geometry& geometry)
+{
+    std::vector<TriangleKey> keys;
+    for (u32 t = 0; t + 2 < geometry.get_index_count(); t += 3)
+    {
+        std::array<std::array<f32, 7>, 3> corners;
+        for (u32 c = 0; c < 3; ++c)
+        {
+            const JojRenderer::Vertex& v = geometry.vertices[geometry.indices[t + c]];
+            corners[c] = { v.pos.x, v.pos.y, v.pos.z, v.color.x, v.color.y, v.color.z, v.color.w };
+        }
+
+        u32 first = 0;
+        for (u32 c = 1; c < 3; ++c)
+            first = corners[c] < corners[first] ? c : first;
+
+        TriangleKey key;
+        for (u32 c = 0; c < 3; ++c)
+            std::copy(corners[(first + c) % 3].begin(), corners[(first + c) % 3].end(), key.begin() + c * 7);
+        keys.push_back(key);
+    }
+
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+// Optimized meshes draw the same triangles with the same winding and never transform more vertices
+TEST_CASE(geometry, mesh_optimizer)
+{
+    JojRenderer::Sphere sphere(1.0f, 40, 40);
+    JojRenderer::GeoSphere geosphere(1.0f, 4);
+    JojRenderer::Grid grid(10.0f, 10.0f, 60, 60);
+    JojRenderer::Cylinder cylinder(1.0f, 0.5f, 2.0f, 30, 20);
+    JojRenderer::Geometry* meshes[] = { &sphere, &geosphere, &grid, &cylinder };
+
+    for (JojRenderer::Geometry* mesh : meshes)
+    {
+        std::vector<TriangleKey> before = triangle_keys(*mesh);
+        u32 vertex_count = mesh->get_vertex_count();
+
+        // Cache pass alone on the original order
+        std::vector<u32> cached(mesh->get_index_count());
+        JojRenderer::optimize_vertex_cache(cached.data(), mesh->indices.data(), mesh->get_index_count(), vertex_count);
+        JojRenderer::VertexCacheStats original = JojRenderer::analyze_vertex_cache(mesh->indices.data(), mesh->get_index_count(), vertex_count);
+        JojRenderer::VertexCacheStats reordered = JojRenderer::analyze_vertex_cache(cached.data(), mesh->get_index_count(), vertex_count);
+        TEST_CHECK(reordered.acmr <= original.acmr);
+
+        JojRenderer::MeshOptimizationReport report = JojRenderer::optimize_mesh(*mesh);
+        JojRenderer::VertexCacheStats after = JojRenderer::analyze_vertex_cache(mesh->indices.data(), mesh->get_index_count(), mesh->get_vertex_count());
+
+        TEST_CHECK(mesh->get_vertex_count() <= vertex_count);
+        TEST_CHECK(triangle_keys(*mesh) == before);
+        TEST_CHECK(report.before.acmr == original.acmr);
+        TEST_CHECK(report.after.acmr == after.acmr);
+        TEST_CHECK(report.after.acmr <= report.before.acmr);
+        TEST_CHECK(report.after.transformed <= report.before.transformed);
+    }
+}
@@ -0,0 +1,71 @@
+#include "test.h"
+
+#include "job_system.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// Every range runs once
+TEST_CASE(jobs, parallel_for)
+{
+    JojEngine::JobSystem jobs;
+    jobs.init(4);
+
+    std::vector<u32> hits(100000, 0);
+    jobs.parallel_for(u32(hits.size()), 1000, [&](u32 begin, u32 end)
+    {
+        for (u32 i = begin; i < end; ++i)
+            hits[i]++;
+    });
+
+    u32 wrong = 0;
+    for (u32 h : hits)
+        wrong += h != 1;
+    TEST_CHECK(wrong == 0);
+
+    jobs.shutdown();
+}
+
+// Continuations wait for their dependency
+TEST_CASE(jobs, run_after)
+{
+    JojEngine::JobSystem jobs;
+    jobs.init(4);
+
+    struct Chain { std::atomic<u32> step{ 0 }; b8 ordered = true; } chain;
+    JojEngine::JobCounter first;
+    JojEngine::JobCounter second;
+
+    JojEngine::Job slow = { [](void* data) {
+        Chain* c = (Chain*)data;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        c->step.store(1);
+    }, &chain, &first };
+
+    JojEngine::Job after = { [](void* data) {
+        Chain* c = (Chain*)data;
+        c->ordered = c->step.load() == 1;
+        c->step.store(2);
+    }, &chain, &second };
+
+    jobs.run(slow);
+    jobs.run_after(&first, after);
+    jobs.wait(&second);
+    TEST_CHECK(chain.ordered);
+    TEST_CHECK(chain.step.load() == 2);
+
+    jobs.shutdown();
+}
+
+// Shut down systems run inline
+TEST_CASE(jobs, inline_after_shutdown)
+{
+    JojEngine::JobSystem jobs;
+    jobs.init(2);
+    jobs.shutdown();
+
+    u32 inline_hits = 0;
+    jobs.parallel_for(10, 1, [&](u32 begin, u32 end) { inline_hits += end - begin; });
+    TEST_CHECK(inline_hits == 10);
+}
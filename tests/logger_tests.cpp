@@ -0,0 +1,240 @@
+#include "test.h"
+
+#include "binary_log.h"
+#include "logger.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+
+using JojTest::StdoutSilencer;
+
+// Async lines of every thread come out in order, FATAL is written before it returns, drops are counted
+TEST_CASE(logger, async)
+{
+    const char* path = "joj_logger_test.txt";
+    const u32 threads = 4;
+    const u32 lines = 500;
+    const u32 flood = 10000;
+    b8 fatal_written = false;
+    u64 dropped = 0;
+
+    {
+        StdoutSilencer capture(path);
+
+        log_start_async(64, LOG_OVERFLOW_BLOCK);
+        std::vector<std::thread> writers;
+        for (u32 t = 0; t < threads; ++t)
+            writers.emplace_back([t, lines]() { for (u32 i = 0; i < lines; ++i) FINFO("async %u %u", t, i); });
+        for (std::thread& w : writers)
+            w.join();
+
+        FFATAL(FAILED, "check fatal 7");
+        fatal_written = JojTest::read_file(path).find("check fatal 7") != std::string::npos;
+        log_stop_async();
+
+        log_start_async(4, LOG_OVERFLOW_DROP);
+        for (u32 i = 0; i < flood; ++i)
+            FINFO("drop %u", i);
+        log_stop_async();
+        dropped = log_get_dropped();
+    }
+
+    std::string text = JojTest::read_file(path);
+    remove(path);
+
+    u32 next[threads] = {};
+    u32 out_of_order = 0;
+    u32 drop_lines = 0;
+    size_t fatal_at = text.find("check fatal 7");
+    for (size_t at = text.find("[INFO][game]: "); at != std::string::npos; at = text.find("[INFO][game]: ", at + 1))
+    {
+        u32 t = 0, i = 0;
+        if (sscanf(text.c_str() + at, "[INFO][game]: async %u %u", &t, &i) == 2)
+        {
+            out_of_order += t >= threads || i != next[t] || at > fatal_at;
+            if (t < threads)
+                next[t] = i + 1;
+        }
+        else if (sscanf(text.c_str() + at, "[INFO][game]: drop %u", &i) == 1)
+            drop_lines++;
+    }
+
+    TEST_CHECK(out_of_order == 0);
+    for (u32 t = 0; t < threads; ++t)
+        TEST_CHECK(next[t] == lines);
+    TEST_CHECK(fatal_written);
+    TEST_CHECK(drop_lines + dropped == flood);
+}
+
+// Channel levels filter before formatting, sampled and rate limited sites write their share
+TEST_CASE(logger, channels)
+{
+    const char* path = "joj_channels_test.txt";
+
+    {
+        StdoutSilencer capture(path);
+
+        TEST_CHECK(log_parse_levels("warn,game=debug"));
+        TEST_CHECK(!log_parse_levels("game=loud,renderer=info"));
+        TEST_CHECK(log_get_level(LOG_CHANNEL_GAME) == LOG_LEVEL_DEBUG);
+        TEST_CHECK(log_get_level(LOG_CHANNEL_ENGINE) == LOG_LEVEL_WARN);
+        TEST_CHECK(log_get_level(LOG_CHANNEL_RENDERER) == LOG_LEVEL_INFO);
+
+        FINFO("channel hidden");
+        FDEBUG("channel shown");
+        for (u32 i = 0; i < 100; ++i)
+            FLOG_EVERY_N(LOG_LEVEL_DEBUG, 10, "sampled %u", i);
+        for (u32 i = 0; i < 1000; ++i)
+            FLOG_RATE(LOG_LEVEL_DEBUG, 5, "limited %u", i);
+
+        log_parse_levels("info");
+        fflush(stdout);
+    }
+
+    std::string text = JojTest::read_file(path);
+    remove(path);
+
+    auto count = [&text](const char* needle)
+    {
+        u32 found = 0;
+        for (size_t at = text.find(needle); at != std::string::npos; at = text.find(needle, at + 1))
+            found++;
+        return found;
+    };
+
+    // The rate limited loop may straddle two seconds
+    u32 limited = count("[DEBUG][game]: limited ");
+    TEST_CHECK(count("channel hidden") == 0);
+    TEST_CHECK(count("[DEBUG][game]: channel shown") == 1);
+    TEST_CHECK(count("[DEBUG][game]: sampled ") == 10);
+    TEST_CHECK(text.find("sampled 90") != std::string::npos);
+    TEST_CHECK(limited >= 5 && limited <= 10);
+    TEST_CHECK(log_get_level(LOG_CHANNEL_ENGINE) == LOG_LEVEL_INFO);
+}
+
+// Binary records of every thread decode to the text the synchronous logger would write
+TEST_CASE(logger, binary)
+{
+    const char* path = "joj_binary_test.log";
+    const char* text_path = "joj_binary_test.txt";
+    const u32 threads = 2;
+    const u32 lines = 1000;
+    TEST_CHECK(log_open_binary(path, 1 << 20));
+
+    std::vector<std::thread> writers;
+    for (u32 t = 0; t < threads; ++t)
+        writers.emplace_back([t, lines]() { for (u32 i = 0; i < lines; ++i) FINFO("binary %u %d", t, -i32(i)); });
+    for (std::thread& w : writers)
+        w.join();
+
+    i32 local = 0;
+    FINFO("values %5.2f|%s|%lld|%x|100%%", 3.14159, "text", -1234567890123ll, 255u);
+    FDEBUG("pointer %p", (void*)&local);
+    FINFO("char %c", 'j');
+
+    // Arguments that don't match their conversion decode to a placeholder, not to printf with the wrong type
+    u32 mismatch = log_register_format(LOG_CHANNEL_GAME, LOG_LEVEL_INFO, "mismatch %s|%p|%d|%+05s|%n", __FILE__, __LINE__);
+    log_binary(mismatch, LOG_CHANNEL_GAME, LOG_LEVEL_INFO, 42, "text", (void*)&local, "ok", 1);
+    log_close_binary();
+
+    char expected_values[128];
+    snprintf(expected_values, sizeof(expected_values), "values %5.2f|%s|%lld|%x|100%%", 3.14159, "text", -1234567890123ll, 255u);
+    char expected_pointer[64];
+    snprintf(expected_pointer, sizeof(expected_pointer), "[DEBUG][game]: pointer %p", (void*)&local);
+
+    FILE* out = fopen(text_path, "w");
+    TEST_CHECK(out && log_decode_binary(path, out));
+    if (out)
+        fclose(out);
+
+    std::string text = JojTest::read_file(text_path);
+    remove(path);
+    remove(text_path);
+
+    u32 next[threads] = {};
+    u32 out_of_order = 0;
+    for (size_t at = text.find("[INFO][game]: binary "); at != std::string::npos; at = text.find("[INFO][game]: binary ", at + 1))
+    {
+        u32 t = 0;
+        i32 i = 0;
+        if (sscanf(text.c_str() + at, "[INFO][game]: binary %u %d", &t, &i) == 2 && t < threads)
+        {
+            out_of_order += -i != i32(next[t]);
+            next[t]++;
+        }
+    }
+
+    TEST_CHECK(out_of_order == 0);
+    for (u32 t = 0; t < threads; ++t)
+        TEST_CHECK(next[t] == lines);
+    TEST_CHECK(text.find(expected_values) != std::string::npos);
+    TEST_CHECK(text.find(expected_pointer) != std::string::npos);
+    TEST_CHECK(text.find("[INFO][game]: char j") != std::string::npos);
+    TEST_CHECK(text.find("[INFO][game]: mismatch <bad %s>|<bad %p>|<bad %d>|   ok|<bad %n>") != std::string::npos);
+    TEST_CHECK(log_binary_dropped() == 0);
+}
+
+// Append a record with payload to a binary log image
+static void append_record(std::vector<u8>& image, u32 id, BinaryLogKind kind, const void* payload, u32 payload_size)
+{
+    BinaryLogRecord record = {};
+    record.size = u32(sizeof(BinaryLogRecord)) + payload_size;
+    record.id = id;
+    record.kind = kind;
+    record.level = LOG_LEVEL_INFO;
+    record.channel = LOG_CHANNEL_GAME;
+
+    const u8* bytes = (const u8*)&record;
+    image.insert(image.end(), bytes, bytes + sizeof(record));
+    image.insert(image.end(), (const u8*)payload, (const u8*)payload + payload_size);
+}
+
+// Format records with huge IDs, short payloads or unterminated strings are skipped, the rest still decodes
+TEST_CASE(logger, binary_corrupt)
+{
+    const char* path = "joj_binary_corrupt.log";
+    const char* text_path = "joj_binary_corrupt.txt";
+
+    u32 line = 7;
+    char valid[32];
+    memcpy(valid, &line, 4);
+    memcpy(valid + 4, "f.cpp\0kept\0", 11);
+    char unterminated[16];
+    memcpy(unterminated, &line, 4);
+    memcpy(unterminated + 4, "f.cpp\0lost", 10);
+
+    std::vector<u8> image(sizeof(BinaryLogHeader), 0);
+    append_record(image, 0xFFFFFFF0u, BINARY_LOG_FORMAT, valid, 15);
+    append_record(image, 0, BINARY_LOG_FORMAT, unterminated, 14);
+    append_record(image, 1, BINARY_LOG_FORMAT, valid, 2);
+    append_record(image, 2, BINARY_LOG_FORMAT, valid, 15);
+    append_record(image, 0, BINARY_LOG_MESSAGE, nullptr, 0);
+    append_record(image, 1, BINARY_LOG_MESSAGE, nullptr, 0);
+    append_record(image, 2, BINARY_LOG_MESSAGE, nullptr, 0);
+
+    BinaryLogHeader header = {};
+    memcpy(header.magic, "JOJBLOG1", 8);
+    header.ticks_per_second = 1e9;
+    header.used = image.size() - sizeof(BinaryLogHeader);
+    memcpy(image.data(), &header, sizeof(header));
+
+    FILE* file = fopen(path, "wb");
+    TEST_CHECK(file && fwrite(image.data(), 1, image.size(), file) == image.size());
+    if (file)
+        fclose(file);
+
+    FILE* out = fopen(text_path, "w");
+    TEST_CHECK(out && log_decode_binary(path, out));
+    if (out)
+        fclose(out);
+
+    std::string text = JojTest::read_file(text_path);
+    remove(path);
+    remove(text_path);
+
+    TEST_CHECK(text.find("<unknown format 0>") != std::string::npos);
+    TEST_CHECK(text.find("<unknown format 1>") != std::string::npos);
+    TEST_CHECK(text.find("[INFO][game]: kept") != std::string::npos);
+    TEST_CHECK(text.find("lost") == std::string::npos);
+}
@@ -0,0 +1,61 @@
+#include "test.h"
+
+#include <stdio.h>
+#include <string.h>
+
+using namespace JojTest;
+
+static void print_usage(const char* exe)
+{
+    fprintf(stderr, "Usage: %s [--filter <prefix>] [--list]\n", exe);
+}
+
+int main(int argc, char** argv)
+{
+    const char* filter = nullptr;
+    b8 list_only = false;
+
+    for (i32 i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+            filter = argv[++i];
+        else if (strcmp(argv[i], "--list") == 0)
+            list_only = true;
+        else
+        {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    u32 run = 0;
+    u32 failed = 0;
+
+    for (const TestCase& t : get_tests())
+    {
+        if (filter && strncmp(t.name, filter, strlen(filter)) != 0)
+            continue;
+
+        if (list_only)
+        {
+            printf("%s\n", t.name);
+            continue;
+        }
+
+        u32 failures = get_failure_count();
+        t.func();
+        run++;
+
+        b8 passed = get_failure_count() == failures;
+        failed += !passed;
+        fprintf(stderr, "[%s] %s\n", passed ? "  OK  " : " FAIL ", t.name);
+    }
+
+    if (list_only)
+        return 0;
+
+    // Groups compiled out by the build options (profiler, memory tracking) run nothing
+    fprintf(stderr, "%u tests, %u failed\n", run, failed);
+
+    return failed == 0 ? 0 : 1;
+}
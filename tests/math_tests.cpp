@@ -0,0 +1,399 @@
+#include "test.h"
+
+#include "fmath.h"
+#include "fmath_batch.h"
+
+#include <math.h>
+#include <vector>
+
+// Matrices and vectors per equivalence test
+static const u32 SAMPLES = 1000;
+
+// Uniform in [-1, 1), same sequence on every backend
+static f32 next_unit(u32& seed)
+{
+    seed = seed * 1664525u + 1013904223u;
+    return f32(seed >> 8) / f32(1 << 23) - 1.0f;
+}
+
+static Mat4 random_mat4(u32& seed)
+{
+    Mat4 m;
+    for (u32 k = 0; k < 16; ++k)
+        m.data[k] = next_unit(seed) * 4.0f;
+    return m;
+}
+
+static Vec3 random_vec3(u32& seed)
+{
+    f32 x = next_unit(seed) * 10.0f;
+    f32 y = next_unit(seed) * 10.0f;
+    return vec3_create(x, y, next_unit(seed) * 10.0f);
+}
+
+// Rotation, scale and translation, always invertible
+static Mat4 random_affine(u32& seed)
+{
+    Vec3 axis = vec3_normalize(random_vec3(seed));
+    Quat rotation = quat_from_axis_angle(axis, next_unit(seed) * F_PI);
+    return transform_to_mat4(transform_create(random_vec3(seed), rotation, vec3_create(1.5f, 0.5f, 2.0f)));
+}
+
+// Values agree within tolerance relative to their magnitude
+static b8 nearly_equal(f32 a, f32 b, f32 tolerance)
+{
+    f32 scale = fabsf(a) > fabsf(b) ? fabsf(a) : fabsf(b);
+    return fabsf(a - b) <= tolerance * (scale > 1.0f ? scale : 1.0f);
+}
+
+static b8 mat4_nearly_equal(const Mat4& a, const Mat4& b, f32 tolerance)
+{
+    for (u32 k = 0; k < 16; ++k)
+    {
+        if (!nearly_equal(a.data[k], b.data[k], tolerance))
+            return false;
+    }
+    return true;
+}
+
+static b8 vec3_nearly_equal(Vec3 a, Vec3 b, f32 tolerance)
+{
+    return nearly_equal(a.x, b.x, tolerance) && nearly_equal(a.y, b.y, tolerance) && nearly_equal(a.z, b.z, tolerance);
+}
+
+// SIMD Mat4 kernels give the scalar reference results, up to rounding where the compiler fuses the scalar multiply-adds
+TEST_CASE(math, mat4_simd_matches_scalar)
+{
+    u32 seed = 42;
+    u32 mul = 0, transpose = 0, mult_vec = 0, points = 0, vectors = 0;
+
+    for (u32 i = 0; i < SAMPLES; ++i)
+    {
+        Mat4 a = random_mat4(seed);
+        Mat4 b = random_mat4(seed);
+        Vec3 p = random_vec3(seed);
+        Vec4 v = vec4_create(p.x, p.y, p.z, 1.0f);
+
+        mul += !mat4_nearly_equal(mat4_mul(a, b), mat4_mul_scalar(a, b), 1e-5f);
+        transpose += !mat4_nearly_equal(mat4_transpose(a), mat4_transpose_scalar(a), 0.0f);
+
+        Vec4 r = mat4_mult_vec3(a, v);
+        Vec4 s = mat4_mult_vec3_scalar(a, v);
+        mult_vec += !nearly_equal(r.x, s.x, 1e-5f) || !nearly_equal(r.y, s.y, 1e-5f)
+            || !nearly_equal(r.z, s.z, 1e-5f) || !nearly_equal(r.w, s.w, 1e-5f);
+
+        points += !vec3_nearly_equal(mat4_transform_point(a, p), mat4_transform_point_scalar(a, p), 1e-5f);
+        vectors += !vec3_nearly_equal(mat4_transform_vector(a, p), mat4_transform_vector_scalar(a, p), 1e-5f);
+    }
+
+    TEST_CHECK(mul == 0);
+    TEST_CHECK(transpose == 0);
+    TEST_CHECK(mult_vec == 0);
+    TEST_CHECK(points == 0);
+    TEST_CHECK(vectors == 0);
+}
+
+// SIMD inverses agree with the scalar cofactor expansion and invert their input
+TEST_CASE(math, mat4_inverse_matches_scalar)
+{
+    u32 seed = 7;
+    u32 general = 0, affine = 0, identity = 0;
+
+    for (u32 i = 0; i < SAMPLES; ++i)
+    {
+        Mat4 a = random_affine(seed);
+
+        // Full 4x4 matrices far from singular: diagonally dominant
+        Mat4 g = random_mat4(seed);
+        for (u32 k = 0; k < 4; ++k)
+            g.data[k * 5] += 16.0f;
+
+        general += !mat4_nearly_equal(mat4_inverse(g), mat4_inverse_scalar(g), 1e-4f);
+        affine += !mat4_nearly_equal(mat4_inverse_affine(a), mat4_inverse_affine_scalar(a), 1e-5f);
+        identity += !mat4_nearly_equal(mat4_mul(a, mat4_inverse_affine(a)), mat4_identity(), 1e-4f)
+            || !mat4_nearly_equal(mat4_mul(g, mat4_inverse(g)), mat4_identity(), 1e-4f);
+    }
+
+    TEST_CHECK(general == 0);
+    TEST_CHECK(affine == 0);
+    TEST_CHECK(identity == 0);
+}
+
+// Multiplication applies a first: transforming by a * b equals transforming by a, then by b
+TEST_CASE(math, mat4_mul_order)
+{
+    u32 seed = 99;
+    u32 wrong = 0;
+
+    for (u32 i = 0; i < SAMPLES; ++i)
+    {
+        Mat4 a = random_affine(seed);
+        Mat4 b = random_affine(seed);
+        Vec3 p = random_vec3(seed);
+        wrong += !vec3_nearly_equal(mat4_transform_point(mat4_mul(a, b), p),
+            mat4_transform_point(b, mat4_transform_point(a, p)), 1e-4f);
+    }
+
+    TEST_CHECK(wrong == 0);
+}
+
+// Structure-of-arrays storage for count Vec3
+struct SoAStorage
+{
+    std::vector<f32> x, y, z;
+
+    SoAStorage(u32 count, u32& seed) : x(count), y(count), z(count)
+    {
+        for (u32 i = 0; i < count; ++i)
+        {
+            Vec3 v = random_vec3(seed);
+            x[i] = v.x;
+            y[i] = v.y;
+            z[i] = v.z;
+        }
+    }
+
+    Vec3SoA view() { return vec3_soa_create(x.data(), y.data(), z.data()); }
+};
+
+// Every batch kernel matches the per-element scalar reference for counts hitting the AVX, SSE/NEON and tail loops,
+// with separate and aliased output arrays
+TEST_CASE(math, batch_kernels_match_scalar)
+{
+    u32 seed = 2024;
+    u32 add = 0, translate = 0, scale = 0, points = 0, vectors = 0, aliased = 0;
+    u32 mul = 0, shared = 0, translate_mat = 0;
+
+    for (u32 count = 0; count <= 37; ++count)
+    {
+        SoAStorage a(count, seed);
+        SoAStorage b(count, seed);
+        SoAStorage out(count, seed);
+        Mat4 m = random_affine(seed);
+        Vec3 offset = random_vec3(seed);
+        f32 k = next_unit(seed) * 3.0f;
+
+        vec3_soa_add(out.view(), a.view(), b.view(), count);
+        for (u32 i = 0; i < count; ++i)
+            add += !vec3_nearly_equal(vec3_soa_get(out.view(), i), vec3_add(vec3_soa_get(a.view(), i), vec3_soa_get(b.view(), i)), 0.0f);
+
+        vec3_soa_translate(out.view(), a.view(), offset, count);
+        for (u32 i = 0; i < count; ++i)
+            translate += !vec3_nearly_equal(vec3_soa_get(out.view(), i), vec3_add(vec3_soa_get(a.view(), i), offset), 0.0f);
+
+        vec3_soa_multiply_by_scalar(out.view(), a.view(), k, count);
+        for (u32 i = 0; i < count; ++i)
+            scale += !vec3_nearly_equal(vec3_soa_get(out.view(), i), vec3_multiply_by_scalar(vec3_soa_get(a.view(), i), k), 0.0f);
+
+        mat4_transform_points_soa(m, a.view(), out.view(), count);
+        for (u32 i = 0; i < count; ++i)
+            points += !vec3_nearly_equal(vec3_soa_get(out.view(), i), mat4_transform_point_scalar(m, vec3_soa_get(a.view(), i)), 1e-5f);
+
+        mat4_transform_vectors_soa(m, a.view(), out.view(), count);
+        for (u32 i = 0; i < count; ++i)
+            vectors += !vec3_nearly_equal(vec3_soa_get(out.view(), i), mat4_transform_vector_scalar(m, vec3_soa_get(a.view(), i)), 1e-5f);
+
+        // In place: out aliases in
+        SoAStorage copy = a;
+        mat4_transform_points_soa(m, a.view(), a.view(), count);
+        for (u32 i = 0; i < count; ++i)
+            aliased += !vec3_nearly_equal(vec3_soa_get(a.view(), i), mat4_transform_point_scalar(m, vec3_soa_get(copy.view(), i)), 1e-5f);
+
+        std::vector<Mat4> ma(count), mb(count), mo(count);
+        for (u32 i = 0; i < count; ++i)
+        {
+            ma[i] = random_mat4(seed);
+            mb[i] = random_mat4(seed);
+        }
+
+        mat4_mul_batch(ma.data(), mb.data(), mo.data(), count);
+        for (u32 i = 0; i < count; ++i)
+            mul += !mat4_nearly_equal(mo[i], mat4_mul_scalar(ma[i], mb[i]), 1e-5f);
+
+        mat4_mul_batch_shared(ma.data(), m, mo.data(), count);
+        for (u32 i = 0; i < count; ++i)
+            shared += !mat4_nearly_equal(mo[i], mat4_mul_scalar(ma[i], m), 1e-5f);
+
+        std::vector<Mat4> in_place = ma;
+        mat4_mul_batch_shared(in_place.data(), m, in_place.data(), count);
+        for (u32 i = 0; i < count; ++i)
+            aliased += !mat4_nearly_equal(in_place[i], mat4_mul_scalar(ma[i], m), 1e-5f);
+
+        mat4_translate_batch_soa(m, b.view(), mo.data(), count);
+        for (u32 i = 0; i < count; ++i)
+            translate_mat += !mat4_nearly_equal(mo[i], mat4_translate(m, vec3_soa_get(b.view(), i)), 0.0f);
+    }
+
+    TEST_CHECK(add == 0);
+    TEST_CHECK(translate == 0);
+    TEST_CHECK(scale == 0);
+    TEST_CHECK(points == 0);
+    TEST_CHECK(vectors == 0);
+    TEST_CHECK(aliased == 0);
+    TEST_CHECK(mul == 0);
+    TEST_CHECK(shared == 0);
+    TEST_CHECK(translate_mat == 0);
+}
+
+static Quat random_quat(u32& seed)
+{
+    f32 x = next_unit(seed);
+    f32 y = next_unit(seed);
+    f32 z = next_unit(seed);
+    return quat_normalize_scalar(quat_create(x, y, z, next_unit(seed) + 1.5f));
+}
+
+static b8 quat_nearly_equal(Quat a, Quat b, f32 tolerance)
+{
+    return nearly_equal(a.x, b.x, tolerance) && nearly_equal(a.y, b.y, tolerance)
+        && nearly_equal(a.z, b.z, tolerance) && nearly_equal(a.w, b.w, tolerance);
+}
+
+// SIMD quaternion and Transform kernels give the scalar reference results
+TEST_CASE(math, quat_simd_matches_scalar)
+{
+    u32 seed = 5;
+    u32 normalize = 0, mul = 0, rotate = 0, nlerp = 0, to_mat4 = 0;
+
+    for (u32 i = 0; i < SAMPLES; ++i)
+    {
+        Quat a = random_quat(seed);
+        Quat b = random_quat(seed);
+        Quat raw = quat_create(next_unit(seed), next_unit(seed), next_unit(seed), next_unit(seed) + 2.0f);
+        Vec3 v = random_vec3(seed);
+        f32 t = next_unit(seed) * 0.5f + 0.5f;
+        Transform transform = transform_create(random_vec3(seed), a, vec3_create(0.5f, 2.0f, 1.5f));
+
+        normalize += !quat_nearly_equal(quat_normalize(raw), quat_normalize_scalar(raw), 1e-6f);
+        mul += !quat_nearly_equal(quat_mul(a, b), quat_mul_scalar(a, b), 1e-6f);
+        rotate += !vec3_nearly_equal(quat_rotate_vec3(a, v), quat_rotate_vec3_scalar(a, v), 1e-5f);
+        nlerp += !quat_nearly_equal(quat_nlerp(a, b, t), quat_nlerp_scalar(a, b, t), 1e-6f);
+        to_mat4 += !mat4_nearly_equal(transform_to_mat4(transform), transform_to_mat4_scalar(transform), 1e-6f);
+    }
+
+    TEST_CHECK(normalize == 0);
+    TEST_CHECK(mul == 0);
+    TEST_CHECK(rotate == 0);
+    TEST_CHECK(nlerp == 0);
+    TEST_CHECK(to_mat4 == 0);
+}
+
+// Transform columns written as SoA are the columns of the scalar matrix
+TEST_CASE(math, transform_columns_soa)
+{
+    u32 seed = 9;
+    std::vector<Transform> transforms(SAMPLES);
+    for (Transform& transform : transforms)
+        transform = transform_create(random_vec3(seed), random_quat(seed), vec3_create(0.5f, 2.0f, 1.5f));
+
+    std::vector<f32> lanes(12 * SAMPLES);
+    f32* l = lanes.data();
+    Vec3SoA x_axis = vec3_soa_create(l, l + SAMPLES, l + 2 * SAMPLES);
+    Vec3SoA y_axis = vec3_soa_create(l + 3 * SAMPLES, l + 4 * SAMPLES, l + 5 * SAMPLES);
+    Vec3SoA z_axis = vec3_soa_create(l + 6 * SAMPLES, l + 7 * SAMPLES, l + 8 * SAMPLES);
+    Vec3SoA translation = vec3_soa_create(l + 9 * SAMPLES, l + 10 * SAMPLES, l + 11 * SAMPLES);
+    transform_columns_soa(transforms.data(), x_axis, y_axis, z_axis, translation, SAMPLES);
+
+    u32 wrong = 0;
+    for (u32 i = 0; i < SAMPLES; ++i)
+    {
+        Mat4 m = transform_to_mat4_scalar(transforms[i]);
+        wrong += !vec3_nearly_equal(vec3_soa_get(x_axis, i), vec3_create(m.data[0], m.data[1], m.data[2]), 1e-6f)
+            || !vec3_nearly_equal(vec3_soa_get(y_axis, i), vec3_create(m.data[4], m.data[5], m.data[6]), 1e-6f)
+            || !vec3_nearly_equal(vec3_soa_get(z_axis, i), vec3_create(m.data[8], m.data[9], m.data[10]), 1e-6f)
+            || !vec3_nearly_equal(vec3_soa_get(translation, i), transforms[i].translation, 0.0f);
+    }
+    TEST_CHECK(wrong == 0);
+}
+
+// Identity does nothing, q * conjugate(q) and q^-1 * q are the identity, products of unit quaternions stay unit
+TEST_CASE(math, quat_identities)
+{
+    u32 seed = 11;
+    u32 identity = 0, conjugate = 0, inverse = 0, unit = 0;
+    Quat one = quat_identity();
+
+    for (u32 i = 0; i < SAMPLES; ++i)
+    {
+        Quat q = random_quat(seed);
+        Quat raw = quat_create(next_unit(seed), next_unit(seed), next_unit(seed), next_unit(seed) + 2.0f);
+        Vec3 v = random_vec3(seed);
+
+        identity += !quat_nearly_equal(quat_mul(q, one), q, 0.0f) || !quat_nearly_equal(quat_mul(one, q), q, 0.0f)
+            || !vec3_nearly_equal(quat_rotate_vec3(one, v), v, 0.0f);
+        conjugate += !quat_nearly_equal(quat_mul(q, quat_conjugate(q)), one, 1e-6f);
+        inverse += !quat_nearly_equal(quat_mul(quat_inverse(raw), raw), one, 1e-6f);
+        Quat product = quat_mul(q, random_quat(seed));
+        unit += fabsf(quat_dot(product, product) - 1.0f) > 1e-5f;
+    }
+
+    TEST_CHECK(identity == 0);
+    TEST_CHECK(conjugate == 0);
+    TEST_CHECK(inverse == 0);
+    TEST_CHECK(unit == 0);
+}
+
+// Rotations round-trip, products compose right to left and match the rotation matrices
+TEST_CASE(math, quat_round_trips)
+{
+    u32 seed = 13;
+    u32 round_trip = 0, compose = 0, matrix = 0, axis_angle = 0, transform = 0;
+
+    for (u32 i = 0; i < SAMPLES; ++i)
+    {
+        Quat a = random_quat(seed);
+        Quat b = random_quat(seed);
+        Vec3 v = random_vec3(seed);
+
+        round_trip += !vec3_nearly_equal(quat_rotate_vec3(quat_conjugate(a), quat_rotate_vec3(a, v)), v, 1e-5f);
+        compose += !vec3_nearly_equal(quat_rotate_vec3(quat_mul(a, b), v), quat_rotate_vec3(a, quat_rotate_vec3(b, v)), 1e-5f);
+        matrix += !vec3_nearly_equal(mat4_transform_point(quat_to_mat4(a), v), quat_rotate_vec3(a, v), 1e-5f);
+
+        // Quarter turn about an axis maps the perpendicular axis onto their cross product
+        f32 angle = next_unit(seed) * F_PI;
+        Vec3 turned = quat_rotate_vec3(quat_from_axis_angle(vec3_up(), angle), vec3_right());
+        axis_angle += !vec3_nearly_equal(turned, vec3_create(cosf(angle), 0.0f, -sinf(angle)), 1e-5f);
+
+        // Uniform scale: Transform inverse and matrix agree with transform_point
+        Transform t = transform_create(random_vec3(seed), a, vec3_create(2.0f, 2.0f, 2.0f));
+        Vec3 p = transform_point(t, v);
+        transform += !vec3_nearly_equal(transform_point(transform_inverse(t), p), v, 1e-4f)
+            || !vec3_nearly_equal(mat4_transform_point(transform_to_mat4(t), v), p, 1e-4f);
+    }
+
+    TEST_CHECK(round_trip == 0);
+    TEST_CHECK(compose == 0);
+    TEST_CHECK(matrix == 0);
+    TEST_CHECK(axis_angle == 0);
+    TEST_CHECK(transform == 0);
+}
+
+// Interpolation hits both ends, stays unit length and takes the shortest path
+TEST_CASE(math, quat_interpolation)
+{
+    u32 seed = 17;
+    u32 ends = 0, unit = 0, halfway = 0;
+
+    for (u32 i = 0; i < SAMPLES; ++i)
+    {
+        Quat a = random_quat(seed);
+        Quat b = random_quat(seed);
+
+        // -b is the same rotation, both paths end on a rotation equal to b
+        Quat s0 = quat_slerp(a, b, 0.0f);
+        Quat s1 = quat_slerp(a, quat_create(-b.x, -b.y, -b.z, -b.w), 1.0f);
+        ends += !quat_nearly_equal(s0, a, 1e-5f) || fabsf(quat_dot(s1, b)) < 1.0f - 1e-5f
+            || fabsf(quat_dot(quat_nlerp(a, b, 1.0f), b)) < 1.0f - 1e-5f;
+
+        Quat s = quat_slerp(a, b, 0.5f);
+        Quat n = quat_nlerp(a, b, 0.5f);
+        unit += fabsf(quat_dot(s, s) - 1.0f) > 1e-5f || fabsf(quat_dot(n, n) - 1.0f) > 1e-5f;
+
+        // Midpoint of the shortest arc is as close to a as to b, and nlerp agrees with slerp there
+        halfway += fabsf(fabsf(quat_dot(s, a)) - fabsf(quat_dot(s, b))) > 1e-4f || fabsf(quat_dot(s, n)) < 1.0f - 1e-4f;
+    }
+
+    TEST_CHECK(ends == 0);
+    TEST_CHECK(unit == 0);
+    TEST_CHECK(halfway == 0);
+}
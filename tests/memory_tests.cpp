@@ -0,0 +1,271 @@
+#include "test.h"
+
+#include "frame_arena.h"
+#include "geometry.h"
+#include "handle_pool.h"
+#include "memory_tracker.h"
+#include "null/renderer_null.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// Allocations are aligned, overflow grows the arena at reset
+TEST_CASE(memory, linear_arena)
+{
+    JojEngine::LinearArena arena;
+    TEST_CHECK(arena.init(256));
+
+    for (u64 alignment = 1; alignment <= 256; alignment *= 2)
+    {
+        void* p = arena.allocate(3, alignment);
+        TEST_CHECK(p && (uintptr_t(p) & (alignment - 1)) == 0);
+    }
+
+    // Past the capacity: served from the heap, then the block grows to fit
+    u8* big = (u8*)arena.allocate(1000, 8);
+    memset(big, 0xAB, 1000);
+    TEST_CHECK(arena.get_overflow_count() >= 1);
+    TEST_CHECK(arena.get_used() > 1000);
+
+    arena.reset();
+    TEST_CHECK(arena.get_used() == 0);
+    TEST_CHECK(arena.get_capacity() >= arena.get_peak());
+    TEST_CHECK(arena.get_peak() > 1000);
+
+    u64 overflows = arena.get_overflow_count();
+    arena.allocate(1000, 8);
+    TEST_CHECK(arena.get_overflow_count() == overflows);
+}
+
+// Vector growth stays in the arena
+TEST_CASE(memory, frame_vector)
+{
+    JojEngine::LinearArena arena;
+    TEST_CHECK(arena.init(1 << 16));
+
+    JojEngine::FrameVector<u64> values{ JojEngine::ArenaAllocator<u64>(&arena) };
+    for (u64 i = 0; i < 100; ++i)
+        values.push_back(i * i);
+
+    u32 wrong = 0;
+    for (u64 i = 0; i < 100; ++i)
+        wrong += values[i] != i * i;
+    TEST_CHECK(wrong == 0);
+    TEST_CHECK(arena.get_overflow_count() == 0);
+    TEST_CHECK(arena.get_used() >= 100 * sizeof(u64));
+}
+
+// Two arenas: frame N data survives frame N + 1
+TEST_CASE(memory, frame_arena_rotation)
+{
+    JojEngine::FrameArena frames;
+    if (!TEST_CHECK(frames.init(2, 1024)))
+        return;
+    TEST_CHECK(frames.get_count() == 2);
+
+    frames.begin_frame();
+    u32* first = (u32*)frames.allocate(sizeof(u32));
+    *first = 42;
+    frames.begin_frame();
+    u32* second = (u32*)frames.allocate(sizeof(u32));
+    *second = 7;
+    TEST_CHECK(*first == 42);
+    TEST_CHECK(first != second);
+    frames.begin_frame();
+    TEST_CHECK(frames.allocate(sizeof(u32)) == first);
+}
+
+// Stale handles are rejected after destroy, clear and slot reuse, iteration sees every live object once
+TEST_CASE(memory, handle_pool)
+{
+    JojEngine::Pool<u32> pool;
+    pool.init(8);
+
+    JojEngine::Handle<u32> handles[8];
+    for (u32 i = 0; i < 8; ++i)
+        handles[i] = pool.create(i * 10);
+
+    TEST_CHECK(pool.create(99).is_null());
+    TEST_CHECK(pool.get_count() == 8);
+    TEST_CHECK(JojEngine::Handle<u32>().is_null());
+
+    TEST_CHECK(pool.destroy(handles[2]));
+    TEST_CHECK(pool.destroy(handles[5]));
+    TEST_CHECK(!pool.destroy(handles[2]));
+    TEST_CHECK(!pool.get(handles[2]));
+    TEST_CHECK(!pool.is_alive(handles[5]));
+    TEST_CHECK(pool.get(handles[7]) && *pool.get(handles[7]) == 70);
+
+    // Reused slot, new generation
+    JojEngine::Handle<u32> reused = pool.create(123);
+    TEST_CHECK(!reused.is_null() && reused.index == handles[5].index && reused != handles[5]);
+    TEST_CHECK(!pool.get(handles[5]));
+    TEST_CHECK(pool.get(reused) && *pool.get(reused) == 123);
+
+    u32 sum = 0, visited = 0;
+    for (u32 value : pool)
+    {
+        sum += value;
+        visited++;
+    }
+    TEST_CHECK(visited == pool.get_count() && visited == 7);
+    TEST_CHECK(sum == 0 + 10 + 30 + 40 + 60 + 70 + 123);
+
+    for (u32 i = 0; i < pool.get_count(); ++i)
+        TEST_CHECK(pool.get(pool.get_handle(i)) == pool.begin() + i);
+
+    pool.clear();
+    TEST_CHECK(pool.get_count() == 0);
+    TEST_CHECK(!pool.get(reused));
+    TEST_CHECK(!pool.get(handles[0]));
+
+    // Objects created after clear or init reuse the slots with newer generations
+    JojEngine::Handle<u32> after_clear = pool.create(1);
+    TEST_CHECK(!pool.get(handles[after_clear.index]) && pool.get(after_clear));
+    pool.init(16);
+    TEST_CHECK(!pool.get(after_clear));
+    u32 aliased = 0;
+    for (u32 i = 0; i < 16; ++i)
+    {
+        JojEngine::Handle<u32> fresh = pool.create(i);
+        aliased += pool.get(after_clear) != nullptr || pool.get(reused) != nullptr;
+        for (const JojEngine::Handle<u32>& old : handles)
+            aliased += pool.get(old) != nullptr;
+        TEST_CHECK(pool.get(fresh) && *pool.get(fresh) == i);
+    }
+    TEST_CHECK(aliased == 0);
+}
+
+// Renderer resources behind handles
+TEST_CASE(memory, renderer_handles)
+{
+    JojRenderer::NullRenderer renderer;
+    renderer.init();
+
+    JojRenderer::BufferDesc desc;
+    desc.size = 1024;
+    JojRenderer::BufferHandle vertices = renderer.create_buffer(desc);
+    desc.type = JojRenderer::BufferType::INDEX;
+    desc.size = 256;
+    JojRenderer::BufferHandle indices = renderer.create_buffer(desc);
+    JojRenderer::MeshHandle mesh = renderer.create_mesh(vertices, indices, 64);
+
+    TEST_CHECK(renderer.get_buffer_memory() == 1280);
+    TEST_CHECK(renderer.draw_mesh(mesh));
+    TEST_CHECK(renderer.destroy_buffer(indices));
+    TEST_CHECK(!renderer.draw_mesh(mesh));
+    TEST_CHECK(renderer.get_buffer_memory() == 1024);
+    TEST_CHECK(renderer.create_mesh(vertices, indices, 64).is_null());
+    TEST_CHECK(renderer.get_draw_count() == 1);
+
+    JojRenderer::ShaderHandle shader = renderer.create_shader(JojRenderer::ShaderDesc());
+    TEST_CHECK(renderer.get_shader_count() == 1);
+    TEST_CHECK(renderer.set_shader(shader));
+    TEST_CHECK(renderer.destroy_shader(shader));
+    TEST_CHECK(!renderer.set_shader(shader));
+    TEST_CHECK(!renderer.destroy_shader(shader));
+    TEST_CHECK(renderer.get_shader_count() == 0);
+
+    renderer.shutdown();
+}
+
+#if !FMEMORY_TRACKING_DISABLED
+// Geometry memory is counted while alive and returned when freed, reports are written
+TEST_CASE(memory, tracker_geometry)
+{
+    using JojEngine::MemoryTag;
+    using JojEngine::MemoryTracker;
+
+    const char* path = "joj_memory_test.json";
+    MemoryTracker::frame_mark();
+    JojEngine::MemoryStats before = MemoryTracker::get_stats(MemoryTag::GEOMETRY);
+    u64 expected = 0;
+
+    {
+        JojRenderer::GeoSphere sphere(1.0f, 4);
+        JojEngine::MemoryStats during = MemoryTracker::get_stats(MemoryTag::GEOMETRY);
+        expected = during.live_bytes - before.live_bytes;
+
+        // Vertices and 32-bit indices at least, the 16-bit copy comes on top
+        TEST_CHECK(expected >= u64(sphere.vertices.size()) * sizeof(JojRenderer::Vertex) + u64(sphere.indices.size()) * sizeof(u32));
+        TEST_CHECK(during.peak_bytes >= during.live_bytes);
+        TEST_CHECK(during.allocations > before.allocations);
+        TEST_CHECK(during.live_allocations > before.live_allocations);
+
+        MemoryTracker::frame_mark();
+        TEST_CHECK(MemoryTracker::get_stats(MemoryTag::GEOMETRY).frame_allocations == during.allocations - before.allocations);
+        TEST_CHECK(MemoryTracker::write_json(path));
+    }
+
+    JojEngine::MemoryStats after = MemoryTracker::get_stats(MemoryTag::GEOMETRY);
+    TEST_CHECK(after.live_bytes == before.live_bytes);
+    TEST_CHECK(after.live_allocations == before.live_allocations);
+    TEST_CHECK(after.peak_bytes >= before.live_bytes + expected);
+
+    // Nothing allocated since the mark
+    MemoryTracker::frame_mark();
+    TEST_CHECK(MemoryTracker::get_stats(MemoryTag::GEOMETRY).frame_allocations == 0);
+
+    std::string text = JojTest::read_file(path);
+    remove(path);
+    TEST_CHECK(text.find("\"geometry\"") != std::string::npos);
+    TEST_CHECK(text.find("\"total\"") != std::string::npos);
+    TEST_CHECK(text.find("\"peak_bytes\"") != std::string::npos);
+}
+
+// Renderer buffers are counted while alive
+TEST_CASE(memory, tracker_renderer)
+{
+    using JojEngine::MemoryTag;
+    using JojEngine::MemoryTracker;
+
+    JojRenderer::NullRenderer renderer;
+    renderer.init();
+    u64 renderer_live = MemoryTracker::get_stats(MemoryTag::RENDERER).live_bytes;
+
+    JojRenderer::BufferDesc desc;
+    desc.size = 4096;
+    JojRenderer::BufferHandle buffer = renderer.create_buffer(desc);
+    TEST_CHECK(MemoryTracker::get_stats(MemoryTag::RENDERER).live_bytes == renderer_live + 4096);
+    renderer.destroy_buffer(buffer);
+    TEST_CHECK(MemoryTracker::get_stats(MemoryTag::RENDERER).live_bytes == renderer_live);
+
+    // Shutdown frees each live buffer once and nothing when none are left
+    JojEngine::MemoryStats before = MemoryTracker::get_stats(MemoryTag::RENDERER);
+    renderer.create_buffer(desc);
+    renderer.create_buffer(desc);
+    renderer.shutdown();
+    renderer.shutdown();
+    JojEngine::MemoryStats after = MemoryTracker::get_stats(MemoryTag::RENDERER);
+    TEST_CHECK(after.live_bytes == before.live_bytes);
+    TEST_CHECK(after.live_allocations == before.live_allocations);
+}
+
+// Every arena block is freed once: overflow blocks at reset, the main block at shutdown
+TEST_CASE(memory, tracker_arena)
+{
+    using JojEngine::MemoryTag;
+    using JojEngine::MemoryTracker;
+
+    JojEngine::MemoryStats before = MemoryTracker::get_stats(MemoryTag::ENGINE);
+    {
+        JojEngine::LinearArena arena;
+        TEST_CHECK(arena.init(64));
+        for (u32 i = 0; i < 3; ++i)
+            arena.allocate(100, 8);
+        TEST_CHECK(MemoryTracker::get_stats(MemoryTag::ENGINE).live_allocations == before.live_allocations + 4);
+
+        // Overflow blocks go away, the grown main block replaces the old one
+        arena.reset();
+        JojEngine::MemoryStats grown = MemoryTracker::get_stats(MemoryTag::ENGINE);
+        TEST_CHECK(grown.live_allocations == before.live_allocations + 1);
+        TEST_CHECK(grown.live_bytes == before.live_bytes + arena.get_capacity());
+
+        arena.allocate(1000, 8);
+        arena.shutdown();
+    }
+    JojEngine::MemoryStats after = MemoryTracker::get_stats(MemoryTag::ENGINE);
+    TEST_CHECK(after.live_bytes == before.live_bytes);
+    TEST_CHECK(after.live_allocations == before.live_allocations);
+}
+#endif // !FMEMORY_TRACKING_DISABLED
@@ -0,0 +1,196 @@
+#include "test.h"
+
+#include "engine.h"
+#include "frame_pipeline.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+// Render thread side of the FramePipeline tests, checked on the main thread afterwards
+struct PipelineRecord
+{
+    std::vector<u64> frames;            // Frames in the order they were drawn
+    std::atomic<u64> writing{ 0 };      // Frame the main thread simulates
+    u64 most_ahead = 0;                 // Largest writing - drawn frame seen while drawing
+    u32 render_ms = 0;                  // Time each draw takes
+};
+
+static void record_frame(JojEngine::FrameSnapshot* snapshot, void* user)
+{
+    PipelineRecord* record = (PipelineRecord*)user;
+    std::this_thread::sleep_for(std::chrono::milliseconds(record->render_ms));
+
+    u64 ahead = record->writing.load(std::memory_order_acquire) - snapshot->frame;
+    record->most_ahead = ahead > record->most_ahead ? ahead : record->most_ahead;
+    record->frames.push_back(snapshot->frame);
+}
+
+// Frames are drawn in order, the simulation runs exactly depth frames ahead of a slow renderer and no further
+TEST_CASE(pipeline, order_and_depth)
+{
+    const u32 frame_count = 20;
+
+    for (u32 depth = 1; depth <= JojEngine::MAX_PIPELINE_DEPTH; ++depth)
+    {
+        JojEngine::FrameSnapshot storage[JojEngine::MAX_PIPELINE_DEPTH + 1];
+        JojEngine::FrameSnapshot* snapshots[JojEngine::MAX_PIPELINE_DEPTH + 1];
+        for (u32 i = 0; i <= JojEngine::MAX_PIPELINE_DEPTH; ++i)
+            snapshots[i] = &storage[i];
+
+        PipelineRecord record;
+        record.render_ms = 2;
+
+        JojEngine::FramePipeline pipeline;
+        if (!TEST_CHECK(pipeline.init(depth, snapshots, record_frame, &record)))
+            continue;
+        TEST_CHECK(pipeline.get_depth() == depth);
+
+        for (u32 i = 0; i < frame_count; ++i)
+        {
+            JojEngine::FrameSnapshot* snapshot = pipeline.begin_frame();
+            record.writing.store(snapshot->frame, std::memory_order_release);
+            pipeline.end_frame();
+        }
+        pipeline.shutdown();
+
+        u32 out_of_order = 0;
+        for (u32 i = 0; i < record.frames.size(); ++i)
+            out_of_order += record.frames[i] != i;
+        TEST_CHECK(record.frames.size() == frame_count);
+        TEST_CHECK(out_of_order == 0);
+        TEST_CHECK(record.most_ahead == depth);
+    }
+}
+
+// Shutdown draws every submitted frame before the render thread stops
+TEST_CASE(pipeline, shutdown_renders_submitted)
+{
+    const u32 frame_count = 16;
+
+    for (u32 depth = 1; depth <= JojEngine::MAX_PIPELINE_DEPTH; ++depth)
+    {
+        JojEngine::FrameSnapshot storage[JojEngine::MAX_PIPELINE_DEPTH + 1];
+        JojEngine::FrameSnapshot* snapshots[JojEngine::MAX_PIPELINE_DEPTH + 1];
+        for (u32 i = 0; i <= JojEngine::MAX_PIPELINE_DEPTH; ++i)
+            snapshots[i] = &storage[i];
+
+        PipelineRecord record;
+        record.render_ms = 1;
+
+        JojEngine::FramePipeline pipeline;
+        if (!TEST_CHECK(pipeline.init(depth, snapshots, record_frame, &record)))
+            continue;
+
+        for (u32 i = 0; i < frame_count; ++i)
+        {
+            pipeline.begin_frame();
+            pipeline.end_frame();
+        }
+
+        // Up to depth + 1 frames are still queued here
+        pipeline.shutdown();
+        TEST_CHECK(!pipeline.is_running());
+        TEST_CHECK(pipeline.get_frames_rendered() == frame_count);
+        TEST_CHECK(record.frames.size() == frame_count);
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Engine
+// ------------------------------------------------------------------------------
+
+// Values written into the frame arena by each update
+static const u32 PIPELINE_VALUES = 64;
+
+struct PipelineGameSnapshot : public JojEngine::FrameSnapshot
+{
+    const u64* values = nullptr;    // Frame arena memory of the simulated frame
+    u64 tick = 0;                   // Update that wrote them
+};
+
+// Outlives the game, which the engine deletes
+struct PipelineGameResult
+{
+    u32 frames = 0;                     // Updates before the game closes the engine
+    u64 updates = 0;                    // Updates run (main thread)
+    std::thread::id main_thread;
+    std::atomic<u32> draws{ 0 };        // draw_snapshot calls
+    std::atomic<u32> wrong_thread{ 0 }; // Draws on the main thread
+    std::atomic<u32> corrupted{ 0 };    // Draws that saw other values than the update wrote
+};
+
+class PipelineGame : public JojEngine::Game
+{
+public:
+    explicit PipelineGame(PipelineGameResult* result) : result(result) {}
+
+    void init() {}
+    void shutdown() {}
+
+    void update()
+    {
+        result->updates++;
+        values = (u64*)frame_arena->allocate(PIPELINE_VALUES * sizeof(u64));
+        for (u32 i = 0; i < PIPELINE_VALUES; ++i)
+            values[i] = result->updates;
+
+        if (result->updates == result->frames)
+            JojEngine::Engine::close_engine();
+    }
+
+    JojEngine::FrameSnapshot* create_snapshot() { return new PipelineGameSnapshot(); }
+
+    void write_snapshot(JojEngine::FrameSnapshot* snapshot)
+    {
+        PipelineGameSnapshot* s = (PipelineGameSnapshot*)snapshot;
+        s->values = values;
+        s->tick = result->updates;
+    }
+
+    void draw_snapshot(const JojEngine::FrameSnapshot* snapshot)
+    {
+        const PipelineGameSnapshot* s = (const PipelineGameSnapshot*)snapshot;
+
+        // Drawing lags, later frames reuse the older arenas meanwhile
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        u32 wrong = 0;
+        for (u32 i = 0; i < PIPELINE_VALUES; ++i)
+            wrong += s->values[i] != s->tick;
+
+        result->corrupted += wrong != 0;
+        result->wrong_thread += std::this_thread::get_id() == result->main_thread;
+        result->draws++;
+    }
+
+private:
+    PipelineGameResult* result;
+    u64* values = nullptr;
+};
+
+// A headless engine draws game snapshots on the render thread and keeps their arena memory until drawn
+TEST_CASE(pipeline, engine_headless)
+{
+    for (u32 depth = 1; depth <= JojEngine::MAX_PIPELINE_DEPTH; ++depth)
+    {
+        PipelineGameResult result;
+        result.frames = 4 * (depth + 2);
+        result.main_thread = std::this_thread::get_id();
+
+        {
+            JojTest::StdoutSilencer silencer;
+            JojEngine::Engine::set_pipeline_depth(depth);
+            JojEngine::Engine engine;
+            TEST_CHECK(engine.start(new PipelineGame(&result), JojEngine::RendererBackend::NULL_RENDERER) == 0);
+        }
+
+        TEST_CHECK(result.updates == result.frames);
+        TEST_CHECK(result.draws == result.frames);
+        TEST_CHECK(result.wrong_thread == 0);
+        TEST_CHECK(result.corrupted == 0);
+    }
+
+    JojEngine::Engine::set_pipeline_depth(0);
+}
@@ -0,0 +1,108 @@
+#include "test.h"
+
+#include "events.h"
+
+#if PLATFORM_LINUX
+#include "engine.h"
+#include "platform_manager.h"
+
+static void flood_mouse(JojPlatform::PlatformManager& pm, u32 count)
+{
+    for (u32 i = 0; i < count; ++i)
+        pm.post_event({ JojPlatform::EventType::MOUSE_MOVE, 0, i32(i % 1366), i32(i % 768), 0 });
+}
+
+// A key press queued behind a mouse flood reaches the very next frame and the buffer stays small
+TEST_CASE(platform, event_merge)
+{
+    JojPlatform::PlatformManager pm;
+    if (!TEST_CHECK(pm.init()))
+        return;
+
+    // One message per loop iteration (the old loop) needs 10001 iterations to reach the key
+    flood_mouse(pm, 10000);
+    pm.post_event({ JojPlatform::EventType::KEY_DOWN, 'W', 0, 0, 0 });
+    flood_mouse(pm, 10000);
+    pm.post_event({ JojPlatform::EventType::MOUSE_WHEEL, 0, 0, 0, 120 });
+    pm.post_event({ JojPlatform::EventType::MOUSE_WHEEL, 0, 0, 0, -240 });
+    pm.post_event({ JojPlatform::EventType::KEY_UP, 'W', 0, 0, 0 });
+
+    TEST_CHECK(pm.pump_events());
+
+    const JojPlatform::EventQueue& events = pm.get_events();
+    TEST_CHECK(events.get_received() == 20004);
+    TEST_CHECK(!pm.is_key_down('W'));
+    TEST_CHECK(pm.get_xmouse() == 9999 % 1366 && pm.get_ymouse() == 9999 % 768);
+    if (!TEST_CHECK(events.size() == 5))
+        return;
+    TEST_CHECK(events[0].type == JojPlatform::EventType::MOUSE_MOVE && events[0].x == 9999 % 1366);
+    TEST_CHECK(events[1].type == JojPlatform::EventType::KEY_DOWN && events[1].key == 'W');
+    TEST_CHECK(events[2].type == JojPlatform::EventType::MOUSE_MOVE && events[2].y == 9999 % 768);
+    TEST_CHECK(events[3].type == JojPlatform::EventType::MOUSE_WHEEL && events[3].wheel == -120);
+    TEST_CHECK(events[4].type == JojPlatform::EventType::KEY_UP);
+
+    // The posted queue was drained, the next frame starts empty
+    TEST_CHECK(pm.pump_events());
+    TEST_CHECK(pm.get_events().size() == 0 && pm.get_events().get_received() == 0);
+
+    pm.shutdown();
+}
+#endif // PLATFORM_LINUX
+
+// Full buffer drops input but never a quit request
+TEST_CASE(platform, event_overflow)
+{
+    JojPlatform::EventQueue events;
+    for (u32 i = 0; i < JojPlatform::MAX_FRAME_EVENTS + 10; ++i)
+        events.push({ i % 2 ? JojPlatform::EventType::KEY_UP : JojPlatform::EventType::KEY_DOWN, 'A', 0, 0, 0 });
+    events.push({ JojPlatform::EventType::QUIT, 0, 0, 0, 0 });
+
+    TEST_CHECK(events.size() == JojPlatform::MAX_FRAME_EVENTS);
+    TEST_CHECK(events.get_dropped() == 11);
+    TEST_CHECK(events[events.size() - 1].type == JojPlatform::EventType::QUIT);
+}
+
+#if PLATFORM_LINUX
+// Engine::start runs the game lifecycle headless, posted input reaches the next frame and QUIT ends the loop
+TEST_CASE(platform, headless_engine)
+{
+    class InputGame : public JojEngine::Game
+    {
+    public:
+        // Frame memory is ready before the game initializes
+        void init() override { initialized = frame_arena->get_count() >= 2 && frame_arena->allocate(64) != nullptr; }
+        void shutdown() override { shut_down = true; }
+
+        void update() override
+        {
+            JojPlatform::PlatformManager* pm = JojEngine::Engine::pm.get();
+            frames++;
+
+            if (frames == 1)
+                pm->post_event({ JojPlatform::EventType::KEY_DOWN, 'W', 0, 0, 0 });
+            else if (frames == 2)
+            {
+                saw_key = pm->is_key_down('W') && pm->get_events().size() == 1;
+                pm->post_event({ JojPlatform::EventType::QUIT, 7, 0, 0, 0 });
+            }
+        }
+
+        void draw() override { JojEngine::Engine::null_renderer->swap_buffers(); }
+
+        u32 frames = 0;
+        b8 initialized = false;
+        b8 shut_down = false;
+        b8 saw_key = false;
+    };
+
+    InputGame* game = new InputGame();
+    JojEngine::Engine engine;
+    i32 exit_code = engine.start(game, JojEngine::RendererBackend::NULL_RENDERER);
+
+    TEST_CHECK(exit_code == 7);
+    TEST_CHECK(game->initialized && game->shut_down);
+    TEST_CHECK(game->saw_key);
+    TEST_CHECK(game->frames == 2);
+    TEST_CHECK(JojEngine::Engine::null_renderer->get_frame_count() == 2);
+}
+#endif // PLATFORM_LINUX
@@ -0,0 +1,121 @@
+#include "test.h"
+
+#include "memory_tracker.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+
+#if !FPROFILER_DISABLED
+// Nested zones keep their depth and order per thread, rings keep the newest events, traces are written
+TEST_CASE(profiler, zones)
+{
+    using JojEngine::Profiler;
+    using JojEngine::ProfileEvent;
+
+    Profiler::clear();
+
+    // Registered first, so it doesn't take over the worker's buffer once the worker exits
+    Profiler::set_thread_name("Check main");
+
+    u32 worker_thread = 0;
+    std::thread worker([&]()
+    {
+        Profiler::set_thread_name("Check \"worker\"");
+        for (u32 i = 0; i < JojEngine::PROFILER_BUFFER_SIZE + 10; ++i)
+        {
+            FPROFILE_ZONE("worker_zone");
+        }
+
+        std::vector<ProfileEvent> events;
+        Profiler::collect(events);
+        worker_thread = events.back().thread;
+    });
+    worker.join();
+
+    {
+        FPROFILE_ZONE("outer");
+        FPROFILE_ZONE("inner");
+    }
+    FPROFILE_FRAME();
+
+    Profiler::set_enabled(false);
+    TEST_CHECK(!Profiler::begin_zone("ignored"));
+    Profiler::set_enabled(true);
+
+    std::vector<ProfileEvent> events;
+    Profiler::collect(events);
+
+    u32 worker_events = 0;
+    const ProfileEvent* inner = nullptr;
+    const ProfileEvent* outer = nullptr;
+    const ProfileEvent* frame = nullptr;
+    for (const ProfileEvent& e : events)
+    {
+        if (e.thread == worker_thread)
+            worker_events++;
+        else if (strcmp(e.name, "inner") == 0)
+            inner = &e;
+        else if (strcmp(e.name, "outer") == 0)
+            outer = &e;
+        else if (e.type == JojEngine::ProfileEventType::FRAME)
+            frame = &e;
+    }
+
+    TEST_CHECK(worker_events == JojEngine::PROFILER_BUFFER_SIZE);
+    if (TEST_CHECK(inner && outer && frame))
+    {
+        TEST_CHECK(inner < outer);
+        TEST_CHECK(inner->depth == 1 && outer->depth == 0);
+        TEST_CHECK(outer->begin <= inner->begin && inner->end <= outer->end && outer->end <= frame->begin);
+    }
+    TEST_CHECK(Profiler::get_frame_count() == 1);
+
+    const char* path = "joj_profiler_test.json";
+    TEST_CHECK(Profiler::write_chrome_trace(path));
+    std::string trace = JojTest::read_file(path);
+    remove(path);
+
+    TEST_CHECK(trace.find("\"name\":\"outer\",\"ph\":\"X\"") != std::string::npos);
+    TEST_CHECK(trace.find("\"ph\":\"i\"") != std::string::npos);
+    TEST_CHECK(trace.find("Check \\\"worker\\\"") != std::string::npos);
+
+    Profiler::clear();
+}
+
+#if !FMEMORY_TRACKING_DISABLED
+// Buffers of finished threads are taken over by new threads instead of adding up
+TEST_CASE(profiler, thread_buffers)
+{
+    auto run_threads = []()
+    {
+        std::vector<std::thread> threads;
+        for (u32 t = 0; t < 4; ++t)
+            threads.emplace_back([]() { FPROFILE_ZONE("recycled_zone"); });
+        for (std::thread& t : threads)
+            t.join();
+    };
+
+    run_threads();
+    u64 live = JojEngine::MemoryTracker::get_stats(JojEngine::MemoryTag::ENGINE).live_bytes;
+
+    for (u32 i = 0; i < 8; ++i)
+        run_threads();
+
+    TEST_CHECK(JojEngine::MemoryTracker::get_stats(JojEngine::MemoryTag::ENGINE).live_bytes == live);
+
+    // Every generation keeps its own thread id
+    std::vector<JojEngine::ProfileEvent> events;
+    JojEngine::Profiler::collect(events);
+    std::vector<u32> threads;
+    for (const JojEngine::ProfileEvent& e : events)
+        if (strcmp(e.name, "recycled_zone") == 0)
+            threads.push_back(e.thread);
+    std::sort(threads.begin(), threads.end());
+    TEST_CHECK(threads.size() == 36);
+    TEST_CHECK(std::unique(threads.begin(), threads.end()) == threads.end());
+}
+#endif // !FMEMORY_TRACKING_DISABLED
+#endif // !FPROFILER_DISABLED
@@ -0,0 +1,92 @@
+#include "test.h"
+
+#include <stdio.h>
+
+#if PLATFORM_WINDOWS
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+// Function local so TEST_CASE registrations of other files may run first
+static std::vector<JojTest::TestCase>& registry()
+{
+    static std::vector<JojTest::TestCase> tests;
+    return tests;
+}
+
+static u32 failures = 0;
+
+namespace JojTest
+{
+    b8 register_test(const char* name, TestFunc func)
+    {
+        registry().push_back({ name, func });
+        return true;
+    }
+
+    const std::vector<TestCase>& get_tests()
+    {
+        return registry();
+    }
+
+    b8 check(b8 passed, const char* file, i32 line, const char* expression)
+    {
+        if (!passed)
+        {
+            fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+            failures++;
+        }
+        return passed;
+    }
+
+    u32 get_failure_count()
+    {
+        return failures;
+    }
+
+    std::string read_file(const char* path)
+    {
+        std::string text;
+        if (FILE* file = fopen(path, "r"))
+        {
+            char buffer[4096];
+            size_t read = 0;
+            while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+                text.append(buffer, read);
+            fclose(file);
+        }
+        return text;
+    }
+
+    StdoutSilencer::StdoutSilencer(const char* path)
+    {
+        fflush(stdout);
+#if PLATFORM_WINDOWS
+        saved_fd = _dup(_fileno(stdout));
+        i32 target_fd = path ? _open(path, _O_WRONLY | _O_CREAT | _O_TRUNC, _S_IREAD | _S_IWRITE) : _open("NUL", _O_WRONLY);
+        _dup2(target_fd, _fileno(stdout));
+        _close(target_fd);
+#else
+        saved_fd = dup(fileno(stdout));
+        i32 target_fd = path ? open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644) : open("/dev/null", O_WRONLY);
+        dup2(target_fd, fileno(stdout));
+        close(target_fd);
+#endif
+    }
+
+    StdoutSilencer::~StdoutSilencer()
+    {
+        fflush(stdout);
+#if PLATFORM_WINDOWS
+        _dup2(saved_fd, _fileno(stdout));
+        _close(saved_fd);
+#else
+        dup2(saved_fd, fileno(stdout));
+        close(saved_fd);
+#endif
+    }
+}
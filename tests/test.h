@@ -0,0 +1,54 @@
+#pragma once
+
+#include "defines.h"
+
+#include <string>
+#include <vector>
+
+namespace JojTest
+{
+    // Test body, reports failures through TEST_CHECK
+    typedef void(*TestFunc)();
+
+    struct TestCase
+    {
+        const char* name;           // "group.name", --filter matches a prefix
+        TestFunc func;              // Test body
+    };
+
+    // Add a test to the registry, TEST_CASE calls it before main
+    b8 register_test(const char* name, TestFunc func);
+
+    // Return registered tests, in registration order
+    const std::vector<TestCase>& get_tests();
+
+    // Record a failed check of the running test if passed is false, return passed
+    b8 check(b8 passed, const char* file, i32 line, const char* expression);
+
+    // Return number of failed checks since the program started
+    u32 get_failure_count();
+
+    // Return contents of the file at path, empty if it can't be read
+    std::string read_file(const char* path);
+
+    // Redirect stdout while alive (logger output)
+    class StdoutSilencer
+    {
+    public:
+        // Redirect stdout to path, or discard it if path is nullptr
+        explicit StdoutSilencer(const char* path = nullptr);
+        ~StdoutSilencer();
+
+    private:
+        i32 saved_fd;
+    };
+}
+
+// Define test group.name and register it
+#define TEST_CASE(group, name) \
+    static void test_##group##_##name(); \
+    static const b8 test_##group##_##name##_registered = JojTest::register_test(#group "." #name, test_##group##_##name); \
+    static void test_##group##_##name()
+
+// Record expression as a failure of the running test when it is false, the test keeps going
+#define TEST_CHECK(expression) JojTest::check(b8(expression), __FILE__, __LINE__, #expression)
@@ -0,0 +1,144 @@
+#include "test.h"
+
+#include "clock.h"
+#include "fixed_timestep.h"
+#include "timer_wheel.h"
+
+#include <chrono>
+#include <thread>
+
+// Clock ticks convert to the OS clock
+TEST_CASE(time, clock_ticks)
+{
+    i64 begin = JojPlatform::Clock::now();
+    i64 begin_ticks = JojPlatform::Clock::ticks();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    i64 elapsed = JojPlatform::Clock::now() - begin;
+    i64 converted = JojPlatform::Clock::ticks_to_ns(JojPlatform::Clock::ticks() - begin_ticks);
+
+    TEST_CHECK(elapsed >= 20000000);
+    TEST_CHECK(converted > elapsed - elapsed / 50 && converted < elapsed + elapsed / 50);
+}
+
+// Timers fire on their tick at every level, cancelled ones never fire
+TEST_CASE(time, timer_wheel)
+{
+    struct Shot
+    {
+        JojEngine::TimerWheel* wheel;
+        i64 due;            // Expected get_time() when it fires
+        u32 fired;
+        u32 late;
+    };
+
+    // Tick of 1 ns so every level is crossed quickly
+    JojEngine::TimerWheel wheel;
+    wheel.init(1000, 1);
+
+    const u32 count = 2000;
+    std::vector<Shot> shots(count);
+    std::vector<JojEngine::TimerHandle> handles(count);
+    u32 seed = 777;
+
+    auto fire = [](void* data)
+    {
+        Shot* shot = (Shot*)data;
+        shot->fired++;
+        shot->late += shot->wheel->get_time() != shot->due;
+    };
+
+    for (u32 i = 0; i < count; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        i64 delay = i64(seed >> (i % 4 == 0 ? 7 : 20)) + 1;      // Up to 2^25 ticks or 4096 ticks
+        shots[i] = { &wheel, 1000 + delay, 0, 0 };
+        handles[i] = wheel.schedule(delay, fire, &shots[i]);
+    }
+
+    u32 bad_cancels = 0;
+    for (u32 i = 0; i < count; i += 3)
+        bad_cancels += !wheel.cancel(handles[i]) || wheel.cancel(handles[i]);
+    TEST_CHECK(bad_cancels == 0);
+
+    // Periodic timer cancelling itself on its fifth call, one shot scheduled from a callback
+    struct Repeat
+    {
+        JojEngine::TimerWheel* wheel;
+        JojEngine::TimerHandle handle;
+        u32 calls;
+        i64 last;
+    } repeat = { &wheel, 0, 0, 0 };
+
+    repeat.handle = wheel.schedule(100, [](void* data)
+    {
+        Repeat* r = (Repeat*)data;
+        r->calls++;
+        r->last = r->wheel->get_time();
+        if (r->calls == 5)
+        {
+            r->wheel->cancel(r->handle);
+            r->wheel->schedule(0, [](void* d) { ((Repeat*)d)->calls += 100; }, r);
+        }
+    }, &repeat, 1000);
+
+    // Random steps, some within one tick
+    i64 now = 1000;
+    while (now < 1000 + (i64(1) << 26))
+    {
+        seed = seed * 1664525u + 1013904223u;
+        now += i64(seed >> 12);
+        wheel.advance(now);
+    }
+
+    u32 wrong = 0;
+    for (u32 i = 0; i < count; ++i)
+    {
+        if (i % 3 == 0)
+            wrong += shots[i].fired != 0;
+        else
+            wrong += shots[i].fired != 1 || shots[i].late != 0;
+    }
+
+    TEST_CHECK(wrong == 0);
+    TEST_CHECK(repeat.calls == 105);
+    TEST_CHECK(repeat.last == 1000 + 100 + 4 * 1000);
+    TEST_CHECK(wheel.get_pending() == 0);
+}
+
+// Ticks follow simulated time at any frame rate, alpha stays in [0, 1]
+TEST_CASE(time, fixed_timestep)
+{
+    JojEngine::FixedTimestep timestep;
+    timestep.init(64.0, 5);
+
+    // Uneven frames around 144 Hz that sum to exactly one second: over it exactly 64 ticks run.
+    // Frames and tick are multiples of 1/1024 s, so the accumulator has no rounding error
+    const f64 frames[] = { 7.0 / 1024.0, 9.0 / 1024.0, 5.0 / 1024.0 };
+    f64 time = 0.0;
+    u64 ticks = 0;
+    u32 bad_alpha = 0;
+    for (u32 i = 0; time < 1.0; ++i)
+    {
+        f64 frame = time + frames[i % 3] <= 1.0 ? frames[i % 3] : 1.0 - time;
+        time += frame;
+        ticks += timestep.advance(frame);
+        f32 alpha = timestep.get_alpha();
+        bad_alpha += alpha < 0.0f || alpha > 1.0f;
+    }
+    TEST_CHECK(time == 1.0);
+    TEST_CHECK(bad_alpha == 0);
+    TEST_CHECK(ticks == timestep.get_tick_count());
+    TEST_CHECK(ticks == 64);
+    TEST_CHECK(timestep.get_alpha() == 0.0f);
+}
+
+// A 1 s hitch runs max_steps ticks and drops the rest
+TEST_CASE(time, fixed_timestep_catch_up)
+{
+    JojEngine::FixedTimestep timestep;
+    timestep.init(60.0, 5);
+
+    TEST_CHECK(timestep.advance(1.0) == 5);
+    TEST_CHECK(timestep.get_dropped_time() > 1.0 - 6.0 / 60.0 - 1e-6);
+    TEST_CHECK(timestep.advance(1.0 / 60.0) <= 2);
+}
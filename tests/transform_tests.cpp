@@ -0,0 +1,218 @@
+#include "test.h"
+
+#include "job_system.h"
+#include "transform_hierarchy.h"
+
+#include <math.h>
+#include <string.h>
+
+static Transform node_transform(u32 i)
+{
+    return transform_create(vec3_create(f32(i % 17), 1.0f, -f32(i % 5)),
+        quat_from_axis_angle(vec3_up(), 0.01f * f32(i % 31)), vec3_create(1.0f, 1.0f, 1.0f));
+}
+
+// World matrix of node computed by walking up to its root
+static Mat4 reference_world(const JojEngine::TransformHierarchy& hierarchy, JojEngine::TransformNode node)
+{
+    Mat4 world = transform_to_mat4(*hierarchy.get_local(node));
+    for (JojEngine::TransformNode p = hierarchy.get_parent(node); !p.is_null(); p = hierarchy.get_parent(p))
+        world = mat4_mul(world, transform_to_mat4(*hierarchy.get_local(p)));
+    return world;
+}
+
+// Return number of live nodes whose world matrix differs from the reference
+static u32 world_mismatches(const JojEngine::TransformHierarchy& hierarchy, const std::vector<JojEngine::TransformNode>& nodes)
+{
+    u32 mismatches = 0;
+    for (JojEngine::TransformNode node : nodes)
+    {
+        if (!hierarchy.is_alive(node))
+            continue;
+
+        Mat4 expected = reference_world(hierarchy, node);
+        const Mat4* world = hierarchy.get_world(node);
+        for (u32 k = 0; k < 16; ++k)
+        {
+            if (fabsf(world->data[k] - expected.data[k]) > 1e-3f)
+            {
+                mismatches++;
+                break;
+            }
+        }
+    }
+    return mismatches;
+}
+
+// Roots with 10 children of 10 children each (111 nodes per root), every node in all
+static std::vector<JojEngine::TransformNode> build_scene(JojEngine::TransformHierarchy& hierarchy, u32 root_count,
+    std::vector<JojEngine::TransformNode>& all)
+{
+    std::vector<JojEngine::TransformNode> roots;
+    hierarchy.init(root_count * 111);
+
+    u32 n = 0;
+    for (u32 r = 0; r < root_count; ++r)
+    {
+        JojEngine::TransformNode root = hierarchy.create(node_transform(n++));
+        roots.push_back(root);
+        all.push_back(root);
+        for (u32 c = 0; c < 10; ++c)
+        {
+            JojEngine::TransformNode child = hierarchy.create(node_transform(n++), root);
+            all.push_back(child);
+            for (u32 g = 0; g < 10; ++g)
+                all.push_back(hierarchy.create(node_transform(n++), child));
+        }
+    }
+
+    hierarchy.update();
+    return roots;
+}
+
+// Only changed subtrees are recomputed, reparenting and destroying keep the worlds right
+TEST_CASE(transform, dirty_subtrees)
+{
+    JojEngine::TransformHierarchy hierarchy;
+    hierarchy.init(64);
+
+    // Two roots, a has a chain of three below it
+    JojEngine::TransformNode a = hierarchy.create(node_transform(1));
+    JojEngine::TransformNode b = hierarchy.create(node_transform(2));
+    JojEngine::TransformNode a1 = hierarchy.create(node_transform(3), a);
+    JojEngine::TransformNode a2 = hierarchy.create(node_transform(4), a1);
+    JojEngine::TransformNode a3 = hierarchy.create(node_transform(5), a2);
+    JojEngine::TransformNode b1 = hierarchy.create(node_transform(6), b);
+    std::vector<JojEngine::TransformNode> nodes = { a, b, a1, a2, a3, b1 };
+
+    TEST_CHECK(hierarchy.update() == 6);
+    TEST_CHECK(hierarchy.get_level_count() == 4);
+    TEST_CHECK(world_mismatches(hierarchy, nodes) == 0);
+    TEST_CHECK(hierarchy.update() == 0);
+
+    // a1 moved: a1, a2 and a3
+    TEST_CHECK(hierarchy.set_local(a1, node_transform(7)));
+    TEST_CHECK(hierarchy.update() == 3);
+    TEST_CHECK(world_mismatches(hierarchy, nodes) == 0);
+
+    // a2 below b: a2 and a3, one level less
+    TEST_CHECK(hierarchy.set_parent(a2, b));
+    TEST_CHECK(hierarchy.get_parent(a2) == b);
+    TEST_CHECK(hierarchy.update() == 2);
+    TEST_CHECK(hierarchy.get_level_count() == 3);
+    TEST_CHECK(world_mismatches(hierarchy, nodes) == 0);
+
+    // Cycles are refused
+    TEST_CHECK(!hierarchy.set_parent(b, a3));
+    TEST_CHECK(!hierarchy.set_parent(b, b));
+    TEST_CHECK(hierarchy.update() == 0);
+
+    // Destroying b takes a2, a3 and b1 with it, the others stay where they are until the next update
+    const Mat4* a1_world = hierarchy.get_world(a1);
+    TEST_CHECK(hierarchy.destroy(b));
+    TEST_CHECK(!hierarchy.is_alive(a3) && !hierarchy.is_alive(b1));
+    TEST_CHECK(hierarchy.get_world(a1) == a1_world);
+    TEST_CHECK(!hierarchy.destroy(a2));
+    TEST_CHECK(hierarchy.get_count() == 2);
+    TEST_CHECK(hierarchy.update() == 0);
+    TEST_CHECK(world_mismatches(hierarchy, nodes) == 0);
+    TEST_CHECK(hierarchy.create(transform_identity(), b).is_null());
+
+    // Reused slots hand out new generations
+    JojEngine::TransformNode c = hierarchy.create(node_transform(8), a1);
+    TEST_CHECK(!c.is_null() && c != b && c != a2);
+    TEST_CHECK(hierarchy.update() == 1);
+    TEST_CHECK(world_mismatches(hierarchy, { a, a1, c }) == 0);
+
+    // Destroyed before its first update: only the new subtree goes
+    JojEngine::TransformNode d = hierarchy.create(node_transform(9), c);
+    JojEngine::TransformNode e = hierarchy.create(node_transform(10), d);
+    TEST_CHECK(hierarchy.destroy(d));
+    TEST_CHECK(!hierarchy.is_alive(e) && hierarchy.is_alive(c));
+    TEST_CHECK(hierarchy.get_count() == 3);
+    TEST_CHECK(hierarchy.update() == 0);
+    TEST_CHECK(world_mismatches(hierarchy, { a, a1, c }) == 0);
+
+    hierarchy.clear();
+    TEST_CHECK(hierarchy.get_count() == 0);
+    TEST_CHECK(!hierarchy.is_alive(a));
+    TEST_CHECK(hierarchy.update() == 0);
+}
+
+// Big levels split across jobs give the same matrices
+TEST_CASE(transform, parallel_update)
+{
+    JojEngine::JobSystem jobs;
+    jobs.init(4);
+
+    const u32 roots = 100;
+    JojEngine::TransformHierarchy serial;
+    JojEngine::TransformHierarchy parallel;
+    std::vector<JojEngine::TransformNode> serial_nodes;
+    std::vector<JojEngine::TransformNode> parallel_nodes;
+    std::vector<JojEngine::TransformNode> serial_roots = build_scene(serial, roots, serial_nodes);
+    std::vector<JojEngine::TransformNode> parallel_roots = build_scene(parallel, roots, parallel_nodes);
+
+    for (u32 r = 0; r < roots; r += 3)
+    {
+        serial.set_local(serial_roots[r], node_transform(r + 11));
+        parallel.set_local(parallel_roots[r], node_transform(r + 11));
+    }
+    u32 serial_count = serial.update();
+    TEST_CHECK(serial_count == ((roots + 2) / 3) * 111);
+    TEST_CHECK(parallel.update(&jobs) == serial_count);
+
+    u32 different = 0;
+    for (u32 i = 0; i < serial_nodes.size(); ++i)
+        different += memcmp(serial.get_world(serial_nodes[i]), parallel.get_world(parallel_nodes[i]), sizeof(Mat4)) != 0;
+    TEST_CHECK(different == 0);
+    TEST_CHECK(world_mismatches(parallel, parallel_nodes) == 0);
+
+    jobs.shutdown();
+}
+
+// Random edits between updates always end with the reference matrices
+TEST_CASE(transform, random_edits)
+{
+    JojEngine::TransformHierarchy hierarchy;
+    hierarchy.init(256);
+
+    std::vector<JojEngine::TransformNode> nodes;
+    u32 seed = 1234;
+    auto next = [&seed]() { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+
+    for (u32 round = 0; round < 200; ++round)
+    {
+        for (u32 op = 0; op < 8; ++op)
+        {
+            u32 pick = next();
+            JojEngine::TransformNode node = nodes.empty() ? JojEngine::TransformNode() : nodes[pick % nodes.size()];
+            switch (next() % 6)
+            {
+            case 0:
+            case 1:
+                nodes.push_back(hierarchy.create(node_transform(pick), hierarchy.is_alive(node) ? node : JojEngine::TransformNode()));
+                break;
+            case 2:
+                hierarchy.set_local(node, node_transform(pick + 1));
+                break;
+            case 3:
+                if (!nodes.empty())
+                    hierarchy.set_parent(node, next() % 4 ? nodes[next() % nodes.size()] : JojEngine::TransformNode());
+                break;
+            default:
+                if (next() % 3 == 0)
+                    hierarchy.destroy(node);
+                break;
+            }
+        }
+
+        hierarchy.update();
+        TEST_CHECK(world_mismatches(hierarchy, nodes) == 0);
+    }
+
+    u32 alive = 0;
+    for (JojEngine::TransformNode node : nodes)
+        alive += hierarchy.is_alive(node);
+    TEST_CHECK(alive == hierarchy.get_count());
+}
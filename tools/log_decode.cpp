@@ -0,0 +1,32 @@
+#include "binary_log.h"
+
+#include <stdio.h>
+
+// Usage: JojLogDecode <binary log> [output text file]
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s <binary log> [output]\n", argv[0]);
+        return 1;
+    }
+
+    FILE* out = argc > 2 ? fopen(argv[2], "w") : stdout;
+    if (!out)
+    {
+        fprintf(stderr, "Failed to create %s\n", argv[2]);
+        return 1;
+    }
+
+    b8 decoded = log_decode_binary(argv[1], out);
+    if (out != stdout)
+        fclose(out);
+
+    if (!decoded)
+    {
+        fprintf(stderr, "%s is not a binary log\n", argv[1]);
+        return 1;
+    }
+
+    return 0;
+}